@@ -116,6 +116,9 @@ def main():
     reader.Update()
     data     = reader.GetOutput()
 
+    # convert 16-bit quantized fields (out_quantize) to physical values
+    dequantize(filename,data)
+
     # extract coordinates
     x = VN.vtk_to_numpy(data.GetXCoordinates())
     y = VN.vtk_to_numpy(data.GetYCoordinates())
@@ -210,6 +213,26 @@ def main():
 
 
 
+def dequantize(filename,data):
+  # quantized fields are stored as UInt16, physical value = Offset + Scale*raw
+  # Offset and Scale are stored as attributes of the PDataArray in the .pvtr file
+  from vtk.util import numpy_support as VN
+  import xml.etree.ElementTree as ET
+  import numpy as np
+
+  root = ET.parse(filename).getroot()
+  for arr in root.iter('PDataArray'):
+    if arr.get('Scale') is None:
+      continue
+    name   = arr.get('Name')
+    scale  = float(arr.get('Scale'))
+    offset = float(arr.get('Offset'))
+    raw    = VN.vtk_to_numpy(data.GetPointData().GetArray(name))
+    Out    = VN.numpy_to_vtk(offset + scale*raw.astype(np.float64), deep=1)
+    Out.SetName(name)
+    data.GetPointData().RemoveArray(name)
+    data.GetPointData().AddArray(Out)
+
 def findSteps(dirList,name,steps,surfaceFlag):
   import os
   # sort reverse so we can start searching from the end
@@ -24,19 +24,101 @@
 #include "bc.h"
 #include "tools.h"
 
+//---------------------------------------------------------------------------
+PetscErrorCode AVDReserve(AVD *A, PetscInt npoints)
+{
+	// grow pooled storage for the current grid (A->nx, A->ny, A->nz) and npoints
+	// (zero the structure before the first call, free it with AVDDestroy)
+
+	// Claim & boundary lists of every chain get the worst-case size (all grid
+	// cells plus terminator), since a chain never lists a cell twice. The AVD
+	// algorithm itself therefore never allocates. Contents are NOT preserved.
+
+	PetscInt p, ncells, npcap;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// cells plus one layer of boundary cells
+	ncells = (A->nx+2)*(A->ny+2)*(A->nz+2);
+
+	// --------------
+	//   AVD CELLS
+	// --------------
+	if(ncells > A->ncellcap)
+	{
+		ierr = PetscFree(A->cell); CHKERRQ(ierr);
+		ierr = PetscMalloc((size_t)ncells*sizeof(AVDCell), &A->cell); CHKERRQ(ierr);
+		A->ncellcap = ncells;
+	}
+
+	// ---------------------
+	//   AVD CHAIN & POINTS
+	// ---------------------
+	if(npoints > A->npcap)
+	{
+		npcap = (PetscInt)(_cap_overhead_*(PetscScalar)npoints);
+
+		for(p = 0; p < A->npcap; p++)
+		{
+			ierr = PetscFree(A->chain[p].claim); CHKERRQ(ierr);
+			ierr = PetscFree(A->chain[p].bound); CHKERRQ(ierr);
+		}
+
+		ierr = PetscFree(A->chain);  CHKERRQ(ierr);
+		ierr = PetscFree(A->points); CHKERRQ(ierr);
+
+		ierr = PetscMalloc((size_t)npcap*sizeof(AVDChain), &A->chain); CHKERRQ(ierr);
+		ierr = PetscMemzero(A->chain, (size_t)npcap*sizeof(AVDChain)); CHKERRQ(ierr);
+
+		ierr = PetscMalloc((size_t)npcap*sizeof(Marker), &A->points); CHKERRQ(ierr);
+
+		A->npcap = npcap;
+	}
+
+	// grow claim & boundary lists
+	for(p = 0; p < A->npcap; p++)
+	{
+		if(A->chain[p].iclaim >= ncells+1) continue;
+
+		ierr = PetscFree(A->chain[p].claim); CHKERRQ(ierr);
+		ierr = PetscFree(A->chain[p].bound); CHKERRQ(ierr);
+
+		A->chain[p].iclaim = ncells+1;
+		A->chain[p].ibound = ncells+1;
+
+		ierr = makeIntArray(&A->chain[p].claim, NULL, ncells+1); CHKERRQ(ierr);
+		ierr = makeIntArray(&A->chain[p].bound, NULL, ncells+1); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
 //---------------------------------------------------------------------------
 PetscErrorCode AVDCreate(AVD *A)
 {
-	PetscInt    p, npoints;
-	PetscInt    ind;
+	// (re)initialize AVD structure for A->npoints points, storage is reused between calls
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = AVDReserve(A, A->npoints); CHKERRQ(ierr);
+
+	AVDReset(A);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void AVDReset(AVD *A)
+{
+	// initialize grid cells, chains & points (storage must be reserved)
+
+	PetscInt    *claim, *bound, iclaim, ibound;
+	PetscInt    p, ind;
 	PetscInt    i, j, k;
 	PetscInt    mx,my,mz;
 	PetscScalar x[3], dx[3];
 	PetscScalar s[3];
 
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
-
 	// initialize variables
 	mx  = A->nx+2;
 	my  = A->ny+2;
@@ -53,10 +135,6 @@ PetscErrorCode AVDCreate(AVD *A)
 	// --------------
 	//   AVD CELLS
 	// --------------
-	// allocate memory for cells plus one layer of boundary cells
-	ierr = PetscMalloc((size_t)(mx*my*mz)*sizeof(AVDCell), &A->cell); CHKERRQ(ierr);
-	ierr = PetscMemzero(A->cell, (size_t)(mx*my*mz)*sizeof(AVDCell)); CHKERRQ(ierr);
-
 	for (k=0; k<mz; k++)
 	{
 		// compute z - center coordinate
@@ -96,38 +174,27 @@ PetscErrorCode AVDCreate(AVD *A)
 	//   AVD CHAIN
 	// --------------
 	A->buffer = 1;
-	npoints   = A->npoints;
 
-	// allocate memory for chains
-	ierr = PetscMalloc((size_t)(npoints)*sizeof(AVDChain), &A->chain); CHKERRQ(ierr);
-	ierr = PetscMemzero(A->chain, (size_t)(npoints)*sizeof(AVDChain)); CHKERRQ(ierr);
-
-	for (p=0; p < npoints; p++)
+	for (p=0; p < A->npoints; p++)
 	{
-		// initialize dominant axis for half-centroid
-		A->chain[p].xh[0] = 0.0;
-		A->chain[p].xh[1] = 0.0;
-		A->chain[p].xh[2] = 0.0;
-
-		// allocate memory for chains
-		A->chain[p].iclaim  = A->buffer;
-		A->chain[p].ibound = A->buffer;
-
-		ierr = PetscMalloc(sizeof(PetscInt)*(size_t)(A->chain[p].iclaim + A->buffer), &A->chain[p].claim); CHKERRQ(ierr);
-		ierr = PetscMemzero(A->chain[p].claim, sizeof(PetscInt)*(size_t)(A->chain[p].iclaim + A->buffer)); CHKERRQ(ierr);
-
-		ierr = PetscMalloc(sizeof(PetscInt)*(size_t)(A->chain[p].ibound + A->buffer), &A->chain[p].bound); CHKERRQ(ierr);
-		ierr = PetscMemzero(A->chain[p].bound, sizeof(PetscInt)*(size_t)(A->chain[p].ibound + A->buffer)); CHKERRQ(ierr);
+		// reset chain, keep allocated lists
+		claim  = A->chain[p].claim;
+		bound  = A->chain[p].bound;
+		iclaim = A->chain[p].iclaim;
+		ibound = A->chain[p].ibound;
+
+		memset(&A->chain[p], 0, sizeof(AVDChain));
+
+		A->chain[p].claim  = claim;
+		A->chain[p].bound  = bound;
+		A->chain[p].iclaim = iclaim;
+		A->chain[p].ibound = ibound;
 	}
 
 	// --------------
 	//   AVD POINTS
 	// --------------
-	// allocate memory for points
-	ierr = PetscMalloc((size_t)(npoints)*sizeof(Marker), &A->points); CHKERRQ(ierr);
-	ierr = PetscMemzero(A->points, (size_t)(npoints)*sizeof(Marker)); CHKERRQ(ierr);
-
-	PetscFunctionReturn(0);
+	memset(A->points, 0, (size_t)A->npoints*sizeof(Marker));
 }
 //---------------------------------------------------------------------------
 PetscErrorCode AVDDestroy(AVD *A)
@@ -145,7 +212,7 @@ PetscErrorCode AVDDestroy(AVD *A)
 	// --------------
 	//   AVD CHAIN
 	// --------------
-	for (p = 0; p < A->npoints; p++)
+	for (p = 0; p < A->npcap; p++)
 	{
 		if (A->chain[p].claim ) { ierr = PetscFree(A->chain[p].claim ); CHKERRQ(ierr); }
 		if (A->chain[p].bound ) { ierr = PetscFree(A->chain[p].bound ); CHKERRQ(ierr); }
@@ -157,19 +224,21 @@ PetscErrorCode AVDDestroy(AVD *A)
 	// --------------
 	ierr = PetscFree(A->points); CHKERRQ(ierr);
 
+	A->ncellcap = 0;
+	A->npcap    = 0;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDCellInit(AVD *A)
+PetscInt AVDCellInit(AVD *A)
 {
+	// place points in their cells, returns 1 if a point lies in a boundary cell
+
 	Marker     *points;
 	PetscInt    npoints;
 	PetscInt    p,i,j,k;
 	PetscInt    mx,my,mz,ind;
 
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
-
 	// initialize variables
 	points  = A->points;
 	npoints = A->npoints;
@@ -193,9 +262,8 @@ PetscErrorCode AVDCellInit(AVD *A)
 
 		ind = i+j*mx+k*mx*my;
 
-		if (A->cell[ind].p == AVD_CELL_MASK) {
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Inserting cells into boundary cells is not permitted \n");
-		}
+		// inserting points into boundary cells is not permitted
+		if (A->cell[ind].p == AVD_CELL_MASK) return 1;
 
 		A->cell[ind].p                   = p;         // particle index
 		A->chain[p].nclaimed             = 1;         // number of claimed cells, currently just the one the point initially resides within
@@ -206,12 +274,13 @@ PetscErrorCode AVDCellInit(AVD *A)
 		A->chain[p].claim[1]             = -1;        // mark end of claimed_cells list with -1
 
 		// update initial chain
-		ierr = AVDUpdateChain(A,p); CHKERRQ(ierr);
+		AVDUpdateChain(A,p);
 	}
-	PetscFunctionReturn(0);
+
+	return 0;
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDClaimCells(AVD *A, const PetscInt ip)
+void AVDClaimCells(AVD *A, const PetscInt ip)
 {
 	PetscInt    i,count;
 	PetscScalar x0[3], x1[3], x2[3], dist;
@@ -219,12 +288,7 @@ PetscErrorCode AVDClaimCells(AVD *A, const PetscInt ip)
 	AVDCell     *cells;
 	Marker      *points;
 	PetscInt    cell_num0;
-	PetscInt    buffer;
-
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
 
-	buffer = A->buffer;
 	bchain = &A->chain[ip];
 	cells  = A->cell;
 	points = A->points;
@@ -238,9 +302,6 @@ PetscErrorCode AVDClaimCells(AVD *A, const PetscInt ip)
 		// if cell unclaimed, then claim it
 		if (cells[cell_num0].p == AVD_CELL_UNCLAIMED)
 		{
-			// re-alloc, note that we need one space more than the number of points to terminate the list
-			if( count == bchain->iclaim-1 ) { ierr = AVDReAlloc(bchain, buffer); CHKERRQ(ierr); }
-
 			// claim cell
 			bchain->claim[count] = cell_num0;
 
@@ -285,23 +346,17 @@ PetscErrorCode AVDClaimCells(AVD *A, const PetscInt ip)
 		// mark end of list
 		bchain->claim[count] = -1;
 	}
-
-	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDUpdateChain(AVD *A, const PetscInt ip)
+void AVDUpdateChain(AVD *A, const PetscInt ip)
 {
 	PetscInt i,k;
 	PetscInt count;
 	PetscInt cell_num0,cell_num1,cell_num[6];
 	AVDChain *bchain;
 	AVDCell  *cells,*cell0;
-	PetscInt mx,my,buffer;
+	PetscInt mx,my;
 
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
-
-	buffer = A->buffer;
 	mx     = A->nx+2;
 	my     = A->ny+2;
 	bchain = &A->chain[ip];
@@ -338,9 +393,6 @@ PetscErrorCode AVDUpdateChain(AVD *A, const PetscInt ip)
 			{
 				if ( (cells[cell_num1].p != ip) && (!cells[cell_num1].done) )
 				{
-					// re-alloc - we need one space more than the number of points to terminate the list
-					if (count == bchain->ibound-1 ) { ierr = AVDReAlloc(bchain, buffer); CHKERRQ(ierr); }
-
 					// add new cell to boundary
 					bchain->bound[count] = cell_num1;
 
@@ -360,43 +412,32 @@ PetscErrorCode AVDUpdateChain(AVD *A, const PetscInt ip)
 	{
 		cells[ bchain->bound[i] ].done = PETSC_FALSE;
 	}
-	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDReAlloc(AVDChain *chain, PetscInt buffer)
+PetscInt AVDCompute(AVD *A)
 {
-	PetscInt *temp;
-
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
-
-	// 1. allocate memory for claimed cells
-	ierr = makeIntArray(&temp, NULL, chain->iclaim + buffer); CHKERRQ(ierr);
-
-	// copy current data
-	ierr = PetscMemcpy(temp, chain->claim, (size_t)(chain->nclaimed + buffer)*sizeof(PetscInt)); CHKERRQ(ierr);
-
-	// delete previous storage
-	ierr = PetscFree(chain->claim); CHKERRQ(ierr);
+	// compute Voronoi diagram of the loaded points (no allocation, no PETSc calls)
+	// returns 1 if a point lies outside the grid
 
-	// save new capacity & storage
-	chain->claim      = temp;
-	chain->iclaim    += buffer;
+	PetscInt i, claimed;
 
-	// 2. allocate memory for boundary cells
-	ierr = makeIntArray(&temp, NULL, chain->ibound + buffer); CHKERRQ(ierr);
-
-	// copy current data
-	ierr = PetscMemcpy(temp, chain->bound, (size_t)(chain->length + buffer)*sizeof(PetscInt)); CHKERRQ(ierr);
-
-	// delete previous storage
-	ierr = PetscFree(chain->bound); CHKERRQ(ierr);
+	// initialize AVD cells
+	if(AVDCellInit(A)) return 1;
 
-	// save new capacity & storage
-	chain->bound      = temp;
-	chain->ibound    += buffer;
+	// AVD algorithm
+	claimed = 1;
+	while (claimed != 0)
+	{
+		claimed = 0;
+		for (i = 0; i < A->npoints; i++)
+		{
+			AVDClaimCells(A,i);
+			claimed += A->chain[i].nclaimed;
+			AVDUpdateChain(A,i);
+		}
+	}
 
-	PetscFunctionReturn(0);
+	return 0;
 }
 //---------------------------------------------------------------------------
 PetscErrorCode AVDLoadPoints(AdvCtx *actx, AVD *A, PetscInt ind)
@@ -603,64 +644,47 @@ PetscErrorCode AVDInjectDeletePoints(AdvCtx *actx, AVD *A, PetscInt cellID)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDExecuteMarkerInjection(AdvCtx *actx, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind)
+PetscErrorCode AVDExecuteMarkerInjection(AdvCtx *actx, AVD *A, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind)
 {
-
-	AVD          A;
-	PetscInt       i,claimed;
-
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// initialize some parameters
-	A.nx = actx->avdx;
-	A.ny = actx->avdy;
-	A.nz = actx->avdz;
+	A->nx = actx->avdx;
+	A->ny = actx->avdy;
+	A->nz = actx->avdz;
 
-	A.mmin = actx->nmin;
-	A.mmax = actx->nmax;
+	A->mmin = actx->nmin;
+	A->mmax = actx->nmax;
 
-	A.npoints = npoints;
+	A->npoints = npoints;
 
-	A.xs[0] = xs[0];
-	A.xs[1] = xs[1];
-	A.xs[2] = xs[2];
+	A->xs[0] = xs[0];
+	A->xs[1] = xs[1];
+	A->xs[2] = xs[2];
 
-	A.xe[0] = xe[0];
-	A.xe[1] = xe[1];
-	A.xe[2] = xe[2];
+	A->xe[0] = xe[0];
+	A->xe[1] = xe[1];
+	A->xe[2] = xe[2];
 
-	A.dx = (xe[0]-xs[0])/(PetscScalar)A.nx;
-	A.dy = (xe[1]-xs[1])/(PetscScalar)A.ny;
-	A.dz = (xe[2]-xs[2])/(PetscScalar)A.nz;
+	A->dx = (xe[0]-xs[0])/(PetscScalar)A->nx;
+	A->dy = (xe[1]-xs[1])/(PetscScalar)A->ny;
+	A->dz = (xe[2]-xs[2])/(PetscScalar)A->nz;
 
 	// AVD structures
-	ierr = AVDCreate(&A); CHKERRQ(ierr);
+	ierr = AVDCreate(A); CHKERRQ(ierr);
 
 	// load particles
-	ierr = AVDLoadPoints(actx,&A,ind); CHKERRQ(ierr);
-
-	// initialize AVD cells
-	ierr = AVDCellInit(&A); CHKERRQ(ierr);
+	ierr = AVDLoadPoints(actx,A,ind); CHKERRQ(ierr);
 
 	// AVD algorithm
-	claimed = 1;
-	while (claimed!= 0)
+	if(AVDCompute(A))
 	{
-		claimed = 0;
-		for (i = 0; i < npoints; i++)
-		{
-			ierr = AVDClaimCells(&A,i); CHKERRQ(ierr);
-			claimed += A.chain[i].nclaimed;
-			ierr = AVDUpdateChain(&A,i); CHKERRQ(ierr);
-		}
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Inserting cells into boundary cells is not permitted \n");
 	}
 
 	// inject/delete markers
-	ierr = AVDInjectDeletePoints(actx, &A, ind); CHKERRQ(ierr);
-
-	// destroy AVD structure
-	ierr = AVDDestroy(&A); CHKERRQ(ierr);
+	ierr = AVDInjectDeletePoints(actx, A, ind); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -717,9 +741,18 @@ PetscErrorCode AVDMarkerControlMV(AdvCtx *actx, VolumeCase vtype)
 PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 {
 	// check marker distribution and delete or inject markers if necessary
-	PetscScalar    xs[3], xe[3];
-	PetscInt       ind, i, j, k, M, N;
-	PetscInt       n, ninj, ndel, nmin;
+
+	// Voronoi diagrams of the control volumes are computed on worker threads
+	// (see ThreadFor), every thread uses its own pooled AVD structure.
+	// Claimed volumes & half-centroids are stored per marker, injection and
+	// deletion follow sequentially in control volume order, so the result does
+	// not depend on the number of threads.
+
+	AVD           *A;
+	PetscScalar    *xc;
+	PetscInt       *vol, *vmin, *vbeg, *area, *fail;
+	PetscInt       ind, i, j, k, M, N, t, nt;
+	PetscInt       n, ninj, ndel, nmin, nvol, npmax;
 	PetscLogDouble t0,t1;
 	char           lbl[_lbl_sz_];
 
@@ -733,15 +766,24 @@ PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 	M = mv->M;
 	N = mv->N;
 
-	// calculate storage
-	ninj = 0;
-	ndel = 0;
+	// allocate control volume lists
+	ierr = makeIntArray(&vol,  NULL, mv->ncells);   CHKERRQ(ierr);
+	ierr = makeIntArray(&vmin, NULL, mv->ncells);   CHKERRQ(ierr);
+	ierr = makeIntArray(&vbeg, NULL, mv->ncells+1); CHKERRQ(ierr);
+
+	// calculate storage & collect control volumes to be processed
+	ninj  = 0;
+	ndel  = 0;
+	nvol  = 0;
+	npmax = 0;
+	vbeg[0] = 0;
+
 	for(ind = 0; ind < mv->ncells; ind++)
 	{
 		// no of markers in cell
 		n = mv->markstart[ind+1] - mv->markstart[ind];
 
-		if (n < actx->nmin)
+		if ((n < actx->nmin) || (n > actx->nmax))
 		{
 			// expand i, j, k cell indices
 			GET_CELL_IJK(ind, i, j, k, M, N);
@@ -752,65 +794,109 @@ PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 			if ((dir == 1) && ((j == 0) | (j+1 == mv->N))) { nmin = (PetscInt) (actx->nmin/2+1); }
 			if ((dir == 2) && ((k == 0) | (k+1 == mv->P))) { nmin = (PetscInt) (actx->nmin/2+1); }
 
-			if (n < nmin)
+			if (n < actx->nmin && n < nmin)
 			{
 				if ((nmin - n) > n) ninj += n;
 				else                ninj += nmin - n;
 			}
+			if (n > actx->nmax) ndel += n - actx->nmax;
+
+			// inject/delete markers
+			if ((n < nmin) || (n > actx->nmax))
+			{
+				vol [nvol]   = ind;
+				vmin[nvol]   = nmin;
+				vbeg[nvol+1] = vbeg[nvol] + n;
+				nvol++;
+
+				if(n > npmax) npmax = n;
+			}
 		}
-		if (n > actx->nmax) ndel += n - actx->nmax;
 	}
 
 	// if no need for injection/deletion
-	if ((!ninj) && (!ndel)) PetscFunctionReturn(0);
+	if ((!ninj) && (!ndel))
+	{
+		ierr = PetscFree(vol);  CHKERRQ(ierr);
+		ierr = PetscFree(vmin); CHKERRQ(ierr);
+		ierr = PetscFree(vbeg); CHKERRQ(ierr);
+
+		PetscFunctionReturn(0);
+	}
 
 	actx->nrecv = ninj;
 	actx->ndel  = ndel;
 
-	// allocate memory
-	if(ninj) { ierr = PetscMalloc((size_t)actx->nrecv*sizeof(Marker),   &actx->recvbuf); CHKERRQ(ierr); }
-	if(ndel) { ierr = PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel   ); CHKERRQ(ierr); }
+	// make sure space is enough
+	ierr = ADVGetMPIBuff(actx, 0, ninj, ndel); CHKERRQ(ierr);
 
 	actx->cinj = 0;
 	actx->cdel = 0;
 
-	// inject/delete
-	for(ind = 0; ind < mv->ncells; ind++)
+	// AVD storage of every thread is shared by all its control volumes
+	nt = ThreadGetNum();
+
+	ierr = PetscMalloc((size_t)nt*sizeof(AVD), &A); CHKERRQ(ierr);
+	ierr = PetscMemzero(A, (size_t)nt*sizeof(AVD)); CHKERRQ(ierr);
+
+	for(t = 0; t < nt; t++)
 	{
-		// no of markers in cell
-		n = mv->markstart[ind+1] - mv->markstart[ind];
+		A[t].nx = actx->avdx;
+		A[t].ny = actx->avdy;
+		A[t].nz = actx->avdz;
 
-		if ((n < actx->nmin) || (n > actx->nmax))
+		ierr = AVDReserve(&A[t], npmax); CHKERRQ(ierr);
+	}
+
+	// claimed volumes & half-centroids of all markers in processed volumes
+	ierr = makeIntArray(&area, NULL, vbeg[nvol]); CHKERRQ(ierr);
+	ierr = makeIntArray(&fail, NULL, nt);         CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(3*vbeg[nvol]+1)*sizeof(PetscScalar), &xc); CHKERRQ(ierr);
+
+	// compute Voronoi diagrams
+	ierr = ThreadFor(nvol, 1, [&](PetscInt beg, PetscInt end, PetscInt tid)
+	{
+		for(PetscInt iv = beg; iv < end; iv++)
 		{
-			// expand i, j, k cell indices
-			GET_CELL_IJK(ind, i, j, k, M, N);
+			if(AVDAlgorithmMV(actx, mv, &A[tid], vol[iv], vmin[iv], area + vbeg[iv], xc + 3*vbeg[iv])) fail[tid] = 1;
+		}
+	}); CHKERRQ(ierr);
 
-			// get cell coordinates
-			xs[0] = mv->xcoord[i]; xe[0] = mv->xcoord[i+1];
-			xs[1] = mv->ycoord[j]; xe[1] = mv->ycoord[j+1];
-			xs[2] = mv->zcoord[k]; xe[2] = mv->zcoord[k+1];
+	for(t = 0; t < nt; t++)
+	{
+		if(fail[t]) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Inserting cells into boundary cells is not permitted \n");
+	}
 
-			// here calculate half volumes minimum
-			nmin = actx->nmin;
-			if ((dir == 0) && ((i == 0) | (i+1 == mv->M))) { nmin = (PetscInt) (actx->nmin/2+1); }
-			if ((dir == 1) && ((j == 0) | (j+1 == mv->N))) { nmin = (PetscInt) (actx->nmin/2+1); }
-			if ((dir == 2) && ((k == 0) | (k+1 == mv->P))) { nmin = (PetscInt) (actx->nmin/2+1); }
+	// inject/delete
+	for(i = 0; i < nvol; i++)
+	{
+		ind = vol[i];
+		n   = mv->markstart[ind+1] - mv->markstart[ind];
 
-			// inject/delete markers
-			if ((n < nmin) || (n > actx->nmax))
-			{
-				ierr = AVDAlgorithmMV(actx, mv, n, xs, xe, ind, nmin); CHKERRQ(ierr);
-			}
-		}
+		// inject markers
+		if (n < vmin[i]) { ierr = AVDInjectPointsMV(actx, mv, ind, vmin[i], area + vbeg[i], xc + 3*vbeg[i]); CHKERRQ(ierr); }
+
+		// delete markers
+		if (n > actx->nmax) { ierr = AVDDeletePointsMV(actx, mv, ind, area + vbeg[i]); CHKERRQ(ierr); }
 	}
 
+	// destroy AVD structures
+	for(t = 0; t < nt; t++)
+	{
+		ierr = AVDDestroy(&A[t]); CHKERRQ(ierr);
+	}
+
+	ierr = PetscFree(A);    CHKERRQ(ierr);
+	ierr = PetscFree(vol);  CHKERRQ(ierr);
+	ierr = PetscFree(vmin); CHKERRQ(ierr);
+	ierr = PetscFree(vbeg); CHKERRQ(ierr);
+	ierr = PetscFree(area); CHKERRQ(ierr);
+	ierr = PetscFree(fail); CHKERRQ(ierr);
+	ierr = PetscFree(xc);   CHKERRQ(ierr);
+
 	// store new markers
 	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
 
-	// clear
-	ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel);    CHKERRQ(ierr);
-
 	// print info
 	ierr = PetscTime(&t1); CHKERRQ(ierr);
 
@@ -988,10 +1074,9 @@ PetscErrorCode AVDDestroyMV(MarkerVolume *mv)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDLoadPointsMV(AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind)
+void AVDLoadPointsMV(AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind)
 {
 	PetscInt    i, ii;
-	PetscFunctionBeginUser;
 
 	// load particles only within the Voronoi cell
 	for (i = 0; i < A->npoints; i++)
@@ -1005,35 +1090,22 @@ PetscErrorCode AVDLoadPointsMV(AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt
 		// save index
 		A->chain [i].gind  = ii;
 	}
-
-	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A)
+void AVDHalfCentroidMV(AVD *A)
 {
-	FDSTAG     *fs;
-	BCCtx      *bc;
-	PetscInt    i, ii, n, ind, I, J, K, cellID;
-	PetscInt    num_chain, hclaim;
-	PetscInt    npoints, new_nmark = 0;
+	// compute half-centroids & claimed volumes of all points
+	// (half of the Voronoi cell along its dominant axis, on the side of the point)
+
+	PetscInt    i, ii, n, hclaim;
+	PetscInt    npoints, axis;
 	PetscScalar xmin, xmax, ymin, ymax, zmin, zmax;
 	PetscScalar xaxis, yaxis, zaxis;
 	PetscScalar xp[3], xc[3], xh[3];
-	PetscInt    *area, *sind, axis;
-
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
-
-	bc = actx->jr->bc;
-	fs = actx->fs;
 
 	npoints = A->npoints;
 	n  = (A->nx+2)*(A->ny+2)*(A->nz+2);
 
-	// allocate memory for sorting
-	ierr = makeIntArray(&area, NULL, npoints); CHKERRQ(ierr);
-	ierr = makeIntArray(&sind, NULL, npoints); CHKERRQ(ierr);
-
 	// compute dominant axis
 	for (i = 0; i < npoints; i++)
 	{
@@ -1131,162 +1203,166 @@ PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A)
 		A->chain[i].xc[0] = A->chain[i].xc[0]/(PetscScalar)hclaim;
 		A->chain[i].xc[1] = A->chain[i].xc[1]/(PetscScalar)hclaim;
 		A->chain[i].xc[2] = A->chain[i].xc[2]/(PetscScalar)hclaim;
-
-		// initialize variables for sorting
-		sind[i] = i;
-		area[i] = A->chain[i].tclaimed;
 	}
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt ind, PetscInt nmin, PetscInt *area, PetscScalar *xc)
+{
+	FDSTAG     *fs;
+	BCCtx      *bc;
+	Marker     *P;
+	PetscInt    i, jj, I, J, K, cellID;
+	PetscInt    num_chain;
+	PetscInt    npoints, new_nmark = 0;
+	PetscInt    *sind;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	bc = actx->jr->bc;
+	fs = actx->fs;
+
+	npoints = mv->markstart[ind+1] - mv->markstart[ind];
+
+	// allocate memory for sorting
+	ierr = makeIntArray(&sind, NULL, npoints); CHKERRQ(ierr);
+
+	// initialize variables for sorting
+	for (i = 0; i < npoints; i++) sind[i] = i;
 
 	// sort in ascending order
 	ierr = PetscSortIntWithArray(npoints,area,sind); CHKERRQ(ierr);
 
 	// do not insert more markers than available voronoi domains
-	new_nmark = A->mmin - npoints;
+	new_nmark = nmin - npoints;
 	if (npoints < new_nmark) new_nmark = npoints;
 
-	ind = npoints - 1;
+	jj = npoints - 1;
 	for (i = 0; i < new_nmark; i++)
 	{
-		num_chain = sind[ind];
+		num_chain = sind[jj];
 
 		// inject same properties as parent marker except for position
-		actx->recvbuf[actx->cinj+i]      = A->points[num_chain];
-		actx->recvbuf[actx->cinj+i].X[0] = A->chain [num_chain].xc[0];
-		actx->recvbuf[actx->cinj+i].X[1] = A->chain [num_chain].xc[1];
-		actx->recvbuf[actx->cinj+i].X[2] = A->chain [num_chain].xc[2];
+		P = actx->recvbuf + actx->cinj + i;
+
+		(*P)    = actx->markers[mv->markind[mv->markstart[ind] + num_chain]];
+		P->X[0] = xc[3*num_chain  ];
+		P->X[1] = xc[3*num_chain+1];
+		P->X[2] = xc[3*num_chain+2];
 
 		// --- this is not ideal with multiple control volumes (i.e. use mv for BCOverridePhase) ---
 		// find I, J, K indices by bisection algorithm
-		I = FindPointInCell(fs->dsx.ncoor, 0, fs->dsx.ncels, actx->recvbuf[actx->cinj+i].X[0]);
-		J = FindPointInCell(fs->dsy.ncoor, 0, fs->dsy.ncels, actx->recvbuf[actx->cinj+i].X[1]);
-		K = FindPointInCell(fs->dsz.ncoor, 0, fs->dsz.ncels, actx->recvbuf[actx->cinj+i].X[2]);
+		I = FindPointInCell(fs->dsx.ncoor, 0, fs->dsx.ncels, P->X[0]);
+		J = FindPointInCell(fs->dsy.ncoor, 0, fs->dsy.ncels, P->X[1]);
+		K = FindPointInCell(fs->dsz.ncoor, 0, fs->dsz.ncels, P->X[2]);
 
 		// compute and store consecutive index
 		GET_CELL_ID(cellID, I, J, K, fs->dsx.ncels, fs->dsy.ncels);
 
 		// override marker phase (if necessary) - need to calculate cellID
-		ierr = BCOverridePhase(bc, cellID, actx->recvbuf + actx->cinj + i); CHKERRQ(ierr);
+		ierr = BCOverridePhase(bc, cellID, P); CHKERRQ(ierr);
 		// -----------------------------------------------------------------------------------------
 
-		ind--;
+		jj--;
 	}
 	// update total counter
 	actx->cinj +=new_nmark;
 
 	// free memory
-	ierr = PetscFree(area); CHKERRQ(ierr);
 	ierr = PetscFree(sind); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDDeletePointsMV(AdvCtx *actx, AVD *A)
+PetscErrorCode AVDDeletePointsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt ind, PetscInt *area)
 {
-	PetscInt    i, ind;
+	PetscInt    i, jj;
 	PetscInt    num_chain;
 	PetscInt    npoints, new_nmark = 0;
-	PetscInt    *area, *sind;
+	PetscInt    *sind;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	npoints = A->npoints;
-	new_nmark = npoints - A->mmax;
+	npoints = mv->markstart[ind+1] - mv->markstart[ind];
+	new_nmark = npoints - actx->nmax;
 
 	// allocate memory for sorting
-	ierr = makeIntArray(&area, NULL, npoints); CHKERRQ(ierr);
 	ierr = makeIntArray(&sind, NULL, npoints); CHKERRQ(ierr);
 
 	// initialize variables for sorting
-	for (i = 0; i < npoints; i++)
-	{
-		sind[i] = i;
-		area[i] = A->chain[i].tclaimed;
-	}
+	for (i = 0; i < npoints; i++) sind[i] = i;
 
 	// sort in ascending order
 	ierr = PetscSortIntWithArray(npoints,area,sind); CHKERRQ(ierr);
 
-		ind = 0;
-		for (i = 0; i < new_nmark; i++)
-		{
-			num_chain = sind[ind];
-			actx->idel[actx->cdel+i] = A->chain[num_chain].gind;
-			ind++;
-
-		}
-		// update total counter
-		actx->cdel +=new_nmark;
+	jj = 0;
+	for (i = 0; i < new_nmark; i++)
+	{
+		num_chain = sind[jj];
+		actx->idel[actx->cdel+i] = mv->markind[mv->markstart[ind] + num_chain];
+		jj++;
+	}
+	// update total counter
+	actx->cdel +=new_nmark;
 
 	// free memory
-	ierr = PetscFree(area); CHKERRQ(ierr);
 	ierr = PetscFree(sind); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDAlgorithmMV(AdvCtx *actx, MarkerVolume *mv, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind, PetscInt nmin)
+PetscInt AVDAlgorithmMV(AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind, PetscInt nmin, PetscInt *area, PetscScalar *xc)
 {
+	// compute Voronoi diagram of a control volume, store claimed volumes &
+	// half-centroids (injection only) of its markers in area & xc
+	// (no allocation, no PETSc calls), returns 1 if a marker is outside the volume
 
-	AVD          A;
-	PetscInt     i,claimed;
+	PetscInt i, j, k, p;
 
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
+	// expand i, j, k cell indices
+	GET_CELL_IJK(ind, i, j, k, mv->M, mv->N);
 
 	// initialize some parameters
-	A.nx = actx->avdx;
-	A.ny = actx->avdy;
-	A.nz = actx->avdz;
-
-	A.mmin = nmin;
-	A.mmax = actx->nmax;
+	A->nx = actx->avdx;
+	A->ny = actx->avdy;
+	A->nz = actx->avdz;
 
-	A.npoints = npoints;
+	A->mmin = nmin;
+	A->mmax = actx->nmax;
 
-	A.xs[0] = xs[0];
-	A.xs[1] = xs[1];
-	A.xs[2] = xs[2];
+	A->npoints = mv->markstart[ind+1] - mv->markstart[ind];
 
-	A.xe[0] = xe[0];
-	A.xe[1] = xe[1];
-	A.xe[2] = xe[2];
+	// get cell coordinates
+	A->xs[0] = mv->xcoord[i]; A->xe[0] = mv->xcoord[i+1];
+	A->xs[1] = mv->ycoord[j]; A->xe[1] = mv->ycoord[j+1];
+	A->xs[2] = mv->zcoord[k]; A->xe[2] = mv->zcoord[k+1];
 
-	A.dx = (xe[0]-xs[0])/(PetscScalar)A.nx;
-	A.dy = (xe[1]-xs[1])/(PetscScalar)A.ny;
-	A.dz = (xe[2]-xs[2])/(PetscScalar)A.nz;
+	A->dx = (A->xe[0]-A->xs[0])/(PetscScalar)A->nx;
+	A->dy = (A->xe[1]-A->xs[1])/(PetscScalar)A->ny;
+	A->dz = (A->xe[2]-A->xs[2])/(PetscScalar)A->nz;
 
-	// create AVD structure
-	ierr = AVDCreate(&A); CHKERRQ(ierr);
+	// reset AVD structure (storage is reserved)
+	AVDReset(A);
 
 	// load particles
-	ierr = AVDLoadPointsMV(actx,mv,&A,ind); CHKERRQ(ierr);
-
-	// initialize AVD cells
-	ierr = AVDCellInit(&A); CHKERRQ(ierr);
+	AVDLoadPointsMV(actx,mv,A,ind);
 
 	// do AVD algorithm
-	claimed = 1;
-	while (claimed!= 0)
-	{
-		claimed = 0;
-		for (i = 0; i < npoints; i++)
-		{
-			ierr = AVDClaimCells(&A,i); CHKERRQ(ierr);
-			claimed += A.chain[i].nclaimed;
-			ierr = AVDUpdateChain(&A,i); CHKERRQ(ierr);
-		}
-	}
+	if(AVDCompute(A)) return 1;
 
-	// inject markers
-	if (A.npoints < A.mmin) { ierr = AVDInjectPointsMV(actx, &A); CHKERRQ(ierr); }
-
-	// delete markers
-	if (A.npoints > A.mmax) { ierr = AVDDeletePointsMV(actx, &A); CHKERRQ(ierr); }
+	// half-centroids are only needed for injection
+	if (A->npoints < A->mmin) AVDHalfCentroidMV(A);
 
-	// destroy AVD structure
-	ierr = AVDDestroy(&A); CHKERRQ(ierr);
+	// store results
+	for (p = 0; p < A->npoints; p++)
+	{
+		area[p]   = A->chain[p].tclaimed;
+		xc[3*p  ] = A->chain[p].xc[0];
+		xc[3*p+1] = A->chain[p].xc[1];
+		xc[3*p+2] = A->chain[p].xc[2];
+	}
 
-	PetscFunctionReturn(0);
+	return 0;
 }
 //---------------------------------------------------------------------------
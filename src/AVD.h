@@ -63,6 +63,8 @@ struct AVD
 	AVDChain    *chain;                    // voronoi chain for every point (size of npoints)
 	Marker      *points;                   // points that we want to compute voronoi diagram (size of npoints)
 	PetscInt    npoints;                   // no. markers
+	PetscInt    ncellcap;                  // capacity of cell storage
+	PetscInt    npcap;                     // capacity of chain & point storage
 
 } ;
 
@@ -89,17 +91,22 @@ enum VolumeCase
 //---------------------------------------------------------------------------
 
 // basic AVD routines
+// AVDReserve, AVDCreate & AVDDestroy manage pooled storage (not thread-safe),
+// the remaining routines neither allocate nor call PETSc, so that different
+// AVD structures can be processed on worker threads
+PetscErrorCode AVDReserve    (AVD *A, PetscInt npoints);
 PetscErrorCode AVDCreate     (AVD *A);
 PetscErrorCode AVDDestroy    (AVD *A);
-PetscErrorCode AVDCellInit   (AVD *A);
-PetscErrorCode AVDClaimCells (AVD *A, const PetscInt ip);
-PetscErrorCode AVDUpdateChain(AVD *A, const PetscInt ip);
-PetscErrorCode AVDReAlloc    (AVDChain *chain,PetscInt buffer);
+void           AVDReset      (AVD *A);
+PetscInt       AVDCellInit   (AVD *A);
+void           AVDClaimCells (AVD *A, const PetscInt ip);
+void           AVDUpdateChain(AVD *A, const PetscInt ip);
+PetscInt       AVDCompute    (AVD *A);
 
 // routines for old marker control
 PetscErrorCode AVDLoadPoints            (AdvCtx *actx, AVD *A, PetscInt ind);
 PetscErrorCode AVDInjectDeletePoints    (AdvCtx *actx, AVD *A, PetscInt cellID);
-PetscErrorCode AVDExecuteMarkerInjection(AdvCtx *actx, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind);
+PetscErrorCode AVDExecuteMarkerInjection(AdvCtx *actx, AVD *A, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind);
 
 // new marker control (for every control volume)
 PetscErrorCode AVDMarkerControl  (AdvCtx *actx);
@@ -107,10 +114,11 @@ PetscErrorCode AVDMarkerControlMV(AdvCtx *actx, VolumeCase vtype);
 PetscErrorCode AVDCheckCellsMV   (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
 PetscErrorCode AVDMapMarkersMV   (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
 PetscErrorCode AVDCreateMV       (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
-PetscErrorCode AVDAlgorithmMV    (AdvCtx *actx, MarkerVolume *mv, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind, PetscInt nmin);
-PetscErrorCode AVDLoadPointsMV   (AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind);
-PetscErrorCode AVDInjectPointsMV (AdvCtx *actx, AVD *A);
-PetscErrorCode AVDDeletePointsMV (AdvCtx *actx, AVD *A);
+PetscInt       AVDAlgorithmMV    (AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind, PetscInt nmin, PetscInt *area, PetscScalar *xc);
+void           AVDLoadPointsMV   (AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind);
+void           AVDHalfCentroidMV (AVD *A);
+PetscErrorCode AVDInjectPointsMV (AdvCtx *actx, MarkerVolume *mv, PetscInt ind, PetscInt nmin, PetscInt *area, PetscScalar *xc);
+PetscErrorCode AVDDeletePointsMV (AdvCtx *actx, MarkerVolume *mv, PetscInt ind, PetscInt *area);
 PetscErrorCode AVDDestroyMV      (MarkerVolume *mv);
 
 //---------------------------------------------------------------------------
@@ -497,6 +497,83 @@ PetscErrorCode JacResWriteRestart(JacRes *jr, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode JacResWriteRestartPortable(JacRes *jr, PetscViewer viewer)
+{
+	// write solution components as DMDA vectors (stored in natural ordering)
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// split coupled solution vector
+	ierr = JacResSplitSol(jr, PETSC_FALSE); CHKERRQ(ierr);
+
+	ierr = VecView(jr->gvx, viewer); CHKERRQ(ierr);
+	ierr = VecView(jr->gvy, viewer); CHKERRQ(ierr);
+	ierr = VecView(jr->gvz, viewer); CHKERRQ(ierr);
+	ierr = VecView(jr->gp,  viewer); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode JacResReadRestartPortable(JacRes *jr, PetscViewer viewer)
+{
+	// read solution components redistributed over current partitioning
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = VecLoad(jr->gvx, viewer); CHKERRQ(ierr);
+	ierr = VecLoad(jr->gvy, viewer); CHKERRQ(ierr);
+	ierr = VecLoad(jr->gvz, viewer); CHKERRQ(ierr);
+	ierr = VecLoad(jr->gp,  viewer); CHKERRQ(ierr);
+
+	// assemble coupled solution vector
+	ierr = JacResSplitSol(jr, PETSC_TRUE); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode JacResSplitSol(JacRes *jr, PetscBool merge)
+{
+	// copy coupled solution vector to component vectors (or back if merge is set)
+
+	FDSTAG      *fs;
+	PetscScalar *sol, *iter, *v[4];
+	PetscInt     i, n[4];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs = jr->fs;
+
+	n[0] = fs->nXFace;
+	n[1] = fs->nYFace;
+	n[2] = fs->nZFace;
+	n[3] = fs->nCells;
+
+	ierr = VecGetArray(jr->gsol, &sol);  CHKERRQ(ierr);
+	ierr = VecGetArray(jr->gvx,  &v[0]); CHKERRQ(ierr);
+	ierr = VecGetArray(jr->gvy,  &v[1]); CHKERRQ(ierr);
+	ierr = VecGetArray(jr->gvz,  &v[2]); CHKERRQ(ierr);
+	ierr = VecGetArray(jr->gp,   &v[3]); CHKERRQ(ierr);
+
+	for(i = 0, iter = sol; i < 4; i++)
+	{
+		if(merge) { ierr = PetscMemcpy(iter, v[i], (size_t)n[i]*sizeof(PetscScalar)); CHKERRQ(ierr); }
+		else      { ierr = PetscMemcpy(v[i], iter, (size_t)n[i]*sizeof(PetscScalar)); CHKERRQ(ierr); }
+
+		iter += n[i];
+	}
+
+	ierr = VecRestoreArray(jr->gsol, &sol);  CHKERRQ(ierr);
+	ierr = VecRestoreArray(jr->gvx,  &v[0]); CHKERRQ(ierr);
+	ierr = VecRestoreArray(jr->gvy,  &v[1]); CHKERRQ(ierr);
+	ierr = VecRestoreArray(jr->gvz,  &v[2]); CHKERRQ(ierr);
+	ierr = VecRestoreArray(jr->gp,   &v[3]); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode JacResDestroy(JacRes *jr)
 {
 
@@ -282,6 +282,14 @@ PetscErrorCode JacResReadRestart(JacRes *jr, FILE *fp);
 
 PetscErrorCode JacResWriteRestart(JacRes *jr, FILE *fp);
 
+// partition-independent restart (solution components in natural ordering)
+PetscErrorCode JacResWriteRestartPortable(JacRes *jr, PetscViewer viewer);
+
+PetscErrorCode JacResReadRestartPortable(JacRes *jr, PetscViewer viewer);
+
+// copy coupled solution vector to component vectors (or back if merge is set)
+PetscErrorCode JacResSplitSol(JacRes *jr, PetscBool merge);
+
 // destroy residual & Jacobian evaluation context
 PetscErrorCode JacResDestroy(JacRes *jr);
 
@@ -53,6 +53,26 @@
 // local marker buffer size as percentage of local number of markers
 #define _mark_buff_ratio_ 5
 
+// number of compact marker records converted at once during restart I/O
+#define _pack_chunk_ 65536
+
+// partition-independent restart database format version
+#define _rdb_version_ 1
+
+// shared marker file: maximum number of buckets per direction, header size, tags & record sizes
+#define _mark_io_nb_ 32
+#define _mark_io_hdr_ 11
+#define _mark_io_tag_ -2.0
+#define _mark_io_tag_full_ -3.0
+#define _mark_io_rec_ 5
+#define _mark_io_rec_full_ 17
+
+// passive tracer time series file: tag, format version, number of fields & length of field names
+#define _ptr_ser_tag_ -4.0
+#define _ptr_ser_version_ 1
+#define _ptr_ser_nfld_ 8
+#define _ptr_ser_lbl_ 32
+
 // maximum number of strain rate application periods
 #define _max_periods_ 20
 
@@ -98,6 +118,9 @@
 // maximum number of phase aggregates for output
 #define _max_num_phase_agg_ 5
 
+// maximum number of output views
+#define _max_num_out_views_ 5
+
 // maximum number of phases
 #define _max_num_phases_ 32
 
@@ -146,9 +169,6 @@
 // maximum number of adjoint points
 #define _max_adj_point_ 100
 
-// maximum number of passive tracers
-#define _max_passive_tracer 100000
-
 // maximum number of control polygons
 #define _max_ctrl_poly_ 20
 
@@ -169,7 +189,9 @@
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <functional>
 #include <utility>
+#include <string>
 #ifdef _WIN32
 #include "asprintf.h"       // required for some windows compilers
 #endif 
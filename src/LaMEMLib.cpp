@@ -10,6 +10,10 @@
 //---------------------------------------------------------------------------
 // LAMEM LIBRARY MODE ROUTINE
 //---------------------------------------------------------------------------
+// standard headers first (marker.h defines min & max macros)
+#include <thread>
+#include <atomic>
+
 #include "LaMEM.h"
 #include "phase.h"
 #include "dike.h"
@@ -33,13 +37,16 @@
 #include "advect.h"
 #include "marker.h"
 #include "paraViewOutMark.h"
+#include "AVD.h"
 #include "paraViewOutAVD.h"
 #include "objFunct.h"
 #include "adjoint.h"
 #include "paraViewOutPassiveTracers.h"
+#include "diagnostics.h"
 #include "LaMEMLib.h"
 #include "phase_transition.h"
 #include "passive_tracer.h"
+#include "startup.h"
 
 //---------------------------------------------------------------------------
 PetscErrorCode LaMEMLibMain(void *param)
@@ -97,6 +104,12 @@ PetscErrorCode LaMEMLibMain(void *param)
 	// clear
 	ierr = PetscMemzero(&lm, sizeof(LaMEMLib)); CHKERRQ(ierr);
 
+	// start profiling of initialization phases
+	ierr = StartupProfInit(); CHKERRQ(ierr);
+
+	// set number of worker threads
+	ierr = ThreadSetNum(); CHKERRQ(ierr);
+
 	// setup cross-references between library objects
 	ierr = LaMEMLibSetLinks(&lm); CHKERRQ(ierr);
 
@@ -114,8 +127,31 @@ PetscErrorCode LaMEMLibMain(void *param)
 	}
 	else if(mode == _RESTART_)
 	{
-		// open restart database
-		ierr = LaMEMLibLoadRestart(&lm); CHKERRQ(ierr);
+		// check for partition-independent restart database
+		ierr = FileCheck("./restart/state.dat", &exists); CHKERRQ(ierr);
+
+		if(exists)
+		{
+			// create library objects & load partition-independent restart database
+			ierr = LaMEMLibCreate(&lm, param); CHKERRQ(ierr);
+
+			ierr = StartupProfBegin(_STARTUP_RESTART_);      CHKERRQ(ierr);
+			ierr = LaMEMLibLoadRestartPortable(&lm);         CHKERRQ(ierr);
+			ierr = StartupProfEnd  (_STARTUP_RESTART_);      CHKERRQ(ierr);
+		}
+		else
+		{
+			// open restart database
+			ierr = StartupProfBegin(_STARTUP_RESTART_); CHKERRQ(ierr);
+			ierr = LaMEMLibLoadRestart(&lm);            CHKERRQ(ierr);
+			ierr = StartupProfEnd  (_STARTUP_RESTART_); CHKERRQ(ierr);
+		}
+
+		// continue passive tracer time series after restart time
+		ierr = PVPtrSetRestart(&lm.pvptr, lm.ts.time*lm.scal.time); CHKERRQ(ierr);
+
+		// continue diagnostics time series after restart step
+		ierr = DiagSetRestart(&lm.diag, lm.ts.istep); CHKERRQ(ierr);
 	}
 
 	//======
@@ -133,6 +169,9 @@ PetscErrorCode LaMEMLibMain(void *param)
 		ierr = LaMEMLibSolve(&lm, param); CHKERRQ(ierr);
 	}
 
+	// report initialization phases (if not done yet)
+	ierr = StartupProfReport(); CHKERRQ(ierr);
+
 	// destroy library objects
 	ierr = LaMEMLibDestroy(&lm); CHKERRQ(ierr);
 
@@ -154,7 +193,11 @@ PetscErrorCode LaMEMLibCreate(LaMEMLib *lm, void *param )
 	if(param) param = NULL;
 
 	// load input file
-	ierr = FBLoad(&fb, PETSC_TRUE); CHKERRQ(ierr);
+	ierr = StartupProfBegin(_STARTUP_INPUT_); 		CHKERRQ(ierr);
+	ierr = FBLoad(&fb, PETSC_TRUE); 				CHKERRQ(ierr);
+	ierr = StartupProfEnd(_STARTUP_INPUT_); 		CHKERRQ(ierr);
+
+	ierr = StartupProfBegin(_STARTUP_PARAM_); 		CHKERRQ(ierr);
 
 	// create scaling object
 	ierr = ScalingCreate(&lm->scal, fb, PETSC_TRUE);CHKERRQ(ierr);
@@ -162,11 +205,19 @@ PetscErrorCode LaMEMLibCreate(LaMEMLib *lm, void *param )
 	// create time stepping object
 	ierr = TSSolCreate(&lm->ts, fb); 				CHKERRQ(ierr);
 
+	ierr = StartupProfEnd(_STARTUP_PARAM_); 		CHKERRQ(ierr);
+
 	// create parallel grid
+	ierr = StartupProfBegin(_STARTUP_GRID_); 		CHKERRQ(ierr);
 	ierr = FDSTAGCreate(&lm->fs, fb); 				CHKERRQ(ierr);
+	ierr = StartupProfEnd(_STARTUP_GRID_); 			CHKERRQ(ierr);
 
 	// create material database
+	ierr = StartupProfBegin(_STARTUP_PARAM_); 		CHKERRQ(ierr);
 	ierr = DBMatCreate(&lm->dbm, fb, PETSC_TRUE); 	CHKERRQ(ierr);
+	ierr = StartupProfEnd(_STARTUP_PARAM_); 		CHKERRQ(ierr);
+
+	ierr = StartupProfBegin(_STARTUP_OBJECTS_); 	CHKERRQ(ierr);
 
 	// create free surface grid
 	ierr = FreeSurfCreate(&lm->surf, fb); 			CHKERRQ(ierr);
@@ -177,15 +228,23 @@ PetscErrorCode LaMEMLibCreate(LaMEMLib *lm, void *param )
 	// create residual & Jacobian evaluation context
 	ierr = JacResCreate(&lm->jr, fb); 				CHKERRQ(ierr);
 
+	ierr = StartupProfEnd(_STARTUP_OBJECTS_); 		CHKERRQ(ierr);
+
+	ierr = StartupProfBegin(_STARTUP_PARAM_); 		CHKERRQ(ierr);
+
 	// create dike database
 	ierr = DBDikeCreate(&lm->dbdike, &lm->dbm, fb, &lm->jr, PETSC_TRUE);   CHKERRQ(ierr);
 
 	// initialize arrays for dynamic phase transition
 	ierr = DynamicPhTr_Init(&lm->jr);			CHKERRQ(ierr);
 
-	// create advection context
+	ierr = StartupProfEnd(_STARTUP_PARAM_); 		CHKERRQ(ierr);
+
+	// create advection context (profiled internally)
 	ierr = ADVCreate(&lm->actx, fb); 				CHKERRQ(ierr);
 
+	ierr = StartupProfBegin(_STARTUP_OUTPUT_); 		CHKERRQ(ierr);
+
 	// create passive tracers
 	ierr = ADVPtrPassive_Tracer_create(&lm->actx,fb);			CHKERRQ(ierr);
 
@@ -204,6 +263,17 @@ PetscErrorCode LaMEMLibCreate(LaMEMLib *lm, void *param )
 	// AVD output driver
 	ierr = PVAVDCreate(&lm->pvavd, fb); 			CHKERRQ(ierr);
 
+	// in-situ diagnostics
+	ierr = DiagCreate(&lm->diag, fb); 				CHKERRQ(ierr);
+
+	// check restart database format
+	ierr = LaMEMLibCheckRestartPortable(lm); 		CHKERRQ(ierr);
+
+	// report unknown or unused input parameters
+	ierr = FBCheckUnused(fb); 						CHKERRQ(ierr);
+
+	ierr = StartupProfEnd(_STARTUP_OUTPUT_); 		CHKERRQ(ierr);
+
 	// destroy file buffer
 	ierr = FBDestroy(&fb); CHKERRQ(ierr);
 
@@ -296,6 +366,9 @@ PetscErrorCode LaMEMLibLoadRestart(LaMEMLib *lm)
 	// surface output driver
 	ierr = PVSurfCreateData(&lm->pvsurf); CHKERRQ(ierr);
 
+	// AVD phase output driver
+	ierr = PVAVDCreateData(&lm->pvavd); CHKERRQ(ierr);
+
 	// arrays for dynamic NotInAir phase_trans
 	ierr = DynamicPhTr_ReadRestart(&lm->jr, fp); CHKERRQ(ierr);
 
@@ -341,8 +414,27 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	// commit asynchronous checkpoint as soon as all processors finished writing
+	ierr = LaMEMLibRestartAsyncCommit(PETSC_FALSE); CHKERRQ(ierr);
+
 	if(!TSSolIsRestart(&lm->ts)) PetscFunctionReturn(0);
 
+	if(lm->ts.rdb_portable)
+	{
+		// save partition-independent restart database
+		ierr = LaMEMLibSaveRestartPortable(lm); CHKERRQ(ierr);
+
+		PetscFunctionReturn(0);
+	}
+
+	if(lm->ts.rdb_async)
+	{
+		// take memory snapshot & write it in the background
+		ierr = LaMEMLibSaveRestartAsync(lm); CHKERRQ(ierr);
+
+		PetscFunctionReturn(0);
+	}
+
 	PrintStart(&t, "Saving restart database", NULL);
 
 	// get MPI processor rank
@@ -362,6 +454,33 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Cannot open restart file %s\n", fileNameTmp);
 	}
 
+	// write restart database
+	ierr = LaMEMLibWriteRestart(lm, fp); CHKERRQ(ierr);
+
+	// close temporary restart file
+	fclose(fp);
+
+	// delete existing restart database
+	ierr = LaMEMLibDeleteRestart(); CHKERRQ(ierr);
+
+	// push temporary database to actual
+	ierr = DirRename("./restart-tmp", "./restart");
+
+	// free space
+	free(fileNameTmp);
+
+	PrintDone(t);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibWriteRestart(LaMEMLib *lm, FILE *fp)
+{
+	// write restart database of current processor to file or memory stream
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
 	// write LaMEM library database
 	fwrite(lm, sizeof(LaMEMLib), 1, fp);
 
@@ -389,30 +508,180 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 	// dynamic dike 
 	ierr = DynamicDike_WriteRestart(&lm->jr, fp); CHKERRQ(ierr);
 
-	// close temporary restart file
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+//....................... Asynchronous checkpointing ........................
+//---------------------------------------------------------------------------
+// Restart database of every processor is serialized into a memory stream,
+// and written to the temporary directory by a background thread. Only one
+// checkpoint is in flight: a newer snapshot supersedes the older one, so the
+// next snapshot waits for the previous checkpoint. The temporary directory
+// is renamed (committed) only after all processors finished writing.
+//---------------------------------------------------------------------------
+static std::thread     *rdbAsyncWorker = NULL; // never destroyed at exit (see LaMEMLibRestartAsyncFinalize)
+static PetscInt         rdbAsyncFinReg = 0;
+static std::atomic<int> rdbAsyncDone(0);
+static PetscInt         rdbAsyncFailed = 0;
+static char            *rdbAsyncBuf    = NULL;
+static size_t           rdbAsyncSize   = 0;
+static char            *rdbAsyncFile   = NULL;
+//---------------------------------------------------------------------------
+static void LaMEMLibRestartAsyncWrite()
+{
+	// write memory snapshot to disk (background thread, no MPI/PETSc calls)
+
+	FILE *fp;
+
+	fp = fopen(rdbAsyncFile, "wb");
+
+	if(fp == NULL
+	|| fwrite(rdbAsyncBuf, 1, rdbAsyncSize, fp) != rdbAsyncSize
+	|| fclose(fp))
+	{
+		rdbAsyncFailed = 1;
+	}
+
+	rdbAsyncDone = 1;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSaveRestartAsync(LaMEMLib *lm)
+{
+	PetscMPIInt    rank;
+	PetscLogDouble t;
+	FILE          *fp;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// limit number of checkpoints in flight
+	ierr = LaMEMLibRestartAsyncCommit(PETSC_TRUE); CHKERRQ(ierr);
+
+	PrintStart(&t, "Saving restart snapshot", NULL);
+
+	// get MPI processor rank
+	MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+	// compile temporary restart file name
+	asprintf(&rdbAsyncFile, "./restart-tmp/rdb.%1.8lld.dat", (LLD)rank);
+
+	// create temporary restart directory
+	ierr = DirMake("./restart-tmp"); CHKERRQ(ierr);
+
+#if !defined(_WIN32)
+	// serialize restart database into memory
+	fp = open_memstream(&rdbAsyncBuf, &rdbAsyncSize);
+#else
+	fp = NULL;
+#endif
+
+	if(fp == NULL)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Cannot create restart snapshot\n");
+	}
+
+	ierr = LaMEMLibWriteRestart(lm, fp); CHKERRQ(ierr);
+
+	// close memory stream (finalizes buffer)
 	fclose(fp);
 
+	// join writer on shutdown, also if an error exit happens while a checkpoint is in flight
+	if(!rdbAsyncFinReg)
+	{
+		ierr = PetscRegisterFinalize(LaMEMLibRestartAsyncFinalize); CHKERRQ(ierr);
+
+		rdbAsyncFinReg = 1;
+	}
+
+	// hand over snapshot to the background thread
+	rdbAsyncDone   = 0;
+	rdbAsyncWorker = new std::thread(LaMEMLibRestartAsyncWrite);
+
+	PrintDone(t);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibRestartAsyncCommit(PetscBool wait)
+{
+	// commit checkpoint in flight (collective)
+	// without wait flag only commit if all processors finished writing
+
+	PetscInt lflag, gflag;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// all processors start & commit checkpoints simultaneously
+	if(!rdbAsyncWorker) PetscFunctionReturn(0);
+
+	if(!wait)
+	{
+		lflag = (PetscInt)rdbAsyncDone;
+
+		ierr = MPI_Allreduce(&lflag, &gflag, 1, MPIU_INT, MPI_MIN, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+		if(!gflag) PetscFunctionReturn(0);
+	}
+
+	// wait for the background thread & free snapshot
+	ierr = LaMEMLibRestartAsyncFinalize(); CHKERRQ(ierr);
+
+	// check whether all processors succeeded
+	lflag = rdbAsyncFailed;
+
+	ierr = MPI_Allreduce(&lflag, &gflag, 1, MPIU_INT, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	rdbAsyncFailed = 0;
+
+	if(gflag)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_WRITE, "Asynchronous checkpoint failed, previous restart database is kept\n");
+	}
+
 	// delete existing restart database
 	ierr = LaMEMLibDeleteRestart(); CHKERRQ(ierr);
 
 	// push temporary database to actual
-	ierr = DirRename("./restart-tmp", "./restart");
+	ierr = DirRename("./restart-tmp", "./restart"); CHKERRQ(ierr);
 
-	// free space
-	free(fileNameTmp);
-
-	PrintDone(t);
+	PetscPrintf(PETSC_COMM_WORLD, "Restart database committed\n");
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibRestartAsyncFinalize()
+{
+	// wait for the background thread, release it & free snapshot (not collective)
+	// (heap allocated, a joinable static std::thread would call std::terminate at exit)
+
+	if(rdbAsyncWorker)
+	{
+		if(rdbAsyncWorker->joinable()) rdbAsyncWorker->join();
+
+		delete rdbAsyncWorker;
+
+		rdbAsyncWorker = NULL;
+	}
+
+	free(rdbAsyncBuf);
+	free(rdbAsyncFile);
+
+	rdbAsyncBuf  = NULL;
+	rdbAsyncFile = NULL;
+	rdbAsyncSize = 0;
+
+	return 0;
+}
+//---------------------------------------------------------------------------
 PetscErrorCode LaMEMLibDeleteRestart()
 {
 	// delete existing restart database
 	PetscMPIInt  rank;
 	int          status;
-	PetscInt     exists;
+	PetscInt     i, exists;
 	char        *fileName;
+	const char  *rdbFiles[] = { "./restart/state.dat", "./restart/grid.bin", "./restart/mdb.shared.dat" };
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -435,6 +704,20 @@ PetscErrorCode LaMEMLibDeleteRestart()
 			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Failed to delete file %s", fileName);
 		}
 
+		// delete partition-independent database files
+		if(ISRankZero(PETSC_COMM_WORLD))
+		{
+			for(i = 0; i < 3; i++)
+			{
+				status = remove(rdbFiles[i]);
+
+				if(status && errno != ENOENT)
+				{
+					SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Failed to delete file %s", rdbFiles[i]);
+				}
+			}
+		}
+
 		ierr = DirRemove("./restart"); CHKERRQ(ierr);
 	}
 
@@ -444,11 +727,289 @@ PetscErrorCode LaMEMLibDeleteRestart()
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+// partition-independent restart database:
+//    state.dat       - scalar state (key-value records, written by first processor)
+//    grid.bin        - grid coordinates & vectors in natural ordering (collective I/O)
+//    mdb.shared.dat  - markers in a spatially indexed shared file (see ADVMarkWriteShared)
+// Library objects are recreated from the input file before loading, therefore
+// the database can be loaded on any number of processors.
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibCheckRestartPortable(LaMEMLib *lm)
+{
+	// check whether all active features are supported by partition-independent restart
+
+	PetscInt i;
+
+	PetscFunctionBeginUser;
+
+	if(!lm->ts.nstep_rdb || !lm->ts.rdb_portable) PetscFunctionReturn(0);
+
+	if(lm->jr.ctrl.Passive_Tracer)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Partition-independent restart (rdb_portable) does not support passive tracers\n");
+	}
+
+	for(i = 0; lm->jr.ctrl.actDike && i < lm->dbdike.numDike; i++)
+	{
+		if(lm->dbdike.matDike[i].dyndike_start)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Partition-independent restart (rdb_portable) does not support dynamic diking\n");
+		}
+	}
+
+	for(i = 0; i < lm->dbm.numPhtr; i++)
+	{
+		if(lm->dbm.matPhtr[i].Type == _NotInAirBox_)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Partition-independent restart (rdb_portable) does not support NotInAirBox phase transitions\n");
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSaveRestartPortable(LaMEMLib *lm)
+{
+	// save new partition-independent restart database, then delete the original
+
+	PetscViewer    viewer;
+	PetscLogDouble t;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	PrintStart(&t, "Saving restart database", "./restart");
+
+	// create temporary restart directory
+	ierr = DirMake("./restart-tmp"); CHKERRQ(ierr);
+
+	// scalar state
+	ierr = LaMEMLibWriteRestartState(lm, "./restart-tmp/state.dat"); CHKERRQ(ierr);
+
+	// grid coordinates & vectors
+	ierr = LaMEMLibOpenRestartViewer("./restart-tmp/grid.bin", FILE_MODE_WRITE, &viewer); CHKERRQ(ierr);
+
+	ierr = FDSTAGWriteRestartPortable  (&lm->fs,   viewer); CHKERRQ(ierr);
+	ierr = JacResWriteRestartPortable  (&lm->jr,   viewer); CHKERRQ(ierr);
+	ierr = FreeSurfWriteRestartPortable(&lm->surf, viewer); CHKERRQ(ierr);
+
+	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+
+	PrintDone(t);
+
+	// markers
+	ierr = ADVWriteRestartPortable(&lm->actx, "./restart-tmp/mdb.shared.dat"); CHKERRQ(ierr);
+
+	// delete existing restart database
+	ierr = LaMEMLibDeleteRestart(); CHKERRQ(ierr);
+
+	// push temporary database to actual
+	ierr = DirRename("./restart-tmp", "./restart"); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibLoadRestartPortable(LaMEMLib *lm)
+{
+	// load partition-independent restart database into objects created from input file
+
+	PetscViewer    viewer;
+	PetscLogDouble t;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	PrintStart(&t, "Loading restart database", "./restart");
+
+	// scalar state
+	ierr = LaMEMLibReadRestartState(lm, "./restart/state.dat"); CHKERRQ(ierr);
+
+	// grid coordinates & vectors (redistributed over current partitioning)
+	ierr = LaMEMLibOpenRestartViewer("./restart/grid.bin", FILE_MODE_READ, &viewer); CHKERRQ(ierr);
+
+	ierr = FDSTAGReadRestartPortable  (&lm->fs,   viewer); CHKERRQ(ierr);
+	ierr = JacResReadRestartPortable  (&lm->jr,   viewer); CHKERRQ(ierr);
+	ierr = FreeSurfReadRestartPortable(&lm->surf, viewer); CHKERRQ(ierr);
+
+	ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+
+	PrintDone(t);
+
+	// markers (redistributed by position, replace initial marker setup)
+	ierr = ADVReadRestartPortable(&lm->actx, "./restart/mdb.shared.dat"); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibOpenRestartViewer(const char *fileName, PetscFileMode mode, PetscViewer *viewer)
+{
+	// open binary viewer with collective (MPI-IO) access
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscViewerCreate(PETSC_COMM_WORLD, viewer);         CHKERRQ(ierr);
+	ierr = PetscViewerSetType(*viewer, PETSCVIEWERBINARY);      CHKERRQ(ierr);
+	ierr = PetscViewerFileSetMode(*viewer, mode);               CHKERRQ(ierr);
+	ierr = PetscViewerBinarySetUseMPIIO(*viewer, PETSC_TRUE);   CHKERRQ(ierr);
+	ierr = PetscViewerBinarySkipInfo(*viewer);                  CHKERRQ(ierr);
+	ierr = PetscViewerFileSetName(*viewer, fileName);           CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibWriteRestartState(LaMEMLib *lm, const char *fileName)
+{
+	// write scalar state as key-value records (first processor only)
+
+	FILE        *fp;
+	PetscMPIInt  nproc;
+	PetscInt     i;
+
+	PetscFunctionBeginUser;
+
+	if(!ISRankZero(PETSC_COMM_WORLD)) PetscFunctionReturn(0);
+
+	MPI_Comm_size(PETSC_COMM_WORLD, &nproc);
+
+	fp = fopen(fileName, "w");
+
+	if(fp == NULL)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Cannot open restart file %s\n", fileName);
+	}
+
+	fprintf(fp, "version      %lld\n", (LLD)_rdb_version_);
+	fprintf(fp, "nproc        %lld\n", (LLD)nproc);
+	fprintf(fp, "tnods        %lld %lld %lld\n", (LLD)lm->fs.dsx.tnods, (LLD)lm->fs.dsy.tnods, (LLD)lm->fs.dsz.tnods);
+	fprintf(fp, "time         %.17g\n", (double)lm->ts.time);
+	fprintf(fp, "time_out     %.17g\n", (double)lm->ts.time_out);
+	fprintf(fp, "dt           %.17g\n", (double)lm->ts.dt);
+	fprintf(fp, "dt_next      %.17g\n", (double)lm->ts.dt_next);
+	fprintf(fp, "istep        %lld\n", (LLD)lm->ts.istep);
+	fprintf(fp, "init_guess   %lld\n", (LLD)lm->jr.ctrl.initGuess);
+	fprintf(fp, "p_lim_plast  %lld\n", (LLD)lm->jr.ctrl.pLimPlast);
+	fprintf(fp, "offset_out   %ld\n",  lm->pvout.offset);
+	fprintf(fp, "offset_surf  %ld\n",  lm->pvsurf.offset);
+	fprintf(fp, "offset_mark  %ld\n",  lm->pvmark.offset);
+	fprintf(fp, "offset_ptr   %ld\n",  lm->pvptr.offset);
+	fprintf(fp, "offset_avd   %ld\n",  lm->pvavd.offset);
+
+	for(i = 0; i < lm->pvout.nview; i++)
+	{
+		fprintf(fp, "offset_view  %lld %ld\n", (LLD)i, lm->pvout.view[i].offset);
+	}
+
+	fclose(fp);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibReadRestartState(LaMEMLib *lm, const char *fileName)
+{
+	// read scalar state (first processor reads, all processors parse)
+	// unknown keys are ignored to allow extending the format
+
+	FILE        *fp;
+	PetscInt     sz, version, nproc;
+	long long    id, iv;
+	long int     offset;
+	double       dv;
+	char        *buff, *line, key[_str_len_];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	sz   = 0;
+	buff = NULL;
+
+	// read entire file on first processor
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		fp = fopen(fileName, "r");
+
+		if(fp == NULL)
+		{
+			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Cannot open restart file %s\n", fileName);
+		}
+
+		fseek(fp, 0, SEEK_END);
+		sz = (PetscInt)ftell(fp);
+		rewind(fp);
+
+		ierr = PetscMalloc((size_t)(sz+1), &buff); CHKERRQ(ierr);
+
+		sz = (PetscInt)fread(buff, 1, (size_t)sz, fp);
+
+		fclose(fp);
+	}
+
+	// distribute file contents
+	ierr = MPI_Bcast(&sz, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	if(!ISRankZero(PETSC_COMM_WORLD))
+	{
+		ierr = PetscMalloc((size_t)(sz+1), &buff); CHKERRQ(ierr);
+	}
+
+	ierr = MPI_Bcast(buff, (PetscMPIInt)sz, MPI_CHAR, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	buff[sz] = '\0';
+
+	// parse records
+	version = 0;
+	nproc   = 0;
+
+	for(line = strtok(buff, "\n"); line; line = strtok(NULL, "\n"))
+	{
+		if(sscanf(line, "%s", key) != 1) continue;
+
+		line += strspn(line, " \t") + strlen(key);
+
+		if     (!strcmp(key, "version"))     { sscanf(line, "%lld", &iv); version               = (PetscInt)iv;    }
+		else if(!strcmp(key, "nproc"))       { sscanf(line, "%lld", &iv); nproc                 = (PetscInt)iv;    }
+		else if(!strcmp(key, "time"))        { sscanf(line, "%lg",  &dv); lm->ts.time           = (PetscScalar)dv; }
+		else if(!strcmp(key, "time_out"))    { sscanf(line, "%lg",  &dv); lm->ts.time_out       = (PetscScalar)dv; }
+		else if(!strcmp(key, "dt"))          { sscanf(line, "%lg",  &dv); lm->ts.dt             = (PetscScalar)dv; }
+		else if(!strcmp(key, "dt_next"))     { sscanf(line, "%lg",  &dv); lm->ts.dt_next        = (PetscScalar)dv; }
+		else if(!strcmp(key, "istep"))       { sscanf(line, "%lld", &iv); lm->ts.istep          = (PetscInt)iv;    }
+		else if(!strcmp(key, "init_guess"))  { sscanf(line, "%lld", &iv); lm->jr.ctrl.initGuess = (PetscInt)iv;    }
+		else if(!strcmp(key, "p_lim_plast")) { sscanf(line, "%lld", &iv); lm->jr.ctrl.pLimPlast = (PetscInt)iv;    }
+		else if(!strcmp(key, "offset_out"))  { sscanf(line, "%ld",  &lm->pvout.offset);  }
+		else if(!strcmp(key, "offset_surf")) { sscanf(line, "%ld",  &lm->pvsurf.offset); }
+		else if(!strcmp(key, "offset_mark")) { sscanf(line, "%ld",  &lm->pvmark.offset); }
+		else if(!strcmp(key, "offset_ptr"))  { sscanf(line, "%ld",  &lm->pvptr.offset);  }
+		else if(!strcmp(key, "offset_avd"))  { sscanf(line, "%ld",  &lm->pvavd.offset);  }
+		else if(!strcmp(key, "offset_view"))
+		{
+			// views are matched by index (view setup must not change)
+			if(sscanf(line, "%lld %ld", &id, &offset) == 2 && id >= 0 && id < lm->pvout.nview)
+			{
+				lm->pvout.view[id].offset = offset;
+			}
+		}
+	}
+
+	ierr = PetscFree(buff); CHKERRQ(ierr);
+
+	if(version != _rdb_version_)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Unsupported restart database version %lld (expected %lld)\n", (LLD)version, (LLD)_rdb_version_);
+	}
+
+	PetscPrintf(PETSC_COMM_WORLD, "Restart database saved on %lld processes, step %lld\n", (LLD)nproc, (LLD)lm->ts.istep);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode LaMEMLibDestroy(LaMEMLib *lm)
 {
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	// commit outstanding checkpoint
+	ierr = LaMEMLibRestartAsyncCommit(PETSC_TRUE); CHKERRQ(ierr);
+
 	ierr = FDSTAGDestroy  (&lm->fs);     CHKERRQ(ierr);
 	ierr = FreeSurfDestroy(&lm->surf);   CHKERRQ(ierr);
 	ierr = BCDestroy      (&lm->bc);     CHKERRQ(ierr);
@@ -457,6 +1018,7 @@ PetscErrorCode LaMEMLibDestroy(LaMEMLib *lm)
 	ierr = ADVDestroy     (&lm->actx);   CHKERRQ(ierr);
 	ierr = PVOutDestroy   (&lm->pvout);  CHKERRQ(ierr);
 	ierr = PVSurfDestroy  (&lm->pvsurf); CHKERRQ(ierr);
+	ierr = PVAVDDestroy   (&lm->pvavd);  CHKERRQ(ierr);
 
 	ierr = DynamicPhTrDestroy (&lm->dbm); CHKERRQ(ierr);
 	ierr = DynamicDike_Destroy(&lm->jr); CHKERRQ(ierr);
@@ -534,6 +1096,9 @@ PetscErrorCode LaMEMLibSetLinks(LaMEMLib *lm)
 	lm->pvptr.actx  = &lm->actx;
 	// PVAVD
 	lm->pvavd.actx  = &lm->actx;
+	// Diag
+	lm->diag.jr     = &lm->jr;
+	lm->diag.surf   = &lm->surf;
 
 
 	PetscFunctionReturn(0);
@@ -548,7 +1113,7 @@ PetscErrorCode LaMEMLibSaveOutput(LaMEMLib *lm)
 	Scaling        *scal;
 	TSSol          *ts;
 	PetscScalar    time;
-	PetscInt       bgPhase, step;
+	PetscInt       bgPhase, step, out, view;
 	char           *dirName;
 	PetscLogDouble t;
 
@@ -558,9 +1123,13 @@ PetscErrorCode LaMEMLibSaveOutput(LaMEMLib *lm)
 	scal = &lm->scal;
 	ts   = &lm->ts;
 
-	if(!TSSolIsOutput(ts)) PetscFunctionReturn(0);
+	// check full output & output views
+	out  = TSSolIsOutput(ts);
+	view = PVOutViewIsOutput(&lm->pvout, ts->istep);
+
+	if(!out && !view) PetscFunctionReturn(0);
 
-	PrintStart(&t, "Saving output", NULL);
+	PrintStart(&t, out ? "Saving output" : "Saving output views", NULL);
 
 	time    = ts->time*scal->time;
 	step    = ts->istep;
@@ -574,6 +1143,23 @@ PetscErrorCode LaMEMLibSaveOutput(LaMEMLib *lm)
 	// create output directory
 	ierr = DirMake(dirName); CHKERRQ(ierr);
 
+	// wait until previous asynchronous output is written
+	ierr = OutAsyncBegin(lm->pvout.outasync); CHKERRQ(ierr);
+
+	// grid output views (sub-sets of grid output with own frequency)
+	ierr = PVOutWriteViews(&lm->pvout, dirName, time, step); CHKERRQ(ierr);
+
+	if(!out)
+	{
+		ierr = OutAsyncCommit(); CHKERRQ(ierr);
+
+		free(dirName);
+
+		PrintDone(t);
+
+		PetscFunctionReturn(0);
+	}
+
 	// AVD phase output
 	ierr = PVAVDWriteTimeStep(&lm->pvavd, dirName, time); CHKERRQ(ierr);
 
@@ -590,12 +1176,11 @@ PetscErrorCode LaMEMLibSaveOutput(LaMEMLib *lm)
 	ierr = JacResGetPermea(&lm->jr, bgPhase, step, lm->pvout.outfile); CHKERRQ(ierr);
 
 	// passive tracers paraview output
-	if(ISRankZero(PETSC_COMM_WORLD))
-	{
-		// save .dat files// binary of passive tracers
-		ierr = PVPtrWriteTimeStep(&lm->pvptr, dirName, time); CHKERRQ(ierr);
+	ierr = PVPtrWriteTimeStep(&lm->pvptr, dirName, time); CHKERRQ(ierr);
+
+	// write output files in the background (asynchronous mode)
+	ierr = OutAsyncCommit(); CHKERRQ(ierr);
 
-	}
 	// clean up
 	free(dirName);
 
@@ -618,9 +1203,11 @@ PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param)
 	PetscFunctionBeginUser;
 
 	// create Stokes preconditioner, matrix and nonlinear solver
-	ierr = PMatCreate(&pm, &lm->jr);    CHKERRQ(ierr);
-	ierr = PCStokesCreate(&pc, pm);     CHKERRQ(ierr);
-	ierr = NLSolCreate(&nl, pc, &snes); CHKERRQ(ierr);
+	ierr = StartupProfBegin(_STARTUP_SOLVER_); CHKERRQ(ierr);
+	ierr = PMatCreate(&pm, &lm->jr);           CHKERRQ(ierr);
+	ierr = PCStokesCreate(&pc, pm);            CHKERRQ(ierr);
+	ierr = NLSolCreate(&nl, pc, &snes);        CHKERRQ(ierr);
+	ierr = StartupProfEnd  (_STARTUP_SOLVER_); CHKERRQ(ierr);
 
 	//==============
 	// INITIAL GUESS
@@ -725,6 +1312,9 @@ PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param)
 	
 		// update time stamp and counter
 		ierr = TSSolStepForward(&lm->ts); CHKERRQ(ierr);
+
+		// in-situ diagnostics time series
+		ierr = DiagWriteStep(&lm->diag); CHKERRQ(ierr);
 		
 		// grid & marker output
 		ierr = LaMEMLibSaveOutput(lm); CHKERRQ(ierr);
@@ -771,6 +1361,8 @@ PetscErrorCode LaMEMLibDryRun(LaMEMLib *lm)
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	ierr = StartupProfBegin(_STARTUP_INIT_STATE_); CHKERRQ(ierr);
+
 	// initialize boundary constraint vectors
 	ierr = BCApply(&lm->bc); CHKERRQ(ierr);
 
@@ -780,11 +1372,20 @@ PetscErrorCode LaMEMLibDryRun(LaMEMLib *lm)
 	// compute inverse elastic parameters (dependent on dt)
 	ierr = JacResGetI2Gdt(&lm->jr); CHKERRQ(ierr);
 
+	ierr = StartupProfEnd(_STARTUP_INIT_STATE_); CHKERRQ(ierr);
+
 	// evaluate initial residual
-	ierr = JacResFormResidual(&lm->jr, lm->jr.gsol, lm->jr.gres); CHKERRQ(ierr);
+	ierr = StartupProfBegin(_STARTUP_INIT_SOLVE_);                   CHKERRQ(ierr);
+	ierr = JacResFormResidual(&lm->jr, lm->jr.gsol, lm->jr.gres);    CHKERRQ(ierr);
+	ierr = StartupProfEnd  (_STARTUP_INIT_SOLVE_);                   CHKERRQ(ierr);
 
 	// save output for inspection
-	ierr = LaMEMLibSaveOutput(lm); CHKERRQ(ierr);
+	ierr = StartupProfBegin(_STARTUP_INIT_OUT_); CHKERRQ(ierr);
+	ierr = LaMEMLibSaveOutput(lm);               CHKERRQ(ierr);
+	ierr = StartupProfEnd  (_STARTUP_INIT_OUT_); CHKERRQ(ierr);
+
+	// report initialization phases
+	ierr = StartupProfReport(); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -796,6 +1397,8 @@ PetscErrorCode LaMEMLibInitGuess(LaMEMLib *lm, SNES snes)
 
 	PetscLogDouble t;
 
+	ierr = StartupProfBegin(_STARTUP_INIT_STATE_); CHKERRQ(ierr);
+
 	// initialize boundary constraint vectors
 	ierr = BCApply(&lm->bc); CHKERRQ(ierr);
 
@@ -814,6 +1417,10 @@ PetscErrorCode LaMEMLibInitGuess(LaMEMLib *lm, SNES snes)
 	// compute inverse elastic parameters (dependent on dt)
 	ierr = JacResGetI2Gdt(&lm->jr); CHKERRQ(ierr);
 
+	ierr = StartupProfEnd(_STARTUP_INIT_STATE_); CHKERRQ(ierr);
+
+	ierr = StartupProfBegin(_STARTUP_INIT_SOLVE_); CHKERRQ(ierr);
+
 	if(lm->jr.ctrl.initGuess)
 	{
 		PetscPrintf(PETSC_COMM_WORLD, "============================== INITIAL GUESS =============================\n");
@@ -839,8 +1446,15 @@ PetscErrorCode LaMEMLibInitGuess(LaMEMLib *lm, SNES snes)
 		ierr = JacResFormResidual(&lm->jr, lm->jr.gsol, lm->jr.gres); CHKERRQ(ierr);
 	}
 
+	ierr = StartupProfEnd(_STARTUP_INIT_SOLVE_); CHKERRQ(ierr);
+
 	// save output for inspection
-	ierr = LaMEMLibSaveOutput(lm); CHKERRQ(ierr);
+	ierr = StartupProfBegin(_STARTUP_INIT_OUT_); CHKERRQ(ierr);
+	ierr = LaMEMLibSaveOutput(lm);               CHKERRQ(ierr);
+	ierr = StartupProfEnd  (_STARTUP_INIT_OUT_); CHKERRQ(ierr);
+
+	// report initialization phases
+	ierr = StartupProfReport(); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -46,6 +46,7 @@ struct LaMEMLib
 	PVMark   pvmark; // paraview output driver for markers
 	PVAVD    pvavd;  // paraview output driver for AVD
 	PVPtr    pvptr;  // paraview out passive tracers
+	Diag     diag;   // in-situ diagnostics
 };
 
 //---------------------------------------------------------------------------
@@ -60,8 +61,31 @@ PetscErrorCode LaMEMLibLoadRestart(LaMEMLib *lm);
 
 PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm);
 
+PetscErrorCode LaMEMLibWriteRestart(LaMEMLib *lm, FILE *fp);
+
+// asynchronous checkpointing (background write of memory snapshot)
+PetscErrorCode LaMEMLibSaveRestartAsync(LaMEMLib *lm);
+
+PetscErrorCode LaMEMLibRestartAsyncCommit(PetscBool wait);
+
+// join background writer (registered with PetscRegisterFinalize)
+PetscErrorCode LaMEMLibRestartAsyncFinalize();
+
 PetscErrorCode LaMEMLibDeleteRestart();
 
+// partition-independent restart database
+PetscErrorCode LaMEMLibCheckRestartPortable(LaMEMLib *lm);
+
+PetscErrorCode LaMEMLibSaveRestartPortable(LaMEMLib *lm);
+
+PetscErrorCode LaMEMLibLoadRestartPortable(LaMEMLib *lm);
+
+PetscErrorCode LaMEMLibOpenRestartViewer(const char *fileName, PetscFileMode mode, PetscViewer *viewer);
+
+PetscErrorCode LaMEMLibWriteRestartState(LaMEMLib *lm, const char *fileName);
+
+PetscErrorCode LaMEMLibReadRestartState(LaMEMLib *lm, const char *fileName);
+
 PetscErrorCode LaMEMLibDestroy(LaMEMLib *lm);
 
 PetscErrorCode LaMEMLibSetLinks(LaMEMLib *lm);
@@ -212,7 +212,7 @@ PetscErrorCode Adjoint_ScanForMaterialParameters(FB *fb, Scaling *scal, PetscInt
 
 			// Go through the lines in this block & check whether we have excluded phases  
 			line  	= fb->lbuf;
-			lines 	= FBGetLineRanges(fb, &lnbeg, &lnend);
+			lines 	= FBGetLineRanges(fb, &lnbeg, &lnend, PETSC_TRUE);
 			for(i = lnbeg; i < lnend; i++)
 			{
 				strcpy(line, lines[i]);					// copy line for parsing
@@ -273,7 +273,7 @@ PetscErrorCode Adjoint_ScanForMaterialParameters(FB *fb, Scaling *scal, PetscInt
 
 		// get line buffer & pointers
 		line  	= fb->lbuf;
-		lines 	= FBGetLineRanges(fb, &lnbeg, &lnend);
+		lines 	= FBGetLineRanges(fb, &lnbeg, &lnend, PETSC_TRUE);
 		for(i = lnbeg; i < lnend; i++)
 		{
 			strcpy(line, lines[i]);					// copy line for parsing
@@ -27,6 +27,7 @@
 #include "tools.h"
 #include "phase_transition.h"
 #include "passive_tracer.h"
+#include "startup.h"
 /*
 #START_DOC#
 \lamemfunction{\verb- ADVCreate -}
@@ -71,6 +72,68 @@ PetscErrorCode MarkerMerge(Marker &A, Marker &B, Marker &C)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+void MarkerPackCompact(Marker &A, MarkerPack &B)
+{
+	B.phase = (int)  A.phase;
+	B.X[0]  =        A.X[0];
+	B.X[1]  =        A.X[1];
+	B.X[2]  =        A.X[2];
+	B.p     =        A.p;
+	B.T     =        A.T;
+	B.APS   = (float)A.APS;
+	B.ATS   = (float)A.ATS;
+	B.S[0]  = (float)A.S.xx;
+	B.S[1]  = (float)A.S.yy;
+	B.S[2]  = (float)A.S.zz;
+	B.S[3]  = (float)A.S.xy;
+	B.S[4]  = (float)A.S.xz;
+	B.S[5]  = (float)A.S.yz;
+	B.U[0]  = (float)A.U[0];
+	B.U[1]  = (float)A.U[1];
+	B.U[2]  = (float)A.U[2];
+}
+//---------------------------------------------------------------------------
+void MarkerUnpackCompact(MarkerPack &A, Marker &B)
+{
+	B.phase = (PetscInt)   A.phase;
+	B.X[0]  =              A.X[0];
+	B.X[1]  =              A.X[1];
+	B.X[2]  =              A.X[2];
+	B.p     =              A.p;
+	B.T     =              A.T;
+	B.APS   = (PetscScalar)A.APS;
+	B.ATS   = (PetscScalar)A.ATS;
+	B.S.xx  = (PetscScalar)A.S[0];
+	B.S.yy  = (PetscScalar)A.S[1];
+	B.S.zz  = (PetscScalar)A.S[2];
+	B.S.xy  = (PetscScalar)A.S[3];
+	B.S.xz  = (PetscScalar)A.S[4];
+	B.S.yz  = (PetscScalar)A.S[5];
+	B.U[0]  = (PetscScalar)A.U[0];
+	B.U[1]  = (PetscScalar)A.U[1];
+	B.U[2]  = (PetscScalar)A.U[2];
+}
+//---------------------------------------------------------------------------
+uint64_t MarkerHash(Marker &A)
+{
+	uint64_t h = 0, b;
+	PetscInt k;
+
+	for(k = 0; k < 3; k++)
+	{
+		b = 0;
+		memcpy(&b, &A.X[k], sizeof(PetscScalar));
+		h ^= b + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+	}
+
+	// splitmix64 finalizer
+	h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+	h ^= h >> 31;
+
+	return h;
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 {
 	// create advection context
@@ -108,7 +171,7 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	ierr = getIntParam   (fb, _OPTIONAL_, "rand_noise",     &actx->randNoise,1, 1);            CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "rand_noiseGP",   &actx->randNoiseGP,1, 1);          CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "bg_phase",       &actx->bgPhase,  1, maxPhaseID);   CHKERRQ(ierr);
-	ierr = getIntParam   (fb, _OPTIONAL_, "save_mark",      &actx->saveMark, 1, 1);            CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "save_mark",      &actx->saveMark, 1, 2);            CHKERRQ(ierr);
 	ierr = getStringParam(fb, _OPTIONAL_, "mark_save_file",  actx->saveFile, "./markers/mdb"); CHKERRQ(ierr);
 	ierr = getStringParam(fb, _OPTIONAL_, "interp",          interp,         "stag");          CHKERRQ(ierr);
 	ierr = getScalarParam(fb, _OPTIONAL_, "stagp_a",        &actx->A,        1, 1.0);          CHKERRQ(ierr);
@@ -116,6 +179,10 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	ierr = getIntParam   (fb, _OPTIONAL_, "nmark_lim",       nmark_lim,      2, 0);            CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "nmark_avd",       nmark_avd,      3, 0);            CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "nmark_sub",      &actx->npmax,    1, 27);           CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "mark_sort_freq", &actx->sortFreq, 1, -1);           CHKERRQ(ierr);
+	ierr = getScalarParam(fb, _OPTIONAL_, "mark_sort_tol",  &actx->sortTol,  1, 1.0);          CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "mark_timing",    &actx->logTime,  1, 1);            CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "mark_compact",   &actx->compact,  1, 1);            CHKERRQ(ierr);
 
 	// CHECK
 
@@ -123,6 +190,7 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	if     (!strcmp(msetup, "geom"))     actx->msetup = _GEOM_;
 	else if(!strcmp(msetup, "files"))    actx->msetup = _FILES_;
 	else if(!strcmp(msetup, "polygons")) actx->msetup = _POLYGONS_;
+	else if(!strcmp(msetup, "shared"))   actx->msetup = _SHARED_;
 	else SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect setup type (msetup): %s", msetup);
 
 	if     (!strcmp(interp, "stag"))     actx->interp = STAG;
@@ -167,6 +235,16 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Interpolation constant must be between 0 and 1 (stagp_a)");
 	}
 
+	if(actx->sortFreq < 0)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Marker sorting frequency must be non-negative (mark_sort_freq)");
+	}
+
+	if(actx->sortTol && actx->sortTol < 1.0)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Marker sorting locality threshold must be larger than 1 (mark_sort_tol)");
+	}
+
 	if(actx->interp != STAG_P)  actx->A       = 0.0;
 	if(actx->msetup != _GEOM_)  actx->bgPhase = -1;
 
@@ -195,6 +273,7 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	if     (actx->msetup == _GEOM_)     PetscPrintf(PETSC_COMM_WORLD,"geometric primitives\n");
 	else if(actx->msetup == _FILES_)    PetscPrintf(PETSC_COMM_WORLD,"binary files (MATLAB)\n");
 	else if(actx->msetup == _POLYGONS_) PetscPrintf(PETSC_COMM_WORLD,"volumes from polygons (geomIO)\n");
+	else if(actx->msetup == _SHARED_)   PetscPrintf(PETSC_COMM_WORLD,"shared binary file (MPI-IO)\n");
 
 	// print velocity interpolation scheme
 	PetscPrintf(PETSC_COMM_WORLD,"   Velocity interpolation scheme : ");
@@ -218,9 +297,13 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	if(!actx->randNoise) PetscPrintf(PETSC_COMM_WORLD, "uniform\n");
 	else                 PetscPrintf(PETSC_COMM_WORLD, "random noise\n");
 
-	if(actx->saveMark)      PetscPrintf(PETSC_COMM_WORLD,"   Marker storage file           : %s \n", actx->saveFile);
+	if(actx->saveMark)      PetscPrintf(PETSC_COMM_WORLD,"   Marker storage file           : %s %s\n", actx->saveFile, actx->saveMark == 2 ? "(shared)" : "");
 	if(actx->bgPhase != -1) PetscPrintf(PETSC_COMM_WORLD,"   Background phase ID           : %lld \n", (LLD)actx->bgPhase);
 	if(actx->A)             PetscPrintf(PETSC_COMM_WORLD,"   Interpolation constant        : %g \n", actx->A);
+	if(actx->sortFreq)      PetscPrintf(PETSC_COMM_WORLD,"   Marker sorting frequency      : %lld \n", (LLD)actx->sortFreq);
+	if(actx->sortTol)       PetscPrintf(PETSC_COMM_WORLD,"   Marker sorting threshold      : %g \n", actx->sortTol);
+	if(actx->logTime)       PetscPrintf(PETSC_COMM_WORLD,"   Print marker timing & memory  @ \n");
+	if(actx->compact)       PetscPrintf(PETSC_COMM_WORLD,"   Compact restart records       @ \n");
 
 	PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
 
@@ -228,7 +311,11 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	ierr = ADVCreateData(actx); CHKERRQ(ierr);
 
 	// initialize markers
-	ierr = ADVMarkInit(actx, fb); CHKERRQ(ierr);
+	ierr = StartupProfBegin(_STARTUP_MARK_INIT_); CHKERRQ(ierr);
+	ierr = ADVMarkInit(actx, fb);                 CHKERRQ(ierr);
+	ierr = StartupProfEnd  (_STARTUP_MARK_INIT_); CHKERRQ(ierr);
+
+	ierr = StartupProfBegin(_STARTUP_MARK_PROJ_); CHKERRQ(ierr);
 
 	// compute host cells for all the markers
 	ierr = ADVMapMarkToCells(actx); CHKERRQ(ierr);
@@ -248,6 +335,11 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	// project initial history from markers to grid
 	ierr = ADVProjHistMarkToGrid(actx); CHKERRQ(ierr);
 
+	ierr = StartupProfEnd(_STARTUP_MARK_PROJ_); CHKERRQ(ierr);
+
+	// report memory usage
+	ierr = ADVPrintMemory(actx); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -335,7 +427,14 @@ PetscErrorCode ADVReadRestart(AdvCtx *actx, FILE *fp)
 	ierr = makeIntArray(&actx->markind, NULL, actx->markcap); CHKERRQ(ierr);
 
 	// read markers from disk
-	fread(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
+	if(actx->compact)
+	{
+		ierr = ADVReadCompact(actx, fp); CHKERRQ(ierr);
+	}
+	else
+	{
+		fread(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
+	}
 
 	// create communicator and separator
 	ierr = ADVCreateData(actx); CHKERRQ(ierr);
@@ -346,18 +445,131 @@ PetscErrorCode ADVReadRestart(AdvCtx *actx, FILE *fp)
 	// project history from markers to grid (initialize solution variables)
 	ierr = ADVProjHistMarkToGrid(actx); CHKERRQ(ierr);
 
+	// report memory usage
+	ierr = ADVPrintMemory(actx); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode ADVWriteRestart(AdvCtx *actx, FILE *fp)
 {
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// check activation
  	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
 	// store local markers to disk
-	fwrite(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
+	if(actx->compact)
+	{
+		ierr = ADVWriteCompact(actx, fp); CHKERRQ(ierr);
+	}
+	else
+	{
+		fwrite(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVWriteRestartPortable(AdvCtx *actx, const char *filename)
+{
+	// store markers with complete history in a shared file (partition-independent)
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// check activation
+ 	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
+
+	ierr = ADVMarkWriteShared(actx, filename, PETSC_TRUE); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVReadRestartPortable(AdvCtx *actx, const char *filename)
+{
+	// replace markers by the ones stored in a shared file (distributed by position)
+	// NOTE: grid coordinates must be restored before calling this routine
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// check activation
+ 	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
+
+	ierr = ADVMarkReadShared(actx, filename, PETSC_TRUE); CHKERRQ(ierr);
+
+	// compute host cells for all the markers
+	ierr = ADVMapMarkToCells(actx); CHKERRQ(ierr);
+
+	// project history from markers to grid (initialize solution variables)
+	ierr = ADVProjHistMarkToGrid(actx); CHKERRQ(ierr);
+
+	// report memory usage
+	ierr = ADVPrintMemory(actx); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVReadCompact(AdvCtx *actx, FILE *fp)
+{
+	// read compact marker records in chunks
+
+	MarkerPack *pack;
+	PetscInt    i, n, start;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscMalloc((size_t)_pack_chunk_*sizeof(MarkerPack), &pack); CHKERRQ(ierr);
+
+	for(start = 0; start < actx->nummark; start += n)
+	{
+		n = actx->nummark - start;
+
+		if(n > _pack_chunk_) n = _pack_chunk_;
+
+		fread(pack, (size_t)n*sizeof(MarkerPack), 1, fp);
+
+		for(i = 0; i < n; i++)
+		{
+			MarkerUnpackCompact(pack[i], actx->markers[start+i]);
+		}
+	}
+
+	ierr = PetscFree(pack); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVWriteCompact(AdvCtx *actx, FILE *fp)
+{
+	// write compact marker records in chunks
+
+	MarkerPack *pack;
+	PetscInt    i, n, start;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscMalloc((size_t)_pack_chunk_*sizeof(MarkerPack), &pack); CHKERRQ(ierr);
+
+	for(start = 0; start < actx->nummark; start += n)
+	{
+		n = actx->nummark - start;
+
+		if(n > _pack_chunk_) n = _pack_chunk_;
+
+		for(i = 0; i < n; i++)
+		{
+			MarkerPackCompact(actx->markers[start+i], pack[i]);
+		}
+
+		fwrite(pack, (size_t)n*sizeof(MarkerPack), 1, fp);
+	}
+
+	ierr = PetscFree(pack); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -387,6 +599,29 @@ PetscErrorCode ADVCreateData(AdvCtx *actx)
 	// allocate memory for marker index array separators
 	ierr = makeIntArray(&actx->markstart, NULL, fs->nCells + 1); CHKERRQ(ierr);
 
+	// compute space-filling curve ordering of cells for marker sorting
+	ierr = ADVGetCellOrder(actx); CHKERRQ(ierr);
+
+	// reset persistent exchange buffers
+	actx->sendbuf = NULL;
+	actx->recvbuf = NULL;
+	actx->idel    = NULL;
+	actx->ldel    = NULL;
+	actx->sendcap = 0;
+	actx->recvcap = 0;
+	actx->delcap  = 0;
+
+	// create persistent requests for communicating number of markers
+	ierr = ADVCreateNumMarkReq(actx); CHKERRQ(ierr);
+
+	// reset timers
+	actx->tadv  = 0.0;
+	actx->texch = 0.0;
+	actx->tmap  = 0.0;
+	actx->tctrl = 0.0;
+	actx->tsort = 0.0;
+	actx->tproj = 0.0;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -400,14 +635,13 @@ PetscErrorCode ADVDestroy(AdvCtx *actx)
 	// check activation
  	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
+	ierr = ADVDestroyMPIBuff(actx);     CHKERRQ(ierr);
 	ierr = MPI_Comm_free(&actx->icomm); CHKERRQ(ierr);
 	ierr = PetscFree(actx->markers);    CHKERRQ(ierr);
 	ierr = PetscFree(actx->cellnum);    CHKERRQ(ierr);
 	ierr = PetscFree(actx->markind);    CHKERRQ(ierr);
 	ierr = PetscFree(actx->markstart);  CHKERRQ(ierr);
-	ierr = PetscFree(actx->sendbuf);    CHKERRQ(ierr);
-	ierr = PetscFree(actx->recvbuf);    CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel);       CHKERRQ(ierr);
+	ierr = PetscFree(actx->cellord);    CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -452,7 +686,8 @@ PetscErrorCode ADVReAllocStorage(AdvCtx *actx, PetscInt nummark)
 	// or fixed maximum number markers per cell + deleting excessive markers.
 	// The latter has an advantage of maintaining memory locality).
 
-	Marker *markers;
+	Marker   *markers;
+	PetscInt *cellnum;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -464,10 +699,19 @@ PetscErrorCode ADVReAllocStorage(AdvCtx *actx, PetscInt nummark)
 		actx->markcap = (PetscInt)(_cap_overhead_*(PetscScalar)nummark);
 
 		// reallocate memory for host cell and marker-in-cell indices
+		ierr = makeIntArray(&cellnum, NULL, actx->markcap); CHKERRQ(ierr);
+
+		// keep host cells of current markers (mapping guess)
+		if(actx->nummark)
+		{
+			ierr = PetscMemcpy(cellnum, actx->cellnum, (size_t)actx->nummark*sizeof(PetscInt)); CHKERRQ(ierr);
+		}
+
 		ierr = PetscFree(actx->cellnum); CHKERRQ(ierr);
 		ierr = PetscFree(actx->markind); CHKERRQ(ierr);
 
-		ierr = makeIntArray(&actx->cellnum, NULL, actx->markcap); CHKERRQ(ierr);
+		actx->cellnum = cellnum;
+
 		ierr = makeIntArray(&actx->markind, NULL, actx->markcap); CHKERRQ(ierr);
 
 		// reallocate memory for markers
@@ -494,11 +738,15 @@ PetscErrorCode ADVAdvect(AdvCtx *actx)
 	// MAJOR ADVECTION ROUTINE
 	//=======================================================================
 
+	PetscLogDouble t0, t1;
+
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+
 	// project history INCREMENTS from grid to markers
 	ierr = ADVProjHistGridToMark(actx); CHKERRQ(ierr);
 
@@ -513,6 +761,10 @@ PetscErrorCode ADVAdvect(AdvCtx *actx)
 		ierr = ADVAdvectMark(actx); CHKERRQ(ierr);
 	}
 
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+
+	actx->tadv += t1 - t0;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -522,6 +774,8 @@ PetscErrorCode ADVRemap(AdvCtx *actx)
 	// MAJOR ADVECTION REMAPPING
 	//=======================================================================
 
+	PetscLogDouble t0, t1, tmap;
+
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
@@ -532,6 +786,12 @@ PetscErrorCode ADVRemap(AdvCtx *actx)
 
 		PetscFunctionReturn(0);
 	}
+
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+
+	// store mapping time to separate it from marker control time
+	tmap = actx->tmap;
+
 	if(actx->mctrl == CTRL_NONE)
 	{
 
@@ -577,14 +837,30 @@ PetscErrorCode ADVRemap(AdvCtx *actx)
 		PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
 	}
 
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+
+	actx->tctrl += (t1 - t0) - (actx->tmap - tmap);
+
+	// reorder marker storage to restore memory locality (if requested)
+	ierr = ADVSortMarkers(actx); CHKERRQ(ierr);
+
 	// change marker phase when crossing flat surface or free surface with fast sedimentation/erosion
 	ierr = ADVMarkCrossFreeSurf(actx); CHKERRQ(ierr);
 
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+
 	// project advected history from markers back to grid
 	ierr = ADVProjHistMarkToGrid(actx); CHKERRQ(ierr);
 
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+
+	actx->tproj += t1 - t0;
+
 	// project melt extraction marker history
 
+	// print timing of marker phases (if requested)
+	ierr = ADVPrintTiming(actx); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -596,31 +872,36 @@ PetscErrorCode ADVExchange(AdvCtx *actx)
 	// Exchange markers between the processors resulting from the position change
 	//=======================================================================
 
+	PetscLogDouble t0, t1;
+
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+
 	// count number of markers to be sent to each neighbor domain
 	ierr = ADVMapMarkToDomains(actx); CHKERRQ(ierr);
 
-	// communicate number of markers with neighbor processes
+	// start communicating number of markers with neighbor processes
 	ierr = ADVExchangeNumMark(actx); CHKERRQ(ierr);
 
-	// create send and receive buffers for asynchronous MPI communication
+	// pack send buffer (overlaps with communication of marker numbers)
 	ierr = ADVCreateMPIBuff(actx); CHKERRQ(ierr);
 
 	// apply periodic marker advection
 	ierr = ADVApplyPeriodic(actx); CHKERRQ(ierr);
 
-	// communicate markers with neighbor processes
+	// communicate markers with neighbor processes, close holes in storage
 	ierr = ADVExchangeMark(actx); CHKERRQ(ierr);
 
-	// store received markers, collect garbage
+	// store the rest of received markers, collect garbage
 	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
 
-	// free communication buffer
-	ierr = ADVDestroyMPIBuff(actx); CHKERRQ(ierr);
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+
+	actx->texch += t1 - t0;
 
 	PetscFunctionReturn(0);
 }
@@ -952,6 +1233,7 @@ PetscErrorCode ADVAdvectMark(AdvCtx *actx)
 PetscErrorCode ADVMapMarkToDomains(AdvCtx *actx)
 {
 	// count number of markers to be sent to each neighbor domain
+	// store indices and destinations of all departing markers (single pass)
 
 	PetscInt     i, lrank, cnt;
 	PetscMPIInt  grank;
@@ -971,17 +1253,28 @@ PetscErrorCode ADVMapMarkToDomains(AdvCtx *actx)
 		// get global & local ranks of a marker
 		ierr = FDSTAGGetPointRanks(fs, actx->markers[i].X, &lrank, &grank); CHKERRQ(ierr);
 
+		if(grank == actx->iproc) continue;
+
+		// make sure space is enough
+		if(cnt == actx->delcap)
+		{
+			ierr = ADVGrowDelBuff(actx, cnt + 1); CHKERRQ(ierr);
+		}
+
 		if(grank == -1)
 		{
-			// count outflow markers
-			cnt++;
+			// mark outflow marker
+			actx->ldel[cnt] = -1;
 		}
-		else if(grank != actx->iproc)
+		else
 		{
 			// count markers that should be sent to each neighbor
+			actx->ldel[cnt] = lrank;
 			actx->nsendm[lrank]++;
-			cnt++;
 		}
+
+		// store index of marker to be deleted from storage
+		actx->idel[cnt++] = i;
 	}
 
 	// store number of deleted markers
@@ -990,98 +1283,142 @@ PetscErrorCode ADVMapMarkToDomains(AdvCtx *actx)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode ADVGrowDelBuff(AdvCtx *actx, PetscInt ndel)
+{
+	// grow buffers of deleted marker indices (keep current contents)
+
+	PetscInt *idel, *ldel, delcap;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(ndel <= actx->delcap) PetscFunctionReturn(0);
+
+	delcap = (PetscInt)(_cap_overhead_*(PetscScalar)ndel);
+
+	if(delcap < _mark_buff_sz_) delcap = _mark_buff_sz_;
+
+	ierr = makeIntArray(&idel, NULL, delcap); CHKERRQ(ierr);
+	ierr = makeIntArray(&ldel, NULL, delcap); CHKERRQ(ierr);
+
+	if(actx->delcap)
+	{
+		ierr = PetscMemcpy(idel, actx->idel, (size_t)actx->delcap*sizeof(PetscInt)); CHKERRQ(ierr);
+		ierr = PetscMemcpy(ldel, actx->ldel, (size_t)actx->delcap*sizeof(PetscInt)); CHKERRQ(ierr);
+	}
+
+	ierr = PetscFree(actx->idel); CHKERRQ(ierr);
+	ierr = PetscFree(actx->ldel); CHKERRQ(ierr);
+
+	actx->idel   = idel;
+	actx->ldel   = ldel;
+	actx->delcap = delcap;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVExchangeNumMark(AdvCtx *actx)
 {
-	// communicate number of markers with neighbor processes
+	// start communicating number of markers with neighbor processes
+	// NOTE: completion is checked in ADVWaitNumMark
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(actx->nnreq)
+	{
+		ierr = MPI_Startall(actx->nnreq, actx->nreq); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVWaitNumMark(AdvCtx *actx)
+{
+	// complete communication of marker numbers, setup receive buffer
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(actx->nnreq)
+	{
+		ierr = MPI_Waitall(actx->nnreq, actx->nreq, MPI_STATUSES_IGNORE); CHKERRQ(ierr);
+	}
+
+	// compute receive buffer pointers
+	actx->nrecv = getPtrCnt(_num_neighb_, actx->nrecvm, actx->ptrecv);
+
+	// make sure space is enough
+	ierr = ADVGetMPIBuff(actx, 0, actx->nrecv, 0); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVCreateNumMarkReq(AdvCtx *actx)
+{
+	// create persistent requests for communicating number of markers
+
 	FDSTAG     *fs;
 	PetscInt    k;
-	PetscMPIInt scnt, rcnt;
-	MPI_Request srequest[_num_neighb_];
-	MPI_Request rrequest[_num_neighb_];
+	PetscMPIInt cnt;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = actx->fs;
-
-	// zero out message counters
-	scnt = 0;
-	rcnt = 0;
+	fs  = actx->fs;
+	cnt = 0;
 
 	// send number of markers to ALL neighbor processes (except self & non-existing)
 	for(k = 0; k < _num_neighb_; k++)
 	{
 		if(fs->neighb[k] != actx->iproc && fs->neighb[k] != -1)
 		{
-			ierr = MPI_Isend(&actx->nsendm[k], 1, MPIU_INT,
-				fs->neighb[k], 100, actx->icomm, &srequest[scnt++]); CHKERRQ(ierr);
+			ierr = MPI_Send_init(&actx->nsendm[k], 1, MPIU_INT,
+				fs->neighb[k], 100, actx->icomm, &actx->nreq[cnt++]); CHKERRQ(ierr);
 		}
 	}
 
 	// receive number of markers from ALL neighbor processes (except self & non-existing)
 	for(k = 0; k < _num_neighb_; k++)
 	{
+		actx->nrecvm[k] = 0;
+
 		if(fs->neighb[k] != actx->iproc && fs->neighb[k] != -1)
 		{
-			ierr = MPI_Irecv(&actx->nrecvm[k], 1, MPIU_INT,
-				fs->neighb[k], 100, actx->icomm, &rrequest[rcnt++]); CHKERRQ(ierr);
+			ierr = MPI_Recv_init(&actx->nrecvm[k], 1, MPIU_INT,
+				fs->neighb[k], 100, actx->icomm, &actx->nreq[cnt++]); CHKERRQ(ierr);
 		}
-		else actx->nrecvm[k] = 0;
 	}
 
-	// wait until all communication processes have been terminated
-	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
-	if(rcnt) { ierr = MPI_Waitall(rcnt, rrequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+	actx->nnreq = cnt;
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode ADVCreateMPIBuff(AdvCtx *actx)
 {
-	// create send and receive buffers for asynchronous MPI communication
+	// pack departing markers into send buffer (counting sort by destination)
+	// NOTE! Buffers are persistent and only grow, see ADVGetMPIBuff
 
-	// NOTE! Currently the memory allocation model is fully dynamic.
-	// Maybe it makes sense to introduce static model with reallocation.
-	FDSTAG     *fs;
-	PetscInt    i, cnt, lrank;
-	PetscMPIInt grank;
+	PetscInt i, lrank;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = actx->fs;
-
-	// compute buffer pointers
+	// compute send buffer pointers
 	actx->nsend = getPtrCnt(_num_neighb_, actx->nsendm, actx->ptsend);
-	actx->nrecv = getPtrCnt(_num_neighb_, actx->nrecvm, actx->ptrecv);
 
-	actx->sendbuf = NULL;
-	actx->recvbuf = NULL;
-	actx->idel    = NULL;
-
-	// allocate exchange buffers & array of deleted (sent) marker indices
-	if(actx->nsend) { ierr = PetscMalloc((size_t)actx->nsend*sizeof(Marker),   &actx->sendbuf); CHKERRQ(ierr); }
-	if(actx->nrecv) { ierr = PetscMalloc((size_t)actx->nrecv*sizeof(Marker),   &actx->recvbuf); CHKERRQ(ierr); }
-	if(actx->ndel)  { ierr = PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel);    CHKERRQ(ierr); }
+	// make sure space is enough
+	ierr = ADVGetMPIBuff(actx, actx->nsend, 0, 0); CHKERRQ(ierr);
 
-	// copy markers to send buffer, store their indices
-	for(i = 0, cnt = 0; i < actx->nummark; i++)
+	// copy markers to send buffer
+	for(i = 0; i < actx->ndel; i++)
 	{
-		// get global & local ranks of a marker
-		ierr = FDSTAGGetPointRanks(fs, actx->markers[i].X, &lrank, &grank); CHKERRQ(ierr);
+		lrank = actx->ldel[i];
 
-		if(grank == -1)
-		{
-			// delete outflow marker from the storage
-			actx->idel[cnt++] = i;
-		}
-		else if(grank != actx->iproc)
+		if(lrank != -1)
 		{
-			// store marker in the send buffer
-			actx->sendbuf[actx->ptsend[lrank]++] = actx->markers[i];
-
-			// delete marker from the storage
-			actx->idel[cnt++] = i;
+			actx->sendbuf[actx->ptsend[lrank]++] = actx->markers[actx->idel[i]];
 		}
 	}
 
@@ -1091,6 +1428,37 @@ PetscErrorCode ADVCreateMPIBuff(AdvCtx *actx)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode ADVGetMPIBuff(AdvCtx *actx, PetscInt nsend, PetscInt nrecv, PetscInt ndel)
+{
+	// make sure exchange buffers can hold requested number of entries
+	// buffers only grow, contents are NOT preserved (except deleted indices)
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(nsend > actx->sendcap)
+	{
+		ierr = PetscFree(actx->sendbuf); CHKERRQ(ierr);
+
+		actx->sendcap = (PetscInt)(_cap_overhead_*(PetscScalar)nsend);
+
+		ierr = PetscMalloc((size_t)actx->sendcap*sizeof(Marker), &actx->sendbuf); CHKERRQ(ierr);
+	}
+
+	if(nrecv > actx->recvcap)
+	{
+		ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
+
+		actx->recvcap = (PetscInt)(_cap_overhead_*(PetscScalar)nrecv);
+
+		ierr = PetscMalloc((size_t)actx->recvcap*sizeof(Marker), &actx->recvbuf); CHKERRQ(ierr);
+	}
+
+	ierr = ADVGrowDelBuff(actx, ndel); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVApplyPeriodic(AdvCtx *actx)
 {
 	// apply periodic marker advection
@@ -1159,8 +1527,12 @@ PetscErrorCode ADVApplyPeriodic(AdvCtx *actx)
 PetscErrorCode ADVExchangeMark(AdvCtx *actx)
 {
 	// communicate markers with neighbor processes
+	// received markers are stored in the holes of the storage in neighbor order
+	// (independent of message arrival, so that runs are reproducible)
+
 	FDSTAG     *fs;
-	PetscInt    k;
+	Marker     *recv;
+	PetscInt    k, n, nrest[_num_neighb_];
 	PetscMPIInt scnt, rcnt, nbyte;
 	MPI_Request srequest[_num_neighb_];
 	MPI_Request rrequest[_num_neighb_];
@@ -1187,9 +1559,14 @@ PetscErrorCode ADVExchangeMark(AdvCtx *actx)
 		}
 	}
 
+	// get number of markers to be received
+	ierr = ADVWaitNumMark(actx); CHKERRQ(ierr);
+
 	// receive packages (if any) with markers from neighbor processes
 	for(k = 0; k < _num_neighb_; k++)
 	{
+		nrest[k] = 0;
+
 		if(actx->nrecvm[k])
 		{
 			nbyte = (PetscMPIInt)(actx->nrecvm[k]*(PetscInt)sizeof(Marker));
@@ -1199,22 +1576,66 @@ PetscErrorCode ADVExchangeMark(AdvCtx *actx)
 		}
 	}
 
-	// wait until all communication processes have been terminated
-	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+	// wait until all receive processes have been terminated
 	if(rcnt) { ierr = MPI_Waitall(rcnt, rrequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
 
+	// close holes in marker storage in fixed neighbor order
+	// (host cells of received markers are unknown)
+	for(k = 0; k < _num_neighb_; k++)
+	{
+		recv = actx->recvbuf + actx->ptrecv[k];
+
+		for(n = 0; n < actx->nrecvm[k] && actx->ndel; n++)
+		{
+			actx->ndel--;
+			actx->markers[actx->idel[actx->ndel]] = recv[n];
+			actx->cellnum[actx->idel[actx->ndel]] = -1;
+		}
+
+		// store number of markers left in the package
+		nrest[k] = actx->nrecvm[k] - n;
+	}
+
+	// move the rest of received markers to the beginning of the buffer
+	for(k = 0, actx->nrecv = 0; k < _num_neighb_; k++)
+	{
+		recv = actx->recvbuf + actx->ptrecv[k] + actx->nrecvm[k] - nrest[k];
+
+		for(n = 0; n < nrest[k]; n++)
+		{
+			actx->recvbuf[actx->nrecv++] = recv[n];
+		}
+	}
+
+	// wait until all send processes have been terminated
+	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode ADVDestroyMPIBuff(AdvCtx *actx)
 {
+	// destroy persistent exchange buffers & requests
+
+	PetscMPIInt i;
+
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	// destroy buffers
+	for(i = 0; i < actx->nnreq; i++)
+	{
+		ierr = MPI_Request_free(&actx->nreq[i]); CHKERRQ(ierr);
+	}
+
 	ierr = PetscFree(actx->sendbuf); CHKERRQ(ierr);
 	ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel);  	 CHKERRQ(ierr);
+	ierr = PetscFree(actx->idel);    CHKERRQ(ierr);
+	ierr = PetscFree(actx->ldel);    CHKERRQ(ierr);
+
+	actx->nnreq   = 0;
+	actx->sendcap = 0;
+	actx->recvcap = 0;
+	actx->delcap  = 0;
 
 	PetscFunctionReturn(0);
 }
@@ -1224,7 +1645,7 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 	// store received markers, collect garbage
 
 	Marker   *markers, *recvbuf;
-	PetscInt *idel, nummark, nrecv, ndel;
+	PetscInt *idel, *cellnum, nummark, nrecv, ndel;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -1232,6 +1653,7 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 	// access storage
 	nummark = actx->nummark;
 	markers = actx->markers;
+	cellnum = actx->cellnum;
 
 	nrecv   = actx->nrecv;
 	recvbuf = actx->recvbuf;
@@ -1240,9 +1662,11 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 	idel    = actx->idel;
 
 	// close holes in marker storage
+	// (host cells of received markers are unknown)
 	while(nrecv && ndel)
 	{
 		markers[idel[ndel-1]] = recvbuf[nrecv-1];
+		cellnum[idel[ndel-1]] = -1;
 		nrecv--;
 		ndel--;
 	}
@@ -1254,10 +1678,12 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 
 		// make sure we have a correct storage pointer
 		markers = actx->markers;
+		cellnum = actx->cellnum;
 
 		// put the rest in the end of marker storage
 		while(nrecv)
 		{
+			cellnum[nummark]   = -1;
 			markers[nummark++] = recvbuf[nrecv-1];
 			nrecv--;
 		}
@@ -1271,6 +1697,7 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 			if(idel[ndel-1] != nummark-1)
 			{
 				markers[idel[ndel-1]] = markers[nummark-1];
+				cellnum[idel[ndel-1]] = cellnum[nummark-1];
 			}
 			nummark--;
 			ndel--;
@@ -1288,13 +1715,16 @@ PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 	// store host cell ID for every marker & list of marker IDs in every cell
 	// NOTE: this routine MUST be called for the local markers only
 
-	FDSTAG      *fs;
-	PetscScalar *X;
-	PetscInt     i, ID, I, J, K, M, N, nummark;
+	FDSTAG        *fs;
+	PetscScalar   *X;
+	PetscInt       i, ID, I, J, K, M, N, nummark;
+	PetscLogDouble t0, t1;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+
 	// get context
 	fs = actx->fs;
 	M  = fs->dsx.ncels;
@@ -1306,10 +1736,22 @@ PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 		// get marker coordinates
 		X = actx->markers[i].X;
 
-		// get host cell IDs in all directions
-		ierr = Discret1DFindPoint(&fs->dsx, X[0], I); CHKERRQ(ierr);
-		ierr = Discret1DFindPoint(&fs->dsy, X[1], J); CHKERRQ(ierr);
-		ierr = Discret1DFindPoint(&fs->dsz, X[2], K); CHKERRQ(ierr);
+		// get previous host cell as a guess (negative if unknown)
+		ID = actx->cellnum[i];
+
+		if(ID >= 0 && ID < fs->nCells)
+		{
+			GET_CELL_IJK(ID, I, J, K, M, N);
+		}
+		else
+		{
+			I = J = K = -1;
+		}
+
+		// get host cell IDs in all directions (neighbors first)
+		ierr = Discret1DFindPointNear(&fs->dsx, X[0], I); CHKERRQ(ierr);
+		ierr = Discret1DFindPointNear(&fs->dsy, X[1], J); CHKERRQ(ierr);
+		ierr = Discret1DFindPointNear(&fs->dsz, X[2], K); CHKERRQ(ierr);
 
 		// compute and store consecutive index
 		GET_CELL_ID(ID, I, J, K, M, N);
@@ -1354,6 +1796,253 @@ PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 	// set end-of-array index
 	actx->markstart[fs->nCells] = nummark;
 
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+
+	actx->tmap += t1 - t0;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static inline unsigned long long ADVGetMortonKey(PetscInt I, PetscInt J, PetscInt K)
+{
+	// interleave bits of cell indices (Morton code)
+
+	unsigned long long key = 0, bit;
+	PetscInt           b;
+
+	for(b = 0; b < 21; b++)
+	{
+		bit  = 1ULL << b;
+		key |= ((unsigned long long)(I & bit)) << (2*b);
+		key |= ((unsigned long long)(J & bit)) << (2*b + 1);
+		key |= ((unsigned long long)(K & bit)) << (2*b + 2);
+	}
+
+	return key;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVGetCellOrder(AdvCtx *actx)
+{
+	// compute Morton (Z-order) curve ordering of local cells
+
+	FDSTAG   *fs;
+	PetscInt  ID, I, J, K, M, N;
+
+	vector <pair <unsigned long long, PetscInt> > order;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs = actx->fs;
+	M  = fs->dsx.ncels;
+	N  = fs->dsy.ncels;
+
+	ierr = makeIntArray(&actx->cellord, NULL, fs->nCells); CHKERRQ(ierr);
+
+	order.resize((size_t)fs->nCells);
+
+	for(ID = 0; ID < fs->nCells; ID++)
+	{
+		GET_CELL_IJK(ID, I, J, K, M, N);
+
+		order[(size_t)ID] = make_pair(ADVGetMortonKey(I, J, K), ID);
+	}
+
+	sort(order.begin(), order.end());
+
+	for(ID = 0; ID < fs->nCells; ID++)
+	{
+		actx->cellord[ID] = order[(size_t)ID].second;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVSortMarkers(AdvCtx *actx)
+{
+	// reorder marker storage cell-wise along Morton curve of host cells
+	// NOTE: this routine MUST be called after marker-to-cell mapping
+
+	// Advection, injection, and exchange gradually shuffle marker storage.
+	// Sorting restores memory locality of marker-to-grid interpolation.
+	// After sorting markers of every cell occupy a contiguous range, so that
+	// markind is an identity permutation within each cell.
+
+	// Locality measure is the number of host cell switches in the storage
+	// normalized by the number of non-empty cells (unity for sorted storage).
+
+	FDSTAG         *fs;
+	Marker         *markers;
+	PetscInt       *cellnum, *markind, *markstart;
+	PetscInt        i, jj, ID, n, p, cnt, nswitch, nfill, istep, sort;
+	PetscScalar     loc;
+	PetscLogDouble  t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// check activation
+	if(!actx->sortFreq && !actx->sortTol) PetscFunctionReturn(0);
+
+	ierr = PetscTime(&t0); CHKERRQ(ierr);
+
+	fs        = actx->fs;
+	markind   = actx->markind;
+	markstart = actx->markstart;
+	istep     = actx->jr->ts->istep;
+
+	// compute locality measure
+	for(i = 1, nswitch = 1; i < actx->nummark; i++)
+	{
+		if(actx->cellnum[i] != actx->cellnum[i-1]) nswitch++;
+	}
+
+	for(ID = 0, nfill = 0; ID < fs->nCells; ID++)
+	{
+		if(markstart[ID+1] > markstart[ID]) nfill++;
+	}
+
+	loc = 1.0;
+
+	if(nfill) loc = (PetscScalar)nswitch/(PetscScalar)nfill;
+
+	// check whether sorting is required
+	sort = 0;
+
+	if(actx->sortFreq && !(istep % actx->sortFreq)) sort = 1;
+	if(actx->sortTol  && loc > actx->sortTol)       sort = 1;
+
+	if(!sort || !actx->nummark) PetscFunctionReturn(0);
+
+	// allocate sorted storage
+	ierr = PetscMalloc((size_t)actx->markcap*sizeof(Marker), &markers); CHKERRQ(ierr);
+	ierr = makeIntArray(&cellnum, NULL, actx->markcap); CHKERRQ(ierr);
+
+	// copy markers cell-wise, update marker indices
+	for(jj = 0, cnt = 0; jj < fs->nCells; jj++)
+	{
+		ID = actx->cellord[jj];
+		n  = markstart[ID+1] - markstart[ID];
+		p  = markstart[ID];
+
+		for(i = 0; i < n; i++)
+		{
+			markers[cnt]  = actx->markers[markind[p+i]];
+			cellnum[cnt]  = ID;
+			markind[p+i]  = cnt++;
+		}
+	}
+
+	// replace storage
+	ierr = PetscFree(actx->markers); CHKERRQ(ierr);
+	ierr = PetscFree(actx->cellnum); CHKERRQ(ierr);
+
+	actx->markers = markers;
+	actx->cellnum = cellnum;
+
+	ierr = PetscTime(&t1); CHKERRQ(ierr);
+
+	actx->tsort += t1 - t0;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVPrintTiming(AdvCtx *actx)
+{
+	// print timing of marker phases of current time step (maximum over ranks)
+
+	PetscLogDouble ltime[6], gtime[6];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!actx->logTime) PetscFunctionReturn(0);
+
+	ltime[0] = actx->tadv;
+	ltime[1] = actx->texch;
+	ltime[2] = actx->tmap;
+	ltime[3] = actx->tctrl;
+	ltime[4] = actx->tsort;
+	ltime[5] = actx->tproj;
+
+	if(ISParallel(PETSC_COMM_WORLD))
+	{
+		ierr = MPI_Reduce(ltime, gtime, 6, MPI_DOUBLE, MPI_MAX, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = PetscMemcpy(gtime, ltime, 6*sizeof(PetscLogDouble)); CHKERRQ(ierr);
+	}
+
+	PetscPrintf(PETSC_COMM_WORLD,"Marker phase timing (max over ranks):\n");
+	PetscPrintf(PETSC_COMM_WORLD,"   Advection                     : %1.4e s\n", gtime[0]);
+	PetscPrintf(PETSC_COMM_WORLD,"   Exchange                      : %1.4e s\n", gtime[1]);
+	PetscPrintf(PETSC_COMM_WORLD,"   Marker-to-cell mapping        : %1.4e s\n", gtime[2]);
+	PetscPrintf(PETSC_COMM_WORLD,"   Marker control                : %1.4e s\n", gtime[3]);
+	PetscPrintf(PETSC_COMM_WORLD,"   Sorting                       : %1.4e s\n", gtime[4]);
+	PetscPrintf(PETSC_COMM_WORLD,"   Projection to grid            : %1.4e s\n", gtime[5]);
+	PetscPrintf(PETSC_COMM_WORLD,"   Total                         : %1.4e s\n",
+		gtime[0] + gtime[1] + gtime[2] + gtime[3] + gtime[4] + gtime[5]);
+
+	// reset timers
+	actx->tadv  = 0.0;
+	actx->texch = 0.0;
+	actx->tmap  = 0.0;
+	actx->tctrl = 0.0;
+	actx->tsort = 0.0;
+	actx->tproj = 0.0;
+
+	// report memory usage
+	ierr = ADVPrintMemory(actx); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVPrintMemory(AdvCtx *actx)
+{
+	// print memory usage of marker storage (min, max, total over ranks)
+	// markers are always stored in memory and exchanged as full-precision Marker
+	// structures, compact records only apply to restart files
+
+	FDSTAG        *fs;
+	PetscLogDouble lmem[3], gmem[3];
+	size_t         nbyte, nrec;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// report is requested together with marker timing
+	if(!actx->logTime) PetscFunctionReturn(0);
+
+	fs = actx->fs;
+
+	// markers, host cells & marker indices
+	nbyte  = (size_t)actx->markcap*(sizeof(Marker) + 2*sizeof(PetscInt));
+
+	// cell separators & cell ordering
+	nbyte += (size_t)(2*fs->nCells + 1)*sizeof(PetscInt);
+
+	// convert to megabytes
+	lmem[0] = -(PetscLogDouble)nbyte/1024.0/1024.0;
+	lmem[1] =  (PetscLogDouble)nbyte/1024.0/1024.0;
+	lmem[2] =  (PetscLogDouble)nbyte/1024.0/1024.0;
+
+	if(ISParallel(PETSC_COMM_WORLD))
+	{
+		ierr = MPI_Reduce(lmem,   gmem,   2, MPI_DOUBLE, MPI_MAX, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+		ierr = MPI_Reduce(lmem+2, gmem+2, 1, MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = PetscMemcpy(gmem, lmem, 3*sizeof(PetscLogDouble)); CHKERRQ(ierr);
+	}
+
+	// size of restart record
+	nrec = actx->compact ? sizeof(MarkerPack) : sizeof(Marker);
+
+	PetscPrintf(PETSC_COMM_WORLD,"Marker storage memory [MB] (min/max/total): %g / %g / %g\n", -gmem[0], gmem[1], gmem[2]);
+	PetscPrintf(PETSC_COMM_WORLD,"Bytes per marker (in memory & exchange / restart record): %lld / %lld\n", (LLD)sizeof(Marker), (LLD)nrec);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1361,6 +2050,7 @@ PetscErrorCode ADVMarkControl(AdvCtx *actx)
 {
 	// check marker distribution and delete or inject markers if necessary
 	FDSTAG         *fs;
+	AVD            A;
 	PetscScalar    xs[3], xe[3];
 	PetscInt       ind, i, j, k, M, N;
 	PetscInt       n, ninj, ndel;
@@ -1399,14 +2089,16 @@ PetscErrorCode ADVMarkControl(AdvCtx *actx)
 	actx->nrecv = ninj;
 	actx->ndel  = ndel;
 
-	// allocate memory
-	if(ninj) { ierr = PetscMalloc((size_t)actx->nrecv*sizeof(Marker),   &actx->recvbuf); CHKERRQ(ierr); }
-	if(ndel) { ierr = PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel);    CHKERRQ(ierr); }
+	// make sure space is enough
+	ierr = ADVGetMPIBuff(actx, 0, ninj, ndel); CHKERRQ(ierr);
 
 	actx->cinj = 0;
 	actx->cdel = 0;
 	ind        = 0;
 
+	// AVD storage is shared by all cells
+	ierr = PetscMemzero(&A, sizeof(AVD)); CHKERRQ(ierr);
+
 	// inject/delete
 	for(ind = 0; ind < fs->nCells; ind++)
 	{
@@ -1424,10 +2116,13 @@ PetscErrorCode ADVMarkControl(AdvCtx *actx)
 			xs[2] = fs->dsz.ncoor[k]; xe[2] = fs->dsz.ncoor[k+1];
 
 			// inject/delete markers
-			ierr = AVDExecuteMarkerInjection(actx, n, xs, xe, ind); CHKERRQ(ierr);
+			ierr = AVDExecuteMarkerInjection(actx, &A, n, xs, xe, ind); CHKERRQ(ierr);
 		}
 	}
 
+	// destroy AVD structure
+	ierr = AVDDestroy(&A); CHKERRQ(ierr);
+
 	// store new markers
 	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
 
@@ -1438,10 +2133,6 @@ PetscErrorCode ADVMarkControl(AdvCtx *actx)
 	ierr = PetscTime(&t1); CHKERRQ(ierr);
 	PetscPrintf(PETSC_COMM_WORLD,"Marker control [%lld]: (AVD Cell) injected %lld markers and deleted %lld markers in %1.4e s\n",(LLD)actx->iproc, (LLD)ninj, (LLD)ndel, t1-t0);
 
-	// clear
-	ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel);    CHKERRQ(ierr);
-
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1544,7 +2235,7 @@ PetscErrorCode ADVCheckCorners(AdvCtx *actx)
 	
 	// allocate memory for new markers
 	actx->nrecv = ninj;
-	ierr = PetscMalloc((size_t)actx->nrecv*sizeof(Marker), &actx->recvbuf); CHKERRQ(ierr);
+	ierr = ADVGetMPIBuff(actx, 0, actx->nrecv, 0); CHKERRQ(ierr);
 	ierr = PetscMemzero(actx->recvbuf, (size_t)actx->nrecv*sizeof(Marker)); CHKERRQ(ierr);
 
 	// initialize the random number generator
@@ -1707,8 +2398,7 @@ PetscErrorCode ADVCheckCorners(AdvCtx *actx)
 	PetscPrintf(PETSC_COMM_WORLD,"Marker control [%lld]: (Corners ) injected %lld markers in %1.4e s \n",(LLD)actx->iproc, (LLD)ninj, t1-t0);
 
 	// clear
-	ierr = PetscFree(numcorner);     CHKERRQ(ierr);
-	ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
+	ierr = PetscFree(numcorner); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
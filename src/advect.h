@@ -39,12 +39,44 @@ struct Marker
 	Tensor2RS   S;     // deviatoric stress
 	PetscScalar U[3];  // displacement
 
-	// WARNING! after adding new field modify marker merge routine (below)
+	// WARNING! after adding new field modify marker merge & pack routines (below)
 };
 
 // merge two markers and average history and position C = (A + B)/2
 PetscErrorCode MarkerMerge(Marker &A, Marker &B, Marker &C);
 
+//---------------------------------------------------------------------------
+//.................   Compact marker record (restart)   .....................
+//---------------------------------------------------------------------------
+
+// Position, pressure and temperature are kept in full precision, history
+// variables that are only accumulated (strain, stress, displacement) are
+// stored in single precision. The record size is reduced from 136 to 88 bytes.
+// Records are only used for restart files. The marker storage and exchange
+// messages always consist of full-precision Marker structures, so that the
+// history does not depend on the domain decomposition.
+
+struct MarkerPack
+{
+	PetscScalar X[3];  // global coordinates
+	PetscScalar p;     // pressure
+	PetscScalar T;     // temperature
+	float       APS;   // accumulated plastic strain
+	float       ATS;   // accumulated total strain
+	float       S[6];  // deviatoric stress (xx, yy, zz, xy, xz, yz)
+	float       U[3];  // displacement
+	int         phase; // phase identifier
+};
+
+// pack marker into compact record
+void MarkerPackCompact(Marker &A, MarkerPack &B);
+
+// unpack marker from compact record
+void MarkerUnpackCompact(MarkerPack &A, Marker &B);
+
+// hash of marker coordinates (independent of storage order and domain decomposition)
+uint64_t MarkerHash(Marker &A);
+
 //---------------------------------------------------------------------------
 
 // marker initialization type enumeration
@@ -52,7 +84,8 @@ enum SetupType
 {
 	_GEOM_,    // read geometric primitives from input file
 	_FILES_,   // read coordinates, phase and temperature from files in parallel
-	_POLYGONS_ // read polygons from file redundantly
+	_POLYGONS_,// read polygons from file redundantly
+	_SHARED_   // read coordinates, phase and temperature from single shared file (MPI-IO)
 
 };
 
@@ -146,6 +179,7 @@ struct AdvCtx
 	PetscScalar   A;                   // FDSTAG velocity interpolation parameter
 
 	MarkCtrlType  mctrl;               // marker control type
+	PetscInt      compact;             // compact marker restart records flag
 
 	//====================
 	// RUN TIME PARAMETERS
@@ -155,6 +189,24 @@ struct AdvCtx
 	PetscInt    avdx, avdy, avdz; // AVD cells refinement factors
 	PetscInt    npmax;            // maximum number of same phase markers per subcell
 
+	//========
+	// SORTING
+	//========
+	PetscInt    sortFreq;         // marker sorting frequency (number of steps, 0 - deactivate)
+	PetscScalar sortTol;          // locality measure triggering marker sorting (0 - deactivate)
+	PetscInt   *cellord;          // local cells ordered along Morton (Z-order) curve
+
+	//=======
+	// TIMING
+	//=======
+	PetscInt       logTime;       // print timing of marker phases flag
+	PetscLogDouble tadv;          // marker advection time
+	PetscLogDouble texch;         // marker exchange time
+	PetscLogDouble tmap;          // marker-to-cell mapping time
+	PetscLogDouble tctrl;         // marker control time
+	PetscLogDouble tsort;         // marker sorting time
+	PetscLogDouble tproj;         // marker-to-grid projection time
+
 	//=============
 	// COMMUNICATOR
 	//=============
@@ -180,8 +232,13 @@ struct AdvCtx
 	//=========
 	// EXCHANGE
 	//=========
-	Marker   *sendbuf; // send buffer
-	Marker   *recvbuf; // receive buffer
+	Marker   *sendbuf; // send buffer (persistent, grow-only)
+	Marker   *recvbuf; // receive buffer (persistent, grow-only)
+	PetscInt  sendcap; // capacity of send buffer
+	PetscInt  recvcap; // capacity of receive buffer
+
+	MPI_Request nreq[2*_num_neighb_]; // persistent requests for number of markers
+	PetscMPIInt nnreq;                // number of persistent requests
 
 	PetscInt  nsend;                // total number of markers to be sent (local)
 	PetscInt  nsendm[_num_neighb_]; // number of markers to be sent to each process
@@ -191,8 +248,10 @@ struct AdvCtx
 	PetscInt  nrecvm[_num_neighb_]; // number of markers to be received from each process
 	PetscInt  ptrecv[_num_neighb_]; // receive buffer pointers
 
-	PetscInt  ndel; // number of markers to be deleted from storage
-	PetscInt *idel; // indices of markers to be deleted
+	PetscInt  ndel;   // number of markers to be deleted from storage
+	PetscInt *idel;   // indices of markers to be deleted
+	PetscInt *ldel;   // destinations of markers to be deleted (local neighbor rank, -1 - outflow)
+	PetscInt  delcap; // capacity of deleted marker buffers
 
 };
 
@@ -208,6 +267,17 @@ PetscErrorCode ADVReadRestart(AdvCtx *actx, FILE *fp);
 // read advection object from restart database
 PetscErrorCode ADVWriteRestart(AdvCtx *actx, FILE *fp);
 
+// partition-independent restart (markers in a spatially indexed shared file)
+PetscErrorCode ADVWriteRestartPortable(AdvCtx *actx, const char *filename);
+
+PetscErrorCode ADVReadRestartPortable(AdvCtx *actx, const char *filename);
+
+// read compact marker records from restart database
+PetscErrorCode ADVReadCompact(AdvCtx *actx, FILE *fp);
+
+// write compact marker records to restart database
+PetscErrorCode ADVWriteCompact(AdvCtx *actx, FILE *fp);
+
 // create communicator and separator
 PetscErrorCode ADVCreateData(AdvCtx *actx);
 
@@ -238,15 +308,27 @@ PetscErrorCode ADVInterpFieldToMark(AdvCtx *actx, InterpCase icase);
 // update marker positions from current velocities & time step
 PetscErrorCode ADVAdvectMark(AdvCtx *actx);
 
-// count number of markers to be sent to each neighbor domain
+// count number of markers to be sent to each neighbor domain, store departing markers
 PetscErrorCode ADVMapMarkToDomains(AdvCtx *actx);
 
-// communicate number of markers with neighbor processes
+// grow buffers of deleted marker indices
+PetscErrorCode ADVGrowDelBuff(AdvCtx *actx, PetscInt ndel);
+
+// start communicating number of markers with neighbor processes
 PetscErrorCode ADVExchangeNumMark(AdvCtx *actx);
 
-// create send and receive buffers for asynchronous MPI communication
+// complete communication of marker numbers, setup receive buffer
+PetscErrorCode ADVWaitNumMark(AdvCtx *actx);
+
+// create persistent requests for communicating number of markers
+PetscErrorCode ADVCreateNumMarkReq(AdvCtx *actx);
+
+// pack departing markers into send buffer
 PetscErrorCode ADVCreateMPIBuff(AdvCtx *actx);
 
+// make sure exchange buffers are large enough
+PetscErrorCode ADVGetMPIBuff(AdvCtx *actx, PetscInt nsend, PetscInt nrecv, PetscInt ndel);
+
 // apply periodic marker advection
 PetscErrorCode ADVApplyPeriodic(AdvCtx *actx);
 
@@ -256,12 +338,24 @@ PetscErrorCode ADVExchangeMark(AdvCtx *actx);
 // store received markers, collect garbage
 PetscErrorCode ADVCollectGarbage(AdvCtx *actx);
 
-// free communication buffer
+// free persistent communication buffers & requests
 PetscErrorCode ADVDestroyMPIBuff(AdvCtx *actx);
 
 // store host cell ID for every marker & list of marker IDs in every cell
 PetscErrorCode ADVMapMarkToCells(AdvCtx *actx);
 
+// compute Morton (Z-order) curve ordering of local cells
+PetscErrorCode ADVGetCellOrder(AdvCtx *actx);
+
+// reorder marker storage cell-wise along Morton curve (if requested)
+PetscErrorCode ADVSortMarkers(AdvCtx *actx);
+
+// print timing of marker phases of current time step
+PetscErrorCode ADVPrintTiming(AdvCtx *actx);
+
+// print memory usage of marker storage (min, max, total over ranks)
+PetscErrorCode ADVPrintMemory(AdvCtx *actx);
+
 // project history fields from markers to grid
 PetscErrorCode ADVProjHistMarkToGrid(AdvCtx *actx);
 
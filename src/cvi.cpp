@@ -184,8 +184,7 @@ PetscErrorCode ADVelAdvectScheme(AdvCtx *actx, AdvVelCtx *vi)
 	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
 
 	// clear memory
-	ierr = ADVelDestroy(vi);      CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel); CHKERRQ(ierr);
+	ierr = ADVelDestroy(vi); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -268,6 +267,11 @@ PetscErrorCode ADVelCreate(AdvCtx *actx, AdvVelCtx *vi)
 	vi->ndel = 0;
 	vi->idel = NULL;
 
+	vi->nbnd    = 0;
+	vi->nbndcap = 0;
+	vi->ibnd    = NULL;
+	vi->lbnd    = NULL;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -285,6 +289,8 @@ PetscErrorCode ADVelDestroy(AdvVelCtx *vi)
 	ierr = PetscFree(vi->sendbuf);   CHKERRQ(ierr);
 	ierr = PetscFree(vi->recvbuf);   CHKERRQ(ierr);
 	ierr = PetscFree(vi->idel);      CHKERRQ(ierr);
+	ierr = PetscFree(vi->ibnd);      CHKERRQ(ierr);
+	ierr = PetscFree(vi->lbnd);      CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -350,45 +356,57 @@ PetscErrorCode ADVelInitCoord(AdvCtx *actx, VelInterp *interp, PetscInt n)
 //---------------------------------------------------------------------------
 PetscErrorCode ADVelCalcEffVel(VelInterp *interp, PetscInt n, PetscScalar a)
 {
-	PetscInt     jj;
-
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// scan all markers
-	for(jj = 0; jj < n; jj++)
+	ierr = ThreadFor(n, _thread_grain_, [&](PetscInt beg, PetscInt end, PetscInt)
 	{
-		interp[jj].v_eff[0] += a*interp[jj].v[0];
-		interp[jj].v_eff[1] += a*interp[jj].v[1];
-		interp[jj].v_eff[2] += a*interp[jj].v[2];
-	}
+		for(PetscInt jj = beg; jj < end; jj++)
+		{
+			interp[jj].v_eff[0] += a*interp[jj].v[0];
+			interp[jj].v_eff[1] += a*interp[jj].v[1];
+			interp[jj].v_eff[2] += a*interp[jj].v[2];
+		}
+	}); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode ADVelAdvectCoord(VelInterp *interp, PetscInt n, PetscScalar dt, PetscInt type)
 {
-	PetscInt     jj;
-
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	// scan all markers
-	for(jj = 0; jj < n; jj++)
+	ierr = ThreadFor(n, _thread_grain_, [&](PetscInt beg, PetscInt end, PetscInt)
 	{
+		VelInterp *P;
+
 		if (type==1)
 		{
 			// final advection of marker
-			interp[jj].x[0] += interp[jj].v_eff[0]*dt;
-			interp[jj].x[1] += interp[jj].v_eff[1]*dt;
-			interp[jj].x[2] += interp[jj].v_eff[2]*dt;
+			for(PetscInt jj = beg; jj < end; jj++)
+			{
+				P = interp + jj;
+
+				P->x[0] += P->v_eff[0]*dt;
+				P->x[1] += P->v_eff[1]*dt;
+				P->x[2] += P->v_eff[2]*dt;
+			}
 		}
 		else
 		{
 			// intermediate advection of marker
-			interp[jj].x[0] = interp[jj].x0[0] + interp[jj].v[0]*dt;
-			interp[jj].x[1] = interp[jj].x0[1] + interp[jj].v[1]*dt;
-			interp[jj].x[2] = interp[jj].x0[2] + interp[jj].v[2]*dt;
+			for(PetscInt jj = beg; jj < end; jj++)
+			{
+				P = interp + jj;
+
+				P->x[0] = P->x0[0] + P->v[0]*dt;
+				P->x[1] = P->x0[1] + P->v[1]*dt;
+				P->x[2] = P->x0[2] + P->v[2]*dt;
+			}
 		}
-	}
+	}); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -450,8 +468,8 @@ PetscErrorCode ADVelCollectIndices(AdvCtx *actx, AdvVelCtx *vi)
 	// if no need for injection/deletion
 	if (!actx->ndel) PetscFunctionReturn(0);
 
-	// allocate storage
-	if(actx->ndel) { ierr = PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel); CHKERRQ(ierr); }
+	// make sure space is enough
+	ierr = ADVGetMPIBuff(actx, 0, 0, actx->ndel); CHKERRQ(ierr);
 
 	// allocate storage for mapping
 	ierr = PetscMalloc((size_t)actx->nummark*sizeof(PetscInt), &p); CHKERRQ(ierr);
@@ -481,45 +499,33 @@ PetscErrorCode ADVelDeleteOutflow(AdvVelCtx *vi)
 {
 	// check if advected positions are within the box bounds
 
-	PetscInt     i, lrank, ndel;
-	PetscMPIInt  grank;
-	FDSTAG       *fs;
+	PetscInt i, ndel;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = vi->fs;
+	// get markers leaving local domain
+	ierr = ADVelGetBoundMark(vi); CHKERRQ(ierr);
 
-	// scan all markers
-	for(i = 0, ndel = 0; i < vi->nmark; i++)
+	// count markers outside
+	for(i = 0, ndel = 0; i < vi->nbnd; i++)
 	{
-		// get global & local ranks of a marker
-		ierr = FDSTAGGetPointRanks(fs, vi->interp[i].x, &lrank, &grank); CHKERRQ(ierr);
-
-		// count markers outside
-		if(grank == -1) ndel++;
+		if(vi->lbnd[i] == -1) ndel++;
 	}
 
 	// if no need for deletion return
 	if (!ndel) PetscFunctionReturn(0);
 
 	// save points to exclude
-	vi->ndel    = ndel;
+	vi->ndel = ndel;
 
 	// allocate storage
 	ierr = PetscMalloc((size_t)ndel *sizeof(PetscInt), &vi->idel); CHKERRQ(ierr);
 
 	// save markers indices to be deleted
-	for(i = 0, ndel = 0; i < vi->nmark; i++)
+	for(i = 0, ndel = 0; i < vi->nbnd; i++)
 	{
-		// get global & local ranks of a marker
-		ierr = FDSTAGGetPointRanks(fs, vi->interp[i].x, &lrank, &grank); CHKERRQ(ierr);
-
-		// save markers outside
-		if(grank == -1)
-		{
-			vi->idel[ndel++] = i;
-		}
+		if(vi->lbnd[i] == -1) vi->idel[ndel++] = vi->ibnd[i];
 	}
 
 	// delete outside markers
@@ -528,41 +534,131 @@ PetscErrorCode ADVelDeleteOutflow(AdvVelCtx *vi)
 	// clear
 	ierr = PetscFree(vi->idel); CHKERRQ(ierr);
 
+	vi->ndel = 0;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode ADVelMapToDomains(AdvVelCtx *vi)
+PetscErrorCode ADVelGetBoundMark(AdvVelCtx *vi)
 {
-	// count number of positions to be sent to each neighbor domain
+	// collect markers leaving local domain & store their destinations
+	// (local neighbor rank, -1 for outflow)
+
+	// Markers with host cells within one cell of the subdomain boundary are
+	// always checked. Host cells are known from the previous interpolation
+	// stage, CFL time step limit ensures that markers normally move less than
+	// one cell. Markers from interior cells are only checked if they left the
+	// local box (larger displacement), so the result never depends on CFL.
 
-	PetscInt     i, lrank, cnt;
-	PetscMPIInt  grank;
 	FDSTAG      *fs;
+	PetscScalar *X, bx, by, bz, ex, ey, ez;
+	PetscInt     i, ID, I, J, K, nx, ny, nz, lrank, ncand;
+	PetscMPIInt  grank;
 
-	PetscErrorCode  ierr;
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	fs = vi->fs;
+	nx = fs->dsx.ncels;
+	ny = fs->dsy.ncels;
+	nz = fs->dsz.ncels;
 
-	// clear send counters
-	ierr = PetscMemzero(vi->nsendm, _num_neighb_*sizeof(PetscInt)); CHKERRQ(ierr);
+	// get local box
+	ierr = FDSTAGGetLocalBox(fs, &bx, &by, &bz, &ex, &ey, &ez); CHKERRQ(ierr);
 
-	// scan markers
-	for(i = 0, cnt = 0; i < vi->nmark; i++)
+	// flag boundary candidates
+	for(i = 0, ncand = 0; i < vi->nmark; i++)
 	{
-		// get global & local ranks of a marker
-		ierr = FDSTAGGetPointRanks(fs, vi->interp[i].x, &lrank, &grank); CHKERRQ(ierr);
+		ID = vi->cellnum[i];
+		X  = vi->interp[i].x;
+
+		if(ID >= 0 && ID < fs->nCells)
+		{
+			GET_CELL_IJK(ID, I, J, K, nx, ny);
+
+			if(I > 0 && I < nx-1
+			&& J > 0 && J < ny-1
+			&& K > 0 && K < nz-1
+			&& X[0] >= bx && X[0] < ex
+			&& X[1] >= by && X[1] < ey
+			&& X[2] >= bz && X[2] < ez) continue;
+		}
+
+		ncand++;
+	}
+
+	vi->nbnd = 0;
 
-		if(grank != vi->iproc)
+	if(!ncand) PetscFunctionReturn(0);
+
+	// reallocate lists if necessary (only grow, contents are NOT preserved)
+	if(ncand > vi->nbndcap)
+	{
+		ierr = PetscFree(vi->ibnd); CHKERRQ(ierr);
+		ierr = PetscFree(vi->lbnd); CHKERRQ(ierr);
+
+		vi->nbndcap = (PetscInt)(_cap_overhead_*(PetscScalar)ncand);
+
+		ierr = makeIntArray(&vi->ibnd, NULL, vi->nbndcap); CHKERRQ(ierr);
+		ierr = makeIntArray(&vi->lbnd, NULL, vi->nbndcap); CHKERRQ(ierr);
+	}
+
+	// check candidates
+	for(i = 0; i < vi->nmark; i++)
+	{
+		ID = vi->cellnum[i];
+		X  = vi->interp[i].x;
+
+		if(ID >= 0 && ID < fs->nCells)
 		{
-			// count markers that should be sent to each neighbor
-			vi->nsendm[lrank]++;
-			cnt++;
+			GET_CELL_IJK(ID, I, J, K, nx, ny);
+
+			if(I > 0 && I < nx-1
+			&& J > 0 && J < ny-1
+			&& K > 0 && K < nz-1
+			&& X[0] >= bx && X[0] < ex
+			&& X[1] >= by && X[1] < ey
+			&& X[2] >= bz && X[2] < ez) continue;
 		}
+
+		// get global & local ranks of a marker
+		ierr = FDSTAGGetPointRanks(fs, X, &lrank, &grank); CHKERRQ(ierr);
+
+		if(grank == vi->iproc) continue;
+
+		if(grank == -1) lrank = -1;
+
+		vi->ibnd[vi->nbnd] = i;
+		vi->lbnd[vi->nbnd] = lrank;
+		vi->nbnd++;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVelMapToDomains(AdvVelCtx *vi)
+{
+	// count number of positions to be sent to each neighbor domain
+
+	PetscInt i;
+
+	PetscErrorCode  ierr;
+	PetscFunctionBeginUser;
+
+	// clear send counters
+	ierr = PetscMemzero(vi->nsendm, _num_neighb_*sizeof(PetscInt)); CHKERRQ(ierr);
+
+	// get markers leaving local domain
+	ierr = ADVelGetBoundMark(vi); CHKERRQ(ierr);
+
+	// count markers that should be sent to each neighbor
+	for(i = 0; i < vi->nbnd; i++)
+	{
+		if(vi->lbnd[i] != -1) vi->nsendm[vi->lbnd[i]]++;
 	}
 
 	// store number of deleted markers
-	vi->ndel = cnt;
+	vi->ndel = vi->nbnd;
 
 	PetscFunctionReturn(0);
 }
@@ -618,15 +714,11 @@ PetscErrorCode ADVelCreateMPIBuff(AdvVelCtx *vi)
 {
 	// create send and receive buffers for asynchronous MPI communication
 
-	FDSTAG     *fs;
-	PetscInt    i, cnt, lrank;
-	PetscMPIInt grank;
+	PetscInt i;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = vi->fs;
-
 	// compute buffer pointers
 	vi->nsend = getPtrCnt(_num_neighb_, vi->nsendm, vi->ptsend);
 	vi->nrecv = getPtrCnt(_num_neighb_, vi->nrecvm, vi->ptrecv);
@@ -641,19 +733,16 @@ PetscErrorCode ADVelCreateMPIBuff(AdvVelCtx *vi)
 	if(vi->ndel)  { ierr = PetscMalloc((size_t)vi->ndel *sizeof(PetscInt ), &vi->idel);    CHKERRQ(ierr); }
 
 	// copy markers to send buffer, store their indices
-	for(i = 0, cnt = 0; i < vi->nmark; i++)
+	for(i = 0; i < vi->nbnd; i++)
 	{
-		// get global & local ranks of a marker
-		ierr = FDSTAGGetPointRanks(fs, vi->interp[i].x, &lrank, &grank); CHKERRQ(ierr);
-
-		if(grank != vi->iproc)
+		// store marker in the send buffer (outflow markers are just deleted)
+		if(vi->lbnd[i] != -1)
 		{
-			// store marker in the send buffer
-			vi->sendbuf[vi->ptsend[lrank]++] = vi->interp[i];
-
-			// delete marker from the storage
-			vi->idel[cnt++] = i;
+			vi->sendbuf[vi->ptsend[vi->lbnd[i]]++] = vi->interp[vi->ibnd[i]];
 		}
+
+		// delete marker from the storage
+		vi->idel[i] = vi->ibnd[i];
 	}
 
 	// rewind send buffer pointers
@@ -721,7 +810,10 @@ PetscErrorCode ADVelDestroyMPIBuff(AdvVelCtx *vi)
 	// destroy buffers
 	ierr = PetscFree(vi->sendbuf); CHKERRQ(ierr);
 	ierr = PetscFree(vi->recvbuf); CHKERRQ(ierr);
-	ierr = PetscFree(vi->idel);  	 CHKERRQ(ierr);
+	ierr = PetscFree(vi->idel);    CHKERRQ(ierr);
+
+	// boundary lists are kept for the next stage
+	vi->nbnd = 0;
 
 	// reset values
 	vi->nrecv = 0;
@@ -735,7 +827,7 @@ PetscErrorCode ADVelCollectGarbage(AdvVelCtx *vi)
 	// store received markers, collect garbage
 
 	VelInterp   *interp, *recvbuf;
-	PetscInt    *idel, nmark, nrecv, ndel;
+	PetscInt    *idel, *cellnum, nmark, nrecv, ndel;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -743,6 +835,7 @@ PetscErrorCode ADVelCollectGarbage(AdvVelCtx *vi)
 	// access storage
 	nmark   = vi->nmark;
 	interp  = vi->interp;
+	cellnum = vi->cellnum;
 
 	nrecv   = vi->nrecv;
 	recvbuf = vi->recvbuf;
@@ -751,9 +844,11 @@ PetscErrorCode ADVelCollectGarbage(AdvVelCtx *vi)
 	idel    = vi->idel;
 
 	// close holes in marker storage
+	// (host cells of received markers are unknown)
 	while(nrecv && ndel)
 	{
-		interp[idel[ndel-1]] = recvbuf[nrecv-1];
+		interp [idel[ndel-1]] = recvbuf[nrecv-1];
+		cellnum[idel[ndel-1]] = -1;
 		nrecv--;
 		ndel--;
 	}
@@ -764,11 +859,13 @@ PetscErrorCode ADVelCollectGarbage(AdvVelCtx *vi)
 		ierr = ADVelReAllocStorage(vi, nmark + nrecv); CHKERRQ(ierr);
 
 		// make sure we have a correct storage pointer
-		interp = vi->interp;
+		interp  = vi->interp;
+		cellnum = vi->cellnum;
 
 		// put the rest in the end of marker storage
 		while(nrecv)
 		{
+			cellnum[nmark]  = -1;
 			interp[nmark++] = recvbuf[nrecv-1];
 			nrecv--;
 		}
@@ -781,7 +878,8 @@ PetscErrorCode ADVelCollectGarbage(AdvVelCtx *vi)
 		{
 			if(idel[ndel-1] != nmark-1)
 			{
-				interp[idel[ndel-1]] = interp[nmark-1];
+				interp [idel[ndel-1]] = interp [nmark-1];
+				cellnum[idel[ndel-1]] = cellnum[nmark-1];
 			}
 			nmark--;
 			ndel--;
@@ -798,7 +896,7 @@ PetscErrorCode ADVelReAllocStorage(AdvVelCtx *vi, PetscInt nmark)
 {
 	// re-allocate memory to dynamic storage
 
-	PetscInt     nbuff;
+	PetscInt     nbuff, *cellnum;
 	VelInterp   *interp;
 
 	PetscErrorCode ierr;
@@ -807,9 +905,6 @@ PetscErrorCode ADVelReAllocStorage(AdvVelCtx *vi, PetscInt nmark)
 	// check whether current storage is insufficient
 	if(nmark > vi->nbuff)
 	{
-		// delete host cell numbers
-		ierr = PetscFree(vi->cellnum); CHKERRQ(ierr);
-
 		// compute new capacity
 		nbuff = (PetscInt)(_cap_overhead_*(PetscScalar)nmark);
 
@@ -830,11 +925,20 @@ PetscErrorCode ADVelReAllocStorage(AdvVelCtx *vi, PetscInt nmark)
 		vi->nbuff  = nbuff;
 		vi->interp = interp;
 
-		// allocate memory for host cell numbers
-		ierr = PetscMalloc((size_t)nbuff*sizeof(PetscInt), &vi->cellnum); CHKERRQ(ierr);
-		ierr = PetscMemzero(vi->cellnum, (size_t)nbuff*sizeof(PetscInt)); CHKERRQ(ierr);
+		// reallocate memory for host cell numbers (keep current values)
+		ierr = makeIntArray(&cellnum, NULL, nbuff); CHKERRQ(ierr);
+
+		if(vi->nmark)
+		{
+			ierr = PetscMemcpy(cellnum, vi->cellnum, (size_t)vi->nmark*sizeof(PetscInt)); CHKERRQ(ierr);
+		}
+
+		ierr = PetscFree(vi->cellnum); CHKERRQ(ierr);
+
+		vi->cellnum = cellnum;
 
 		// allocate memory for id marker arranging per cell
+		ierr = PetscFree(vi->markind); CHKERRQ(ierr);
 		ierr = PetscMalloc((size_t)nbuff*sizeof(PetscInt), &vi->markind); CHKERRQ(ierr);
 		ierr = PetscMemzero(vi->markind, (size_t)nbuff*sizeof(PetscInt)); CHKERRQ(ierr);
 	}
@@ -848,8 +952,7 @@ PetscErrorCode ADVelMapMarkToCells(AdvVelCtx *vi)
 
 	FDSTAG      *fs;
 	PetscScalar *X;
-	PetscInt     i, ID, I, J, K, M, N;
-	PetscInt    *numMarkCell, *m, p;
+	PetscInt     i, ID, I, J, K, M, N, nmark;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -866,10 +969,22 @@ PetscErrorCode ADVelMapMarkToCells(AdvVelCtx *vi)
 		// get marker coordinates
 		X = vi->interp[i].x;
 
-		// get host cell IDs in all directions
-		ierr = Discret1DFindPoint(&fs->dsx, X[0], I); CHKERRQ(ierr);
-		ierr = Discret1DFindPoint(&fs->dsy, X[1], J); CHKERRQ(ierr);
-		ierr = Discret1DFindPoint(&fs->dsz, X[2], K); CHKERRQ(ierr);
+		// get previous host cell as a guess (negative if unknown)
+		ID = vi->cellnum[i];
+
+		if(ID >= 0 && ID < fs->nCells)
+		{
+			GET_CELL_IJK(ID, I, J, K, M, N);
+		}
+		else
+		{
+			I = J = K = -1;
+		}
+
+		// get host cell IDs in all directions (neighbors first)
+		ierr = Discret1DFindPointNear(&fs->dsx, X[0], I); CHKERRQ(ierr);
+		ierr = Discret1DFindPointNear(&fs->dsy, X[1], J); CHKERRQ(ierr);
+		ierr = Discret1DFindPointNear(&fs->dsz, X[2], K); CHKERRQ(ierr);
 
 		// compute and store consecutive index
 		GET_CELL_ID(ID, I, J, K, M, N);
@@ -877,30 +992,25 @@ PetscErrorCode ADVelMapMarkToCells(AdvVelCtx *vi)
 		vi->cellnum[i] = ID;
 	}
 
-	// allocate marker counter array
-	ierr = makeIntArray(&numMarkCell, NULL, fs->nCells); CHKERRQ(ierr);
-
 	// count number of markers in the cells
-	for(i = 0; i < vi->nmark; i++) numMarkCell[vi->cellnum[i]]++;
+	ierr = clearIntArray(vi->markstart, fs->nCells+1); CHKERRQ(ierr);
 
-	// store starting indices of markers belonging to a cell
-	vi->markstart[0] = 0;
-	for(i = 1; i < fs->nCells+1; i++) vi->markstart[i] = vi->markstart[i-1]+numMarkCell[i-1];
+	for(i = 0; i < vi->nmark; i++) vi->markstart[vi->cellnum[i]]++;
 
-	// allocate memory for id offset
-	ierr = makeIntArray(&m, NULL, fs->nCells); CHKERRQ(ierr);
+	// store starting indices of markers belonging to a cell
+	nmark = getPtrCnt(fs->nCells, vi->markstart, vi->markstart);
 
 	// store marker indices belonging to a cell
 	for(i = 0; i < vi->nmark; i++)
 	{
-		p = vi->markstart[vi->cellnum[i]];
-		vi->markind[p + m[vi->cellnum[i]]] = i;
-		m[vi->cellnum[i]]++;
+		vi->markind[vi->markstart[vi->cellnum[i]]++] = i;
 	}
 
-	// free memory
-	ierr = PetscFree(m);           CHKERRQ(ierr);
-	ierr = PetscFree(numMarkCell); CHKERRQ(ierr);
+	// rewind iterators
+	rewindPtr(fs->nCells, vi->markstart);
+
+	// set end-of-array index
+	vi->markstart[fs->nCells] = nmark;
 
 	PetscFunctionReturn(0);
 }
@@ -928,11 +1038,9 @@ PetscErrorCode ADVelInterpSTAG(AdvVelCtx *vi)
 	FDSTAG      *fs;
 	JacRes      *jr;
 	PetscInt    sx, sy, sz, nx, ny, nmark;
-	PetscInt    jj, ID, I, J, K, II, JJ, KK;
 	PetscScalar *ncx, *ncy, *ncz;
 	PetscScalar *ccx, *ccy, *ccz;
 	PetscScalar ***lvx, ***lvy, ***lvz;
-	PetscScalar xc, yc, zc, xp, yp, zp;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -962,34 +1070,40 @@ PetscErrorCode ADVelInterpSTAG(AdvVelCtx *vi)
 	ierr = DMDAVecGetArray(fs->DA_Z,   jr->lvz, &lvz); CHKERRQ(ierr);
 
 	// scan all markers
-	for(jj = 0; jj < nmark; jj++)
+	ierr = ThreadFor(nmark, _thread_grain_, [&](PetscInt beg, PetscInt end, PetscInt)
 	{
-		// get marker coordinates
-		xp = vi->interp[jj].x[0];
-		yp = vi->interp[jj].x[1];
-		zp = vi->interp[jj].x[2];
-
-		// get consecutive index of the host cell
-		ID = vi->cellnum[jj];
-
-		// expand I, J, K cell indices
-		GET_CELL_IJK(ID, I, J, K, nx, ny)
-
-		// get coordinates of cell center
-		xc = ccx[I];
-		yc = ccy[J];
-		zc = ccz[K];
-
-		// map marker on the cells of X, Y, Z & center grids
-		if(xp > xc) { II = I; } else { II = I-1; }
-		if(yp > yc) { JJ = J; } else { JJ = J-1; }
-		if(zp > zc) { KK = K; } else { KK = K-1; }
+		PetscInt    jj, ID, I, J, K, II, JJ, KK;
+		PetscScalar xc, yc, zc, xp, yp, zp;
 
-		// interpolate velocity, pressure & temperature
-		vi->interp[jj].v[0] = InterpLin3D(lvx, I,  JJ, KK, sx, sy, sz, xp, yp, zp, ncx, ccy, ccz);
-		vi->interp[jj].v[1] = InterpLin3D(lvy, II, J,  KK, sx, sy, sz, xp, yp, zp, ccx, ncy, ccz);
-		vi->interp[jj].v[2] = InterpLin3D(lvz, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz);
-	}
+		for(jj = beg; jj < end; jj++)
+		{
+			// get marker coordinates
+			xp = vi->interp[jj].x[0];
+			yp = vi->interp[jj].x[1];
+			zp = vi->interp[jj].x[2];
+
+			// get consecutive index of the host cell
+			ID = vi->cellnum[jj];
+
+			// expand I, J, K cell indices
+			GET_CELL_IJK(ID, I, J, K, nx, ny)
+
+			// get coordinates of cell center
+			xc = ccx[I];
+			yc = ccy[J];
+			zc = ccz[K];
+
+			// map marker on the cells of X, Y, Z & center grids
+			if(xp > xc) { II = I; } else { II = I-1; }
+			if(yp > yc) { JJ = J; } else { JJ = J-1; }
+			if(zp > zc) { KK = K; } else { KK = K-1; }
+
+			// interpolate velocity, pressure & temperature
+			vi->interp[jj].v[0] = InterpLin3D(lvx, I,  JJ, KK, sx, sy, sz, xp, yp, zp, ncx, ccy, ccz);
+			vi->interp[jj].v[1] = InterpLin3D(lvy, II, J,  KK, sx, sy, sz, xp, yp, zp, ccx, ncy, ccz);
+			vi->interp[jj].v[2] = InterpLin3D(lvz, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz);
+		}
+	}); CHKERRQ(ierr);
 
 	// restore access
 	ierr = DMDAVecRestoreArray(fs->DA_X,   jr->lvx, &lvx); CHKERRQ(ierr);
@@ -1008,16 +1122,9 @@ PetscErrorCode ADVelInterpMINMOD(AdvVelCtx *vi)
 	FDSTAG      *fs;
 	JacRes      *jr;
 	PetscInt    sx, sy, sz, nx, ny,nz;
-	PetscInt    i, j, k, I, J, K;
-	PetscInt    ID, pind, jj, n;
 	PetscScalar *ncx, *ncy, *ncz;
 	PetscScalar *ccx, *ccy, *ccz;
 	PetscScalar ***lvx, ***lvy, ***lvz;
-	PetscScalar vxn[8], vyn[8], vzn[8];
-	PetscScalar C12, C23, C31, C10, C20, C30;
-	PetscScalar xp, yp, zp;
-	PetscScalar nxs, nys, nzs, nxe, nye, nze, dx, dy, dz;
-	PetscScalar xpl, ypl, zpl;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -1044,167 +1151,179 @@ PetscErrorCode ADVelInterpMINMOD(AdvVelCtx *vi)
 	ierr = DMDAVecGetArray(fs->DA_Y,   jr->lvy, &lvy); CHKERRQ(ierr);
 	ierr = DMDAVecGetArray(fs->DA_Z,   jr->lvz, &lvz); CHKERRQ(ierr);
 
-	// scan all local cells
-	START_STD_LOOP
+	// scan all local cells (markers of a cell are only accessed from its plane)
+	ierr = ThreadFor(nz, 1, [&](PetscInt beg, PetscInt end, PetscInt)
 	{
-		// get local indices
-		I = i-sx;
-		J = j-sy;
-		K = k-sz;
-
-		// get start/end coordinates of nodes
-		nxs = ncx[I]; nxe = ncx[I+1];
-		nys = ncy[J]; nye = ncy[J+1];
-		nzs = ncz[K]; nze = ncz[K+1];
-
-		// get cell dimensions
-		dx = nxe-nxs;
-		dy = nye-nys;
-		dz = nze-nzs;
-
-		// Linear and minmod limiter
-		PetscScalar U1, U2, U3;
-		// ---------------------------------------------------------------------
-		// Vx 0,2
-		U1     = InterpLinMinmod(lvx[k-1][j-1][i], lvx[k][j-1][i], lvx[k+1][j-1][i], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-		U2     = InterpLinMinmod(lvx[k-1][j  ][i], lvx[k][j  ][i], lvx[k+1][j  ][i], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-		U3     = InterpLinMinmod(lvx[k-1][j+1][i], lvx[k][j+1][i], lvx[k+1][j+1][i], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-
-		vxn[0] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-		vxn[2] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-
-		// Vx 4,6
-		U1     = InterpLinMinmod(lvx[k-1][j-1][i], lvx[k][j-1][i], lvx[k+1][j-1][i], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-		U2     = InterpLinMinmod(lvx[k-1][j  ][i], lvx[k][j  ][i], lvx[k+1][j  ][i], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-		U3     = InterpLinMinmod(lvx[k-1][j+1][i], lvx[k][j+1][i], lvx[k+1][j+1][i], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-
-		vxn[4] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-		vxn[6] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-
-		// Vx 1,3
-		U1     = InterpLinMinmod(lvx[k-1][j-1][i+1], lvx[k][j-1][i+1], lvx[k+1][j-1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-		U2     = InterpLinMinmod(lvx[k-1][j  ][i+1], lvx[k][j  ][i+1], lvx[k+1][j  ][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-		U3     = InterpLinMinmod(lvx[k-1][j+1][i+1], lvx[k][j+1][i+1], lvx[k+1][j+1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-
-		vxn[1] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-		vxn[3] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-
-		// Vx 5,7
-		U1     = InterpLinMinmod(lvx[k-1][j-1][i+1], lvx[k][j-1][i+1], lvx[k+1][j-1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-		U2     = InterpLinMinmod(lvx[k-1][j  ][i+1], lvx[k][j  ][i+1], lvx[k+1][j  ][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-		U3     = InterpLinMinmod(lvx[k-1][j+1][i+1], lvx[k][j+1][i+1], lvx[k+1][j+1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-
-		vxn[5] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-		vxn[7] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-		// ---------------------------------------------------------------------
-		// Vy 0,1
-		U1     = InterpLinMinmod(lvy[k-1][j][i-1], lvy[k][j][i-1], lvy[k+1][j][i-1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-		U2     = InterpLinMinmod(lvy[k-1][j][i  ], lvy[k][j][i  ], lvy[k+1][j][i  ], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-		U3     = InterpLinMinmod(lvy[k-1][j][i+1], lvy[k][j][i+1], lvy[k+1][j][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-
-		vyn[0] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
-		vyn[1] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
-
-		// Vy 4,5
-		U1     = InterpLinMinmod(lvy[k-1][j][i-1], lvy[k][j][i-1], lvy[k+1][j][i-1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-		U2     = InterpLinMinmod(lvy[k-1][j][i  ], lvy[k][j][i  ], lvy[k+1][j][i  ], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-		U3     = InterpLinMinmod(lvy[k-1][j][i+1], lvy[k][j][i+1], lvy[k+1][j][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-
-		vyn[4] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
-		vyn[5] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
-
-		// Vy 2,3
-		U1     = InterpLinMinmod(lvy[k-1][j+1][i-1], lvy[k][j+1][i-1], lvy[k+1][j+1][i-1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-		U2     = InterpLinMinmod(lvy[k-1][j+1][i  ], lvy[k][j+1][i  ], lvy[k+1][j+1][i  ], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-		U3     = InterpLinMinmod(lvy[k-1][j+1][i+1], lvy[k][j+1][i+1], lvy[k+1][j+1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
-
-		vyn[2] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
-		vyn[3] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
-
-		// Vy 6,7
-		U1     = InterpLinMinmod(lvy[k-1][j+1][i-1], lvy[k][j+1][i-1], lvy[k+1][j+1][i-1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-		U2     = InterpLinMinmod(lvy[k-1][j+1][i  ], lvy[k][j+1][i  ], lvy[k+1][j+1][i  ], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-		U3     = InterpLinMinmod(lvy[k-1][j+1][i+1], lvy[k][j+1][i+1], lvy[k+1][j+1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
-
-		vyn[6] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
-		vyn[7] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
-		// ---------------------------------------------------------------------
-		// Vz 0,1
-		U1     = InterpLinMinmod(lvz[k][j-1][i-1], lvz[k][j][i-1], lvz[k][j+1][i-1], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-		U2     = InterpLinMinmod(lvz[k][j-1][i  ], lvz[k][j][i  ], lvz[k][j+1][i  ], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-		U3     = InterpLinMinmod(lvz[k][j-1][i+1], lvz[k][j][i+1], lvz[k][j+1][i+1], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-
-		vzn[0] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
-		vzn[1] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
-
-		// Vz 2,3
-		U1     = InterpLinMinmod(lvz[k][j-1][i-1], lvz[k][j][i-1], lvz[k][j+1][i-1], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-		U2     = InterpLinMinmod(lvz[k][j-1][i  ], lvz[k][j][i  ], lvz[k][j+1][i  ], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-		U3     = InterpLinMinmod(lvz[k][j-1][i+1], lvz[k][j][i+1], lvz[k][j+1][i+1], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-
-		vzn[2] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
-		vzn[3] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
-
-		// Vz 4,5
-		U1     = InterpLinMinmod(lvz[k+1][j-1][i-1], lvz[k+1][j][i-1], lvz[k+1][j+1][i-1], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-		U2     = InterpLinMinmod(lvz[k+1][j-1][i  ], lvz[k+1][j][i  ], lvz[k+1][j+1][i  ], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-		U3     = InterpLinMinmod(lvz[k+1][j-1][i+1], lvz[k+1][j][i+1], lvz[k+1][j+1][i+1], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
-
-		vzn[4] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
-		vzn[5] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
-
-		// Vz 6,7
-		U1     = InterpLinMinmod(lvz[k+1][j-1][i-1], lvz[k+1][j][i-1], lvz[k+1][j+1][i-1], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-		U2     = InterpLinMinmod(lvz[k+1][j-1][i  ], lvz[k+1][j][i  ], lvz[k+1][j+1][i  ], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-		U3     = InterpLinMinmod(lvz[k+1][j-1][i+1], lvz[k+1][j][i+1], lvz[k+1][j+1][i+1], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
-
-		vzn[6] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
-		vzn[7] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
-		// ---------------------------------------------------------------------
-
-		// calculate corrections
-		C12 = dx/2/dy*(-vyn[0]+vyn[1]+vyn[2]-vyn[3]+vyn[4]-vyn[5]-vyn[6]+vyn[7]);
-		C23 = dz/2/dx*(-vxn[0]+vxn[1]+vxn[2]-vxn[3]+vxn[4]-vxn[5]-vxn[6]+vxn[7]);
-		C31 = dy/2/dz*(-vzn[0]+vzn[1]+vzn[2]-vzn[3]+vzn[4]-vzn[5]-vzn[6]+vzn[7]);
-
-		C10 = dx/2/dz*(vzn[0]-vzn[4]+vzn[5]-vzn[1])       + dx/2/dy*(vyn[0]-vyn[2]+vyn[3]-vyn[1] + C31);
-		C20 = dz/2/dx*(vxn[0]-vxn[1]+vxn[5]-vxn[4] + C12) + dz/2/dy*(vyn[0]-vyn[2]+vyn[6]-vyn[4]      );
-		C30 = dy/2/dx*(vxn[0]-vxn[1]+vxn[3]-vxn[2])       + dy/2/dz*(vzn[0]-vzn[4]+vzn[6]-vzn[2] + C23);
-
-		// get cell id
-		GET_CELL_ID(ID, I, J, K, nx, ny);
-
-		// get markers in cell
-		n = vi->markstart[ID+1] - vi->markstart[ID];
-
-		// scan cell markers
-		for(jj = 0; jj < n; jj++)
+		PetscInt    i, j, k, I, J, K;
+		PetscInt    ID, pind, jj, n;
+		PetscScalar vxn[8], vyn[8], vzn[8];
+		PetscScalar C12, C23, C31, C10, C20, C30;
+		PetscScalar xp, yp, zp;
+		PetscScalar nxs, nys, nzs, nxe, nye, nze, dx, dy, dz;
+		PetscScalar xpl, ypl, zpl;
+
+		for(k = sz+beg; k < sz+end; k++)
+		for(j = sy; j < sy+ny; j++)
+		for(i = sx; i < sx+nx; i++)
 		{
-			// get marker index
-			pind = vi->markind[vi->markstart[ID] + jj];
-
-			// get marker coordinates
-			xp = vi->interp[pind].x[0];
-			yp = vi->interp[pind].x[1];
-			zp = vi->interp[pind].x[2];
-
-			// transform into local coordinates
-			xpl = (xp-nxs)/(nxe-nxs);
-			ypl = (yp-nys)/(nye-nys);
-			zpl = (zp-nzs)/(nze-nzs);
-
-			// interpolate velocities
-			vi->interp[pind].v[0] = GenInterpLin3D(vxn,xpl,ypl,zpl);
-			vi->interp[pind].v[1] = GenInterpLin3D(vyn,xpl,ypl,zpl);
-			vi->interp[pind].v[2] = GenInterpLin3D(vzn,xpl,ypl,zpl);
-
-			// add correction
-			vi->interp[pind].v[0] += xpl*(1-xpl)*(C10 + zpl*C12);
-			vi->interp[pind].v[1] += ypl*(1-ypl)*(C30 + xpl*C31);
-			vi->interp[pind].v[2] += zpl*(1-zpl)*(C20 + ypl*C23);
+			// get local indices
+			I = i-sx;
+			J = j-sy;
+			K = k-sz;
+
+			// get start/end coordinates of nodes
+			nxs = ncx[I]; nxe = ncx[I+1];
+			nys = ncy[J]; nye = ncy[J+1];
+			nzs = ncz[K]; nze = ncz[K+1];
+
+			// get cell dimensions
+			dx = nxe-nxs;
+			dy = nye-nys;
+			dz = nze-nzs;
+
+			// Linear and minmod limiter
+			PetscScalar U1, U2, U3;
+			// ---------------------------------------------------------------------
+			// Vx 0,2
+			U1     = InterpLinMinmod(lvx[k-1][j-1][i], lvx[k][j-1][i], lvx[k+1][j-1][i], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+			U2     = InterpLinMinmod(lvx[k-1][j  ][i], lvx[k][j  ][i], lvx[k+1][j  ][i], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+			U3     = InterpLinMinmod(lvx[k-1][j+1][i], lvx[k][j+1][i], lvx[k+1][j+1][i], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+
+			vxn[0] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+			vxn[2] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+
+			// Vx 4,6
+			U1     = InterpLinMinmod(lvx[k-1][j-1][i], lvx[k][j-1][i], lvx[k+1][j-1][i], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+			U2     = InterpLinMinmod(lvx[k-1][j  ][i], lvx[k][j  ][i], lvx[k+1][j  ][i], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+			U3     = InterpLinMinmod(lvx[k-1][j+1][i], lvx[k][j+1][i], lvx[k+1][j+1][i], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+
+			vxn[4] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+			vxn[6] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+
+			// Vx 1,3
+			U1     = InterpLinMinmod(lvx[k-1][j-1][i+1], lvx[k][j-1][i+1], lvx[k+1][j-1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+			U2     = InterpLinMinmod(lvx[k-1][j  ][i+1], lvx[k][j  ][i+1], lvx[k+1][j  ][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+			U3     = InterpLinMinmod(lvx[k-1][j+1][i+1], lvx[k][j+1][i+1], lvx[k+1][j+1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+
+			vxn[1] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+			vxn[3] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+
+			// Vx 5,7
+			U1     = InterpLinMinmod(lvx[k-1][j-1][i+1], lvx[k][j-1][i+1], lvx[k+1][j-1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+			U2     = InterpLinMinmod(lvx[k-1][j  ][i+1], lvx[k][j  ][i+1], lvx[k+1][j  ][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+			U3     = InterpLinMinmod(lvx[k-1][j+1][i+1], lvx[k][j+1][i+1], lvx[k+1][j+1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+
+			vxn[5] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+			vxn[7] = InterpLinMinmod(U1, U2, U3, dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+			// ---------------------------------------------------------------------
+			// Vy 0,1
+			U1     = InterpLinMinmod(lvy[k-1][j][i-1], lvy[k][j][i-1], lvy[k+1][j][i-1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+			U2     = InterpLinMinmod(lvy[k-1][j][i  ], lvy[k][j][i  ], lvy[k+1][j][i  ], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+			U3     = InterpLinMinmod(lvy[k-1][j][i+1], lvy[k][j][i+1], lvy[k+1][j][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+
+			vyn[0] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
+			vyn[1] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
+
+			// Vy 4,5
+			U1     = InterpLinMinmod(lvy[k-1][j][i-1], lvy[k][j][i-1], lvy[k+1][j][i-1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+			U2     = InterpLinMinmod(lvy[k-1][j][i  ], lvy[k][j][i  ], lvy[k+1][j][i  ], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+			U3     = InterpLinMinmod(lvy[k-1][j][i+1], lvy[k][j][i+1], lvy[k+1][j][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+
+			vyn[4] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
+			vyn[5] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
+
+			// Vy 2,3
+			U1     = InterpLinMinmod(lvy[k-1][j+1][i-1], lvy[k][j+1][i-1], lvy[k+1][j+1][i-1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+			U2     = InterpLinMinmod(lvy[k-1][j+1][i  ], lvy[k][j+1][i  ], lvy[k+1][j+1][i  ], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+			U3     = InterpLinMinmod(lvy[k-1][j+1][i+1], lvy[k][j+1][i+1], lvy[k+1][j+1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 0);
+
+			vyn[2] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
+			vyn[3] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
+
+			// Vy 6,7
+			U1     = InterpLinMinmod(lvy[k-1][j+1][i-1], lvy[k][j+1][i-1], lvy[k+1][j+1][i-1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+			U2     = InterpLinMinmod(lvy[k-1][j+1][i  ], lvy[k][j+1][i  ], lvy[k+1][j+1][i  ], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+			U3     = InterpLinMinmod(lvy[k-1][j+1][i+1], lvy[k][j+1][i+1], lvy[k+1][j+1][i+1], dz, ccz[K-1], ccz[K], ccz[K+1], 1);
+
+			vyn[6] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
+			vyn[7] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
+			// ---------------------------------------------------------------------
+			// Vz 0,1
+			U1     = InterpLinMinmod(lvz[k][j-1][i-1], lvz[k][j][i-1], lvz[k][j+1][i-1], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+			U2     = InterpLinMinmod(lvz[k][j-1][i  ], lvz[k][j][i  ], lvz[k][j+1][i  ], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+			U3     = InterpLinMinmod(lvz[k][j-1][i+1], lvz[k][j][i+1], lvz[k][j+1][i+1], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+
+			vzn[0] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
+			vzn[1] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
+
+			// Vz 2,3
+			U1     = InterpLinMinmod(lvz[k][j-1][i-1], lvz[k][j][i-1], lvz[k][j+1][i-1], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+			U2     = InterpLinMinmod(lvz[k][j-1][i  ], lvz[k][j][i  ], lvz[k][j+1][i  ], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+			U3     = InterpLinMinmod(lvz[k][j-1][i+1], lvz[k][j][i+1], lvz[k][j+1][i+1], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+
+			vzn[2] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
+			vzn[3] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
+
+			// Vz 4,5
+			U1     = InterpLinMinmod(lvz[k+1][j-1][i-1], lvz[k+1][j][i-1], lvz[k+1][j+1][i-1], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+			U2     = InterpLinMinmod(lvz[k+1][j-1][i  ], lvz[k+1][j][i  ], lvz[k+1][j+1][i  ], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+			U3     = InterpLinMinmod(lvz[k+1][j-1][i+1], lvz[k+1][j][i+1], lvz[k+1][j+1][i+1], dy, ccy[J-1], ccy[J], ccy[J+1], 0);
+
+			vzn[4] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
+			vzn[5] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
+
+			// Vz 6,7
+			U1     = InterpLinMinmod(lvz[k+1][j-1][i-1], lvz[k+1][j][i-1], lvz[k+1][j+1][i-1], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+			U2     = InterpLinMinmod(lvz[k+1][j-1][i  ], lvz[k+1][j][i  ], lvz[k+1][j+1][i  ], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+			U3     = InterpLinMinmod(lvz[k+1][j-1][i+1], lvz[k+1][j][i+1], lvz[k+1][j+1][i+1], dy, ccy[J-1], ccy[J], ccy[J+1], 1);
+
+			vzn[6] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 0);
+			vzn[7] = InterpLinMinmod(U1, U2, U3, dx, ccx[I-1], ccx[I], ccx[I+1], 1);
+			// ---------------------------------------------------------------------
+
+			// calculate corrections
+			C12 = dx/2/dy*(-vyn[0]+vyn[1]+vyn[2]-vyn[3]+vyn[4]-vyn[5]-vyn[6]+vyn[7]);
+			C23 = dz/2/dx*(-vxn[0]+vxn[1]+vxn[2]-vxn[3]+vxn[4]-vxn[5]-vxn[6]+vxn[7]);
+			C31 = dy/2/dz*(-vzn[0]+vzn[1]+vzn[2]-vzn[3]+vzn[4]-vzn[5]-vzn[6]+vzn[7]);
+
+			C10 = dx/2/dz*(vzn[0]-vzn[4]+vzn[5]-vzn[1])       + dx/2/dy*(vyn[0]-vyn[2]+vyn[3]-vyn[1] + C31);
+			C20 = dz/2/dx*(vxn[0]-vxn[1]+vxn[5]-vxn[4] + C12) + dz/2/dy*(vyn[0]-vyn[2]+vyn[6]-vyn[4]      );
+			C30 = dy/2/dx*(vxn[0]-vxn[1]+vxn[3]-vxn[2])       + dy/2/dz*(vzn[0]-vzn[4]+vzn[6]-vzn[2] + C23);
+
+			// get cell id
+			GET_CELL_ID(ID, I, J, K, nx, ny);
+
+			// get markers in cell
+			n = vi->markstart[ID+1] - vi->markstart[ID];
+
+			// scan cell markers
+			for(jj = 0; jj < n; jj++)
+			{
+				// get marker index
+				pind = vi->markind[vi->markstart[ID] + jj];
+
+				// get marker coordinates
+				xp = vi->interp[pind].x[0];
+				yp = vi->interp[pind].x[1];
+				zp = vi->interp[pind].x[2];
+
+				// transform into local coordinates
+				xpl = (xp-nxs)/(nxe-nxs);
+				ypl = (yp-nys)/(nye-nys);
+				zpl = (zp-nzs)/(nze-nzs);
+
+				// interpolate velocities
+				vi->interp[pind].v[0] = GenInterpLin3D(vxn,xpl,ypl,zpl);
+				vi->interp[pind].v[1] = GenInterpLin3D(vyn,xpl,ypl,zpl);
+				vi->interp[pind].v[2] = GenInterpLin3D(vzn,xpl,ypl,zpl);
+
+				// add correction
+				vi->interp[pind].v[0] += xpl*(1-xpl)*(C10 + zpl*C12);
+				vi->interp[pind].v[1] += ypl*(1-ypl)*(C30 + xpl*C31);
+				vi->interp[pind].v[2] += zpl*(1-zpl)*(C20 + ypl*C23);
+			}
 		}
-	}
-	END_STD_LOOP
+	}); CHKERRQ(ierr);
 
 	// restore access
 	ierr = DMDAVecRestoreArray(fs->DA_X,   jr->lvx, &lvx); CHKERRQ(ierr);
@@ -1221,15 +1340,9 @@ PetscErrorCode ADVelInterpSTAGP(AdvVelCtx *vi)
 	FDSTAG      *fs;
 	JacRes      *jr;
 	PetscInt    sx, sy, sz, nx, ny, nz, nmark;
-	PetscInt    jj, ID, I, J, K, II, JJ, KK;
-	PetscInt    IN, JN, KN;
 	PetscScalar *ncx, *ncy, *ncz;
 	PetscScalar *ccx, *ccy, *ccz;
-	PetscScalar v[3], vp[3];
 	PetscScalar ***lvx, ***lvy, ***lvz;
-	PetscScalar xc, yc, zc, xp, yp, zp;
-	PetscScalar vii[12], vxp[8], vyp[8], vzp[8];
-	PetscScalar nxs, nxe, nys, nye, nzs, nze, xpl, ypl, zpl;
 	PetscScalar A, B;
 
 	PetscErrorCode ierr;
@@ -1266,192 +1379,202 @@ PetscErrorCode ADVelInterpSTAGP(AdvVelCtx *vi)
 	ierr = DMDAVecGetArray(fs->DA_Z,   jr->lvz, &lvz); CHKERRQ(ierr);
 
 	// scan all markers
-	for(jj = 0; jj < nmark; jj++)
+	ierr = ThreadFor(nmark, _thread_grain_, [&](PetscInt beg, PetscInt end, PetscInt)
 	{
-		// get marker coordinates
-		xp = vi->interp[jj].x[0];
-		yp = vi->interp[jj].x[1];
-		zp = vi->interp[jj].x[2];
+		PetscInt    jj, ID, I, J, K, II, JJ, KK;
+		PetscInt    IN, JN, KN;
+		PetscScalar v[3], vp[3];
+		PetscScalar xc, yc, zc, xp, yp, zp;
+		PetscScalar vii[12], vxp[8], vyp[8], vzp[8];
+		PetscScalar nxs, nxe, nys, nye, nzs, nze, xpl, ypl, zpl;
+
+		for(jj = beg; jj < end; jj++)
+		{
+			// get marker coordinates
+			xp = vi->interp[jj].x[0];
+			yp = vi->interp[jj].x[1];
+			zp = vi->interp[jj].x[2];
 
-		// get consecutive index of the host cell
-		ID = vi->cellnum[jj];
+			// get consecutive index of the host cell
+			ID = vi->cellnum[jj];
 
-		// expand I, J, K cell indices
-		GET_CELL_IJK(ID, I, J, K, nx, ny)
+			// expand I, J, K cell indices
+			GET_CELL_IJK(ID, I, J, K, nx, ny)
 
-		// get coordinates of cell center
-		xc = ccx[I];
-		yc = ccy[J];
-		zc = ccz[K];
+			// get coordinates of cell center
+			xc = ccx[I];
+			yc = ccy[J];
+			zc = ccz[K];
 
-		// map marker on the cells of X, Y, Z & center grids
-		if(xp > xc) { II = I; } else { II = I-1; }
-		if(yp > yc) { JJ = J; } else { JJ = J-1; }
-		if(zp > zc) { KK = K; } else { KK = K-1; }
+			// map marker on the cells of X, Y, Z & center grids
+			if(xp > xc) { II = I; } else { II = I-1; }
+			if(yp > yc) { JJ = J; } else { JJ = J-1; }
+			if(zp > zc) { KK = K; } else { KK = K-1; }
 
-		// interpolate velocity, pressure & temperature
-		v[0] = InterpLin3D(lvx, I,  JJ, KK, sx, sy, sz, xp, yp, zp, ncx, ccy, ccz);
-		v[1] = InterpLin3D(lvy, II, J,  KK, sx, sy, sz, xp, yp, zp, ccx, ncy, ccz);
-		v[2] = InterpLin3D(lvz, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz);
+			// interpolate velocity, pressure & temperature
+			v[0] = InterpLin3D(lvx, I,  JJ, KK, sx, sy, sz, xp, yp, zp, ncx, ccy, ccz);
+			v[1] = InterpLin3D(lvy, II, J,  KK, sx, sy, sz, xp, yp, zp, ccx, ncy, ccz);
+			v[2] = InterpLin3D(lvz, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz);
 
-		// check marker position relative to pressure cube
-		// WARNING! ONLY FOR FREE SLIP BC
+			// check marker position relative to pressure cube
+			// WARNING! ONLY FOR FREE SLIP BC
 
-		// ----------------
-		// VX
-		// ----------------
-		if(xp > xc) { IN = I+1; } else { IN = I; }
+			// ----------------
+			// VX
+			// ----------------
+			if(xp > xc) { IN = I+1; } else { IN = I; }
 
-		if (IN == 0)
-		{
-			vii[0] = 2*lvx[sz+KK  ][sy+JJ  ][sx+IN]-lvx[sz+KK  ][sy+JJ  ][sx+IN+1]; vii[1]  = lvx[sz+KK  ][sy+JJ  ][sx+IN  ]; vii[2]  = lvx[sz+KK  ][sy+JJ  ][sx+IN+1];
-			vii[3] = 2*lvx[sz+KK  ][sy+JJ+1][sx+IN]-lvx[sz+KK  ][sy+JJ+1][sx+IN+1]; vii[4]  = lvx[sz+KK  ][sy+JJ+1][sx+IN  ]; vii[5]  = lvx[sz+KK  ][sy+JJ+1][sx+IN+1];
-			vii[6] = 2*lvx[sz+KK+1][sy+JJ  ][sx+IN]-lvx[sz+KK+1][sy+JJ  ][sx+IN+1]; vii[7]  = lvx[sz+KK+1][sy+JJ  ][sx+IN  ]; vii[8]  = lvx[sz+KK+1][sy+JJ  ][sx+IN+1];
-			vii[9] = 2*lvx[sz+KK+1][sy+JJ+1][sx+IN]-lvx[sz+KK+1][sy+JJ+1][sx+IN+1]; vii[10] = lvx[sz+KK+1][sy+JJ+1][sx+IN  ]; vii[11] = lvx[sz+KK+1][sy+JJ+1][sx+IN+1];
+			if (IN == 0)
+			{
+				vii[0] = 2*lvx[sz+KK  ][sy+JJ  ][sx+IN]-lvx[sz+KK  ][sy+JJ  ][sx+IN+1]; vii[1]  = lvx[sz+KK  ][sy+JJ  ][sx+IN  ]; vii[2]  = lvx[sz+KK  ][sy+JJ  ][sx+IN+1];
+				vii[3] = 2*lvx[sz+KK  ][sy+JJ+1][sx+IN]-lvx[sz+KK  ][sy+JJ+1][sx+IN+1]; vii[4]  = lvx[sz+KK  ][sy+JJ+1][sx+IN  ]; vii[5]  = lvx[sz+KK  ][sy+JJ+1][sx+IN+1];
+				vii[6] = 2*lvx[sz+KK+1][sy+JJ  ][sx+IN]-lvx[sz+KK+1][sy+JJ  ][sx+IN+1]; vii[7]  = lvx[sz+KK+1][sy+JJ  ][sx+IN  ]; vii[8]  = lvx[sz+KK+1][sy+JJ  ][sx+IN+1];
+				vii[9] = 2*lvx[sz+KK+1][sy+JJ+1][sx+IN]-lvx[sz+KK+1][sy+JJ+1][sx+IN+1]; vii[10] = lvx[sz+KK+1][sy+JJ+1][sx+IN  ]; vii[11] = lvx[sz+KK+1][sy+JJ+1][sx+IN+1];
 
-			nxs = 2*ccx[IN]-ccx[IN+1]; nxe = ccx[IN];
-		}
-		else if (IN == nx)
-		{
-			vii[0] = lvx[sz+KK  ][sy+JJ  ][sx+IN-1]; vii[1]  = lvx[sz+KK  ][sy+JJ  ][sx+IN  ]; vii[2]  = 2*lvx[sz+KK  ][sy+JJ  ][sx+IN]-lvx[sz+KK  ][sy+JJ  ][sx+IN-1];
-			vii[3] = lvx[sz+KK  ][sy+JJ+1][sx+IN-1]; vii[4]  = lvx[sz+KK  ][sy+JJ+1][sx+IN  ]; vii[5]  = 2*lvx[sz+KK  ][sy+JJ+1][sx+IN]-lvx[sz+KK  ][sy+JJ+1][sx+IN-1];
-			vii[6] = lvx[sz+KK+1][sy+JJ  ][sx+IN-1]; vii[7]  = lvx[sz+KK+1][sy+JJ  ][sx+IN  ]; vii[8]  = 2*lvx[sz+KK+1][sy+JJ  ][sx+IN]-lvx[sz+KK+1][sy+JJ  ][sx+IN-1];
-			vii[9] = lvx[sz+KK+1][sy+JJ+1][sx+IN-1]; vii[10] = lvx[sz+KK+1][sy+JJ+1][sx+IN  ]; vii[11] = 2*lvx[sz+KK+1][sy+JJ+1][sx+IN]-lvx[sz+KK+1][sy+JJ+1][sx+IN-1];
+				nxs = 2*ccx[IN]-ccx[IN+1]; nxe = ccx[IN];
+			}
+			else if (IN == nx)
+			{
+				vii[0] = lvx[sz+KK  ][sy+JJ  ][sx+IN-1]; vii[1]  = lvx[sz+KK  ][sy+JJ  ][sx+IN  ]; vii[2]  = 2*lvx[sz+KK  ][sy+JJ  ][sx+IN]-lvx[sz+KK  ][sy+JJ  ][sx+IN-1];
+				vii[3] = lvx[sz+KK  ][sy+JJ+1][sx+IN-1]; vii[4]  = lvx[sz+KK  ][sy+JJ+1][sx+IN  ]; vii[5]  = 2*lvx[sz+KK  ][sy+JJ+1][sx+IN]-lvx[sz+KK  ][sy+JJ+1][sx+IN-1];
+				vii[6] = lvx[sz+KK+1][sy+JJ  ][sx+IN-1]; vii[7]  = lvx[sz+KK+1][sy+JJ  ][sx+IN  ]; vii[8]  = 2*lvx[sz+KK+1][sy+JJ  ][sx+IN]-lvx[sz+KK+1][sy+JJ  ][sx+IN-1];
+				vii[9] = lvx[sz+KK+1][sy+JJ+1][sx+IN-1]; vii[10] = lvx[sz+KK+1][sy+JJ+1][sx+IN  ]; vii[11] = 2*lvx[sz+KK+1][sy+JJ+1][sx+IN]-lvx[sz+KK+1][sy+JJ+1][sx+IN-1];
 
-			nxs = ccx[IN-1]; nxe = 2*ccx[IN]-ccx[IN-1];
-		}
-		else
-		{
-			vii[0] = lvx[sz+KK  ][sy+JJ  ][sx+IN-1]; vii[1]  = lvx[sz+KK  ][sy+JJ  ][sx+IN  ]; vii[2]  = lvx[sz+KK  ][sy+JJ  ][sx+IN+1];
-			vii[3] = lvx[sz+KK  ][sy+JJ+1][sx+IN-1]; vii[4]  = lvx[sz+KK  ][sy+JJ+1][sx+IN  ]; vii[5]  = lvx[sz+KK  ][sy+JJ+1][sx+IN+1];
-			vii[6] = lvx[sz+KK+1][sy+JJ  ][sx+IN-1]; vii[7]  = lvx[sz+KK+1][sy+JJ  ][sx+IN  ]; vii[8]  = lvx[sz+KK+1][sy+JJ  ][sx+IN+1];
-			vii[9] = lvx[sz+KK+1][sy+JJ+1][sx+IN-1]; vii[10] = lvx[sz+KK+1][sy+JJ+1][sx+IN  ]; vii[11] = lvx[sz+KK+1][sy+JJ+1][sx+IN+1];
+				nxs = ccx[IN-1]; nxe = 2*ccx[IN]-ccx[IN-1];
+			}
+			else
+			{
+				vii[0] = lvx[sz+KK  ][sy+JJ  ][sx+IN-1]; vii[1]  = lvx[sz+KK  ][sy+JJ  ][sx+IN  ]; vii[2]  = lvx[sz+KK  ][sy+JJ  ][sx+IN+1];
+				vii[3] = lvx[sz+KK  ][sy+JJ+1][sx+IN-1]; vii[4]  = lvx[sz+KK  ][sy+JJ+1][sx+IN  ]; vii[5]  = lvx[sz+KK  ][sy+JJ+1][sx+IN+1];
+				vii[6] = lvx[sz+KK+1][sy+JJ  ][sx+IN-1]; vii[7]  = lvx[sz+KK+1][sy+JJ  ][sx+IN  ]; vii[8]  = lvx[sz+KK+1][sy+JJ  ][sx+IN+1];
+				vii[9] = lvx[sz+KK+1][sy+JJ+1][sx+IN-1]; vii[10] = lvx[sz+KK+1][sy+JJ+1][sx+IN  ]; vii[11] = lvx[sz+KK+1][sy+JJ+1][sx+IN+1];
 
-			nxs = ccx[IN-1]; nxe = ccx[IN  ];
-		}
+				nxs = ccx[IN-1]; nxe = ccx[IN  ];
+			}
 
-		// get velocities and boundaries
-		vxp[0] = (vii[0] + vii[1] )/2; vxp[1] = (vii[1]  + vii[2] )/2;
-		vxp[2] = (vii[3] + vii[4] )/2; vxp[3] = (vii[4]  + vii[5] )/2;
-		vxp[4] = (vii[6] + vii[7] )/2; vxp[5] = (vii[7]  + vii[8] )/2;
-		vxp[6] = (vii[9] + vii[10])/2; vxp[7] = (vii[10] + vii[11])/2;
+			// get velocities and boundaries
+			vxp[0] = (vii[0] + vii[1] )/2; vxp[1] = (vii[1]  + vii[2] )/2;
+			vxp[2] = (vii[3] + vii[4] )/2; vxp[3] = (vii[4]  + vii[5] )/2;
+			vxp[4] = (vii[6] + vii[7] )/2; vxp[5] = (vii[7]  + vii[8] )/2;
+			vxp[6] = (vii[9] + vii[10])/2; vxp[7] = (vii[10] + vii[11])/2;
 
-		// transform into local coordinates
-		nys = ccy[JJ  ]; nye = ccy[JJ+1];
-		nzs = ccz[KK  ]; nze = ccz[KK+1];
+			// transform into local coordinates
+			nys = ccy[JJ  ]; nye = ccy[JJ+1];
+			nzs = ccz[KK  ]; nze = ccz[KK+1];
 
-		xpl = (xp-nxs)/(nxe-nxs);
-		ypl = (yp-nys)/(nye-nys);
-		zpl = (zp-nzs)/(nze-nzs);
+			xpl = (xp-nxs)/(nxe-nxs);
+			ypl = (yp-nys)/(nye-nys);
+			zpl = (zp-nzs)/(nze-nzs);
 
-		// calculate velocity in pressure points
-		vp[0] = GenInterpLin3D(vxp,xpl,ypl,zpl);
+			// calculate velocity in pressure points
+			vp[0] = GenInterpLin3D(vxp,xpl,ypl,zpl);
 
-		// ----------------
-		// VY
-		// ----------------
-		if(yp > yc) { JN = J+1; } else { JN = J; }
+			// ----------------
+			// VY
+			// ----------------
+			if(yp > yc) { JN = J+1; } else { JN = J; }
 
-		if (JN == 0)
-		{
-			vii[0] = 2*lvy[sz+KK  ][sy+JN][sx+II  ]-lvy[sz+KK  ][sy+JN+1][sx+II  ]; vii[1]  = lvy[sz+KK  ][sy+JN][sx+II  ]; vii[2]  = lvy[sz+KK  ][sy+JN+1][sx+II  ];
-			vii[3] = 2*lvy[sz+KK  ][sy+JN][sx+II+1]-lvy[sz+KK  ][sy+JN+1][sx+II+1]; vii[4]  = lvy[sz+KK  ][sy+JN][sx+II+1]; vii[5]  = lvy[sz+KK  ][sy+JN+1][sx+II+1];
-			vii[6] = 2*lvy[sz+KK+1][sy+JN][sx+II  ]-lvy[sz+KK+1][sy+JN+1][sx+II  ]; vii[7]  = lvy[sz+KK+1][sy+JN][sx+II  ]; vii[8]  = lvy[sz+KK+1][sy+JN+1][sx+II  ];
-			vii[9] = 2*lvy[sz+KK+1][sy+JN][sx+II+1]-lvy[sz+KK+1][sy+JN+1][sx+II+1]; vii[10] = lvy[sz+KK+1][sy+JN][sx+II+1]; vii[11] = lvy[sz+KK+1][sy+JN+1][sx+II+1];
+			if (JN == 0)
+			{
+				vii[0] = 2*lvy[sz+KK  ][sy+JN][sx+II  ]-lvy[sz+KK  ][sy+JN+1][sx+II  ]; vii[1]  = lvy[sz+KK  ][sy+JN][sx+II  ]; vii[2]  = lvy[sz+KK  ][sy+JN+1][sx+II  ];
+				vii[3] = 2*lvy[sz+KK  ][sy+JN][sx+II+1]-lvy[sz+KK  ][sy+JN+1][sx+II+1]; vii[4]  = lvy[sz+KK  ][sy+JN][sx+II+1]; vii[5]  = lvy[sz+KK  ][sy+JN+1][sx+II+1];
+				vii[6] = 2*lvy[sz+KK+1][sy+JN][sx+II  ]-lvy[sz+KK+1][sy+JN+1][sx+II  ]; vii[7]  = lvy[sz+KK+1][sy+JN][sx+II  ]; vii[8]  = lvy[sz+KK+1][sy+JN+1][sx+II  ];
+				vii[9] = 2*lvy[sz+KK+1][sy+JN][sx+II+1]-lvy[sz+KK+1][sy+JN+1][sx+II+1]; vii[10] = lvy[sz+KK+1][sy+JN][sx+II+1]; vii[11] = lvy[sz+KK+1][sy+JN+1][sx+II+1];
 
-			nys = 2*ccy[JN]-ccy[JN+1]; nye = ccy[JN];
-		}
-		else if (JN == ny)
-		{
-			vii[0] = lvy[sz+KK  ][sy+JN-1][sx+II  ]; vii[1]  = lvy[sz+KK  ][sy+JN][sx+II  ]; vii[2]  = 2*lvy[sz+KK  ][sy+JN][sx+II  ]-lvy[sz+KK  ][sy+JN-1][sx+II  ];
-			vii[3] = lvy[sz+KK  ][sy+JN-1][sx+II+1]; vii[4]  = lvy[sz+KK  ][sy+JN][sx+II+1]; vii[5]  = 2*lvy[sz+KK  ][sy+JN][sx+II+1]-lvy[sz+KK  ][sy+JN-1][sx+II+1];
-			vii[6] = lvy[sz+KK+1][sy+JN-1][sx+II  ]; vii[7]  = lvy[sz+KK+1][sy+JN][sx+II  ]; vii[8]  = 2*lvy[sz+KK+1][sy+JN][sx+II  ]-lvy[sz+KK+1][sy+JN-1][sx+II  ];
-			vii[9] = lvy[sz+KK+1][sy+JN-1][sx+II+1]; vii[10] = lvy[sz+KK+1][sy+JN][sx+II+1]; vii[11] = 2*lvy[sz+KK+1][sy+JN][sx+II+1]-lvy[sz+KK+1][sy+JN-1][sx+II+1];
+				nys = 2*ccy[JN]-ccy[JN+1]; nye = ccy[JN];
+			}
+			else if (JN == ny)
+			{
+				vii[0] = lvy[sz+KK  ][sy+JN-1][sx+II  ]; vii[1]  = lvy[sz+KK  ][sy+JN][sx+II  ]; vii[2]  = 2*lvy[sz+KK  ][sy+JN][sx+II  ]-lvy[sz+KK  ][sy+JN-1][sx+II  ];
+				vii[3] = lvy[sz+KK  ][sy+JN-1][sx+II+1]; vii[4]  = lvy[sz+KK  ][sy+JN][sx+II+1]; vii[5]  = 2*lvy[sz+KK  ][sy+JN][sx+II+1]-lvy[sz+KK  ][sy+JN-1][sx+II+1];
+				vii[6] = lvy[sz+KK+1][sy+JN-1][sx+II  ]; vii[7]  = lvy[sz+KK+1][sy+JN][sx+II  ]; vii[8]  = 2*lvy[sz+KK+1][sy+JN][sx+II  ]-lvy[sz+KK+1][sy+JN-1][sx+II  ];
+				vii[9] = lvy[sz+KK+1][sy+JN-1][sx+II+1]; vii[10] = lvy[sz+KK+1][sy+JN][sx+II+1]; vii[11] = 2*lvy[sz+KK+1][sy+JN][sx+II+1]-lvy[sz+KK+1][sy+JN-1][sx+II+1];
 
-			nys = ccy[JN-1]; nye = 2*ccy[JN]-ccy[JN-1];
-		}
-		else
-		{
-			vii[0] = lvy[sz+KK  ][sy+JN-1][sx+II  ]; vii[1]  = lvy[sz+KK  ][sy+JN][sx+II  ]; vii[2]  = lvy[sz+KK  ][sy+JN+1][sx+II  ];
-			vii[3] = lvy[sz+KK  ][sy+JN-1][sx+II+1]; vii[4]  = lvy[sz+KK  ][sy+JN][sx+II+1]; vii[5]  = lvy[sz+KK  ][sy+JN+1][sx+II+1];
-			vii[6] = lvy[sz+KK+1][sy+JN-1][sx+II  ]; vii[7]  = lvy[sz+KK+1][sy+JN][sx+II  ]; vii[8]  = lvy[sz+KK+1][sy+JN+1][sx+II  ];
-			vii[9] = lvy[sz+KK+1][sy+JN-1][sx+II+1]; vii[10] = lvy[sz+KK+1][sy+JN][sx+II+1]; vii[11] = lvy[sz+KK+1][sy+JN+1][sx+II+1];
+				nys = ccy[JN-1]; nye = 2*ccy[JN]-ccy[JN-1];
+			}
+			else
+			{
+				vii[0] = lvy[sz+KK  ][sy+JN-1][sx+II  ]; vii[1]  = lvy[sz+KK  ][sy+JN][sx+II  ]; vii[2]  = lvy[sz+KK  ][sy+JN+1][sx+II  ];
+				vii[3] = lvy[sz+KK  ][sy+JN-1][sx+II+1]; vii[4]  = lvy[sz+KK  ][sy+JN][sx+II+1]; vii[5]  = lvy[sz+KK  ][sy+JN+1][sx+II+1];
+				vii[6] = lvy[sz+KK+1][sy+JN-1][sx+II  ]; vii[7]  = lvy[sz+KK+1][sy+JN][sx+II  ]; vii[8]  = lvy[sz+KK+1][sy+JN+1][sx+II  ];
+				vii[9] = lvy[sz+KK+1][sy+JN-1][sx+II+1]; vii[10] = lvy[sz+KK+1][sy+JN][sx+II+1]; vii[11] = lvy[sz+KK+1][sy+JN+1][sx+II+1];
 
-			nys = ccy[JN-1]; nye = ccy[JN  ];
-		}
+				nys = ccy[JN-1]; nye = ccy[JN  ];
+			}
 
-		// get velocities and boundaries
-		vyp[0] = (vii[0] + vii[1] )/2; vyp[1] = (vii[3]  + vii[4] )/2;
-		vyp[2] = (vii[1] + vii[2] )/2; vyp[3] = (vii[4]  + vii[5] )/2;
-		vyp[4] = (vii[6] + vii[7] )/2; vyp[5] = (vii[9]  + vii[10])/2;
-		vyp[6] = (vii[7] + vii[8] )/2; vyp[7] = (vii[10] + vii[11])/2;
+			// get velocities and boundaries
+			vyp[0] = (vii[0] + vii[1] )/2; vyp[1] = (vii[3]  + vii[4] )/2;
+			vyp[2] = (vii[1] + vii[2] )/2; vyp[3] = (vii[4]  + vii[5] )/2;
+			vyp[4] = (vii[6] + vii[7] )/2; vyp[5] = (vii[9]  + vii[10])/2;
+			vyp[6] = (vii[7] + vii[8] )/2; vyp[7] = (vii[10] + vii[11])/2;
 
-		// transform into local coordinates
-		nxs = ccx[II  ]; nxe = ccx[II+1];
-		nzs = ccz[KK  ]; nze = ccz[KK+1];
+			// transform into local coordinates
+			nxs = ccx[II  ]; nxe = ccx[II+1];
+			nzs = ccz[KK  ]; nze = ccz[KK+1];
 
-		xpl = (xp-nxs)/(nxe-nxs);
-		ypl = (yp-nys)/(nye-nys);
-		zpl = (zp-nzs)/(nze-nzs);
+			xpl = (xp-nxs)/(nxe-nxs);
+			ypl = (yp-nys)/(nye-nys);
+			zpl = (zp-nzs)/(nze-nzs);
 
-		// calculate velocity in pressure points
-		vp[1] = GenInterpLin3D(vyp,xpl,ypl,zpl);
+			// calculate velocity in pressure points
+			vp[1] = GenInterpLin3D(vyp,xpl,ypl,zpl);
 
-		// ----------------
-		// VZ
-		// ----------------
-		if(zp > zc) { KN = K+1; } else { KN = K; }
+			// ----------------
+			// VZ
+			// ----------------
+			if(zp > zc) { KN = K+1; } else { KN = K; }
 
-		if (KN == 0)
-		{
-			vii[0] = 2*lvz[sz+KN][sy+JJ  ][sx+II  ]-lvz[sz+KN+1][sy+JJ  ][sx+II  ]; vii[1]  = lvz[sz+KN][sy+JJ  ][sx+II  ]; vii[2]  = lvz[sz+KN+1][sy+JJ  ][sx+II  ];
-			vii[3] = 2*lvz[sz+KN][sy+JJ  ][sx+II+1]-lvz[sz+KN+1][sy+JJ  ][sx+II+1]; vii[4]  = lvz[sz+KN][sy+JJ  ][sx+II+1]; vii[5]  = lvz[sz+KN+1][sy+JJ  ][sx+II+1];
-			vii[6] = 2*lvz[sz+KN][sy+JJ+1][sx+II  ]-lvz[sz+KN+1][sy+JJ+1][sx+II  ]; vii[7]  = lvz[sz+KN][sy+JJ+1][sx+II  ]; vii[8]  = lvz[sz+KN+1][sy+JJ+1][sx+II  ];
-			vii[9] = 2*lvz[sz+KN][sy+JJ+1][sx+II+1]-lvz[sz+KN+1][sy+JJ+1][sx+II+1]; vii[10] = lvz[sz+KN][sy+JJ+1][sx+II+1]; vii[11] = lvz[sz+KN+1][sy+JJ+1][sx+II+1];
+			if (KN == 0)
+			{
+				vii[0] = 2*lvz[sz+KN][sy+JJ  ][sx+II  ]-lvz[sz+KN+1][sy+JJ  ][sx+II  ]; vii[1]  = lvz[sz+KN][sy+JJ  ][sx+II  ]; vii[2]  = lvz[sz+KN+1][sy+JJ  ][sx+II  ];
+				vii[3] = 2*lvz[sz+KN][sy+JJ  ][sx+II+1]-lvz[sz+KN+1][sy+JJ  ][sx+II+1]; vii[4]  = lvz[sz+KN][sy+JJ  ][sx+II+1]; vii[5]  = lvz[sz+KN+1][sy+JJ  ][sx+II+1];
+				vii[6] = 2*lvz[sz+KN][sy+JJ+1][sx+II  ]-lvz[sz+KN+1][sy+JJ+1][sx+II  ]; vii[7]  = lvz[sz+KN][sy+JJ+1][sx+II  ]; vii[8]  = lvz[sz+KN+1][sy+JJ+1][sx+II  ];
+				vii[9] = 2*lvz[sz+KN][sy+JJ+1][sx+II+1]-lvz[sz+KN+1][sy+JJ+1][sx+II+1]; vii[10] = lvz[sz+KN][sy+JJ+1][sx+II+1]; vii[11] = lvz[sz+KN+1][sy+JJ+1][sx+II+1];
 
-			nzs = 2*ccz[KN]-ccz[KN+1]; nze = ccz[KN];
-		}
-		else if (KN == nz)
-		{
-			vii[0] = lvz[sz+KN-1][sy+JJ  ][sx+II  ]; vii[1]  = lvz[sz+KN][sy+JJ  ][sx+II  ]; vii[2]  = 2*lvz[sz+KN][sy+JJ  ][sx+II  ]-lvz[sz+KN-1][sy+JJ  ][sx+II  ];
-			vii[3] = lvz[sz+KN-1][sy+JJ  ][sx+II+1]; vii[4]  = lvz[sz+KN][sy+JJ  ][sx+II+1]; vii[5]  = 2*lvz[sz+KN][sy+JJ  ][sx+II+1]-lvz[sz+KN-1][sy+JJ  ][sx+II+1];
-			vii[6] = lvz[sz+KN-1][sy+JJ+1][sx+II  ]; vii[7]  = lvz[sz+KN][sy+JJ+1][sx+II  ]; vii[8]  = 2*lvz[sz+KN][sy+JJ+1][sx+II  ]-lvz[sz+KN-1][sy+JJ+1][sx+II  ];
-			vii[9] = lvz[sz+KN-1][sy+JJ+1][sx+II+1]; vii[10] = lvz[sz+KN][sy+JJ+1][sx+II+1]; vii[11] = 2*lvz[sz+KN][sy+JJ+1][sx+II+1]-lvz[sz+KN-1][sy+JJ+1][sx+II+1];
+				nzs = 2*ccz[KN]-ccz[KN+1]; nze = ccz[KN];
+			}
+			else if (KN == nz)
+			{
+				vii[0] = lvz[sz+KN-1][sy+JJ  ][sx+II  ]; vii[1]  = lvz[sz+KN][sy+JJ  ][sx+II  ]; vii[2]  = 2*lvz[sz+KN][sy+JJ  ][sx+II  ]-lvz[sz+KN-1][sy+JJ  ][sx+II  ];
+				vii[3] = lvz[sz+KN-1][sy+JJ  ][sx+II+1]; vii[4]  = lvz[sz+KN][sy+JJ  ][sx+II+1]; vii[5]  = 2*lvz[sz+KN][sy+JJ  ][sx+II+1]-lvz[sz+KN-1][sy+JJ  ][sx+II+1];
+				vii[6] = lvz[sz+KN-1][sy+JJ+1][sx+II  ]; vii[7]  = lvz[sz+KN][sy+JJ+1][sx+II  ]; vii[8]  = 2*lvz[sz+KN][sy+JJ+1][sx+II  ]-lvz[sz+KN-1][sy+JJ+1][sx+II  ];
+				vii[9] = lvz[sz+KN-1][sy+JJ+1][sx+II+1]; vii[10] = lvz[sz+KN][sy+JJ+1][sx+II+1]; vii[11] = 2*lvz[sz+KN][sy+JJ+1][sx+II+1]-lvz[sz+KN-1][sy+JJ+1][sx+II+1];
 
-			nzs = ccz[KN-1]; nze = 2*ccz[KN]-ccz[KN-1];
-		}
-		else
-		{
-			vii[0] = lvz[sz+KN-1][sy+JJ  ][sx+II  ]; vii[1]  = lvz[sz+KN][sy+JJ  ][sx+II  ]; vii[2]  = lvz[sz+KN+1][sy+JJ  ][sx+II  ];
-			vii[3] = lvz[sz+KN-1][sy+JJ  ][sx+II+1]; vii[4]  = lvz[sz+KN][sy+JJ  ][sx+II+1]; vii[5]  = lvz[sz+KN+1][sy+JJ  ][sx+II+1];
-			vii[6] = lvz[sz+KN-1][sy+JJ+1][sx+II  ]; vii[7]  = lvz[sz+KN][sy+JJ+1][sx+II  ]; vii[8]  = lvz[sz+KN+1][sy+JJ+1][sx+II  ];
-			vii[9] = lvz[sz+KN-1][sy+JJ+1][sx+II+1]; vii[10] = lvz[sz+KN][sy+JJ+1][sx+II+1]; vii[11] = lvz[sz+KN+1][sy+JJ+1][sx+II+1];
+				nzs = ccz[KN-1]; nze = 2*ccz[KN]-ccz[KN-1];
+			}
+			else
+			{
+				vii[0] = lvz[sz+KN-1][sy+JJ  ][sx+II  ]; vii[1]  = lvz[sz+KN][sy+JJ  ][sx+II  ]; vii[2]  = lvz[sz+KN+1][sy+JJ  ][sx+II  ];
+				vii[3] = lvz[sz+KN-1][sy+JJ  ][sx+II+1]; vii[4]  = lvz[sz+KN][sy+JJ  ][sx+II+1]; vii[5]  = lvz[sz+KN+1][sy+JJ  ][sx+II+1];
+				vii[6] = lvz[sz+KN-1][sy+JJ+1][sx+II  ]; vii[7]  = lvz[sz+KN][sy+JJ+1][sx+II  ]; vii[8]  = lvz[sz+KN+1][sy+JJ+1][sx+II  ];
+				vii[9] = lvz[sz+KN-1][sy+JJ+1][sx+II+1]; vii[10] = lvz[sz+KN][sy+JJ+1][sx+II+1]; vii[11] = lvz[sz+KN+1][sy+JJ+1][sx+II+1];
 
-			nzs = ccz[KN-1]; nze = ccz[KN  ];
-		}
+				nzs = ccz[KN-1]; nze = ccz[KN  ];
+			}
 
-		// get velocities and boundaries
-		vzp[0] = (vii[0] + vii[1] )/2; vzp[1] = (vii[3]  + vii[4] )/2;
-		vzp[2] = (vii[6] + vii[7] )/2; vzp[3] = (vii[9]  + vii[10])/2;
-		vzp[4] = (vii[1] + vii[2] )/2; vzp[5] = (vii[4]  + vii[5] )/2;
-		vzp[6] = (vii[7] + vii[8] )/2; vzp[7] = (vii[10] + vii[11])/2;
+			// get velocities and boundaries
+			vzp[0] = (vii[0] + vii[1] )/2; vzp[1] = (vii[3]  + vii[4] )/2;
+			vzp[2] = (vii[6] + vii[7] )/2; vzp[3] = (vii[9]  + vii[10])/2;
+			vzp[4] = (vii[1] + vii[2] )/2; vzp[5] = (vii[4]  + vii[5] )/2;
+			vzp[6] = (vii[7] + vii[8] )/2; vzp[7] = (vii[10] + vii[11])/2;
 
-		// transform into local coordinates
-		nxs = ccx[II  ]; nxe = ccx[II+1];
-		nys = ccy[JJ  ]; nye = ccy[JJ+1];
+			// transform into local coordinates
+			nxs = ccx[II  ]; nxe = ccx[II+1];
+			nys = ccy[JJ  ]; nye = ccy[JJ+1];
 
-		xpl = (xp-nxs)/(nxe-nxs);
-		ypl = (yp-nys)/(nye-nys);
-		zpl = (zp-nzs)/(nze-nzs);
+			xpl = (xp-nxs)/(nxe-nxs);
+			ypl = (yp-nys)/(nye-nys);
+			zpl = (zp-nzs)/(nze-nzs);
 
-		// calculate velocity in pressure points
-		vp[2] = GenInterpLin3D(vzp,xpl,ypl,zpl);
+			// calculate velocity in pressure points
+			vp[2] = GenInterpLin3D(vzp,xpl,ypl,zpl);
 
-		// interpolate velocity
-		vi->interp[jj].v[0] = A*v[0] + B*vp[0];
-		vi->interp[jj].v[1] = A*v[1] + B*vp[1];
-		vi->interp[jj].v[2] = A*v[2] + B*vp[2];
-	}
+			// interpolate velocity
+			vi->interp[jj].v[0] = A*v[0] + B*vp[0];
+			vi->interp[jj].v[1] = A*v[1] + B*vp[1];
+			vi->interp[jj].v[2] = A*v[2] + B*vp[2];
+		}
+	}); CHKERRQ(ierr);
 
 	// restore access
 	ierr = DMDAVecRestoreArray(fs->DA_X,   jr->lvx, &lvx); CHKERRQ(ierr);
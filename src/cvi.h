@@ -67,6 +67,11 @@ struct AdvVelCtx
 	PetscInt         ndel;
 	PetscInt         *idel;
 
+	PetscInt         nbnd;   // number of markers leaving local domain
+	PetscInt         nbndcap; // capacity of boundary lists
+	PetscInt         *ibnd;  // indices of markers leaving local domain
+	PetscInt         *lbnd;  // destinations of markers leaving local domain (local neighbor rank, -1 - outflow)
+
 };
 
 //-----------------------------------------------------------------------------
@@ -98,6 +103,7 @@ PetscErrorCode ADVelCalcEffVel     (VelInterp *interp, PetscInt n, PetscScalar a
 // used for exchange
 PetscErrorCode ADVelExchange       (AdvVelCtx *vi);
 PetscErrorCode ADVelDeleteOutflow  (AdvVelCtx *vi);
+PetscErrorCode ADVelGetBoundMark   (AdvVelCtx *vi);
 PetscErrorCode ADVelMapToDomains   (AdvVelCtx *vi);
 PetscErrorCode ADVelExchangeNMark  (AdvVelCtx *vi);
 PetscErrorCode ADVelCreateMPIBuff  (AdvVelCtx *vi);
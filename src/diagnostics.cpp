@@ -0,0 +1,442 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//...................   IN-SITU DIAGNOSTICS TIME SERIES   ...................
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "diagnostics.h"
+#include "parsing.h"
+#include "scaling.h"
+#include "tssolve.h"
+#include "fdstag.h"
+#include "surf.h"
+#include "phase.h"
+#include "JacRes.h"
+#include "tools.h"
+//---------------------------------------------------------------------------
+// number of global values (sum section)
+#define _diag_num_sum_ 3
+// number of values per phase (sum section)
+#define _diag_num_phase_ 5
+// number of maxima (max section)
+#define _diag_num_max_ 3
+//---------------------------------------------------------------------------
+PetscErrorCode DiagCreate(Diag *diag, FB *fb)
+{
+	FILE       *fp;
+	PetscInt    i, numPhases;
+	PetscBool   found, restart;
+	char        filename[_str_len_], mode[_str_len_];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	numPhases = diag->jr->dbm->numPhases;
+
+	// set defaults
+	diag->nstep     =  1;
+	diag->slabPhase = -1;
+
+	// read
+	ierr = getIntParam   (fb, _OPTIONAL_, "diag",            &diag->diag,      1, 1);           CHKERRQ(ierr);
+
+	if(!diag->diag) PetscFunctionReturn(0);
+
+	ierr = getStringParam(fb, _OPTIONAL_, "out_file_name",    filename,        "output");       CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "diag_nstep",      &diag->nstep,     1, -1);          CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "diag_phase",      &diag->phase,     1, 1);           CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "diag_slab_phase", &diag->slabPhase, 1, numPhases-1); CHKERRQ(ierr);
+
+	if(diag->nstep < 1) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "diag_nstep must be positive\n");
+
+	// set file name
+	sprintf(diag->outfile, "%s_diag.csv", filename);
+
+	// print summary
+	PetscPrintf(PETSC_COMM_WORLD, "Diagnostics parameters:\n");
+	PetscPrintf(PETSC_COMM_WORLD, "   Diagnostics file                        : %s \n", diag->outfile);
+	PetscPrintf(PETSC_COMM_WORLD, "   Diagnostics frequency                   : %lld \n", (LLD)diag->nstep);
+	if(diag->phase)          PetscPrintf(PETSC_COMM_WORLD, "   Per-phase reductions                    @ \n");
+	if(diag->slabPhase != -1)PetscPrintf(PETSC_COMM_WORLD, "   Slab tip phase                          : %lld \n", (LLD)diag->slabPhase);
+	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
+
+	// check for partition-independent restart (objects are recreated from input file)
+	ierr = PetscOptionsGetCheckString("-mode", mode, &found); CHKERRQ(ierr);
+
+	restart = (found && !strcmp(mode, "restart")) ? PETSC_TRUE : PETSC_FALSE;
+
+	if(restart && ISRankZero(PETSC_COMM_WORLD))
+	{
+		fp = fopen(diag->outfile, "r");
+
+		if(fp) { fclose(fp); PetscFunctionReturn(0); }
+	}
+
+	// write header (restarted runs append to the existing file, see DiagSetRestart)
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		fp = fopen(diag->outfile, "w");
+
+		if(fp == NULL) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Cannot open file %s\n", diag->outfile);
+
+		fprintf(fp, "step,time,vrms,vmax,topo_max,plast_frac,slab_tip_z");
+
+		if(diag->phase)
+		{
+			for(i = 0; i < numPhases; i++)
+			{
+				fprintf(fp, ",vol_frac_%lld,eta_%lld,T_%lld,p_%lld,tauII_%lld",
+					(LLD)i, (LLD)i, (LLD)i, (LLD)i, (LLD)i);
+			}
+		}
+
+		fprintf(fp, "\n");
+
+		fclose(fp);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode DiagSetRestart(Diag *diag, PetscInt istep)
+{
+	// continue CSV file after restart (delete lines of the steps after restart step)
+
+	FILE       *fp;
+	MPI_File    fh;
+	long long   step, keep;
+	int         c, mpierr;
+
+	PetscFunctionBeginUser;
+
+	if(!diag->diag || !ISRankZero(PETSC_COMM_WORLD)) PetscFunctionReturn(0);
+
+	fp = fopen(diag->outfile, "r");
+
+	if(fp == NULL) PetscFunctionReturn(0);
+
+	// skip header
+	while((c = getc(fp)) != EOF && c != '\n') { }
+
+	keep = (long long)ftell(fp);
+
+	// keep complete lines up to restart step
+	while(c != EOF && fscanf(fp, "%lld", &step) == 1 && step <= (long long)istep)
+	{
+		while((c = getc(fp)) != EOF && c != '\n') { }
+
+		if(c == '\n') keep = (long long)ftell(fp);
+	}
+
+	fclose(fp);
+
+	mpierr = MPI_File_open(PETSC_COMM_SELF, diag->outfile, MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Cannot open file %s\n", diag->outfile);
+
+	mpierr = MPI_File_set_size(fh, (MPI_Offset)keep);
+
+	MPI_File_close(&fh);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Cannot truncate file %s\n", diag->outfile);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode DiagWriteStep(Diag *diag)
+{
+	// compute global & per-phase reductions from cell solution variables
+	//
+	// sum section : volume, plastic volume, v^2 volume,
+	//               per phase: volume, log10(eta), T, p, tauII (all volume-weighted)
+	// max section : max velocity, max topography, -min slab cell z-coordinate
+	//
+	// tauII is computed from normal deviatoric stress components at cell centers,
+	// squared shear stresses are averaged from the four adjacent edges of every cell
+	// (edge strain-rate vectors are used as scratch storage, as in the vorticity output)
+
+	FDSTAG      *fs;
+	JacRes      *jr;
+	FreeSurf    *surf;
+	Scaling     *scal;
+	TSSol       *ts;
+	SolVarCell  *svCell;
+	SolVarEdge  *svEdge;
+	FILE        *fp;
+	PetscScalar *lbuf, *gbuf, *ps, *pm, *phRat;
+	PetscScalar ***vx, ***vy, ***vz, ***p, ***T, ***topo, ***sxy, ***sxz, ***syz;
+	PetscScalar  dV, v2, vc[3], eta, tau, s, J2, pf, z, V, Vph, zslab;
+	PetscInt     i, j, k, nx, ny, nz, sx, sy, sz, L, ph, iter, numPhases, nsum, nbuf;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!diag->diag) PetscFunctionReturn(0);
+
+	// access context
+	jr        = diag->jr;
+	surf      = diag->surf;
+	fs        = jr->fs;
+	scal      = jr->scal;
+	ts        = jr->ts;
+	numPhases = jr->dbm->numPhases;
+
+	// check frequency
+	if(ts->istep % diag->nstep) PetscFunctionReturn(0);
+
+	// allocate packed buffers
+	nsum = _diag_num_sum_ + (diag->phase ? _diag_num_phase_*numPhases : 0);
+	nbuf = nsum + _diag_num_max_;
+
+	ierr = makeScalArray(&lbuf, NULL, nbuf); CHKERRQ(ierr);
+	ierr = makeScalArray(&gbuf, NULL, nbuf); CHKERRQ(ierr);
+
+	ps = lbuf;
+	pm = lbuf + nsum;
+
+	pm[0] =  0.0;
+	pm[1] = -PETSC_MAX_REAL;
+	pm[2] = -PETSC_MAX_REAL;
+
+	// get stabilization pre-factor (same as in stress invariant output)
+	if(jr->ctrl.initGuess) pf = 0.0;
+	else                   pf = 2.0;
+
+	if(diag->phase)
+	{
+		ierr = DMDAVecGetArray(fs->DA_XY, jr->ldxy, &sxy); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(fs->DA_XZ, jr->ldxz, &sxz); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(fs->DA_YZ, jr->ldyz, &syz); CHKERRQ(ierr);
+
+		//---------------------------------------
+		// xy edge points
+		//---------------------------------------
+		iter = 0;
+		GET_NODE_RANGE(nx, sx, fs->dsx)
+		GET_NODE_RANGE(ny, sy, fs->dsy)
+		GET_CELL_RANGE(nz, sz, fs->dsz)
+
+		START_STD_LOOP
+		{
+			svEdge = &jr->svXYEdge[iter++];
+			s      = svEdge->s + pf*svEdge->svDev.eta_st*svEdge->d;
+
+			sxy[k][j][i] = s*s;
+		}
+		END_STD_LOOP
+
+		//---------------------------------------
+		// xz edge points
+		//---------------------------------------
+		iter = 0;
+		GET_NODE_RANGE(nx, sx, fs->dsx)
+		GET_CELL_RANGE(ny, sy, fs->dsy)
+		GET_NODE_RANGE(nz, sz, fs->dsz)
+
+		START_STD_LOOP
+		{
+			svEdge = &jr->svXZEdge[iter++];
+			s      = svEdge->s + pf*svEdge->svDev.eta_st*svEdge->d;
+
+			sxz[k][j][i] = s*s;
+		}
+		END_STD_LOOP
+
+		//---------------------------------------
+		// yz edge points
+		//---------------------------------------
+		iter = 0;
+		GET_CELL_RANGE(nx, sx, fs->dsx)
+		GET_NODE_RANGE(ny, sy, fs->dsy)
+		GET_NODE_RANGE(nz, sz, fs->dsz)
+
+		START_STD_LOOP
+		{
+			svEdge = &jr->svYZEdge[iter++];
+			s      = svEdge->s + pf*svEdge->svDev.eta_st*svEdge->d;
+
+			syz[k][j][i] = s*s;
+		}
+		END_STD_LOOP
+
+		ierr = DMDAVecRestoreArray(fs->DA_XY, jr->ldxy, &sxy); CHKERRQ(ierr);
+		ierr = DMDAVecRestoreArray(fs->DA_XZ, jr->ldxz, &sxz); CHKERRQ(ierr);
+		ierr = DMDAVecRestoreArray(fs->DA_YZ, jr->ldyz, &syz); CHKERRQ(ierr);
+
+		// get ghost edges of the cells adjacent to the subdomain boundaries
+		LOCAL_TO_LOCAL(fs->DA_XY, jr->ldxy);
+		LOCAL_TO_LOCAL(fs->DA_XZ, jr->ldxz);
+		LOCAL_TO_LOCAL(fs->DA_YZ, jr->ldyz);
+
+		ierr = DMDAVecGetArray(fs->DA_XY, jr->ldxy, &sxy); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(fs->DA_XZ, jr->ldxz, &sxz); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(fs->DA_YZ, jr->ldyz, &syz); CHKERRQ(ierr);
+	}
+
+	// access solution vectors
+	ierr = DMDAVecGetArray(fs->DA_X,   jr->lvx, &vx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_Y,   jr->lvy, &vy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_Z,   jr->lvz, &vz); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lp,  &p);  CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lT,  &T);  CHKERRQ(ierr);
+
+	//---------------------------------------
+	// central points
+	//---------------------------------------
+	iter = 0;
+	GET_CELL_RANGE(nx, sx, fs->dsx)
+	GET_CELL_RANGE(ny, sy, fs->dsy)
+	GET_CELL_RANGE(nz, sz, fs->dsz)
+
+	START_STD_LOOP
+	{
+		// access solution variables
+		svCell = &jr->svCell[iter++];
+		phRat  =  svCell->phRat;
+
+		// cell volume
+		dV = SIZE_CELL(i, sx, fs->dsx)*SIZE_CELL(j, sy, fs->dsy)*SIZE_CELL(k, sz, fs->dsz);
+
+		// velocity at cell center
+		vc[0] = (vx[k][j][i] + vx[k][j][i+1])/2.0;
+		vc[1] = (vy[k][j][i] + vy[k][j+1][i])/2.0;
+		vc[2] = (vz[k][j][i] + vz[k+1][j][i])/2.0;
+
+		v2 = vc[0]*vc[0] + vc[1]*vc[1] + vc[2]*vc[2];
+
+		ps[0] += dV;
+		ps[1] += (svCell->svDev.PSR > 0.0) ? dV : 0.0;
+		ps[2] += v2*dV;
+
+		pm[0] = PetscMax(pm[0], v2);
+
+		// slab tip (deepest cell dominated by slab phase)
+		if(diag->slabPhase != -1 && phRat[diag->slabPhase] > 0.5)
+		{
+			z     = COORD_CELL(k, sz, fs->dsz);
+			pm[2] = PetscMax(pm[2], -z);
+		}
+
+		if(!diag->phase) continue;
+
+		eta = PetscLog10Real(svCell->svDev.eta*scal->viscosity);
+		s = svCell->sxx + pf*svCell->svDev.eta_st*svCell->dxx; J2  = 0.5*s*s;
+		s = svCell->syy + pf*svCell->svDev.eta_st*svCell->dyy; J2 += 0.5*s*s;
+		s = svCell->szz + pf*svCell->svDev.eta_st*svCell->dzz; J2 += 0.5*s*s;
+
+		J2 += (sxy[k][j][i] + sxy[k][j+1][i] + sxy[k][j][i+1] + sxy[k][j+1][i+1])/4.0;
+		J2 += (sxz[k][j][i] + sxz[k+1][j][i] + sxz[k][j][i+1] + sxz[k+1][j][i+1])/4.0;
+		J2 += (syz[k][j][i] + syz[k+1][j][i] + syz[k][j+1][i] + syz[k+1][j+1][i])/4.0;
+
+		tau = PetscSqrtReal(J2);
+
+		for(ph = 0; ph < numPhases; ph++)
+		{
+			if(!phRat[ph]) continue;
+
+			Vph = phRat[ph]*dV;
+
+			ps[_diag_num_sum_ + _diag_num_phase_*ph    ] += Vph;
+			ps[_diag_num_sum_ + _diag_num_phase_*ph + 1] += Vph*eta;
+			ps[_diag_num_sum_ + _diag_num_phase_*ph + 2] += Vph*T[k][j][i];
+			ps[_diag_num_sum_ + _diag_num_phase_*ph + 3] += Vph*p[k][j][i];
+			ps[_diag_num_sum_ + _diag_num_phase_*ph + 4] += Vph*tau;
+		}
+	}
+	END_STD_LOOP
+
+	// restore access
+	ierr = DMDAVecRestoreArray(fs->DA_X,   jr->lvx, &vx); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_Y,   jr->lvy, &vy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_Z,   jr->lvz, &vz); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lp,  &p);  CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lT,  &T);  CHKERRQ(ierr);
+
+	if(diag->phase)
+	{
+		ierr = DMDAVecRestoreArray(fs->DA_XY, jr->ldxy, &sxy); CHKERRQ(ierr);
+		ierr = DMDAVecRestoreArray(fs->DA_XZ, jr->ldxz, &sxz); CHKERRQ(ierr);
+		ierr = DMDAVecRestoreArray(fs->DA_YZ, jr->ldyz, &syz); CHKERRQ(ierr);
+	}
+
+	//---------------------------------------
+	// free surface
+	//---------------------------------------
+	if(surf->UseFreeSurf)
+	{
+		L = (PetscInt)fs->dsz.rank;
+
+		ierr = DMDAVecGetArray(surf->DA_SURF, surf->gtopo, &topo); CHKERRQ(ierr);
+
+		ierr = DMDAGetCorners(fs->DA_COR, &sx, &sy, NULL, &nx, &ny, NULL); CHKERRQ(ierr);
+
+		START_PLANE_LOOP
+		{
+			pm[1] = PetscMax(pm[1], topo[L][j][i]);
+		}
+		END_PLANE_LOOP
+
+		ierr = DMDAVecRestoreArray(surf->DA_SURF, surf->gtopo, &topo); CHKERRQ(ierr);
+	}
+
+	// combine all contributions (sum section & max section)
+	ierr = MPI_Allreduce(lbuf,        gbuf,        (PetscMPIInt)nsum,           MPIU_SCALAR, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	ierr = MPI_Allreduce(lbuf + nsum, gbuf + nsum, (PetscMPIInt)_diag_num_max_, MPIU_SCALAR, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	// write line
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		ps = gbuf;
+		pm = gbuf + nsum;
+		V  = ps[0];
+
+		zslab = (pm[2] == -PETSC_MAX_REAL) ? 0.0 : -pm[2]*scal->length;
+
+		fp = fopen(diag->outfile, "a");
+
+		if(fp == NULL) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Cannot open file %s\n", diag->outfile);
+
+		fprintf(fp, "%lld,%g,%g,%g,%g,%g,%g",
+			(LLD)ts->istep,
+			ts->time*scal->time,
+			PetscSqrtReal(ps[2]/V)*scal->velocity,
+			PetscSqrtReal(pm[0])*scal->velocity,
+			surf->UseFreeSurf ? pm[1]*scal->length : 0.0,
+			ps[1]/V,
+			zslab);
+
+		if(diag->phase)
+		{
+			for(ph = 0; ph < numPhases; ph++)
+			{
+				Vph = ps[_diag_num_sum_ + _diag_num_phase_*ph];
+
+				if(!Vph) { fprintf(fp, ",0,0,0,0,0"); continue; }
+
+				fprintf(fp, ",%g,%g,%g,%g,%g",
+					Vph/V,
+					PetscPowReal(10.0, ps[_diag_num_sum_ + _diag_num_phase_*ph + 1]/Vph),
+					ps[_diag_num_sum_ + _diag_num_phase_*ph + 2]/Vph*scal->temperature - scal->Tshift,
+					ps[_diag_num_sum_ + _diag_num_phase_*ph + 3]/Vph*scal->stress,
+					ps[_diag_num_sum_ + _diag_num_phase_*ph + 4]/Vph*scal->stress);
+			}
+		}
+
+		fprintf(fp, "\n");
+
+		fclose(fp);
+	}
+
+	ierr = PetscFree(lbuf); CHKERRQ(ierr);
+	ierr = PetscFree(gbuf); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
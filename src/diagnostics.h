@@ -0,0 +1,51 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//...................   IN-SITU DIAGNOSTICS TIME SERIES   ...................
+//---------------------------------------------------------------------------
+#ifndef __diagnostics_h__
+#define __diagnostics_h__
+//---------------------------------------------------------------------------
+// Scalar diagnostics are computed from the cell solution variables every
+// few time steps and appended by the first processor to a CSV file
+// (one line per step). All local contributions are packed in one buffer
+// (sums followed by maxima) and combined with two standard reductions.
+//---------------------------------------------------------------------------
+
+struct FB;
+struct JacRes;
+struct FreeSurf;
+
+//---------------------------------------------------------------------------
+
+struct Diag
+{
+	JacRes   *jr;                    // Jacobian & residual context
+	FreeSurf *surf;                  // free surface
+	char      outfile[_str_len_+20]; // output file name
+	PetscInt  diag;                  // diagnostics activation flag
+	PetscInt  nstep;                 // output frequency (time steps)
+	PetscInt  phase;                 // per-phase reductions flag
+	PetscInt  slabPhase;             // phase to track slab tip (-1 - deactivated)
+};
+
+//---------------------------------------------------------------------------
+
+// read parameters & write header of the CSV file
+PetscErrorCode DiagCreate(Diag *diag, FB *fb);
+
+// delete lines of the steps after restart step from the CSV file
+PetscErrorCode DiagSetRestart(Diag *diag, PetscInt istep);
+
+// compute diagnostics & append line to the CSV file (collective)
+PetscErrorCode DiagWriteStep(Diag *diag);
+
+//---------------------------------------------------------------------------
+#endif
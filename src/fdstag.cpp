@@ -262,6 +262,7 @@ PetscErrorCode Discret1DDestroy(Discret1D *ds)
 	ierr = PetscFree(ds->nbuff);        CHKERRQ(ierr);
 	ierr = PetscFree(ds->cbuff);        CHKERRQ(ierr);
 	ierr = PetscFree(ds->starts);       CHKERRQ(ierr);
+	ierr = PetscFree(ds->lookup);       CHKERRQ(ierr);
 	ierr = Discret1DFreeColumnComm(ds); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
@@ -283,6 +284,11 @@ PetscErrorCode Discret1DReadRestart(Discret1D *ds, FILE *fp)
 	ds->ncoor = ds->nbuff + 1;
 	ds->ccoor = ds->cbuff + 1;
 
+	// rebuild point lookup table
+	ds->lookup = NULL;
+
+	ierr = Discret1DGetLookup(ds); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -389,6 +395,9 @@ PetscErrorCode Discret1DGenCoord(Discret1D *ds, MeshSeg1D *ms)
 	ds->gcrdbeg = ms->xstart[0];
 	ds->gcrdend = ms->xstart[ms->nsegs];
 
+	// build point lookup table
+	ierr = Discret1DGetLookup(ds); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -399,6 +408,7 @@ PetscErrorCode Discret1DStretch(Discret1D *ds, PetscScalar eps, PetscScalar ref)
 
 	PetscInt i;
 
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// recompute (stretch) node coordinates in the buffer
@@ -412,6 +422,9 @@ PetscErrorCode Discret1DStretch(Discret1D *ds, PetscScalar eps, PetscScalar ref)
 	ds->gcrdbeg *= (1.0 + eps);
 	ds->gcrdend *= (1.0 + eps);
 
+	// rebuild point lookup table
+	ierr = Discret1DGetLookup(ds); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -521,6 +534,53 @@ PetscErrorCode Discret1DGatherCoord(Discret1D *ds, PetscScalar **coord)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode Discret1DScatterCoord(Discret1D *ds, PetscScalar *coord)
+{
+	// set local coordinates (including ghosts) from global coordinate array
+	// WARNING! the global array must exist on all ranks
+
+	PetscInt     i, ig;
+	PetscScalar  A, B;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// copy local & internal ghost node coordinates
+	for(i = -1; i < ds->nnods+1; i++)
+	{
+		ig = ds->pstart + i;
+
+		if(ig >= 0 && ig < ds->tnods) ds->ncoor[i] = coord[ig];
+	}
+
+	// set boundary ghost coordinates
+	if(ds->pstart == 0)
+	{
+		A = ds->ncoor[0];
+		B = ds->ncoor[1];
+		ds->ncoor[-1] = A - (B - A);
+	}
+	if(ds->pstart + ds->nnods == ds->tnods)
+	{
+		A = ds->ncoor[ds->nnods-2];
+		B = ds->ncoor[ds->nnods-1];
+		ds->ncoor[ds->nnods] = B + (B - A);
+	}
+
+	// compute coordinates of the cell centers including ghosts
+	for(i = -1; i < ds->ncels+1; i++)
+		ds->ccoor[i] = (ds->ncoor[i] + ds->ncoor[i+1])/2.0;
+
+	// set global grid coordinate bounds
+	ds->gcrdbeg = coord[0];
+	ds->gcrdend = coord[ds->tnods-1];
+
+	// rebuild point lookup table
+	ierr = Discret1DGetLookup(ds); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode Discret1DCheckMG(Discret1D *ds, const char *dir, PetscInt *_ncors)
 {
 	PetscInt sz, ncors;
@@ -664,6 +724,21 @@ PetscErrorCode Discret1DFindPoint(Discret1D *ds, PetscScalar x, PetscInt &ID)
 		if(ID < 0)   ID = 0;
 		if(ID > n-1) ID = n-1;
 	}
+	else if(ds->lookup)
+	{
+		// get bucket index
+		M = (PetscInt)PetscFloorReal((x - px[0])/dx);
+
+		// check bounds
+		if(M < 0)   M = 0;
+		if(M > n-1) M = n-1;
+
+		// scan cells overlapping the bucket
+		ID = ds->lookup[M];
+
+		while(ID < n-1 && px[ID+1] <= x) ID++;
+		while(ID > 0   && px[ID]   >  x) ID--;
+	}
 	else
 	{
 		// binary search
@@ -704,6 +779,71 @@ PetscErrorCode Discret1DFindPoint(Discret1D *ds, PetscScalar x, PetscInt &ID)
  */
 }
 //---------------------------------------------------------------------------
+PetscErrorCode Discret1DFindPointNear(Discret1D *ds, PetscScalar x, PetscInt &ID)
+{
+	// find index of a cell containing point (local points only)
+	// input ID is a guess (e.g. previous host cell), negative if unknown
+
+	PetscScalar *px;
+	PetscInt     n;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	n  = ds->ncels;
+	px = ds->ncoor;
+
+	if(ID >= 0 && ID < n)
+	{
+		// check guess cell
+		if(px[ID] <= x && x < px[ID+1]) PetscFunctionReturn(0);
+
+		// check direct neighbors
+		if(ID > 0   && px[ID-1] <= x && x < px[ID])   { ID--; PetscFunctionReturn(0); }
+		if(ID < n-1 && px[ID+1] <= x && x < px[ID+2]) { ID++; PetscFunctionReturn(0); }
+	}
+
+	// fall back to global search
+	ierr = Discret1DFindPoint(ds, x, ID); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode Discret1DGetLookup(Discret1D *ds)
+{
+	// build lookup table of uniform buckets for non-uniform grid
+	// every bucket stores the first cell overlapping it
+
+	PetscScalar *px, dx, xb;
+	PetscInt     i, n, ID;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// free previous table
+	ierr = PetscFree(ds->lookup); CHKERRQ(ierr);
+
+	if(ds->uniform) PetscFunctionReturn(0);
+
+	n  =  ds->ncels;
+	px =  ds->ncoor;
+	dx = (px[n] - px[0])/((PetscScalar)n);
+
+	ierr = makeIntArray(&ds->lookup, NULL, n); CHKERRQ(ierr);
+
+	for(i = 0, ID = 0; i < n; i++)
+	{
+		// bucket begin coordinate
+		xb = px[0] + dx*(PetscScalar)i;
+
+		while(ID < n-1 && px[ID+1] <= xb) ID++;
+
+		ds->lookup[i] = ID;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 // DOFIndex functions
 //---------------------------------------------------------------------------
 PetscErrorCode DOFIndexCreate(DOFIndex *dof, DM DA_CEN, DM DA_X, DM DA_Y, DM DA_Z)
@@ -1070,6 +1210,78 @@ PetscErrorCode FDSTAGWriteRestart(FDSTAG *fs, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode FDSTAGWriteRestartPortable(FDSTAG *fs, PetscViewer viewer)
+{
+	// write global grid size and node coordinates (partition-independent)
+
+	Discret1D   *ds[3];
+	PetscInt     d, hdr[3];
+	PetscScalar *coord;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ds[0] = &fs->dsx;
+	ds[1] = &fs->dsy;
+	ds[2] = &fs->dsz;
+
+	for(d = 0; d < 3; d++) hdr[d] = ds[d]->tnods;
+
+	ierr = PetscViewerBinaryWrite(viewer, hdr, 3, PETSC_INT); CHKERRQ(ierr);
+
+	for(d = 0; d < 3; d++)
+	{
+		// coordinates only exist on rank zero, which is the only writer
+		ierr = Discret1DGatherCoord(ds[d], &coord); CHKERRQ(ierr);
+
+		ierr = PetscViewerBinaryWrite(viewer, coord, ds[d]->tnods, PETSC_SCALAR); CHKERRQ(ierr);
+
+		ierr = PetscFree(coord); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FDSTAGReadRestartPortable(FDSTAG *fs, PetscViewer viewer)
+{
+	// read global node coordinates and distribute them over current partitioning
+
+	Discret1D   *ds[3];
+	PetscInt     d, hdr[3];
+	PetscScalar *coord;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ds[0] = &fs->dsx;
+	ds[1] = &fs->dsy;
+	ds[2] = &fs->dsz;
+
+	ierr = PetscViewerBinaryRead(viewer, hdr, 3, NULL, PETSC_INT); CHKERRQ(ierr);
+
+	for(d = 0; d < 3; d++)
+	{
+		if(hdr[d] != ds[d]->tnods)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Restart grid size [%lld, %lld, %lld] does not match input file\n",
+				(LLD)hdr[0], (LLD)hdr[1], (LLD)hdr[2]);
+		}
+	}
+
+	for(d = 0; d < 3; d++)
+	{
+		ierr = makeScalArray(&coord, NULL, ds[d]->tnods); CHKERRQ(ierr);
+
+		ierr = PetscViewerBinaryRead(viewer, coord, ds[d]->tnods, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+		ierr = Discret1DScatterCoord(ds[d], coord); CHKERRQ(ierr);
+
+		ierr = PetscFree(coord); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode FDSTAGDestroy(FDSTAG * fs)
 {
 	PetscErrorCode ierr;
@@ -86,6 +86,8 @@ struct Discret1D
 	PetscScalar   gcrdend;  // global grid coordinate bound (end)
 
 	PetscScalar   gtol;     // geometric tolerance
+
+	PetscInt     *lookup;   // first cell overlapping each uniform bucket (non-uniform grid only)
 };
 
 //---------------------------------------------------------------------------
@@ -128,6 +130,9 @@ PetscErrorCode Discret1DFreeColumnComm(Discret1D *ds);
 // WARNING! the array must be destroyed after use!
 PetscErrorCode Discret1DGatherCoord(Discret1D *ds, PetscScalar **coord);
 
+// set local coordinates from global coordinate array (available on all ranks)
+PetscErrorCode Discret1DScatterCoord(Discret1D *ds, PetscScalar *coord);
+
 // check multigrid restrictions, get maximum number of coarsening steps
 PetscErrorCode Discret1DCheckMG(Discret1D *ds, const char *dir, PetscInt *_ncors);
 
@@ -137,6 +142,12 @@ PetscErrorCode Discret1DgetMaxInvStep(Discret1D *ds, DM da, Vec gv, PetscInt dir
 // find index of a cell containing point (local points only)
 PetscErrorCode Discret1DFindPoint(Discret1D *ds, PetscScalar x, PetscInt &ID);
 
+// find cell containing point starting from a guess (neighbors first)
+PetscErrorCode Discret1DFindPointNear(Discret1D *ds, PetscScalar x, PetscInt &ID);
+
+// build bucket lookup table for non-uniform grid
+PetscErrorCode Discret1DGetLookup(Discret1D *ds);
+
 //---------------------------------------------------------------------------
 
 enum idxtype { IDXNONE, IDXCOUPLED, IDXUNCOUPLED };
@@ -218,6 +229,11 @@ PetscErrorCode FDSTAGReadRestart(FDSTAG *fs, FILE *fp);
 
 PetscErrorCode FDSTAGWriteRestart(FDSTAG *fs, FILE *fp);
 
+// partition-independent restart (global coordinates in natural ordering)
+PetscErrorCode FDSTAGWriteRestartPortable(FDSTAG *fs, PetscViewer viewer);
+
+PetscErrorCode FDSTAGReadRestartPortable(FDSTAG *fs, PetscViewer viewer);
+
 PetscErrorCode FDSTAGCreateDMDA(FDSTAG *fs,
 	PetscInt  Nx, PetscInt  Ny, PetscInt  Nz,
 	PetscInt  Px, PetscInt  Py, PetscInt  Pz,
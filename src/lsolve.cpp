@@ -16,6 +16,7 @@
 #include "multigrid.h"
 #include "lsolve.h"
 #include "JacRes.h"
+#include "startup.h"
 //---------------------------------------------------------------------------
 // * implement preconditioners in PETSc
 // * add default solver options
@@ -127,7 +128,10 @@ PetscErrorCode PCStokesSetup(PCStokes pc)
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	ierr = pc->Setup(pc); CHKERRQ(ierr);
+	// profiled during initial guess only
+	ierr = StartupProfBegin(_STARTUP_PC_SETUP_); CHKERRQ(ierr);
+	ierr = pc->Setup(pc);                        CHKERRQ(ierr);
+	ierr = StartupProfEnd  (_STARTUP_PC_SETUP_); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -23,6 +23,7 @@
 #include "bc.h"
 #include "surf.h"
 #include "phase_transition.h"
+#include "startup.h"
 
 /*
 #START_DOC#
@@ -41,7 +42,8 @@ PetscErrorCode ADVMarkInit(AdvCtx *actx, FB *fb)
 	fs = actx->fs;
 
 	// allocate storage for uniform distribution
-	if(actx->msetup != _FILES_)
+	if(actx->msetup != _FILES_
+	&& actx->msetup != _SHARED_)
 	{
 		// get local number of markers
 		nmarkx  = fs->dsx.ncels * actx->NumPartX;
@@ -58,6 +60,7 @@ PetscErrorCode ADVMarkInit(AdvCtx *actx, FB *fb)
 
 	// initialize coordinates, add random noise
 	if(actx->msetup != _FILES_
+	&& actx->msetup != _SHARED_
 	&& actx->msetup != _POLYGONS_)
 	{
 		ierr = ADVMarkInitCoord(actx); CHKERRQ(ierr);
@@ -67,6 +70,7 @@ PetscErrorCode ADVMarkInit(AdvCtx *actx, FB *fb)
 	if     (actx->msetup == _GEOM_)       { ierr = ADVMarkInitGeom    (actx, fb); CHKERRQ(ierr); }
 	else if(actx->msetup == _FILES_)      { ierr = ADVMarkInitFiles   (actx, fb); CHKERRQ(ierr); }
 	else if(actx->msetup == _POLYGONS_)   { ierr = ADVMarkInitPolygons(actx, fb); CHKERRQ(ierr); }
+	else if(actx->msetup == _SHARED_)     { ierr = ADVMarkInitShared  (actx, fb); CHKERRQ(ierr); }
 
 	// set temperature (optional methods)
 
@@ -90,6 +94,8 @@ PetscErrorCode ADVMarkInit(AdvCtx *actx, FB *fb)
 		}
 	}
 
+	ierr = StartupProfBegin(_STARTUP_PHASE_DIAG_); CHKERRQ(ierr);
+
 	if(LoadPhaseDiagrams)
 	{
 		PetscPrintf(PETSC_COMM_WORLD,"Phase Diagrams:  \n");
@@ -113,6 +119,8 @@ PetscErrorCode ADVMarkInit(AdvCtx *actx, FB *fb)
 		PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
 	}
 
+	ierr = StartupProfEnd(_STARTUP_PHASE_DIAG_); CHKERRQ(ierr);
+
 
 	PetscFunctionReturn(0);
 }
@@ -284,6 +292,14 @@ PetscErrorCode ADVMarkSave(AdvCtx *actx)
 
 	if(!actx->saveMark) PetscFunctionReturn(0);
 
+	// single shared file
+	if(actx->saveMark == 2)
+	{
+		ierr = ADVMarkSaveShared(actx); CHKERRQ(ierr);
+
+		PetscFunctionReturn(0);
+	}
+
 	PrintStart(&t, "Saving markers in parallel to", actx->saveFile);
 
 	// access context
@@ -340,6 +356,293 @@ PetscErrorCode ADVMarkSave(AdvCtx *actx)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode ADVMarkSaveShared(AdvCtx *actx)
+{
+	// save all markers to a single shared file (collective MPI-IO)
+
+	char *filename, path[_str_len_];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// compile file name
+	asprintf(&filename, "%s.shared.dat", actx->saveFile);
+
+	// extract directory path & create directory
+	strcpy(path, actx->saveFile); (*strrchr(path, '/')) = '\0';
+
+	ierr = DirMake(path); CHKERRQ(ierr);
+
+	ierr = ADVMarkWriteShared(actx, filename, PETSC_FALSE); CHKERRQ(ierr);
+
+	free(filename);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVMarkWriteShared(AdvCtx *actx, const char *filename, PetscBool full)
+{
+	// write all markers to a single shared file (collective MPI-IO)
+	// file layout (native PetscScalar):
+	//    header : tag, total number of markers, number of buckets (x, y, z), global box (bx, ex, by, ey, bz, ez)
+	//    index  : start record of every bucket + total number of records
+	//    records: markers sorted by buckets (x-fastest), see ADVMarkSharedPack
+	// every rank writes its markers of a bucket as one contiguous block (ordered by rank)
+	// full records are nondimensional and contain complete marker history (restart)
+
+	FDSTAG         *fs;
+	Marker         *P;
+	MPI_File        fh;
+	MPI_Datatype    rtype, ftype;
+	MPI_Offset      disp;
+	MPI_Aint       *displs;
+	PetscMPIInt    *blens, nblock, rank;
+	int             mpierr;
+	PetscLogDouble  t;
+	PetscScalar     hdr[_mark_io_hdr_], *index, *markbuf, *markptr, chLen;
+	PetscInt        imark, ib, nb[3], nbt, *lcnt, *loff, *gcnt, *lstart, *bind, nummark, nrec;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs      = actx->fs;
+	nummark = actx->nummark;
+	chLen   = full ? 1.0 : actx->jr->scal->length;
+	nrec    = full ? _mark_io_rec_full_ : _mark_io_rec_;
+	index   = NULL;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	PrintStart(&t, "Saving markers to shared file", filename);
+
+	// set header
+	nb[0] = PetscMin(fs->dsx.tcels, _mark_io_nb_);
+	nb[1] = PetscMin(fs->dsy.tcels, _mark_io_nb_);
+	nb[2] = PetscMin(fs->dsz.tcels, _mark_io_nb_);
+	nbt   = nb[0]*nb[1]*nb[2];
+
+	hdr[0]  = full ? _mark_io_tag_full_ : _mark_io_tag_;
+	hdr[1]  = 0.0;
+	hdr[2]  = (PetscScalar)nb[0];
+	hdr[3]  = (PetscScalar)nb[1];
+	hdr[4]  = (PetscScalar)nb[2];
+	hdr[5]  = fs->dsx.gcrdbeg*chLen; hdr[6]  = fs->dsx.gcrdend*chLen;
+	hdr[7]  = fs->dsy.gcrdbeg*chLen; hdr[8]  = fs->dsy.gcrdend*chLen;
+	hdr[9]  = fs->dsz.gcrdbeg*chLen; hdr[10] = fs->dsz.gcrdend*chLen;
+
+	ierr = makeIntArray(&lcnt,   NULL, nbt);     CHKERRQ(ierr);
+	ierr = makeIntArray(&loff,   NULL, nbt);     CHKERRQ(ierr);
+	ierr = makeIntArray(&gcnt,   NULL, nbt);     CHKERRQ(ierr);
+	ierr = makeIntArray(&lstart, NULL, nbt+1);   CHKERRQ(ierr);
+	ierr = makeIntArray(&bind,   NULL, nummark); CHKERRQ(ierr);
+
+	ierr = PetscMalloc((size_t)(nrec*nummark)*sizeof(PetscScalar), &markbuf); CHKERRQ(ierr);
+
+	// count local markers per bucket
+	for(imark = 0; imark < nummark; imark++)
+	{
+		P           = &actx->markers[imark];
+		bind[imark] = ADVMarkSharedBucket(P->X, chLen, hdr);
+		lcnt[bind[imark]]++;
+	}
+
+	// get offsets of local blocks within buckets & total bucket sizes
+	ierr = MPI_Exscan   (lcnt, loff, (PetscMPIInt)nbt, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	ierr = MPI_Allreduce(lcnt, gcnt, (PetscMPIInt)nbt, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	if(!rank)
+	{
+		ierr = PetscMemzero(loff, (size_t)nbt*sizeof(PetscInt)); CHKERRQ(ierr);
+	}
+
+	// sort local markers by buckets
+	for(ib = 0; ib < nbt; ib++) lstart[ib+1] = lstart[ib] + lcnt[ib];
+
+	for(imark = 0; imark < nummark; imark++)
+	{
+		P       = &actx->markers[imark];
+		markptr = markbuf + nrec*(lstart[bind[imark]]++);
+
+		ADVMarkSharedPack(actx, P, markptr, full);
+	}
+
+	// get global bucket starts
+	ierr = PetscMalloc((size_t)(nbt+1)*sizeof(PetscScalar), &index); CHKERRQ(ierr);
+
+	index[0] = 0.0;
+
+	for(ib = 0; ib < nbt; ib++) index[ib+1] = index[ib] + (PetscScalar)gcnt[ib];
+
+	hdr[1] = index[nbt];
+
+	// create record type (all counts below are in markers)
+	ierr = MPI_Type_contiguous((PetscMPIInt)nrec, MPIU_SCALAR, &rtype); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&rtype);                                     CHKERRQ(ierr);
+
+	// create file type of local blocks
+	ierr = PetscMalloc((size_t)nbt*sizeof(PetscMPIInt), &blens);  CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)nbt*sizeof(MPI_Aint),    &displs); CHKERRQ(ierr);
+
+	disp   = (MPI_Offset)((_mark_io_hdr_ + nbt + 1)*(PetscInt)sizeof(PetscScalar));
+	nblock = 0;
+
+	for(ib = 0; ib < nbt; ib++)
+	{
+		if(!lcnt[ib]) continue;
+
+		blens [nblock] = (PetscMPIInt)lcnt[ib];
+		displs[nblock] = (MPI_Aint)(disp + nrec*((MPI_Offset)index[ib] + loff[ib])*(MPI_Offset)sizeof(PetscScalar));
+		nblock++;
+	}
+
+	ierr = MPI_Type_create_hindexed(nblock, blens, displs, rtype, &ftype); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&ftype);                                        CHKERRQ(ierr);
+
+	// write file (MPI-IO routines return MPI error codes)
+	mpierr = MPI_File_open(PETSC_COMM_WORLD, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_OPEN, "Cannot open shared marker file %s\n", filename);
+
+	mpierr = MPI_File_set_size(fh, 0);
+
+	if(mpierr == MPI_SUCCESS && !rank)
+	{
+		mpierr = MPI_File_write_at(fh, 0, hdr, _mark_io_hdr_, MPIU_SCALAR, MPI_STATUS_IGNORE);
+
+		if(mpierr == MPI_SUCCESS) mpierr = MPI_File_write_at(fh, (MPI_Offset)(_mark_io_hdr_*(PetscInt)sizeof(PetscScalar)), index, (PetscMPIInt)(nbt+1), MPIU_SCALAR, MPI_STATUS_IGNORE);
+	}
+
+	if(mpierr == MPI_SUCCESS) mpierr = MPI_File_set_view(fh, 0, rtype, ftype, (char*)"native", MPI_INFO_NULL);
+	if(mpierr == MPI_SUCCESS) mpierr = MPI_File_write_all(fh, markbuf, (PetscMPIInt)nummark, rtype, MPI_STATUS_IGNORE);
+
+	MPI_File_close(&fh);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Cannot write shared marker file %s\n", filename);
+
+	// clean up
+	ierr = MPI_Type_free(&ftype); CHKERRQ(ierr);
+	ierr = MPI_Type_free(&rtype); CHKERRQ(ierr);
+	ierr = PetscFree(lcnt);       CHKERRQ(ierr);
+	ierr = PetscFree(loff);       CHKERRQ(ierr);
+	ierr = PetscFree(gcnt);       CHKERRQ(ierr);
+	ierr = PetscFree(lstart);     CHKERRQ(ierr);
+	ierr = PetscFree(bind);       CHKERRQ(ierr);
+	ierr = PetscFree(markbuf);    CHKERRQ(ierr);
+	ierr = PetscFree(index);      CHKERRQ(ierr);
+	ierr = PetscFree(blens);      CHKERRQ(ierr);
+	ierr = PetscFree(displs);     CHKERRQ(ierr);
+
+	PrintDone(t);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscInt ADVMarkSharedBucket(PetscScalar *X, PetscScalar chLen, PetscScalar *hdr)
+{
+	// get bucket index of a marker in a shared marker file
+
+	return ADVMarkSharedBucketDir(X[0], chLen, hdr, 0)
+	+      ADVMarkSharedBucketDir(X[1], chLen, hdr, 1)*(PetscInt)hdr[2]
+	+      ADVMarkSharedBucketDir(X[2], chLen, hdr, 2)*(PetscInt)hdr[2]*(PetscInt)hdr[3];
+}
+//---------------------------------------------------------------------------
+PetscInt ADVMarkSharedBucketDir(PetscScalar x, PetscScalar chLen, PetscScalar *hdr, PetscInt dir)
+{
+	// get bucket index of a coordinate in one direction (clamped to valid range)
+
+	PetscInt    n, ib;
+	PetscScalar beg, end;
+
+	n   = (PetscInt)hdr[2+dir];
+	beg = hdr[5+2*dir];
+	end = hdr[6+2*dir];
+
+	ib = (PetscInt)PetscFloorReal((x*chLen - beg)/(end - beg)*(PetscScalar)n);
+
+	if(ib < 0)     ib = 0;
+	if(ib > n - 1) ib = n - 1;
+
+	return ib;
+}
+//---------------------------------------------------------------------------
+void ADVMarkSharedPack(AdvCtx *actx, Marker *P, PetscScalar *rec, PetscBool full)
+{
+	// pack shared file record of a marker
+	// short : X (dimensional), phase, T (dimensional)
+	// full  : X, phase, T, p, APS, ATS, S (xx, yy, zz, xy, xz, yz), U (nondimensional)
+
+	Scaling *scal;
+
+	scal = actx->jr->scal;
+
+	if(!full)
+	{
+		rec[0] =              P->X[0]*scal->length;
+		rec[1] =              P->X[1]*scal->length;
+		rec[2] =              P->X[2]*scal->length;
+		rec[3] = (PetscScalar)P->phase;
+		rec[4] =              P->T*scal->temperature - scal->Tshift;
+
+		return;
+	}
+
+	rec[0]  =              P->X[0];
+	rec[1]  =              P->X[1];
+	rec[2]  =              P->X[2];
+	rec[3]  = (PetscScalar)P->phase;
+	rec[4]  =              P->T;
+	rec[5]  =              P->p;
+	rec[6]  =              P->APS;
+	rec[7]  =              P->ATS;
+	rec[8]  =              P->S.xx;
+	rec[9]  =              P->S.yy;
+	rec[10] =              P->S.zz;
+	rec[11] =              P->S.xy;
+	rec[12] =              P->S.xz;
+	rec[13] =              P->S.yz;
+	rec[14] =              P->U[0];
+	rec[15] =              P->U[1];
+	rec[16] =              P->U[2];
+}
+//---------------------------------------------------------------------------
+void ADVMarkSharedUnpack(AdvCtx *actx, Marker *P, PetscScalar *rec, PetscBool full)
+{
+	// unpack shared file record of a marker (see ADVMarkSharedPack)
+
+	Scaling *scal;
+
+	scal = actx->jr->scal;
+
+	if(!full)
+	{
+		P->X[0]  =           rec[0]/scal->length;
+		P->X[1]  =           rec[1]/scal->length;
+		P->X[2]  =           rec[2]/scal->length;
+		P->phase = (PetscInt)rec[3];
+		P->T     =          (rec[4] + scal->Tshift)/scal->temperature;
+
+		return;
+	}
+
+	P->X[0]  =           rec[0];
+	P->X[1]  =           rec[1];
+	P->X[2]  =           rec[2];
+	P->phase = (PetscInt)rec[3];
+	P->T     =           rec[4];
+	P->p     =           rec[5];
+	P->APS   =           rec[6];
+	P->ATS   =           rec[7];
+	P->S.xx  =           rec[8];
+	P->S.yy  =           rec[9];
+	P->S.zz  =           rec[10];
+	P->S.xy  =           rec[11];
+	P->S.xz  =           rec[12];
+	P->S.yz  =           rec[13];
+	P->U[0]  =           rec[14];
+	P->U[1]  =           rec[15];
+	P->U[2]  =           rec[16];
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVMarkCheckMarkers(AdvCtx *actx)
 {
 	// check initial marker distribution
@@ -816,7 +1119,8 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	PetscLogDouble  t;
 	PetscScalar     chLen, chTime;
 	char            TemperatureStructure[_str_len_];
-	PetscInt        jj, ngeom, imark, maxPhaseID;
+	PetscInt        jj, ngeom, imark, icell, npcell, maxPhaseID, nlayer, noisy;
+	PetscInt       *cstart, *cgind, ilayer[_max_geom_];
 	GeomPrim        geom[_max_geom_], *pgeom[_max_geom_], *sphere, *ellipsoid, *box, *ridge, *hex, *layer, *cylinder;
 
 	// map container to sort primitives in the order of appearance
@@ -1153,6 +1457,29 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	// ASSIGN PHASES
 	//==============
 
+	// get primitives that can overlap every local cell (in the order of appearance)
+	ierr = ADVMarkGeomCandidates(actx, pgeom, ngeom, &cstart, &cgind); CHKERRQ(ierr);
+
+	// markers are created cell by cell (see ADVMarkInitCoord)
+	npcell = actx->NumPartX*actx->NumPartY*actx->NumPartZ;
+
+	if(actx->nummark != actx->fs->nCells*npcell)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Markers must be created cell by cell before assigning phases from geometric primitives\n");
+	}
+
+	// get layers in the order of appearance
+	for(jj = 0, nlayer = 0, noisy = 0; jj < ngeom; jj++)
+	{
+		if(pgeom[jj]->setPhase != setPhaseLayer) continue;
+
+		if(pgeom[jj]->rand_amplitude != 0.0) noisy = 1;
+
+		pgeom[jj]->rand_pert = 0.0;
+
+		ilayer[nlayer++] = jj;
+	}
+
 	// loop over local markers
 	for(imark = 0; imark < actx->nummark; imark++)
 	{
@@ -1161,13 +1488,311 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 		//set default
 		P->phase = actx->bgPhase;
 
-		// override from geometric primitives
+		// draw random noise of every layer for every marker (whether or not the layer is tested),
+		// so that the sequence of random numbers is the same as without candidate primitives
+		if(noisy)
+		{
+			for(jj = 0; jj < nlayer; jj++)
+			{
+				layer            = pgeom[ilayer[jj]];
+				layer->rand_pert = (rand()/PetscScalar(RAND_MAX)-0.5)*layer->rand_amplitude;
+			}
+		}
+
+		// get host cell
+		icell = imark/npcell;
+
+		// override from candidate geometric primitives
+		for(jj = cstart[icell]; jj < cstart[icell+1]; jj++)
+		{
+			pgeom[cgind[jj]]->setPhase(pgeom[cgind[jj]], P);
+		}
+	}
+
+	ierr = PetscFree(cstart); CHKERRQ(ierr);
+	ierr = PetscFree(cgind);  CHKERRQ(ierr);
+
+	PrintDone(t);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVMarkGeomCandidates(
+		AdvCtx     *actx,
+		GeomPrim  **pgeom,
+		PetscInt    ngeom,
+		PetscInt  **pcstart,
+		PetscInt  **pcgind)
+{
+	// build lists of geometric primitives which bounding boxes overlap local cells
+	// (compressed storage, primitives of every cell are listed in the order of appearance)
+	// -mark_geom_nocull lists all primitives in every cell (reference for regression tests)
+
+	FDSTAG      *fs;
+	Discret1D   *ds[3];
+	PetscScalar  box[6], h[3];
+	PetscInt     ib[3], ie[3], npart[3];
+	PetscInt     d, i, j, k, jj, nx, ny, ncells, *cstart, *cgind, *cnt;
+	PetscBool    nocull;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscOptionsHasName(NULL, NULL, "-mark_geom_nocull", &nocull); CHKERRQ(ierr);
+
+	fs       = actx->fs;
+	ds[0]    = &fs->dsx;
+	ds[1]    = &fs->dsy;
+	ds[2]    = &fs->dsz;
+	npart[0] = actx->NumPartX;
+	npart[1] = actx->NumPartY;
+	npart[2] = actx->NumPartZ;
+	nx       = fs->dsx.ncels;
+	ny       = fs->dsy.ncels;
+	ncells   = fs->nCells;
+
+	// get maximum subcell sizes to enlarge bounding boxes (covers random noise & round-off)
+	for(k = 0; k < 3; k++)
+	{
+		h[k] = 0.0;
+
+		for(i = 0; i < ds[k]->ncels; i++)
+		{
+			h[k] = PetscMax(h[k], ds[k]->ncoor[i+1] - ds[k]->ncoor[i]);
+		}
+
+		h[k] /= (PetscScalar)npart[k];
+	}
+
+	ierr = makeIntArray(&cstart, NULL, ncells+1); CHKERRQ(ierr);
+	ierr = makeIntArray(&cnt,    NULL, ncells+1); CHKERRQ(ierr);
+
+	// count & fill in two passes
+	for(d = 0; d < 2; d++)
+	{
+		if(d) { ierr = PetscMemcpy(cnt, cstart, (size_t)(ncells+1)*sizeof(PetscInt)); CHKERRQ(ierr); }
+
 		for(jj = 0; jj < ngeom; jj++)
 		{
-			pgeom[jj]->setPhase(pgeom[jj], P);
+			GeomPrimGetBoundingBox(pgeom[jj], box);
+
+			// get range of overlapped cells
+			for(k = 0; k < 3; k++)
+			{
+				if(nocull) { ib[k] = 0; ie[k] = ds[k]->ncels - 1; continue; }
+
+				GeomGetCellRange(ds[k]->ncels, ds[k]->ncoor, box[2*k] - h[k], box[2*k+1] + h[k], ib[k], ie[k]);
+			}
+
+			for(k = ib[2]; k <= ie[2]; k++)
+			for(j = ib[1]; j <= ie[1]; j++)
+			for(i = ib[0]; i <= ie[0]; i++)
+			{
+				if(!d) cnt[i + j*nx + k*nx*ny]++;
+				else   cgind[cnt[i + j*nx + k*nx*ny]++] = jj;
+			}
+		}
+
+		if(!d)
+		{
+			// compute list starts
+			for(i = 0; i < ncells; i++) cstart[i+1] = cstart[i] + cnt[i];
+
+			ierr = makeIntArray(&cgind, NULL, cstart[ncells]+1); CHKERRQ(ierr);
+		}
+	}
+
+	ierr = PetscFree(cnt); CHKERRQ(ierr);
+
+	(*pcstart) = cstart;
+	(*pcgind)  = cgind;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVMarkInitShared(AdvCtx *actx, FB *fb)
+{
+	// read markers from a single shared file (see ADVMarkSaveShared)
+
+	char *filename, file[_str_len_];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// get file name
+	ierr = getStringParam(fb, _OPTIONAL_, "mark_load_file", file, "./markers/mdb"); CHKERRQ(ierr);
+
+	asprintf(&filename, "%s.shared.dat", file);
+
+	ierr = ADVMarkReadShared(actx, filename, PETSC_FALSE); CHKERRQ(ierr);
+
+	free(filename);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVMarkReadShared(AdvCtx *actx, const char *filename, PetscBool full)
+{
+	// read markers from a single shared file (see ADVMarkWriteShared)
+	// every rank reads only buckets overlapping its subdomain and keeps markers it owns
+	// markers are distributed by position, independent of partitioning used for writing
+
+	FDSTAG         *fs;
+	Discret1D      *ds[3];
+	Marker         *P;
+	MPI_File        fh;
+	MPI_Datatype    rtype, ftype;
+	MPI_Offset      disp, rb, re;
+	MPI_Aint       *displs;
+	PetscMPIInt    *blens, nblock;
+	int             mpierr;
+	PetscLogDouble  t;
+	PetscScalar     hdr[_mark_io_hdr_], *index, *markbuf, *markptr, X[3], bx[3], ex[3], chLen;
+	PetscInt        j, k, d, nb[3], nbt, ib[3], ie[3], first, last, nread, imark, nummark, nrec;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs     = actx->fs;
+	ds[0]  = &fs->dsx;
+	ds[1]  = &fs->dsy;
+	ds[2]  = &fs->dsz;
+	chLen  = full ? 1.0 : actx->jr->scal->length;
+	nrec   = full ? _mark_io_rec_full_ : _mark_io_rec_;
+
+	PrintStart(&t, "Loading markers from shared file", filename);
+
+	// MPI-IO routines return MPI error codes
+	mpierr = MPI_File_open(PETSC_COMM_WORLD, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_OPEN, "Cannot open shared marker file %s\n", filename);
+
+	// read header
+	mpierr = MPI_File_read_at_all(fh, 0, hdr, _mark_io_hdr_, MPIU_SCALAR, MPI_STATUS_IGNORE);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_READ, "Cannot read header of shared marker file %s\n", filename);
+
+	if(hdr[0] != (full ? _mark_io_tag_full_ : _mark_io_tag_))
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incompatible shared marker file (wrong tag or byte order): %s", filename);
+	}
+
+	nb[0] = (PetscInt)hdr[2];
+	nb[1] = (PetscInt)hdr[3];
+	nb[2] = (PetscInt)hdr[4];
+	nbt   = nb[0]*nb[1]*nb[2];
+
+	// read bucket index
+	ierr = PetscMalloc((size_t)(nbt+1)*sizeof(PetscScalar), &index); CHKERRQ(ierr);
+
+	mpierr = MPI_File_read_at_all(fh, (MPI_Offset)(_mark_io_hdr_*(PetscInt)sizeof(PetscScalar)), index, (PetscMPIInt)(nbt+1), MPIU_SCALAR, MPI_STATUS_IGNORE);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_READ, "Cannot read bucket index of shared marker file %s\n", filename);
+
+	// get range of overlapped buckets (with one bucket margin)
+	// first & last ranks in every direction own everything beyond the global box
+	for(d = 0; d < 3; d++)
+	{
+		first = (ds[d]->grprev == -1);
+		last  = (ds[d]->grnext == -1);
+
+		bx[d] = ds[d]->ncoor[0];
+		ex[d] = ds[d]->ncoor[ds[d]->ncels];
+
+		ib[d] = PetscMax(ADVMarkSharedBucketDir(bx[d], chLen, hdr, d) - 1, 0);
+		ie[d] = PetscMin(ADVMarkSharedBucketDir(ex[d], chLen, hdr, d) + 1, nb[d] - 1);
+
+		if(first) { ib[d] = 0;         bx[d] = -DBL_MAX; }
+		if(last)  { ie[d] = nb[d] - 1; ex[d] =  DBL_MAX; }
+	}
+
+	// create record type (all counts below are in markers)
+	ierr = MPI_Type_contiguous((PetscMPIInt)nrec, MPIU_SCALAR, &rtype); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&rtype);                                     CHKERRQ(ierr);
+
+	// create file type of contiguous bucket rows
+	ierr = PetscMalloc((size_t)(nb[1]*nb[2])*sizeof(PetscMPIInt), &blens);  CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(nb[1]*nb[2])*sizeof(MPI_Aint),    &displs); CHKERRQ(ierr);
+
+	disp   = (MPI_Offset)((_mark_io_hdr_ + nbt + 1)*(PetscInt)sizeof(PetscScalar));
+	nblock = 0;
+	nread  = 0;
+
+	for(k = ib[2]; k <= ie[2]; k++)
+	for(j = ib[1]; j <= ie[1]; j++)
+	{
+		// records of bucket row are contiguous
+		rb = (MPI_Offset)index[ib[0]   + j*nb[0] + k*nb[0]*nb[1]];
+		re = (MPI_Offset)index[ie[0]+1 + j*nb[0] + k*nb[0]*nb[1]];
+
+		if(re == rb) continue;
+
+		blens [nblock] = (PetscMPIInt)(re - rb);
+		displs[nblock] = (MPI_Aint)(disp + nrec*rb*(MPI_Offset)sizeof(PetscScalar));
+		nblock++;
+		nread += (PetscInt)(re - rb);
+	}
+
+	ierr = MPI_Type_create_hindexed(nblock, blens, displs, rtype, &ftype); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&ftype);                                        CHKERRQ(ierr);
+
+	// read records
+	ierr = PetscMalloc((size_t)(nrec*nread)*sizeof(PetscScalar), &markbuf); CHKERRQ(ierr);
+
+	mpierr = MPI_File_set_view(fh, 0, rtype, ftype, (char*)"native", MPI_INFO_NULL);
+
+	if(mpierr == MPI_SUCCESS) mpierr = MPI_File_read_all(fh, markbuf, (PetscMPIInt)nread, rtype, MPI_STATUS_IGNORE);
+
+	MPI_File_close(&fh);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_READ, "Cannot read markers from shared marker file %s\n", filename);
+
+	// keep owned markers only
+	nummark = 0;
+
+	for(imark = 0, markptr = markbuf; imark < nread; imark++, markptr += nrec)
+	{
+		X[0] = markptr[0]/chLen;
+		X[1] = markptr[1]/chLen;
+		X[2] = markptr[2]/chLen;
+
+		if(X[0] < bx[0] || X[0] >= ex[0]
+		|| X[1] < bx[1] || X[1] >= ex[1]
+		|| X[2] < bx[2] || X[2] >= ex[2]) continue;
+
+		// compact owned records
+		if(nummark != imark)
+		{
+			ierr = PetscMemcpy(markbuf + nrec*nummark, markptr, (size_t)nrec*sizeof(PetscScalar)); CHKERRQ(ierr);
 		}
+
+		nummark++;
+	}
+
+	// allocate marker storage
+	ierr = ADVReAllocStorage(actx, nummark); CHKERRQ(ierr);
+
+	// set number of markers
+	actx->nummark = nummark;
+
+	// copy buffer to marker storage
+	for(imark = 0, markptr = markbuf; imark < nummark; imark++, markptr += nrec)
+	{
+		P = &actx->markers[imark];
+
+		ierr = PetscMemzero(P, sizeof(Marker)); CHKERRQ(ierr);
+
+		ADVMarkSharedUnpack(actx, P, markptr, full);
 	}
 
+	// clean up
+	ierr = MPI_Type_free(&ftype); CHKERRQ(ierr);
+	ierr = MPI_Type_free(&rtype); CHKERRQ(ierr);
+	ierr = PetscFree(index);      CHKERRQ(ierr);
+	ierr = PetscFree(markbuf);    CHKERRQ(ierr);
+	ierr = PetscFree(blens);      CHKERRQ(ierr);
+	ierr = PetscFree(displs);     CHKERRQ(ierr);
+
 	PrintDone(t);
 
 	PetscFunctionReturn(0);
@@ -1201,14 +1826,19 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	PetscScalar    box[4];
 	CtrlP          CtrlPoly;
 	PetscInt       VolID, nCP;
+	PetscInt       distr, bcap, *bstart, *bedge;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	distr = 0;
+
 	// get file name
-	ierr = getStringParam(fb, _OPTIONAL_, "poly_file", filename, "./input/poly.dat"); CHKERRQ(ierr);
+	ierr = getStringParam(fb, _OPTIONAL_, "poly_file",  filename, "./input/poly.dat"); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "poly_distr", &distr,   1, 1);                 CHKERRQ(ierr);
 
-	PrintStart(&t, "Loading polygons redundantly from", filename);
+	if(distr) PrintStart(&t, "Loading polygons (distributed) from", filename);
+	else      PrintStart(&t, "Loading polygons redundantly from", filename);
 
 	// initialize
 	fs = actx->fs;
@@ -1322,20 +1952,35 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	nidx[1] = nmark[0] * nmark[2]; if (nidx[1] > nidxmax) nidxmax = nidx[1];
 	nidx[2] = nmark[0] * nmark[1]; if (nidx[2] > nidxmax) nidxmax = nidx[2];
 
-	// read file
-	ierr = PetscViewerBinaryOpen(PETSC_COMM_SELF, filename, FILE_MODE_READ, &view_in); CHKERRQ(ierr);
-	ierr = PetscViewerBinaryGetDescriptor(view_in, &fd);                               CHKERRQ(ierr);
+	// read geometry variations
+	ierr = ADVMarkReadCtrlPoly(fb, &CtrlPoly, VolID, nCP); CHKERRQ(ierr);
 
-	// read (and ignore) the silent undocumented file header & size of file
-	ierr = PetscBinaryRead(fd, &header, 2, NULL, PETSC_SCALAR); CHKERRQ(ierr);
-	Fsize = (PetscInt)(header[1]);
+	if(distr)
+	{
+		// read local slices only (collective MPI-IO)
+		ierr = ADVMarkReadPolyDistr(actx, filename, tstart, tend, VolID, &PolyFile); CHKERRQ(ierr);
+	}
+	else
+	{
+		// read file
+		ierr = PetscViewerBinaryOpen(PETSC_COMM_SELF, filename, FILE_MODE_READ, &view_in); CHKERRQ(ierr);
+		ierr = PetscViewerBinaryGetDescriptor(view_in, &fd);                               CHKERRQ(ierr);
 
-	// allocate space for entire file & initialize counter
-	ierr = PetscMalloc((size_t)Fsize  *sizeof(PetscScalar),&PolyFile); CHKERRQ(ierr);
-	Fcount = 0;
+		// read (and ignore) the silent undocumented file header & size of file
+		ierr = PetscBinaryRead(fd, &header, 2, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+		Fsize = (PetscInt)(header[1]);
 
-	// read entire file 
-	ierr = PetscBinaryRead(fd, PolyFile, Fsize, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+		// allocate space for entire file
+		ierr = PetscMalloc((size_t)Fsize  *sizeof(PetscScalar),&PolyFile); CHKERRQ(ierr);
+
+		// read entire file
+		ierr = PetscBinaryRead(fd, PolyFile, Fsize, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+		ierr = PetscViewerDestroy(&view_in); CHKERRQ(ierr);
+	}
+
+	// initialize counter
+	Fcount = 0;
 
 	// read number of volumes
 	VolN = (PetscInt)(PolyFile[Fcount]); Fcount++;
@@ -1354,8 +1999,10 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	ierr = PetscMemzero(polyin_sum, (size_t)nidxmax*sizeof(PetscInt)); CHKERRQ(ierr);
 	ierr = PetscMalloc((size_t)nidxmax*2*sizeof(PetscScalar),&X);      CHKERRQ(ierr);
 
-	// read geometry variations
-	ierr = ADVMarkReadCtrlPoly(fb, &CtrlPoly, VolID, nCP); CHKERRQ(ierr);
+	// allocate edge buckets
+	ierr = makeIntArray(&bstart, NULL, Lmax+1); CHKERRQ(ierr);
+	bedge = NULL;
+	bcap  = 0;
 
 	// --- loop over all volumes ---
 	for(kvol = 0; kvol < VolN; kvol++)
@@ -1459,8 +2106,8 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 			// loop over group of polygons and check which markers are in which polygon
 			for(lpoly = 0; lpoly < numLev+1; lpoly++)
 			{
-				// check if slice is part of local proc
-				if(Polys[lpoly].gidx >= tstart[Vol.dir] && Polys[lpoly].gidx <= tend[Vol.dir])
+				// check if slice is part of local proc (distributed input skips the rest)
+				if(Polys[lpoly].gidx >= tstart[Vol.dir] && Polys[lpoly].gidx <= tend[Vol.dir] && Polys[lpoly].len)
 				{
 					// read polygon
 					for (n=0; n<Polys[lpoly].len*2;n++)
@@ -1488,8 +2135,11 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 
 					polygon_box(&nPoly, PolyX, 1e-12, &atol, box);
 
+					// sort polygon edges into buckets
+					ierr = polygon_buckets(nPoly, PolyX, box, nPoly, bstart, &bedge, &bcap); CHKERRQ(ierr);
+
 					// check which markers are in the polygon
-					in_polygon(nidx[Vol.dir], X, nPoly, PolyX, box, atol, polyin);
+					in_polygon_buckets(nidx[Vol.dir], X, nPoly, PolyX, box, atol, nPoly, bstart, bedge, polyin);
 
 					// sum up number of polygons that a marker is in
 					for(k = 0; k < nidx[Vol.dir]; k++)
@@ -1540,19 +2190,347 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	PetscFree(PolyLen);
 	PetscFree(PolyX);
 	PetscFree(PolyFile);
+	PetscFree(bstart);
+	PetscFree(bedge);
 	
 	if(actx->randNoise)
 	{
 		ierr = PetscRandomDestroy(&rctx); CHKERRQ(ierr);
 	}
 
-	ierr = PetscViewerDestroy(&view_in); CHKERRQ(ierr);
-
 	PrintDone(t);
 
 	PetscFunctionReturn(ierr);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode ADVMarkReadPolyDistr(
+	AdvCtx       *actx,
+	const char   *filename,
+	PetscInt     *tstart,
+	PetscInt     *tend,
+	PetscInt      VolID,
+	PetscScalar **pPolyFile)
+{
+	// read only the polygon slices required by every rank (collective MPI-IO)
+	// * first rank reads the file structure (volume headers, positions & lengths of slices)
+	//   skipping the coordinates, and broadcasts it
+	// * every rank reads coordinates of the slices within its marker plane range
+	//   (single collective read, counted in polygon points)
+	// * slices outside the local bounding box are dropped (see ADVMarkFilterPoly)
+	// dropped slices keep their index, but get zero length and no coordinates
+
+	FDSTAG       *fs;
+	Discret1D    *ds[3];
+	int           fd;
+	off_t         fpos;
+	PetscViewer   view_in;
+	MPI_File      fh;
+	MPI_Datatype  ptype, ftype;
+	MPI_Aint     *bdisp;
+	PetscMPIInt  *blen, rank, nblk;
+	PetscScalar   header[2], info[12], h, *ind, *coff, *X, *lfile, *PolyFile;
+	PetscInt      k, i, kvol, kpoly, VolN, num, dir, len, gidx, keep, nind, npts, nslc, n, Fcount, ilen;
+	MPI_Offset    disp;
+	int           mpierr;
+
+	vector<PetscScalar> index, offset;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs    = actx->fs;
+	ds[0] = &fs->dsx;
+	ds[1] = &fs->dsy;
+	ds[2] = &fs->dsz;
+	nind  = 0;
+
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	// marker plane ranges & local bounding box (file units, enlarged by one cell)
+	for(k = 0; k < 3; k++)
+	{
+		h = 0.0;
+
+		for(i = 0; i < ds[k]->ncels; i++) h = PetscMax(h, ds[k]->ncoor[i+1] - ds[k]->ncoor[i]);
+
+		info[k]       = (PetscScalar)tstart[k];
+		info[k+3]     = (PetscScalar)tend[k];
+		info[6+2*k]   = (ds[k]->ncoor[0]            - h)*actx->jr->scal->length;
+		info[6+2*k+1] = (ds[k]->ncoor[ds[k]->ncels] + h)*actx->jr->scal->length;
+	}
+
+	//==================================================
+	// read & broadcast file structure (skip coordinates)
+	//==================================================
+
+	if(!rank)
+	{
+		ierr = PetscViewerBinaryOpen(PETSC_COMM_SELF, filename, FILE_MODE_READ, &view_in); CHKERRQ(ierr);
+		ierr = PetscViewerBinaryGetDescriptor(view_in, &fd);                               CHKERRQ(ierr);
+
+		// read (and ignore) file header
+		ierr = PetscBinaryRead(fd, header, 2, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+		// number of volumes & maximum sizes
+		index.resize(3);
+
+		ierr = PetscBinaryRead(fd, index.data(), 3, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+		VolN   = (PetscInt)index[0];
+		Fcount = 3;
+
+		for(kvol = 0; kvol < VolN; kvol++)
+		{
+			// volume header
+			n = (PetscInt)index.size();
+			index.resize((size_t)(n+4));
+
+			ierr = PetscBinaryRead(fd, index.data() + n, 4, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+			num     = (PetscInt)index[(size_t)(n+3)];
+			Fcount += 4;
+
+			// positions & lengths of slices
+			n = (PetscInt)index.size();
+			index.resize((size_t)(n+2*num));
+
+			ierr = PetscBinaryRead(fd, index.data() + n, 2*num, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+			Fcount += 2*num;
+
+			// byte offset of coordinates in file
+			offset.push_back((PetscScalar)((2 + Fcount)*(PetscInt)sizeof(PetscScalar)));
+
+			// skip coordinates
+			for(kpoly = 0, len = 0; kpoly < num; kpoly++) len += (PetscInt)index[(size_t)(n+num+kpoly)];
+
+			ierr = PetscBinarySeek(fd, (off_t)(2*len)*(off_t)sizeof(PetscScalar), PETSC_BINARY_SEEK_CUR, &fpos); CHKERRQ(ierr);
+
+			Fcount += 2*len;
+		}
+
+		ierr = PetscViewerDestroy(&view_in); CHKERRQ(ierr);
+
+		// append coordinate offsets of volumes
+		index.insert(index.end(), offset.begin(), offset.end());
+
+		nind = (PetscInt)index.size();
+	}
+
+	ierr = MPI_Bcast(&nind, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	ierr = PetscMalloc((size_t)nind*sizeof(PetscScalar), &ind); CHKERRQ(ierr);
+
+	if(!rank) { ierr = PetscMemcpy(ind, index.data(), (size_t)nind*sizeof(PetscScalar)); CHKERRQ(ierr); }
+
+	ierr = MPI_Bcast(ind, (PetscMPIInt)nind, MPIU_SCALAR, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	VolN = (PetscInt)ind[0];
+	coff = ind + nind - VolN;
+
+	//==================================================
+	// collect coordinate blocks of local slices
+	//==================================================
+
+	nslc = (nind - VolN - 3)/2;
+
+	ierr = PetscMalloc((size_t)(nslc+1)*sizeof(PetscMPIInt), &blen);  CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(nslc+1)*sizeof(MPI_Aint),    &bdisp); CHKERRQ(ierr);
+
+	for(kvol = 0, Fcount = 3, nblk = 0, npts = 0; kvol < VolN; kvol++)
+	{
+		dir     = (PetscInt)ind[Fcount];
+		num     = (PetscInt)ind[Fcount+3];
+		Fcount += 4;
+		disp    = (MPI_Offset)coff[kvol];
+
+		for(kpoly = 0; kpoly < num; kpoly++)
+		{
+			gidx = (PetscInt)ind[Fcount + kpoly];
+			len  = (PetscInt)ind[Fcount + num + kpoly];
+			keep = (gidx >= (PetscInt)info[dir] && gidx <= (PetscInt)info[dir+3]);
+
+			if(keep && len)
+			{
+				blen [nblk] = (PetscMPIInt)len;
+				bdisp[nblk] = (MPI_Aint)disp;
+				nblk++;
+				npts += len;
+			}
+
+			disp += (MPI_Offset)(2*len)*(MPI_Offset)sizeof(PetscScalar);
+		}
+
+		Fcount += 2*num;
+	}
+
+	if(npts > PETSC_MPI_INT_MAX)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Too many polygon points on a single rank in file %s, use more ranks\n", filename);
+	}
+
+	//==================================================
+	// read coordinates of local slices
+	//==================================================
+
+	ierr = PetscMalloc((size_t)(2*npts+1)*sizeof(PetscScalar), &X); CHKERRQ(ierr);
+
+	// polygon point datatype & file view of local slices
+	ierr = MPI_Type_contiguous(2, MPIU_SCALAR, &ptype);                CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&ptype);                                    CHKERRQ(ierr);
+	ierr = MPI_Type_create_hindexed(nblk, blen, bdisp, ptype, &ftype); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&ftype);                                    CHKERRQ(ierr);
+
+	mpierr = MPI_File_open(PETSC_COMM_WORLD, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_OPEN, "Cannot open polygon file %s\n", filename);
+
+	mpierr = MPI_File_set_view(fh, 0, ptype, ftype, "native", MPI_INFO_NULL);
+
+	if(mpierr == MPI_SUCCESS) mpierr = MPI_File_read_all(fh, X, (PetscMPIInt)npts, ptype, MPI_STATUS_IGNORE);
+
+	MPI_File_close(&fh);
+
+	if(mpierr != MPI_SUCCESS) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_READ, "Cannot read polygon file %s\n", filename);
+
+	ierr = MPI_Type_free(&ftype); CHKERRQ(ierr);
+	ierr = MPI_Type_free(&ptype); CHKERRQ(ierr);
+
+#if !defined(PETSC_WORDS_BIGENDIAN)
+	// PETSc binary files are big-endian
+	ierr = PetscByteSwap(X, PETSC_SCALAR, 2*npts); CHKERRQ(ierr);
+#endif
+
+	//==================================================
+	// assemble local polygon data & filter by bounding box
+	//==================================================
+
+	ierr = PetscMalloc((size_t)(nind - VolN + 2*npts)*sizeof(PetscScalar), &lfile);    CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(nind - VolN + 2*npts)*sizeof(PetscScalar), &PolyFile); CHKERRQ(ierr);
+
+	for(i = 0, n = 0; i < 3; i++) lfile[n++] = ind[i];
+
+	for(kvol = 0, Fcount = 3, npts = 0; kvol < VolN; kvol++)
+	{
+		dir = (PetscInt)ind[Fcount];
+		num = (PetscInt)ind[Fcount+3];
+
+		for(i = 0; i < 4; i++) lfile[n++] = ind[Fcount++];
+
+		// positions & lengths of slices (lengths of dropped slices are reset below)
+		ilen = n + num;
+
+		for(i = 0; i < 2*num; i++) lfile[n++] = ind[Fcount++];
+
+		for(kpoly = 0; kpoly < num; kpoly++)
+		{
+			gidx = (PetscInt)lfile[ilen - num + kpoly];
+			len  = (PetscInt)lfile[ilen + kpoly];
+			keep = (gidx >= (PetscInt)info[dir] && gidx <= (PetscInt)info[dir+3]);
+
+			if(keep)
+			{
+				for(i = 0; i < 2*len; i++) lfile[n++] = X[2*npts + i];
+
+				npts += len;
+			}
+			else
+			{
+				lfile[ilen + kpoly] = 0.0;
+			}
+		}
+	}
+
+	ADVMarkFilterPoly(lfile, info, VolID, PolyFile, &n);
+
+	ierr = PetscFree(ind);   CHKERRQ(ierr);
+	ierr = PetscFree(blen);  CHKERRQ(ierr);
+	ierr = PetscFree(bdisp); CHKERRQ(ierr);
+	ierr = PetscFree(X);     CHKERRQ(ierr);
+	ierr = PetscFree(lfile); CHKERRQ(ierr);
+
+	(*pPolyFile) = PolyFile;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void ADVMarkFilterPoly(
+	PetscScalar *PolyFile, // entire polygon file (without header)
+	PetscScalar *info,     // marker plane ranges & bounding box of target rank
+	PetscInt     VolID,    // volume with varying geometry (never filtered by box)
+	PetscScalar *buff,     // filtered polygon data
+	PetscInt    *pn)       // size of filtered data
+{
+	// copy polygon file, keep coordinates of slices that can affect target rank only
+
+	PetscInt     kvol, kpoly, VolN, num, dir, ax[2], len, gidx, keep, i, n, Fcount, ilen;
+	PetscScalar *X, xmin, xmax, ymin, ymax;
+
+	Fcount = 0;
+	n      = 0;
+
+	// copy number of volumes & maximum sizes
+	VolN = (PetscInt)(PolyFile[0]);
+
+	for(i = 0; i < 3; i++) buff[n++] = PolyFile[Fcount++];
+
+	for(kvol = 0; kvol < VolN; kvol++)
+	{
+		// copy volume header
+		dir = (PetscInt)(PolyFile[Fcount]);
+		num = (PetscInt)(PolyFile[Fcount+3]);
+
+		for(i = 0; i < 4; i++) buff[n++] = PolyFile[Fcount++];
+
+		if     (dir == 0) { ax[0] = 1; ax[1] = 2; }
+		else if(dir == 1) { ax[0] = 0; ax[1] = 2; }
+		else              { ax[0] = 0; ax[1] = 1; }
+
+		// copy positions & lengths of polygons (lengths are modified below)
+		ilen = n + num;
+
+		for(i = 0; i < 2*num; i++) buff[n++] = PolyFile[Fcount++];
+
+		// filter slices
+		for(kpoly = 0; kpoly < num; kpoly++)
+		{
+			gidx = (PetscInt)(PolyFile[Fcount - 2*num + kpoly]);
+			len  = (PetscInt)(buff[ilen + kpoly]);
+			X    = PolyFile + Fcount;
+			keep = (gidx >= (PetscInt)info[dir] && gidx <= (PetscInt)info[dir+3]);
+
+			if(keep && kvol != VolID && len)
+			{
+				// check overlap of bounding boxes in polygon plane
+				xmin = xmax = X[0];
+				ymin = ymax = X[1];
+
+				for(i = 1; i < len; i++)
+				{
+					xmin = PetscMin(xmin, X[2*i]); xmax = PetscMax(xmax, X[2*i]);
+					ymin = PetscMin(ymin, X[2*i+1]); ymax = PetscMax(ymax, X[2*i+1]);
+				}
+
+				if(xmax < info[6+2*ax[0]] || xmin > info[6+2*ax[0]+1]
+				|| ymax < info[6+2*ax[1]] || ymin > info[6+2*ax[1]+1]) keep = 0;
+			}
+
+			if(keep)
+			{
+				for(i = 0; i < 2*len; i++) buff[n++] = X[i];
+			}
+			else
+			{
+				buff[ilen + kpoly] = 0.0;
+			}
+
+			Fcount += 2*len;
+		}
+	}
+
+	(*pn) = n;
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVMarkReadCtrlPoly(FB *fb, CtrlP *CtrlPoly, PetscInt &VolID, PetscInt &nCP)
 {
 	PetscInt       jj;
@@ -1931,8 +2909,8 @@ void setPhaseLayer(GeomPrim *layer, Marker *P)
 		top 	= 	top + pert;
 	}
 
-	// add random noise
-	pert_random 	= (rand()/PetscScalar(RAND_MAX)-0.5)*layer->rand_amplitude;
+	// add random noise (drawn for current marker, see ADVMarkInitGeom)
+	pert_random 	= layer->rand_pert;
 	bot 			= 	bot + pert_random;
 	top 			= 	top + pert_random;
 
@@ -2123,6 +3101,81 @@ void HexGetBoundingBox(
 	}
 }
 //---------------------------------------------------------------------------
+void GeomPrimGetBoundingBox(
+		GeomPrim    *geom,   // geometric primitive
+		PetscScalar *bounds) // bounding box
+{
+	// conservative bounding box of a geometric primitive
+
+	PetscInt    i;
+	PetscScalar pert;
+
+	for(i = 0; i < 3; i++)
+	{
+		bounds[2*i]   = -DBL_MAX;
+		bounds[2*i+1] =  DBL_MAX;
+	}
+
+	if(geom->setPhase == setPhaseSphere)
+	{
+		for(i = 0; i < 3; i++)
+		{
+			bounds[2*i]   = geom->center[i] - geom->radius;
+			bounds[2*i+1] = geom->center[i] + geom->radius;
+		}
+	}
+	else if(geom->setPhase == setPhaseEllipsoid)
+	{
+		for(i = 0; i < 3; i++)
+		{
+			bounds[2*i]   = geom->center[i] - PetscAbsScalar(geom->axes[i]);
+			bounds[2*i+1] = geom->center[i] + PetscAbsScalar(geom->axes[i]);
+		}
+	}
+	else if(geom->setPhase == setPhaseBox
+	||      geom->setPhase == setPhaseRidge
+	||      geom->setPhase == setPhaseHex)
+	{
+		for(i = 0; i < 6; i++) bounds[i] = geom->bounds[i];
+	}
+	else if(geom->setPhase == setPhaseCylinder)
+	{
+		for(i = 0; i < 3; i++)
+		{
+			bounds[2*i]   = PetscMin(geom->base[i], geom->cap[i]) - geom->radius;
+			bounds[2*i+1] = PetscMax(geom->base[i], geom->cap[i]) + geom->radius;
+		}
+	}
+	else if(geom->setPhase == setPhaseLayer)
+	{
+		// random noise is bounded by half amplitude
+		pert = PetscAbsScalar(geom->rand_amplitude)/2.0;
+
+		if(geom->cosine == 1) pert += PetscAbsScalar(geom->amplitude);
+
+		bounds[4] = geom->bot - pert;
+		bounds[5] = geom->top + pert;
+	}
+}
+//---------------------------------------------------------------------------
+void GeomGetCellRange(
+		PetscInt     n,     // number of cells
+		PetscScalar *ncoor, // node coordinates
+		PetscScalar  a,     // interval begin
+		PetscScalar  b,     // interval end
+		PetscInt    &ib,    // first overlapped cell
+		PetscInt    &ie)    // last overlapped cell (ie < ib if none)
+{
+	// first cell with end node >= a
+	ib = (PetscInt)(lower_bound(ncoor, ncoor + n + 1, a) - ncoor) - 1;
+
+	// last cell with start node <= b
+	ie = (PetscInt)(upper_bound(ncoor, ncoor + n + 1, b) - ncoor) - 1;
+
+	if(ib < 0)     ib = 0;
+	if(ie > n - 1) ie = n - 1;
+}
+//---------------------------------------------------------------------------
 PetscInt TetPointTest(
 		PetscScalar *coord, // tetrahedron coordinates
 		PetscInt    *ii,    // corner indices
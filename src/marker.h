@@ -68,6 +68,7 @@ struct GeomPrim
 	PetscScalar amplitude;
 	PetscScalar wavelength;
 	PetscScalar rand_amplitude;
+	PetscScalar rand_pert;      // random perturbation drawn for current marker
 	// ridge
     PetscScalar v_spread;
     PetscScalar x_oblique;
@@ -108,6 +109,18 @@ void HexGetBoundingBox(
 		PetscScalar *coord,   // hex coordinates
 		PetscScalar *bounds); // bounding box
 
+void GeomPrimGetBoundingBox(
+		GeomPrim    *geom,    // geometric primitive
+		PetscScalar *bounds); // bounding box
+
+void GeomGetCellRange(
+		PetscInt     n,     // number of cells
+		PetscScalar *ncoor, // node coordinates
+		PetscScalar  a,     // interval begin
+		PetscScalar  b,     // interval end
+		PetscInt    &ib,    // first overlapped cell
+		PetscInt    &ie);   // last overlapped cell (ie < ib if none)
+
 PetscInt TetPointTest(
 		PetscScalar *coord, // tetrahedron coordinates
 		PetscInt    *ii,    // corner indices
@@ -130,6 +143,25 @@ PetscErrorCode ADVMarkPerturb(AdvCtx *actx);
 // save all local markers to disk (parallel output)
 PetscErrorCode ADVMarkSave(AdvCtx *actx);
 
+// save all markers to a single shared file (collective MPI-IO)
+PetscErrorCode ADVMarkSaveShared(AdvCtx *actx);
+
+// write all markers to a shared file (full records are nondimensional with complete history)
+PetscErrorCode ADVMarkWriteShared(AdvCtx *actx, const char *filename, PetscBool full);
+
+// read markers from a shared file, redistribute by position
+PetscErrorCode ADVMarkReadShared(AdvCtx *actx, const char *filename, PetscBool full);
+
+// get bucket index of a marker in a shared marker file
+PetscInt ADVMarkSharedBucket(PetscScalar *X, PetscScalar chLen, PetscScalar *hdr);
+
+PetscInt ADVMarkSharedBucketDir(PetscScalar x, PetscScalar chLen, PetscScalar *hdr, PetscInt dir);
+
+// pack & unpack shared file records
+void ADVMarkSharedPack(AdvCtx *actx, Marker *P, PetscScalar *rec, PetscBool full);
+
+void ADVMarkSharedUnpack(AdvCtx *actx, Marker *P, PetscScalar *rec, PetscBool full);
+
 // check phase IDs of all the markers
 PetscErrorCode ADVMarkCheckMarkers(AdvCtx *actx);
 
@@ -160,6 +192,23 @@ struct CtrlP
 
 PetscErrorCode ADVMarkReadCtrlPoly(FB *fb, CtrlP *CtrlPoly, PetscInt &VolID, PetscInt &nCP);
 
+// read polygon slices required by every rank (collective MPI-IO)
+PetscErrorCode ADVMarkReadPolyDistr(
+	AdvCtx       *actx,
+	const char   *filename,
+	PetscInt     *tstart,
+	PetscInt     *tend,
+	PetscInt      VolID,
+	PetscScalar **pPolyFile);
+
+// copy polygon file, keep coordinates of slices that can affect a rank only
+void ADVMarkFilterPoly(
+	PetscScalar *PolyFile,
+	PetscScalar *info,
+	PetscInt     VolID,
+	PetscScalar *buff,
+	PetscInt    *pn);
+
 //---------------------------------------------------------------------------
 
 // Specific initialization routines
@@ -167,6 +216,15 @@ PetscErrorCode ADVMarkReadCtrlPoly(FB *fb, CtrlP *CtrlPoly, PetscInt &VolID, Pet
 PetscErrorCode ADVMarkInitGeom    (AdvCtx *actx, FB *fb);
 PetscErrorCode ADVMarkInitFiles   (AdvCtx *actx, FB *fb);
 PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb);
+PetscErrorCode ADVMarkInitShared  (AdvCtx *actx, FB *fb);
+
+// build lists of geometric primitives overlapping local cells
+PetscErrorCode ADVMarkGeomCandidates(
+		AdvCtx     *actx,
+		GeomPrim  **pgeom,
+		PetscInt    ngeom,
+		PetscInt  **pcstart,
+		PetscInt  **pcgind);
 
 //---------------------------------------------------------------------------
 
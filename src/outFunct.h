@@ -30,6 +30,8 @@ struct OutVec
 	PetscInt  ncomp;                        // number of components
 	char      name      [_str_len_];        // output vector name
 	PetscInt  phase_mask[_max_num_phases_]; // phase mask for phase aggregate
+	PetscInt  quant;                        // 16-bit quantized output flag
+	PetscScalar qoff, qscale;               // quantization offset & scale (value = qoff + qscale*raw)
 	PetscErrorCode (*OutVecWrite)(OutVec*); // output function pointer
 };
 
@@ -31,6 +31,7 @@
 
 //---------------------------------------------------------------------------
 #include "LaMEM.h"
+#include "AVD.h"
 #include "paraViewOutAVD.h"
 #include "paraViewOutBin.h"
 #include "parsing.h"
@@ -40,707 +41,499 @@
 #include "JacRes.h"
 #include "tools.h"
 //---------------------------------------------------------------------------
-#define __AVD_DEBUG_MODE
+// phase of refined cells without markers in the neighborhood (before filling)
+#define _avd_no_phase_ 255
+// number of refined layers around FDSTAG cell covered by its Voronoi diagram
+#define _avd_halo_ 1
 //---------------------------------------------------------------------------
-// ........................... AVDPoint3D ...................................
-//---------------------------------------------------------------------------
-void AVDPoint3DCreate(const PetscInt npoints, AVDPoint3D *P)
-{
-	AVDPoint3D points;
-
-	points = (AVDPoint3D) malloc( sizeof(struct _p_AVDPoint3D)*(size_t)(npoints) );
-	memset( points, 0, sizeof(struct _p_AVDPoint3D)*(size_t)(npoints) );
-
-	*P = points;
-}
-//---------------------------------------------------------------------------
-void AVDPoint3DDestroy(AVDPoint3D *P)
+PetscErrorCode PVAVDCreate(PVAVD *pvavd, FB *fb)
 {
-	AVDPoint3D points;
+	char     filename[_str_len_];
+	PetscInt refine;
 
-	if (!P) { return; }
-	points = *P;
-	free(points);
-	*P = NULL;
-}
-//---------------------------------------------------------------------------
-// ........................... AVDCell3D ....................................
-//---------------------------------------------------------------------------
-void AVDCell3DCreate(const PetscInt mx, const PetscInt my, const PetscInt mz, AVDCell3D *C)
-{
-	AVDCell3D cells;
-	PetscInt i,j,k;
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
-	cells = (AVDCell3D) malloc( sizeof(struct _p_AVDCell3D)*(size_t)(mx*my*mz) );
-	memset( cells, 0, sizeof(struct _p_AVDCell3D)*(size_t)(mx*my*mz) );
+	// check advection type
+	if(pvavd->actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
-	for (k=0; k<mz; k++) {
-		for (j=0; j<my; j++) {
-			for (i=0; i<mx; i++) {
-				PetscInt ind;
+	// check activation
+	ierr = getIntParam(fb, _OPTIONAL_, "out_avd", &pvavd->outavd, 1, 1); CHKERRQ(ierr);
 
-				ind = i + j * mx + k * mx*my;
-				cells[ind].index = ind;
-				cells[ind].i = i;
-				cells[ind].j = j;
-				cells[ind].k = k;
+	if(!pvavd->outavd) PetscFunctionReturn(0);
 
-				if ( (i==0) || (i==mx-1) ) { cells[ind].p = AVD_CELL_MASK; }
-				if ( (j==0) || (j==my-1) ) { cells[ind].p = AVD_CELL_MASK; }
-				if ( (k==0) || (k==mz-1) ) { cells[ind].p = AVD_CELL_MASK; }
+	// initialize
+	pvavd->outpvd = 1; // pvd file output flag
+	refine        = 2; // Voronoi Diagram refinement factor
 
-			}
-		}
-	}
+	// read
+	ierr = getStringParam(fb, _OPTIONAL_, "out_file_name",   filename,                  "output"); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_avd_pvd",     &pvavd->outpvd,                1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_avd_ref",     &refine,        1, _max_avd_refine_); CHKERRQ(ierr);
 
-	*C = cells;
-}
-//---------------------------------------------------------------------------
-void AVDCell3DDestroy(AVDCell3D *C)
-{
-	AVDCell3D cells;
+	pvavd->refine[0] = refine;
+	pvavd->refine[1] = refine;
+	pvavd->refine[2] = refine;
 
-	if (!C) { return; }
-	cells = *C;
-	free(cells);
-	*C = NULL;
-}
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_avd_ref_xyz", pvavd->refine,  3, _max_avd_refine_); CHKERRQ(ierr);
 
-//---------------------------------------------------------------------------
-// ........................... AVDChain3D ...................................
-//---------------------------------------------------------------------------
-void AVDChain3DCreate(const PetscInt npoints, const PetscInt buffer, AVDChain3D *CH)
-{
-	AVDChain3D chains;
-	PetscInt p;
+	if(pvavd->refine[0] < 1 || pvavd->refine[1] < 1 || pvavd->refine[2] < 1)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "AVD refinement factors must be positive (out_avd_ref, out_avd_ref_xyz)");
+	}
 
-	chains = (AVDChain3D) malloc( sizeof(struct _p_AVDChain3D)*(size_t)(npoints) );
-	memset( chains, 0, sizeof(struct _p_AVDChain3D)*(size_t)(npoints) );
-	for (p=0; p<npoints; p++) {
-		chains[p].new_claimed_cells_malloced = buffer;
-		chains[p].new_boundary_cells_malloced = buffer;
+	// print summary
+	PetscPrintf(PETSC_COMM_WORLD, "AVD output parameters:\n");
+	PetscPrintf(PETSC_COMM_WORLD, "   Write .pvd file       : %s \n", pvavd->outpvd ? "yes" : "no");
+	PetscPrintf(PETSC_COMM_WORLD, "   AVD refinement factor : %lld %lld %lld \n", (LLD)pvavd->refine[0], (LLD)pvavd->refine[1], (LLD)pvavd->refine[2]);
+	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
 
-		chains[p].new_claimed_cells = (PetscInt*) malloc (sizeof(PetscInt)*(size_t)(buffer+1) );
-		chains[p].new_boundary_cells = (PetscInt*) malloc (sizeof(PetscInt)*(size_t)(buffer+1) );
-	}
+	// set file name
+	sprintf(pvavd->outfile, "%s_phase", filename);
 
-	*CH = chains;
-}
-//---------------------------------------------------------------------------
-void AVDChain3DDestroy(const PetscInt npoints, AVDChain3D *CH)
-{
-	AVDChain3D chains;
-	PetscInt p;
-
-	if (!CH) { return; }
-	chains = *CH;
-	for (p=0; p<npoints; p++) {
-		if (chains[p].new_claimed_cells) {
-			free( chains[p].new_claimed_cells );
-			chains[p].new_claimed_cells = NULL;
-		}
+	// create output cache
+	ierr = PVAVDCreateData(pvavd); CHKERRQ(ierr);
 
-		if (chains[p].new_boundary_cells) {
-			free( chains[p].new_boundary_cells );
-			chains[p].new_boundary_cells = NULL;
-		}
-	}
-	free(chains);
-	*CH = NULL;
+	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-// ............................... AVD3D ....................................
-//---------------------------------------------------------------------------
-PetscErrorCode AVDViewCreate(AVD3D *A, AdvCtx *actx, PetscInt refine)
+PetscErrorCode PVAVDCreateData(PVAVD *pvavd)
 {
-	AVD3D          avd3D;
-	FDSTAG         *fs;
-	PetscScalar    bx, by, bz, ex, ey, ez;
-	PetscInt       nx, ny, nz;
-	PetscInt       i, count, claimed;
+	FDSTAG   *fs;
+	PetscInt  nx, ny, nz, n;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	// check activation
+	if(!pvavd->outavd) PetscFunctionReturn(0);
+
 	// access context
-	fs = actx->fs;
+	fs = pvavd->actx->fs;
 
-	// compute local grid resolution
-	ierr = FDSTAGGetLocalBox(fs, &bx, &by, &bz, &ex, &ey, &ez); CHKERRQ(ierr);
+	// local refined grid size
+	nx = pvavd->refine[0]*fs->dsx.ncels;
+	ny = pvavd->refine[1]*fs->dsy.ncels;
+	nz = pvavd->refine[2]*fs->dsz.ncels;
 
-	nx = refine*fs->dsx.ncels;
-	ny = refine*fs->dsy.ncels;
-	nz = refine*fs->dsz.ncels;
+	n = nx;
+	if(ny > n) n = ny;
+	if(nz > n) n = nz;
 
-	// allocate space, setup structures
-	AVD3DAllocate(nx, ny, nz, 1, actx->nummark, &avd3D);
+	// AVD storage of every worker thread is allocated on first use and grows
+	pvavd->navd = ThreadGetNum();
 
-	AVD3DSetDomainSize(avd3D, bx, ex, by, ey, bz, ez);
+	ierr = PetscMalloc((size_t)pvavd->navd*sizeof(AVD), &pvavd->avd); CHKERRQ(ierr);
+	ierr = PetscMemzero(pvavd->avd, (size_t)pvavd->navd*sizeof(AVD)); CHKERRQ(ierr);
 
-	ierr = AVD3DSetParallelExtent(avd3D, fs->dsx.nproc, fs->dsy.nproc, fs->dsz.nproc); CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)fs->nCells*sizeof(uint64_t),      &pvavd->hash);  CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)fs->nCells*sizeof(uint64_t),      &pvavd->sig);   CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(nx*ny*nz)*sizeof(unsigned char), &pvavd->phase); CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(n+1)*sizeof(float),              &pvavd->crd);   CHKERRQ(ierr);
 
-	ierr = AVD3DLoadPoints(avd3D, actx); CHKERRQ(ierr);
+	// invalidate cache
+	pvavd->cached = 0;
 
-	AVD3DResetCells(avd3D);
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PVAVDDestroy(PVAVD *pvavd)
+{
+	PetscInt t;
 
-	ierr = AVD3DInit(avd3D); CHKERRQ(ierr);
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
-	// assign all cells to points
-	count   = avd3D->npoints;
-	claimed = 1;
+	// check activation
+	if(!pvavd->outavd) PetscFunctionReturn(0);
 
-	while(claimed != 0)
+	for(t = 0; t < pvavd->navd; t++)
 	{
-		claimed = 0;
-
-		for(i = 0; i < count; i++)
-		{
-			AVD3DClaimCells(avd3D, i);
-
-			claimed += avd3D->chains[i].num_claimed;
-
-			AVD3DUpdateChain(avd3D, i);
-		}
+		ierr = AVDDestroy(&pvavd->avd[t]); CHKERRQ(ierr);
 	}
 
-	(*A) = avd3D;
+	ierr = PetscFree(pvavd->avd);   CHKERRQ(ierr);
+	ierr = PetscFree(pvavd->hash);  CHKERRQ(ierr);
+	ierr = PetscFree(pvavd->sig);   CHKERRQ(ierr);
+	ierr = PetscFree(pvavd->phase); CHKERRQ(ierr);
+	ierr = PetscFree(pvavd->crd);   CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-void AVD3DDestroy(AVD3D *A)
+PetscErrorCode PVAVDWriteTimeStep(PVAVD *pvavd, const char *dirName, PetscScalar ttime)
 {
-	AVD3D aa;
-	if (!A) { return; }
-	aa = *A;
-	if (aa->chains) {
-		AVDChain3DDestroy(aa->npoints,&aa->chains);
-	}
-	if (aa->cells) {
-		AVDCell3DDestroy(&aa->cells);
-	}
-	if (aa->points) {
-		AVDPoint3DDestroy(&aa->points);
-	}
+	// Create a 3D Voronoi diagram from particles with phase information
+	// write the file to disk and perform scaling/unscaling of the variables
 
-	if (aa->ownership_ranges_i) {
-		free(aa->ownership_ranges_i);
-	}
-	if (aa->ownership_ranges_j) {
-		free(aa->ownership_ranges_j);
-	}
-	if (aa->ownership_ranges_k) {
-		free(aa->ownership_ranges_k);
-	}
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!pvavd->outavd) PetscFunctionReturn(0);
+
+	// update Approximate Voronoi Diagram of changed cells
+	ierr = PVAVDUpdate(pvavd); CHKERRQ(ierr);
+
+	// update .pvd file if necessary
+	ierr = UpdatePVDFile(dirName, pvavd->outfile, "pvtr", &pvavd->offset, ttime, pvavd->outpvd); CHKERRQ(ierr);
+
+	ierr = PVAVDWritePVTR(pvavd, dirName); CHKERRQ(ierr);
 
-	free(aa);
-	*A = NULL;
+	ierr = PVAVDWriteVTR(pvavd, dirName); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-void AVD3DAllocate(
-	const PetscInt mx,
-	const PetscInt my,
-	const PetscInt mz,
-	const PetscInt buffer,
-	const PetscInt npoints,
-	AVD3D          *A)
+PetscErrorCode PVAVDUpdate(PVAVD *pvavd)
 {
+	// compute Voronoi diagram separately in every FDSTAG cell on the refined grid.
+	// The diagram of a cell is extended by _avd_halo_ refined layers and includes
+	// markers of all adjacent cells in this range, so that phase interfaces are
+	// continuous across the cell faces (only local cells are used, as before).
+	// Cells whose geometry and markers in the neighborhood did not change since
+	// the previous output reuse cached phases. Diagrams are computed on worker
+	// threads (see ThreadFor), every thread uses its own pooled AVD structure,
+	// the result does not depend on the number of threads.
+
+	AdvCtx      *actx;
+	FDSTAG      *fs;
+	Marker       box;
+	uint64_t     sig;
+	PetscInt     ID, c, i, j, k, ic, jc, kc, p, n, t, M, N, P;
+	PetscInt     rx, ry, rz, h, ncell, npmax, *list, *fail;
 
-	AVD3D avd3D;
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
-	avd3D = (AVD3D) malloc( sizeof(struct _p_AVD3D) );
-	memset( avd3D, 0, sizeof(struct _p_AVD3D) );
+	// access context
+	actx = pvavd->actx;
+	fs   = actx->fs;
 
-	avd3D->buffer = buffer;
-	avd3D->mx = mx;
-	avd3D->my = my;
-	avd3D->mz = mz;
+	rx = pvavd->refine[0];
+	ry = pvavd->refine[1];
+	rz = pvavd->refine[2];
+	h  = _avd_halo_;
 
-	avd3D->mx_mesh = mx+2;
-	avd3D->my_mesh = my+2;
-	avd3D->mz_mesh = mz+2;
+	M  = fs->dsx.ncels;
+	N  = fs->dsy.ncels;
+	P  = fs->dsz.ncels;
 
-	AVDCell3DCreate(
-		 avd3D->mx_mesh,
-		 avd3D->my_mesh,
-		 avd3D->mz_mesh,
-		&avd3D->cells);
+	// compute hash of every cell marker set (independent of marker order)
+	ierr = ThreadFor(fs->nCells, 1, [&](PetscInt beg, PetscInt end, PetscInt tid)
+	{
+		for(PetscInt cell = beg; cell < end; cell++)
+		{
+			uint64_t hash = (uint64_t)(actx->markstart[cell+1] - actx->markstart[cell]);
 
-	avd3D->npoints = npoints;
+			for(PetscInt q = actx->markstart[cell]; q < actx->markstart[cell+1]; q++)
+			{
+				Marker *Q = &actx->markers[actx->markind[q]];
 
-	AVDPoint3DCreate(npoints, &avd3D->points);
+				hash += MarkerHash(*Q) ^ ((uint64_t)Q->phase*0x9e3779b97f4a7c15ULL);
+			}
 
-	AVDChain3DCreate(npoints, avd3D->buffer, &avd3D->chains);
+			pvavd->hash[cell] = hash;
+		}
+		(void)tid;
+	}); CHKERRQ(ierr);
 
-	(*A) = avd3D;
-}
-//---------------------------------------------------------------------------
-PetscErrorCode AVD3DSetParallelExtent(AVD3D A, PetscInt M, PetscInt N, PetscInt P)
-{
-	PetscInt *tmp;
-	PetscInt pid,i,j,k,sum;
-	PetscErrorCode ierr;
+	ierr = makeIntArray(&list, NULL, fs->nCells); CHKERRQ(ierr);
 
-	PetscFunctionBeginUser;
+	ierr = PetscMemzero(&box, sizeof(Marker)); CHKERRQ(ierr);
 
-	A->M = M;
-	A->N = N;
-	A->P = P;
-
-	tmp = (PetscInt*) malloc(sizeof(PetscInt)*(size_t)(A->M*A->N*A->P+1));
-	memset(tmp,0,sizeof(PetscInt)*(size_t)(A->M*A->N*A->P+1));
-
-	A->ownership_ranges_i = (PetscInt*) malloc( sizeof(PetscInt)*(size_t)(A->M+1) );
-	A->ownership_ranges_j = (PetscInt*) malloc( sizeof(PetscInt)*(size_t)(A->N+1) );
-	A->ownership_ranges_k = (PetscInt*) malloc( sizeof(PetscInt)*(size_t)(A->P+1) );
-
-	memset(tmp,0,sizeof(PetscInt)*(size_t)(A->M*A->N*A->P+1));
-	ierr = MPI_Allgather(&A->mx,1,MPIU_INT,tmp,1,MPIU_INT,PETSC_COMM_WORLD); CHKERRQ(ierr);
-	j = k = 0;
-	sum = 0;
-	for (i=0; i<A->M; i++) {
-		pid = i + j*A->M + k*A->M*A->N;
-		A->ownership_ranges_i[i] = sum;
-		sum = sum + tmp[pid];
-	} A->ownership_ranges_i[i] = sum;
-
-	memset(tmp,0,sizeof(PetscInt)*(size_t)(A->M*A->N*A->P+1));
-	ierr = MPI_Allgather(&A->my,1,MPIU_INT,tmp,1,MPIU_INT,PETSC_COMM_WORLD); CHKERRQ(ierr);
-	i = k = 0;
-	sum = 0;
-	for (j=0; j<A->N; j++) {
-		pid = i + j*A->M + k*A->M*A->N;
-		A->ownership_ranges_j[j] = sum;
-		sum = sum + tmp[pid];
-	} A->ownership_ranges_j[j] = sum;
-
-	memset(tmp,0,sizeof(PetscInt)*(size_t)(A->M*A->N*A->P+1));
-	ierr = MPI_Allgather(&A->mz,1,MPIU_INT,tmp,1,MPIU_INT,PETSC_COMM_WORLD); CHKERRQ(ierr);
-	i = j = 0;
-	sum = 0;
-	for (k=0; k<A->P; k++) {
-		pid = i + j*A->M + k*A->M*A->N;
-		A->ownership_ranges_k[k] = sum;
-		sum = sum + tmp[pid];
-	} A->ownership_ranges_k[k] = sum;
-
-	A->gmx = A->ownership_ranges_i[A->M];
-	A->gmy = A->ownership_ranges_j[A->N];
-	A->gmz = A->ownership_ranges_k[A->P];
-
-	free(tmp);
-	PetscFunctionReturn(0);
-}
-//---------------------------------------------------------------------------
-void AVD3DSetDomainSize(AVD3D A,
-	const PetscScalar x0,
-	const PetscScalar x1,
-	const PetscScalar y0,
-	const PetscScalar y1,
-	const PetscScalar z0,
-	const PetscScalar z1)
-{
-	A->x0 = x0;
-	A->x1 = x1;
-	A->y0 = y0;
-	A->y1 = y1;
-	A->z0 = z0;
-	A->z1 = z1;
-
-	A->dx = (x1-x0)/(PetscScalar)A->mx;
-	A->dy = (y1-y0)/(PetscScalar)A->my;
-	A->dz = (z1-z0)/(PetscScalar)A->mz;
-}
-//---------------------------------------------------------------------------
-PetscErrorCode AVD3DLoadPoints(AVD3D A, AdvCtx *actx)
-{
-	// load viewer points from markers
-	// WARNING! Redundant copy of all markers coordinates & phases
-	// can use markers directly
+	// collect cells to be recomputed
+	ncell = 0;
+	npmax = 0;
 
-	Marker     *markers, *M;
-	AVDPoint3D  points, P;
-	PetscInt    i, npoints;
+	for(ID = 0; ID < fs->nCells; ID++)
+	{
+		// expand i, j, k cell indices
+		GET_CELL_IJK(ID, i, j, k, M, N);
 
-	PetscFunctionBeginUser;
+		// compute signature of cell geometry & marker sets in the neighborhood
+		box.X[0] = fs->dsx.ncoor[i];   box.X[1] = fs->dsy.ncoor[j];   box.X[2] = fs->dsz.ncoor[k];   sig  = MarkerHash(box);
+		box.X[0] = fs->dsx.ncoor[i+1]; box.X[1] = fs->dsy.ncoor[j+1]; box.X[2] = fs->dsz.ncoor[k+1]; sig ^= MarkerHash(box) << 1;
 
-	npoints = A->npoints;
-	points  = A->points;
-	markers = actx->markers;
+		n = 0;
 
-	for(i = 0; i < npoints; i++)
-	{
-		M        = markers + i;
-		P        = points  + i;
-		P->x     = M->X[0];
-		P->y     = M->X[1];
-		P->z     = M->X[2];
-		P->phase = M->phase;
-	}
+		for(kc = PetscMax(k-1, 0); kc <= PetscMin(k+1, P-1); kc++)
+		for(jc = PetscMax(j-1, 0); jc <= PetscMin(j+1, N-1); jc++)
+		for(ic = PetscMax(i-1, 0); ic <= PetscMin(i+1, M-1); ic++)
+		{
+			c    = ic + jc*M + kc*M*N;
+			sig  = sig*0x100000001b3ULL + pvavd->hash[c];
+			n   += actx->markstart[c+1] - actx->markstart[c];
+		}
 
-	PetscFunctionReturn(0);
-}
-//---------------------------------------------------------------------------
-void AVD3DResetCells(AVD3D A)
-{
-	PetscInt i,j,k;
-	PetscInt mx,my,mz;
+		// reuse cached phases (zero signature marks cells without markers)
+		if(pvavd->cached && sig && pvavd->sig[ID] == sig) continue;
 
-	mx = A->mx_mesh;
-	my = A->my_mesh;
-	mz = A->mz_mesh;
+		pvavd->sig[ID] = sig;
 
-	for (k=0; k<mz; k++) {
-		for (j=0; j<my; j++) {
-			for (i=0; i<mx; i++) {
-				PetscInt ii = i + j * mx + k * mx*my;
+		list[ncell++] = ID;
 
-				A->cells[ii].p = -1;
-				A->cells[ii].done = AVD_FALSE;
+		if(n > npmax) npmax = n;
+	}
 
-				if ( (i==0) || (i==mx-1) ) { A->cells[ii].p = AVD_CELL_MASK; }
-				if ( (j==0) || (j==my-1) ) { A->cells[ii].p = AVD_CELL_MASK; }
-				if ( (k==0) || (k==mz-1) ) { A->cells[ii].p = AVD_CELL_MASK; }
+	// AVD storage of every thread is shared by all its cells
+	for(t = 0; t < pvavd->navd; t++)
+	{
+		pvavd->avd[t].nx = rx + 2*h;
+		pvavd->avd[t].ny = ry + 2*h;
+		pvavd->avd[t].nz = rz + 2*h;
 
-			}
-		}
+		ierr = AVDReserve(&pvavd->avd[t], npmax); CHKERRQ(ierr);
 	}
-}
-//---------------------------------------------------------------------------
-PetscErrorCode AVD3DInit(AVD3D A)
-{
-	// i = (xp - (x0-dx) )/mx_mesh
 
-	AVDPoint3D points;
-	PetscInt   p, i, j, k, npoints;
-	PetscInt   mx, my, mz, ind;
-
-	PetscFunctionBeginUser;
+	ierr = makeIntArray(&fail, NULL, pvavd->navd); CHKERRQ(ierr);
 
-	npoints = A->npoints;
-	points  = A->points;
+	// compute Voronoi diagrams
+	ierr = ThreadFor(ncell, 1, [&](PetscInt beg, PetscInt end, PetscInt tid)
+	{
+		for(PetscInt ip = beg; ip < end; ip++)
+		{
+			if(PVAVDCellPhase(pvavd, &pvavd->avd[tid], list[ip])) fail[tid] = 1;
+		}
+	}); CHKERRQ(ierr);
 
-	mx = A->mx_mesh;
-	my = A->my_mesh;
-	mz = A->mz_mesh;
+	for(t = 0; t < pvavd->navd; t++)
+	{
+		if(fail[t]) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Inserting cells into boundary cells is not permitted \n");
+	}
 
-	for(p = 0; p < npoints; p++)
+	// fill refined cells without markers in the neighborhood
+	for(p = 0; p < ncell; p++)
 	{
-		i = (PetscInt)((points[p].x - (A->x0 - A->dx))/A->dx);
-		j = (PetscInt)((points[p].y - (A->y0 - A->dy))/A->dy);
-		k = (PetscInt)((points[p].z - (A->z0 - A->dz))/A->dz);
-
-		// if a particle is exactly on the border then make sure it is in a valid cell inside the element
-		if (i == mx) { i--; }
-		if (j == my) { j--; }
-		if (k == mz) { k--; }
-
-		// check bounds
-		if (i==0)            SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "AVD3dInit: i==0:  %lf %lf %lf\n", points[p].x, points[p].y, points[p].z);
-		if (j==0)            SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "AVD3dInit: j==0:  %lf %lf %lf\n", points[p].x, points[p].y, points[p].z);
-		if (k==0)            SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "AVD3dInit: k==0:  %lf %lf %lf\n", points[p].x, points[p].y, points[p].z);
-		if (i==A->mx_mesh-1) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "AVD3dInit: i==mx: %lf %lf %lf\n", points[p].x, points[p].y, points[p].z);
-		if (j==A->my_mesh-1) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "AVD3dInit: j==my: %lf %lf %lf\n", points[p].x, points[p].y, points[p].z);
-		if (k==A->mz_mesh-1) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "AVD3dInit: k==mz: %lf %lf %lf\n", points[p].x, points[p].y, points[p].z);
-
-		ind = i+j*mx+k*mx*my;
-		if (A->cells[ind].p == AVD_CELL_MASK)
+		if(!pvavd->sig[list[p]])
 		{
-			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "AVD3dInit: Inserting points into boundary cells - this is not permitted\n");
+			ierr = PVAVDFillEmpty(pvavd); CHKERRQ(ierr);
+
+			break;
 		}
+	}
 
-		A->cells[i+j*mx+k*mx*my].p = p; // particle index
-		A->chains[p].num_claimed = 1; // number of claimed cells, currently just the one the point initially resides within
-		A->chains[p].length = 0;
-		A->chains[p].total_claimed = 1; // total of claimed cells
-		A->chains[p].done = AVD_FALSE;
-		A->chains[p].index = i+j*mx+k*mx*my; // ith particle is in cell i +j*mx + k*mx*my
-		A->chains[p].new_claimed_cells[0] = i+j*mx+k*mx*my;  // ith particle claimed cell it resides within, i.e. cell_index i+j*mx+k*mx*my
-		A->chains[p].new_claimed_cells[1] = -1; // mark end of claimed_cells list with -1
+	ierr = PetscFree(list); CHKERRQ(ierr);
+	ierr = PetscFree(fail); CHKERRQ(ierr);
 
-		AVD3DUpdateChain(A, p);
-	}
+	pvavd->cached = 1;
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-static inline PetscScalar AVD3DDistanceTest(
-	PetscScalar x0,
-	PetscScalar y0,
-	PetscScalar z0,
-	PetscScalar x1,
-	PetscScalar y1,
-	PetscScalar z1,
-	PetscScalar x2,
-	PetscScalar y2,
-	PetscScalar z2)
-{
-	return (x1+x2-x0-x0)*(x1-x2) + (y1+y2-y0-y0)*(y1-y2) + (z1+z2-z0-z0)*(z1-z2);
-}
-//---------------------------------------------------------------------------
-void AVD3DClaimCells(AVD3D A, const PetscInt p_i)
+PetscInt PVAVDCellPhase(PVAVD *pvavd, AVD *A, PetscInt ID)
 {
-	// Claim cells for particle p_i in the list
-
-	PetscInt i,count;
-	PetscScalar x0,y0,x1,y1,x2,y2,z0,z1,z2,dist1;
-	PetscInt *temp;
-	AVDChain3D bchain;
-	AVDPoint3D points;
-	AVDCell3D cells;
-	PetscInt cell_num0;
-	PetscInt buffer;
-	PetscScalar dx,dy,dz;
-
-	buffer = A->buffer;
-	dx = A->dx;
-	dy = A->dy;
-	dz = A->dz;
-	bchain = &A->chains[p_i];
-	cells = A->cells;
-	points = A->points;
-
-	count = 0;
-	bchain->num_claimed = 0;
-
-	for (i=0; i<bchain->length; i++) {
-		cell_num0 = bchain->new_boundary_cells[i]; // cell number we are trying to claim
-
-#ifdef __AVD_DEBUG_MODE
-		if (cell_num0<0) {
-			printf("  AVD3dClaimCells(ERROR): p_i = %lld, [%lld] \n", (LLD)p_i,(LLD)cell_num0 );
-			printf("  AVD3dClaimCells(ERROR):   point %f %f %f \n", A->points[p_i].x,A->points[p_i].y,A->points[p_i].z);
-			exit(1);
-		}
+	// compute phases of refined cells of a single FDSTAG cell
+	// (called on worker threads, no PETSc or MPI calls, no allocation)
+	// returns 1 if a point is inserted into a boundary cell
 
-		if (cells[cell_num0].p == AVD_CELL_MASK) { printf("YOU SHOULD NEVER HAVE A MASKED CELL IN YOUR LIST\n"); exit(1); }
-#endif
+	AdvCtx      *actx;
+	FDSTAG      *fs;
+	Marker      *Q;
+	PetscInt     i, j, k, ii, jj, kk, ic, jc, kc, c, q, p, n, np, h;
+	PetscInt     M, N, P, rx, ry, rz, nx, ny, mx, my, mz;
+	unsigned char *phase;
 
-		if (cells[cell_num0].p == AVD_CELL_UNCLAIMED) { // if cell unclaimed, then claim it
+	// access context
+	actx  = pvavd->actx;
+	fs    = actx->fs;
+	phase = pvavd->phase;
+
+	rx = pvavd->refine[0];
+	ry = pvavd->refine[1];
+	rz = pvavd->refine[2];
+	h  = _avd_halo_;
+
+	M  = fs->dsx.ncels;
+	N  = fs->dsy.ncels;
+	P  = fs->dsz.ncels;
+	nx = rx*M;
+	ny = ry*N;
+
+	// AVD grid size including boundary (mask) cells
+	mx = A->nx + 2;
+	my = A->ny + 2;
+	mz = A->nz + 2;
+
+	// expand i, j, k cell indices
+	GET_CELL_IJK(ID, i, j, k, M, N);
+
+	// setup AVD grid (refined cell extended by halo layers)
+	A->dx = (fs->dsx.ncoor[i+1] - fs->dsx.ncoor[i])/(PetscScalar)rx;
+	A->dy = (fs->dsy.ncoor[j+1] - fs->dsy.ncoor[j])/(PetscScalar)ry;
+	A->dz = (fs->dsz.ncoor[k+1] - fs->dsz.ncoor[k])/(PetscScalar)rz;
+
+	A->xs[0] = fs->dsx.ncoor[i]   - (PetscScalar)h*A->dx;
+	A->xs[1] = fs->dsy.ncoor[j]   - (PetscScalar)h*A->dy;
+	A->xs[2] = fs->dsz.ncoor[k]   - (PetscScalar)h*A->dz;
+	A->xe[0] = fs->dsx.ncoor[i+1] + (PetscScalar)h*A->dx;
+	A->xe[1] = fs->dsy.ncoor[j+1] + (PetscScalar)h*A->dy;
+	A->xe[2] = fs->dsz.ncoor[k+1] + (PetscScalar)h*A->dz;
+
+	// count markers in the neighborhood
+	np = 0;
+
+	for(kc = PetscMax(k-1, 0); kc <= PetscMin(k+1, P-1); kc++)
+	for(jc = PetscMax(j-1, 0); jc <= PetscMin(j+1, N-1); jc++)
+	for(ic = PetscMax(i-1, 0); ic <= PetscMin(i+1, M-1); ic++)
+	{
+		c   = ic + jc*M + kc*M*N;
+		np += actx->markstart[c+1] - actx->markstart[c];
+	}
 
-// WARNING!!! NEVER use realloc! Either use malloc, or C++ containers
+	// reset AVD structure (reuses storage)
+	A->npoints = np;
 
-			// Realloc, note that we need one space more than the number of points to terminate the list
-			if( count == bchain->new_claimed_cells_malloced-1  ){
-				temp = (PetscInt*) realloc( bchain->new_claimed_cells, (size_t)(bchain->new_claimed_cells_malloced + buffer + 1)*sizeof(PetscInt) );
-				bchain->new_claimed_cells = temp;
-				bchain->new_claimed_cells_malloced += buffer;
+	AVDReset(A);
 
-				temp = (PetscInt*) realloc( bchain->new_boundary_cells, (size_t)(bchain->new_boundary_cells_malloced + buffer + 1)*sizeof(PetscInt) );
-				bchain->new_boundary_cells = temp;
-				bchain->new_boundary_cells_malloced += buffer;
-			}
-			bchain->new_claimed_cells[count] = cell_num0;
-			bchain->num_claimed++;
-			count++;
-			cells[cell_num0].p = p_i; // mark cell as owned by particle p_i
-		} else if (cells[cell_num0].p != p_i) {
-			// perform distance test between points to determine ownership
-			x2 = points[p_i].x;
-			y2 = points[p_i].y;
-			z2 = points[p_i].z;
-
-			x1 = points[cells[cell_num0].p].x;
-			y1 = points[cells[cell_num0].p].y;
-			z1 = points[cells[cell_num0].p].z;
-
-			// cell centroid
-			x0 = (PetscScalar)cells[cell_num0].i*dx + (A->x0 - dx + 0.5*dx);
-			y0 = (PetscScalar)cells[cell_num0].j*dy + (A->y0 - dy + 0.5*dy);
-			z0 = (PetscScalar)cells[cell_num0].k*dz + (A->z0 - dz + 0.5*dz);
-
-			dist1 = AVD3DDistanceTest(x0,y0,z0,x1,y1,z1,x2,y2,z2);
-			if (dist1 > 0.0) {
-				bchain->new_claimed_cells[count] = cell_num0;
-				bchain->num_claimed++;
-				count++;
-				cells[cell_num0].p = p_i; // mark cell as owned by particle p_i
-			}
-		}
-		bchain->new_claimed_cells[count] = -1; // mark end of list
-	}
-}
-//---------------------------------------------------------------------------
-void AVD3DUpdateChain(AVD3D A, const PetscInt p_i)
-{
-	PetscInt i,k;
-	PetscInt count;
-	PetscInt cell_num0,cell_num1,cell_num[6];
-	AVDChain3D bchain;
-	AVDCell3D cells,cell0;
-	PetscInt mx,my,buffer;
-	PetscInt *temp;
-
-	buffer = A->buffer;
-	mx = A->mx_mesh;
-	my = A->my_mesh;
-	bchain = &A->chains[p_i];
-	cells = A->cells;
-
-	count = 0;
-	bchain->length = 0;
-	for( i=0; i<bchain->num_claimed; i++) {
-		cell_num0 = bchain->new_claimed_cells[i];
-		cell0 = &cells[cell_num0];
-
-		if (cell0->p == AVD_CELL_MASK) { continue; }
-
-		cell_num[0] = (cell0->i  ) + (cell0->j-1)*mx + (cell0->k  )*mx*my; // S
-		cell_num[1] = (cell0->i  ) + (cell0->j+1)*mx + (cell0->k  )*mx*my; // N
-		cell_num[2] = (cell0->i+1) + (cell0->j  )*mx + (cell0->k  )*mx*my; // E
-		cell_num[3] = (cell0->i-1) + (cell0->j  )*mx + (cell0->k  )*mx*my; // W
-		cell_num[4] = (cell0->i  ) + (cell0->j  )*mx + (cell0->k+1)*mx*my; // Front
-		cell_num[5] = (cell0->i  ) + (cell0->j  )*mx + (cell0->k-1)*mx*my; // Back
-
-		// boundary protection
-		for (k=0; k<6; k++) {
-			if (cells[cell_num[k]].p == AVD_CELL_MASK) {
-				cell_num[k] = -2;
-			}
-		}
+	// load markers that fall into interior AVD cells
+	// (same index computation as in AVDCellInit)
+	n = 0;
 
-		for (k=0; k<6; k++) {
-			cell_num1 = cell_num[k];
-
-			 // if cell does not already belong to the particle and hasn't been
-			 // marked as being done then add it to new boundary array and mark it as done
-
-			if (cell_num1 != -2) {
-				if ( (cells[cell_num1].p != p_i) && (cells[cell_num1].done != AVD_TRUE) ) {
-
-// WARNING!!! NEVER use realloc! Either use malloc, or C++ containers
-
-					// Realloc, note that we need one space more than the number of points to terminate the list
-					if (count == bchain->new_boundary_cells_malloced-1 ) {
-						temp = (PetscInt*)realloc( bchain->new_claimed_cells, (size_t)(bchain->new_claimed_cells_malloced + buffer + 1)*sizeof(PetscInt) );
-						bchain->new_claimed_cells = temp;
-						bchain->new_claimed_cells_malloced += buffer;
-
-						temp = (PetscInt*)realloc( bchain->new_boundary_cells, (size_t)(bchain->new_boundary_cells_malloced + buffer + 1)*sizeof(PetscInt) );
-						bchain->new_boundary_cells = temp;
-						bchain->new_boundary_cells_malloced += buffer;
-					}
-#ifdef __AVD_DEBUG_MODE
-					if (cell_num1<0) {
-						printf("  AVD3DUpdateChain(ERROR): INSERTING negative cell index \n");
-						printf("  AVD3DUpdateChain(ERROR):   k=%lld :: cell0 i,j,k = %lld,%lld,%lld neighbourid [%lld]\n", (LLD)k,(LLD)(cell0->i), (LLD)(cell0->j), (LLD)(cell0->k), (LLD)cell_num1 );
-						exit(0);
-					}
-#endif
-					bchain->new_boundary_cells[count] = cell_num1;
-					bchain->length++;
-					count++;
-					cells[cell_num1].done = AVD_TRUE;
-				}
-			}
-		}
+	for(kc = PetscMax(k-1, 0); kc <= PetscMin(k+1, P-1); kc++)
+	for(jc = PetscMax(j-1, 0); jc <= PetscMin(j+1, N-1); jc++)
+	for(ic = PetscMax(i-1, 0); ic <= PetscMin(i+1, M-1); ic++)
+	{
+		c = ic + jc*M + kc*M*N;
 
-	}
+		for(q = actx->markstart[c]; q < actx->markstart[c+1]; q++)
+		{
+			Q = &actx->markers[actx->markind[q]];
 
-	// reset the processed flags
-	for (i=0; i<count; i++){
-		cells[ bchain->new_boundary_cells[i] ].done = AVD_FALSE;
-	}
-}
-//---------------------------------------------------------------------------
-// .......................... AVD ParaView Output ...........................
-//---------------------------------------------------------------------------
-PetscErrorCode PVAVDCreate(PVAVD *pvavd, FB *fb)
-{
-	char filename[_str_len_];
+			ii = (PetscInt)((Q->X[0] - (A->xs[0] - A->dx))/A->dx);
+			jj = (PetscInt)((Q->X[1] - (A->xs[1] - A->dy))/A->dy);
+			kk = (PetscInt)((Q->X[2] - (A->xs[2] - A->dz))/A->dz);
 
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
+			if(ii < 1 || ii > mx-2
+			|| jj < 1 || jj > my-2
+			|| kk < 1 || kk > mz-2) continue;
 
-	// check advection type
-	if(pvavd->actx->advect == ADV_NONE) PetscFunctionReturn(0);
+			A->points[n]      = *Q;
+			A->chain [n].gind = actx->markind[q];
+			n++;
+		}
+	}
 
-	// check activation
-	ierr = getIntParam(fb, _OPTIONAL_, "out_avd", &pvavd->outavd, 1, 1); CHKERRQ(ierr);
+	A->npoints = n;
 
-	if(!pvavd->outavd) PetscFunctionReturn(0);
+	if(!n)
+	{
+		// mark refined cells for filling from neighbors, never reuse
+		for(kk = 0; kk < rz; kk++)
+		for(jj = 0; jj < ry; jj++)
+		for(ii = 0; ii < rx; ii++)
+		{
+			phase[(i*rx+ii) + (j*ry+jj)*nx + (k*rz+kk)*nx*ny] = _avd_no_phase_;
+		}
 
-	// initialize
-	pvavd->outpvd = 1; // pvd file output flag
-	pvavd->refine = 2; // Voronoi Diagram refinement factor
+		pvavd->sig[ID] = 0;
 
-	// read
-	ierr = getStringParam(fb, _OPTIONAL_, "out_file_name", filename,                  "output"); CHKERRQ(ierr);
-	ierr = getIntParam   (fb, _OPTIONAL_, "out_avd_pvd",   &pvavd->outpvd,                1, 1); CHKERRQ(ierr);
-	ierr = getIntParam   (fb, _OPTIONAL_, "out_avd_ref",   &pvavd->refine, 1, _max_avd_refine_); CHKERRQ(ierr);
+		return 0;
+	}
 
-	// print summary
-	PetscPrintf(PETSC_COMM_WORLD, "AVD output parameters:\n");
-	PetscPrintf(PETSC_COMM_WORLD, "   Write .pvd file       : %s \n", pvavd->outpvd ? "yes" : "no");
-	PetscPrintf(PETSC_COMM_WORLD, "   AVD refinement factor : %lld \n", (LLD)pvavd->refine);
-	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
+	// do AVD algorithm
+	if(AVDCompute(A)) return 1;
 
-	// set file name
-	sprintf(pvavd->outfile, "%s_phase", filename);
+	// store phases of refined cells (skip halo)
+	for(kk = 0; kk < rz; kk++)
+	for(jj = 0; jj < ry; jj++)
+	for(ii = 0; ii < rx; ii++)
+	{
+		p = A->cell[(ii+h+1) + (jj+h+1)*mx + (kk+h+1)*mx*my].p;
 
-	PetscFunctionReturn(0);
+		phase[(i*rx+ii) + (j*ry+jj)*nx + (k*rz+kk)*nx*ny] = (unsigned char)A->points[p].phase;
+	}
+
+	return 0;
 }
 //---------------------------------------------------------------------------
-PetscErrorCode PVAVDWriteTimeStep(PVAVD *pvavd, const char *dirName, PetscScalar ttime)
+PetscErrorCode PVAVDFillEmpty(PVAVD *pvavd)
 {
-	// Create a 3D Voronoi diagram from particles with phase information
-	// write the file to disk and perform scaling/unscaling of the variables
+	// fill refined cells without phase from face neighbors
+	// (repeated sweeps, until no cells can be filled)
 
-	AVD3D A;
+	FDSTAG        *fs;
+	unsigned char *phase, nb;
+	PetscInt       i, j, k, nx, ny, nz, ind, nfill;
 
-	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	if(!pvavd->outavd) PetscFunctionReturn(0);
+	// access context
+	fs    = pvavd->actx->fs;
+	phase = pvavd->phase;
 
-	// create Approximate Voronoi Diagram from particles
-	ierr = AVDViewCreate(&A, pvavd->actx, pvavd->refine); CHKERRQ(ierr);
+	nx = pvavd->refine[0]*fs->dsx.ncels;
+	ny = pvavd->refine[1]*fs->dsy.ncels;
+	nz = pvavd->refine[2]*fs->dsz.ncels;
 
-	// update .pvd file if necessary
-	ierr = UpdatePVDFile(dirName, pvavd->outfile, "pvtr", &pvavd->offset, ttime, pvavd->outpvd); CHKERRQ(ierr);
+	do
+	{
+		nfill = 0;
+
+		for(k = 0; k < nz; k++)
+		for(j = 0; j < ny; j++)
+		for(i = 0; i < nx; i++)
+		{
+			ind = i + j*nx + k*nx*ny;
 
-	ierr = PVAVDWritePVTR(pvavd, A, dirName); CHKERRQ(ierr);
+			if(phase[ind] != _avd_no_phase_) continue;
 
-	ierr = PVAVDWriteVTR(pvavd, A, dirName); CHKERRQ(ierr);
+			nb = _avd_no_phase_;
 
-	// cleanup
-	AVD3DDestroy(&A);
+			if     (i > 0    && phase[ind-1]     != _avd_no_phase_) nb = phase[ind-1];
+			else if(i < nx-1 && phase[ind+1]     != _avd_no_phase_) nb = phase[ind+1];
+			else if(j > 0    && phase[ind-nx]    != _avd_no_phase_) nb = phase[ind-nx];
+			else if(j < ny-1 && phase[ind+nx]    != _avd_no_phase_) nb = phase[ind+nx];
+			else if(k > 0    && phase[ind-nx*ny] != _avd_no_phase_) nb = phase[ind-nx*ny];
+			else if(k < nz-1 && phase[ind+nx*ny] != _avd_no_phase_) nb = phase[ind+nx*ny];
+
+			if(nb != _avd_no_phase_)
+			{
+				phase[ind] = nb;
+				nfill++;
+			}
+		}
+
+	} while(nfill);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
+PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, const char *dirName)
 {
+	FDSTAG      *fs;
 	FILE        *fp;
+	OutFile      of;
 	char        *fname;
-	PetscMPIInt inproc, irank;
-	PetscInt    r2d, p, pi, pj, pk, nproc, rank;
+	PetscInt    r2d, p, pi, pj, pk, rx, ry, rz, M, N;
 
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// only first process generates this file (WARNING! Bottleneck!)
 	if(!ISRankZero(PETSC_COMM_WORLD)) PetscFunctionReturn(0);
 
-	MPI_Comm_size(PETSC_COMM_WORLD, &inproc); nproc = (PetscInt)inproc;
-	MPI_Comm_rank(PETSC_COMM_WORLD, &irank);  rank  = (PetscInt)irank;
+	// access context
+	fs = pvavd->actx->fs;
+
+	rx = pvavd->refine[0];
+	ry = pvavd->refine[1];
+	rz = pvavd->refine[2];
+
+	M  = fs->dsx.nproc;
+	N  = fs->dsy.nproc;
 
 	// open outfile.pvts file in the output directory (write mode)
 	asprintf(&fname, "%s/%s.pvtr", dirName, pvavd->outfile);
-	fp = fopen(fname,"wb");
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
 	free(fname);
 
-	pk  = rank/(A->M*A->N);
-	r2d = rank - pk*(A->M*A->N);
-	pj  = r2d/(A->M);
-	pi  = r2d - pj*A->M;
-
 	WriteXMLHeader(fp, "PRectilinearGrid");
 
 	fprintf(fp, "  <PRectilinearGrid WholeExtent=\"%lld %lld %lld %lld %lld %lld\" GhostLevel=\"0\" >\n",
-		0LL,(LLD)(A->gmx),
-		0LL,(LLD)(A->gmy),
-		0LL,(LLD)(A->gmz));
+		0LL,(LLD)(rx*fs->dsx.tcels),
+		0LL,(LLD)(ry*fs->dsy.tcels),
+		0LL,(LLD)(rz*fs->dsz.tcels));
 
 	fprintf(fp, "    <PCoordinates>\n");
 	fprintf(fp, "      <PDataArray type=\"Float32\" Name = \"x\" NumberOfComponents=\"1\" format=\"appended\" />\n");
@@ -757,17 +550,17 @@ PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 	fprintf(fp, "    <PPointData>\n");
 	fprintf(fp, "    </PPointData>\n");
 
-	for(p=0; p<nproc; p++)
+	for(p = 0; p < fs->dsx.nproc*fs->dsy.nproc*fs->dsz.nproc; p++)
 	{
-		pk = p/(A->M*A->N);
-		r2d = p - pk*(A->M*A->N);
-		pj = r2d/(A->M);
-		pi = r2d - pj*A->M;
+		pk  = p/(M*N);
+		r2d = p - pk*(M*N);
+		pj  = r2d/M;
+		pi  = r2d - pj*M;
 
 		fprintf(fp, "    <Piece Extent=\"%lld %lld %lld %lld %lld %lld\" Source=\"%s_p%1.6lld.vtr\" />\n",
-				(LLD)(A->ownership_ranges_i[pi]),(LLD)(A->ownership_ranges_i[pi+1]),
-				(LLD)(A->ownership_ranges_j[pj]),(LLD)(A->ownership_ranges_j[pj+1]),
-				(LLD)(A->ownership_ranges_k[pk]),(LLD)(A->ownership_ranges_k[pk+1]),
+				(LLD)(rx*fs->dsx.starts[pi]),(LLD)(rx*fs->dsx.starts[pi+1]),
+				(LLD)(ry*fs->dsy.starts[pj]),(LLD)(ry*fs->dsy.starts[pj+1]),
+				(LLD)(rz*fs->dsz.starts[pk]),(LLD)(rz*fs->dsz.starts[pk+1]),
 				pvavd->outfile, (LLD)p );
 	}
 
@@ -775,56 +568,63 @@ PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 
 	fprintf(fp, "</VTKFile>\n");
 
-	fclose( fp );
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
+PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, const char *dirName)
 {
-	// WARNING! writing single entry at a time is too slow. Use buffers instead!
-
-	PetscMPIInt   irank;
+	FDSTAG        *fs;
+	Discret1D     *ds[3];
+	PetscMPIInt    irank;
 	FILE          *fp;
+	OutFile        of;
 	char          *fname;
-	PetscInt      i, j, k, ii;
-	PetscInt      r2d, pi, pj, pk, rank;
-	PetscScalar   chLen;
-	float         crd;
-	unsigned char phase;
-	int           offset;
-	uint64_t 	  L;
+	PetscInt       d, i, ii, r[3], n[3], beg[3];
+	PetscScalar    chLen, h;
+	size_t         offset;
+	uint64_t       L;
 
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// access context
+	fs    = pvavd->actx->fs;
 	chLen = pvavd->actx->jr->scal->length;
 
-	MPI_Comm_rank(PETSC_COMM_WORLD, &irank);  rank = (PetscInt)irank;
+	ds[0] = &fs->dsx;
+	ds[1] = &fs->dsy;
+	ds[2] = &fs->dsz;
+
+	// local refined grid sizes & extents
+	for(d = 0; d < 3; d++)
+	{
+		r  [d] = pvavd->refine[d];
+		n  [d] = r[d]*ds[d]->ncels;
+		beg[d] = r[d]*ds[d]->starts[ds[d]->rank];
+	}
+
+	MPI_Comm_rank(PETSC_COMM_WORLD, &irank);
 
 	// open outfile_p_XXXXXX.vtr file in the output directory (write mode)
-	asprintf(&fname, "%s/%s_p%1.6lld.vtr", dirName, pvavd->outfile, (LLD)rank);
-	fp = fopen(fname,"wb");
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	asprintf(&fname, "%s/%s_p%1.6lld.vtr", dirName, pvavd->outfile, (LLD)irank);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
 	free(fname);
 
-	pk  = rank/(A->M*A->N);
-	r2d = rank - pk*(A->M*A->N);
-	pj  = r2d/(A->M);
-	pi  = r2d - pj*A->M;
-
 	// write header
 	WriteXMLHeader(fp, "RectilinearGrid");
 
-  fprintf(fp, "  <RectilinearGrid WholeExtent=\"%lld %lld %lld %lld %lld %lld\" >\n",
-		  (LLD)(A->ownership_ranges_i[pi]),(LLD)(A->ownership_ranges_i[pi+1]),
-		  (LLD)(A->ownership_ranges_j[pj]),(LLD)(A->ownership_ranges_j[pj+1]),
-		  (LLD)(A->ownership_ranges_k[pk]),(LLD)(A->ownership_ranges_k[pk+1]));
+	fprintf(fp, "  <RectilinearGrid WholeExtent=\"%lld %lld %lld %lld %lld %lld\" >\n",
+		(LLD)beg[0], (LLD)(beg[0]+n[0]),
+		(LLD)beg[1], (LLD)(beg[1]+n[1]),
+		(LLD)beg[2], (LLD)(beg[2]+n[2]));
 
 	fprintf(fp, "    <Piece Extent=\"%lld %lld %lld %lld %lld %lld\" >\n",
-			(LLD)(A->ownership_ranges_i[pi]),(LLD)(A->ownership_ranges_i[pi+1]),
-			(LLD)(A->ownership_ranges_j[pj]),(LLD)(A->ownership_ranges_j[pj+1]),
-			(LLD)(A->ownership_ranges_k[pk]),(LLD)(A->ownership_ranges_k[pk+1]));
+		(LLD)beg[0], (LLD)(beg[0]+n[0]),
+		(LLD)beg[1], (LLD)(beg[1]+n[1]),
+		(LLD)beg[2], (LLD)(beg[2]+n[2]));
 
 	offset = 0;
 
@@ -832,13 +632,13 @@ PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 
 	// X
 	fprintf(fp, "      <DataArray type=\"Float32\" Name = \"x\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n",(LLD)offset);
-	offset += (int)(sizeof(uint64_t) + sizeof(float)*(size_t)(A->mx+1));
+	offset += sizeof(uint64_t) + sizeof(float)*(size_t)(n[0]+1);
 	// Y
 	fprintf(fp, "      <DataArray type=\"Float32\" Name = \"y\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n",(LLD)offset);
-	offset += (int)(sizeof(uint64_t) + sizeof(float)*(size_t)(A->my+1));
+	offset += sizeof(uint64_t) + sizeof(float)*(size_t)(n[1]+1);
 	// Z
 	fprintf(fp, "      <DataArray type=\"Float32\" Name = \"z\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n",(LLD)offset);
-	offset += (int)(sizeof(uint64_t) + sizeof(float)*(size_t)(A->mz+1));
+	offset += sizeof(uint64_t) + sizeof(float)*(size_t)(n[2]+1);
 
 	fprintf(fp, "    </Coordinates>\n");
 
@@ -853,53 +653,40 @@ PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 	fprintf(fp, "    </PointData>\n");
 
 	fprintf(fp, "    </Piece>\n");
-  fprintf(fp, "  </RectilinearGrid>\n");
+	fprintf(fp, "  </RectilinearGrid>\n");
 
 	fprintf(fp,"  <AppendedData encoding=\"raw\">\n");
 	fprintf(fp,"_");
 
-	// X
-	L = (uint64_t)sizeof(float)*(int)(A->mx+1);
-	fwrite(&L, sizeof(uint64_t), 1, fp);
-	for( i=0; i<A->mx+1; i++ ) {
-		crd = (float)((A->x0 + (PetscScalar)i*A->dx)*chLen);
-		fwrite(&crd,sizeof(float),1,fp);
-	}
+	// coordinates (subdivide FDSTAG cells)
+	for(d = 0; d < 3; d++)
+	{
+		for(i = 0; i < ds[d]->ncels; i++)
+		{
+			h = (ds[d]->ncoor[i+1] - ds[d]->ncoor[i])/(PetscScalar)r[d];
 
-	// Y
-	L = (uint64_t)sizeof(float)*(int)(A->my+1);
-	fwrite(&L, sizeof(uint64_t), 1, fp);
-	for( i=0; i<A->my+1; i++ ) {
-		crd = (float)((A->y0 + (PetscScalar)i*A->dy)*chLen);
-		fwrite(&crd,sizeof(float),1,fp);
-	}
+			for(ii = 0; ii < r[d]; ii++)
+			{
+				pvavd->crd[i*r[d]+ii] = (float)((ds[d]->ncoor[i] + (PetscScalar)ii*h)*chLen);
+			}
+		}
+		pvavd->crd[n[d]] = (float)(ds[d]->ncoor[ds[d]->ncels]*chLen);
 
-	// Z
-	L = (uint64_t)sizeof(float)*(int)(A->mz+1);
-	fwrite(&L, sizeof(uint64_t), 1, fp);
-	for( i=0; i<A->mz+1; i++ ) {
-		crd = (float)((A->z0 + (PetscScalar)i*A->dz)*chLen);
-		fwrite(&crd,sizeof(float),1,fp);
+		L = (uint64_t)sizeof(float)*(uint64_t)(n[d]+1);
+		fwrite(&L, sizeof(uint64_t), 1, fp);
+		fwrite(pvavd->crd, sizeof(float), (size_t)(n[d]+1), fp);
 	}
 
 	// phase
-	L = (uint64_t)sizeof(unsigned char)*(int)(A->mz*A->my*A->mx);
+	L = (uint64_t)sizeof(unsigned char)*(uint64_t)(n[0]*n[1]*n[2]);
 	fwrite(&L, sizeof(uint64_t), 1, fp);
-	for (k=1; k<A->mz+1; k++) {
-		for (j=1; j<A->my+1; j++) {
-			for (i=1; i<A->mx+1; i++)
-			{
-				ii    = i + j*A->mx_mesh + k*A->mx_mesh*A->my_mesh;
-				phase = (unsigned char)A->points[A->cells[ii].p].phase;
-				fwrite(&phase,sizeof(unsigned char),1,fp);
-			}
-		}
-	}
+	fwrite(pvavd->phase, sizeof(unsigned char), (size_t)(n[0]*n[1]*n[2]), fp);
+
 	fprintf(fp,"\n  </AppendedData>\n");
 
 	fprintf(fp, "</VTKFile>\n");
 
-	fclose( fp );
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -27,6 +27,11 @@
  *    This implementation uses von-Neumann neighbourhoods for boundary chain growth.
  *    Do not be tempted to implement "diagonal" neighbourhood growth cycles - this will greatly increase the
  *    size of the boundary chain (and thus memory usage will increase and CPU time will decrease).
+ *
+ *    The phase output is computed cell-by-cell on the refined FDSTAG grid, using the pooled AVD
+ *    storage and claim/update routines of marker control (AVD.h). The diagram of every cell also
+ *    covers a halo of refined cells, loaded with markers of the adjacent cells. Cells whose
+ *    markers in the neighborhood did not change since the previous output are not recomputed.
  */
 
 //---------------------------------------------------------------------------
@@ -34,16 +39,6 @@
 #ifndef __paraViewOutAVD_h__
 #define __paraViewOutAVD_h__
 
-#define AVD_TRUE  'T'
-#define AVD_FALSE 'F'
-#define AVD_CELL_MASK -2
-#define AVD_CELL_UNCLAIMED -1
-
-typedef struct _p_AVDCell3D *AVDCell3D;
-typedef struct _p_AVDChain3D *AVDChain3D;
-typedef struct _p_AVDPoint3D *AVDPoint3D;
-typedef struct _p_AVD3D *AVD3D;
-
 //---------------------------------------------------------------------------
 
 #define _max_avd_refine_ 5
@@ -55,132 +50,47 @@ struct AdvCtx;
 
 //---------------------------------------------------------------------------
 
-struct _p_AVDPoint3D
-{
-	PetscScalar x,y,z;
-	PetscInt    phase;
-};
-
-//---------------------------------------------------------------------------
-
-void AVDPoint3DCreate(const PetscInt npoints, AVDPoint3D *P);
-
-void AVDPoint3DDestroy(AVDPoint3D *P);
-
-//---------------------------------------------------------------------------
-
-struct _p_AVDCell3D
-{
-	PetscInt p;     // particle index which this cell is attributed to
-	PetscInt index; // i + j.mx + k.mx.my
-	PetscInt i,j,k; // cell index i,j,k
-	char     done;
-};
-
-//---------------------------------------------------------------------------
-
-void AVDCell3DCreate(const PetscInt mx, const PetscInt my, const PetscInt mz, AVDCell3D *C);
-
-void AVDCell3DDestroy(AVDCell3D *C);
-
-//---------------------------------------------------------------------------
-
-struct _p_AVDChain3D
-{
-	PetscInt  p;
-	PetscInt  index;
-	PetscInt  length; // current length of the boundary chain
-	PetscInt  num_claimed;
-	PetscInt  total_claimed;
-	PetscInt  new_boundary_cells_malloced;
-	PetscInt  new_claimed_cells_malloced;
-	PetscInt *new_boundary_cells;
-	PetscInt *new_claimed_cells;
-	char      done;
-};
-
-//---------------------------------------------------------------------------
-
-void AVDChain3DCreate(const PetscInt npoints, const PetscInt buffer, AVDChain3D *CH);
-
-void AVDChain3DDestroy(const PetscInt npoints, AVDChain3D *CH);
-
-//---------------------------------------------------------------------------
-
-struct _p_AVD3D
+struct PVAVD
 {
-	PetscScalar x0, x1, y0, y1, z0, z1; // size of domain
-	PetscScalar dx, dy, dz;
-	PetscInt    buffer;
-	PetscInt    mx, my, mz; // user specified resolution
-	PetscInt    mx_mesh, my_mesh, mz_mesh; // computational resolution, mx_mesh = mx + 2
-	AVDCell3D   cells;
-	PetscInt    npoints;
-	AVDChain3D  chains;
-	AVDPoint3D  points;
-	PetscInt    M, N, P;
-	PetscInt    gmx, gmy, gmz;
-	PetscInt   *ownership_ranges_i; // for pvtr output
-	PetscInt   *ownership_ranges_j; // for pvtr output
-	PetscInt   *ownership_ranges_k; // for pvtr output
+	AdvCtx        *actx;                 // advection context
+	char           outfile[_str_len_+20]; // output file name
+	long int       offset;               // pvd file offset
+	PetscInt       outavd;               // AVD output flag
+	PetscInt       refine[3];            // Voronoi Diagram refinement factors (x, y, z)
+	PetscInt       outpvd;               // pvd file output flag
+
+	// run-time data (recreated after restart)
+	AVD           *avd;                  // pooled AVD storage of every worker thread
+	PetscInt       navd;                 // number of AVD structures
+	PetscInt       cached;               // cache validity flag
+	uint64_t      *hash;                 // marker set hash of every FDSTAG cell
+	uint64_t      *sig;                  // signature of cell geometry & markers in the neighborhood (zero if empty)
+	unsigned char *phase;                // phase of refined cells (output order)
+	float         *crd;                  // output coordinate buffer
 };
 
 //---------------------------------------------------------------------------
 
-PetscErrorCode AVDViewCreate(AVD3D *A, AdvCtx *actx, PetscInt refine);
-
-void AVD3DDestroy(AVD3D *A);
-
-void AVD3DAllocate(
-	const PetscInt mx,
-	const PetscInt my,
-	const PetscInt mz,
-	const PetscInt buffer,
-	const PetscInt npoints,
-	AVD3D          *A);
-
-PetscErrorCode AVD3DSetParallelExtent(AVD3D A, PetscInt M, PetscInt N, PetscInt P);
-
-void AVD3DSetDomainSize(AVD3D A,
-	const PetscScalar x0,
-	const PetscScalar x1,
-	const PetscScalar y0,
-	const PetscScalar y1,
-	const PetscScalar z0,
-	const PetscScalar z1);
-
-PetscErrorCode AVD3DLoadPoints(AVD3D A, AdvCtx *actx);
-
-void AVD3DResetCells(AVD3D A);
-
-PetscErrorCode AVD3DInit(AVD3D A);
-
-void AVD3DClaimCells(AVD3D A,const PetscInt p_i);
-
-void AVD3DUpdateChain(AVD3D A,const PetscInt p_i);
+PetscErrorCode PVAVDCreate(PVAVD *pvavd, FB *fb);
 
-//---------------------------------------------------------------------------
+PetscErrorCode PVAVDCreateData(PVAVD *pvavd);
 
-struct PVAVD
-{
-	AdvCtx    *actx;              // advection context
-	char      outfile[_str_len_+20]; // output file name
-	long int  offset;             // pvd file offset
-	PetscInt  outavd;             // AVD output flag
-	PetscInt  refine;             // Voronoi Diagram refinement factor
-	PetscInt  outpvd;             // pvd file output flag
+PetscErrorCode PVAVDDestroy(PVAVD *pvavd);
 
-};
+PetscErrorCode PVAVDWriteTimeStep(PVAVD *pvavd, const char *dirName, PetscScalar ttime);
 
-//---------------------------------------------------------------------------
+// compute (or reuse) phases of refined cells
+PetscErrorCode PVAVDUpdate(PVAVD *pvavd);
 
-PetscErrorCode PVAVDCreate(PVAVD *pvavd, FB *fb);
+// compute phases of refined cells of a single FDSTAG cell (thread-safe, returns error flag)
+PetscInt PVAVDCellPhase(PVAVD *pvavd, AVD *A, PetscInt ID);
 
-PetscErrorCode PVAVDWriteTimeStep(PVAVD *pvavd, const char *dirName, PetscScalar ttime);
+// fill refined cells without markers in the neighborhood from adjacent refined cells
+PetscErrorCode PVAVDFillEmpty(PVAVD *pvavd);
 
-PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, AVD3D A, const char *dirName);
+PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, const char *dirName);
 
-PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, AVD3D A, const char *dirName);
+PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, const char *dirName);
 
 //---------------------------------------------------------------------------
 #endif
@@ -19,6 +19,18 @@
 #include "phase.h"
 #include "outFunct.h"
 #include "tools.h"
+
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#ifdef LAMEM_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef LAMEM_LZ4
+#include <lz4.h>
+#endif
 //---------------------------------------------------------------------------
 // * phase-ratio output
 // * integrate AVD phase viewer
@@ -97,6 +109,71 @@ void OutBufDump(OutBuf *outbuf)
 	outbuf->cn = 0;
 }
 //---------------------------------------------------------------------------
+PetscErrorCode OutBufGetQuant(OutBuf *outbuf, PetscScalar *qoff, PetscScalar *qscale)
+{
+	PetscInt    i;
+	PetscScalar lrange[2], grange[2];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// get local range (maximum & negative minimum)
+	lrange[0] = -PETSC_MAX_REAL;
+	lrange[1] = -PETSC_MAX_REAL;
+
+	for(i = 0; i < outbuf->cn; i++)
+	{
+		lrange[0] = PetscMax(lrange[0],  (PetscScalar)outbuf->buff[i]);
+		lrange[1] = PetscMax(lrange[1], -(PetscScalar)outbuf->buff[i]);
+	}
+
+	// same parameters on all processors
+	ierr = MPI_Allreduce(lrange, grange, 2, MPIU_SCALAR, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	(*qoff)   = -grange[1];
+	(*qscale) = (grange[0] + grange[1])/65535.0;
+
+	// constant field
+	if(!((*qscale) > 0.0)) (*qscale) = 1.0;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void OutBufDumpQuant(OutBuf *outbuf, PetscScalar qoff, PetscScalar qscale)
+{
+	// dump output buffer contents to disk (16-bit unsigned integers)
+	// conversion is done in place (integer never overtakes float)
+
+	uint64_t     nbytes;
+	uint16_t    *ibuff;
+	PetscScalar  val;
+	PetscInt     i;
+
+	ibuff = (uint16_t*)outbuf->buff;
+
+	for(i = 0; i < outbuf->cn; i++)
+	{
+		val = ((PetscScalar)outbuf->buff[i] - qoff)/qscale + 0.5;
+
+		if(val < 0.0)     val = 0.0;
+		if(val > 65535.0) val = 65535.0;
+
+		ibuff[i] = (uint16_t)val;
+	}
+
+	// compute number of bytes
+	nbytes = (uint64_t)outbuf->cn*(int)sizeof(uint16_t);
+
+	// dump number of bytes
+	fwrite(&nbytes, sizeof(uint64_t), 1, outbuf->fp);
+
+	// dump buffer contents
+	fwrite(ibuff, sizeof(uint16_t), (size_t)outbuf->cn, outbuf->fp);
+
+	// clear buffer
+	outbuf->cn = 0;
+}
+//---------------------------------------------------------------------------
 void OutBufPutCoordVec(
 	OutBuf      *outbuf,
 	Discret1D   *ds,
@@ -329,6 +406,11 @@ PetscErrorCode PVOutCreate(PVOut *pvout, FB *fb)
 	// read
 	ierr = getStringParam(fb, _OPTIONAL_, "out_file_name",       pvout->outfile, "output");       CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "out_pvd",            &pvout->outpvd,            1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_async",          &pvout->outasync,          1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_single_file",    &pvout->outsingle,         1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_compress",       &pvout->outzip,            1, 9); CHKERRQ(ierr);
+	ierr = getStringParam(fb, _OPTIONAL_, "out_compressor",      pvout->outzipper, "zlib");        CHKERRQ(ierr);
+	ierr = getStringParam(fb, _OPTIONAL_, "out_quantize",        pvout->outquant,  "none");        CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "out_phase",          &omask->phase,             1, 1); CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "out_density",        &omask->density,           1, 1); CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "out_visc_total",     &omask->visc_total,        1, 1); CHKERRQ(ierr);
@@ -397,6 +479,46 @@ PetscErrorCode PVOutCreate(PVOut *pvout, FB *fb)
 
 	ierr = FBFreeBlocks(fb); CHKERRQ(ierr);
 
+	// read output views
+	ierr = FBFindBlocks(fb, _OPTIONAL_, "<OutViewStart>", "<OutViewEnd>"); CHKERRQ(ierr);
+
+	if(fb->nblocks > _max_num_out_views_)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Too many output views specified! Max allowed: %lld", (LLD)_max_num_out_views_);
+	}
+
+	pvout->nview = fb->nblocks;
+
+	for(i = 0; i < fb->nblocks; i++)
+	{
+		OutView *view = &pvout->view[i];
+
+		// set defaults
+		view->nstep_out = 1;
+		view->stride[0] = view->stride[1] = view->stride[2] = 1;
+
+		for(j = 0; j < 3; j++)
+		{
+			view->box[2*j]   = -PETSC_MAX_REAL;
+			view->box[2*j+1] =  PETSC_MAX_REAL;
+		}
+
+		ierr = getStringParam(fb, _REQUIRED_, "name",      view->name,      NULL);                          CHKERRQ(ierr);
+		ierr = getIntParam   (fb, _OPTIONAL_, "nstep_out", &view->nstep_out, 1, -1);                        CHKERRQ(ierr);
+		ierr = getScalarParam(fb, _OPTIONAL_, "box",        view->box,       6, pvout->jr->scal->length);   CHKERRQ(ierr);
+		ierr = getIntParam   (fb, _OPTIONAL_, "stride",     view->stride,    3, -1);                        CHKERRQ(ierr);
+		ierr = getStringParam(fb, _OPTIONAL_, "fields",     view->fields,   "all");                         CHKERRQ(ierr);
+
+		if(view->nstep_out < 1 || view->stride[0] < 1 || view->stride[1] < 1 || view->stride[2] < 1)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Output view %s: nstep_out and stride must be positive\n", view->name);
+		}
+
+		fb->blockID++;
+	}
+
+	ierr = FBFreeBlocks(fb); CHKERRQ(ierr);
+
 	// check
 	if(!pvout->jr->ctrl.actTemp)             omask->energ_res = 0; // heat diffusion is deactivated
 	if( pvout->jr->ctrl.gwType == _GW_NONE_) omask->eff_press = 0; // pore pressure is deactivated
@@ -405,6 +527,20 @@ PetscErrorCode PVOutCreate(PVOut *pvout, FB *fb)
 	PetscPrintf(PETSC_COMM_WORLD, "Output parameters:\n");
 	PetscPrintf(PETSC_COMM_WORLD, "   Output file name                        : %s \n", pvout->outfile);
 	PetscPrintf(PETSC_COMM_WORLD, "   Write .pvd file                         : %s \n", pvout->outpvd ? "yes" : "no");
+	if(pvout->outasync) PetscPrintf(PETSC_COMM_WORLD, "   Asynchronous output                     @ \n");
+	if(pvout->outsingle)PetscPrintf(PETSC_COMM_WORLD, "   Single-file collective output           @ \n");
+	if(pvout->outzip)   PetscPrintf(PETSC_COMM_WORLD, "   Compressed output (%s, level %lld)      @ \n", pvout->outzipper, (LLD)pvout->outzip);
+	if(strcmp(pvout->outquant, "none")) PetscPrintf(PETSC_COMM_WORLD, "   16-bit quantized output                 : %s \n", pvout->outquant);
+
+	// single-file collective output writes raw Float32 data
+	if(pvout->outsingle && pvout->outzip)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Warning! out_compress is not applied to the single-file grid output, only to other output files \n");
+	}
+	if(pvout->outsingle && strcmp(pvout->outquant, "none"))
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Warning! out_quantize is not applied to the single-file grid output \n");
+	}
 
 	if(omask->phase)          PetscPrintf(PETSC_COMM_WORLD, "   Phase                                   @ \n");
 	if(omask->density)        PetscPrintf(PETSC_COMM_WORLD, "   Density                                 @ \n");
@@ -456,6 +592,13 @@ PetscErrorCode PVOutCreate(PVOut *pvout, FB *fb)
 		PetscPrintf(PETSC_COMM_WORLD, ">\n");
 	}
 
+	for(i = 0; i < pvout->nview; i++)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   View: < %s >   Every %lld step(s), stride < %lld %lld %lld >, fields < %s >\n",
+			pvout->view[i].name, (LLD)pvout->view[i].nstep_out,
+			(LLD)pvout->view[i].stride[0], (LLD)pvout->view[i].stride[1], (LLD)pvout->view[i].stride[2], pvout->view[i].fields);
+	}
+
 	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
 
 	// count active output vectors
@@ -467,6 +610,23 @@ PetscErrorCode PVOutCreate(PVOut *pvout, FB *fb)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+static PetscInt PVOutFindVec(PVOut *pvout, const char *name)
+{
+	// find output vector by name (output vector names are composed of name and label)
+
+	PetscInt k;
+	size_t   len;
+
+	len = strlen(name);
+
+	for(k = 0; k < pvout->nvec; k++)
+	{
+		if(!strncmp(pvout->outvecs[k].name, name, len) && pvout->outvecs[k].name[len] == ' ') return k;
+	}
+
+	return -1;
+}
+//---------------------------------------------------------------------------
 PetscErrorCode PVOutCreateData(PVOut *pvout)
 {
 	JacRes   *jr;
@@ -487,6 +647,9 @@ PetscErrorCode PVOutCreateData(PVOut *pvout)
 	// create output buffer
 	ierr = OutBufCreate(&pvout->outbuf, jr); CHKERRQ(ierr);
 
+	// set compression of appended binary data (shared by all output drivers, also after restart)
+	ierr = OutCompressSet(pvout->outzip, pvout->outzipper); CHKERRQ(ierr);
+
 	// create vectors
 	ierr = PetscMalloc(sizeof(OutVec)*(size_t)pvout->nvec, &pvout->outvecs); CHKERRQ(ierr);
 	ierr = PetscMemzero(pvout->outvecs, sizeof(OutVec)*(size_t)pvout->nvec); CHKERRQ(ierr);
@@ -539,11 +702,32 @@ PetscErrorCode PVOutCreateData(PVOut *pvout)
 		OutVecCreate(&pvout->outvecs[iter++], jr, outbuf, omask->agg_name[i], scal->lbl_unit, &PVOutWritePhaseAgg, omask->agg_num_phase[i], omask->agg_phase_ID[i]);
 	}
 
+	// mark vectors with quantized output
+	if(strcmp(pvout->outquant, "none"))
+	{
+		char fields[_str_len_], *ptr;
+
+		strcpy(fields, pvout->outquant);
+
+		for(ptr = strtok(fields, ","); ptr; ptr = strtok(NULL, ","))
+		{
+			i = PVOutFindVec(pvout, ptr);
+
+			if(i == -1) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Quantized output: field %s is not activated\n", ptr);
+
+			pvout->outvecs[i].quant = 1;
+		}
+	}
+
+	// setup output views
+	ierr = PVOutViewCreateData(pvout); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode PVOutDestroy(PVOut *pvout)
 {
+	PetscInt i;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -551,9 +735,24 @@ PetscErrorCode PVOutDestroy(PVOut *pvout)
 	// output vectors
 	PetscFree(pvout->outvecs);
 
+	// output views
+	for(i = 0; i < pvout->nview; i++)
+	{
+		PetscFree(pvout->view[i].ivec);
+		PetscFree(pvout->view[i].gidx[0]);
+		PetscFree(pvout->view[i].gidx[1]);
+		PetscFree(pvout->view[i].gidx[2]);
+	}
+
 	// output buffer
 	ierr = OutBufDestroy(&pvout->outbuf); CHKERRQ(ierr);
 
+	// write outstanding asynchronous output
+	ierr = OutAsyncFlush(); CHKERRQ(ierr);
+
+	// report compression statistics
+	ierr = OutCompressReport(); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -562,28 +761,40 @@ PetscErrorCode PVOutWriteTimeStep(PVOut *pvout, const char *dirName, PetscScalar
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	if(pvout->outsingle)
+	{
+		// update .pvd file if necessary
+		ierr = UpdatePVDFile(dirName, pvout->outfile, "vtr", &pvout->offset, ttime, pvout->outpvd); CHKERRQ(ierr);
+
+		// write global data .vtr file collectively
+		ierr = PVOutWriteVTRCollective(pvout, dirName); CHKERRQ(ierr);
+
+		PetscFunctionReturn(0);
+	}
+
 	// update .pvd file if necessary
 	ierr = UpdatePVDFile(dirName, pvout->outfile, "pvtr", &pvout->offset, ttime, pvout->outpvd); CHKERRQ(ierr);
 
-	// write parallel data .pvtr file
-	ierr = PVOutWritePVTR(pvout, dirName); CHKERRQ(ierr);
-
 	// write sub-domain data .vtr files
 	ierr = PVOutWriteVTR(pvout, dirName); CHKERRQ(ierr);
 
+	// write parallel data .pvtr file (after quantization parameters are known)
+	ierr = PVOutWritePVTR(pvout, dirName); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
-
 //---------------------------------------------------------------------------
 PetscErrorCode PVOutWritePVTR(PVOut *pvout, const char *dirName)
 {
 	FILE        *fp;
+	OutFile      of;
 	FDSTAG      *fs;
 	char        *fname;
 	OutVec      *outvecs;
 	PetscInt     i, rx, ry, rz;
 	PetscMPIInt  nproc, iproc;
 
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// only first process generates this file (WARNING! Bottleneck!)
@@ -594,8 +805,8 @@ PetscErrorCode PVOutWritePVTR(PVOut *pvout, const char *dirName)
 
 	// open outfile.pvtr file in the output directory (write mode)
 	asprintf(&fname, "%s/%s.pvtr", dirName, pvout->outfile);
-	fp = fopen(fname,"wb");
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
 	free(fname);
 
 	// write header
@@ -622,8 +833,16 @@ PetscErrorCode PVOutWritePVTR(PVOut *pvout, const char *dirName)
 	outvecs = pvout->outvecs;
 	fprintf(fp, "\t\t<PPointData>\n");
 	for(i = 0; i < pvout->nvec; i++)
-	{	fprintf(fp,"\t\t\t<PDataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%lld\" format=\"appended\"/>\n",
-			outvecs[i].name, (LLD)outvecs[i].ncomp);
+	{
+		if(outvecs[i].quant)
+		{	// 16-bit output, physical value = Offset + Scale*raw
+			fprintf(fp,"\t\t\t<PDataArray type=\"UInt16\" Name=\"%s\" NumberOfComponents=\"%lld\" format=\"appended\" Offset=\"%.9g\" Scale=\"%.9g\"/>\n",
+				outvecs[i].name, (LLD)outvecs[i].ncomp, outvecs[i].qoff, outvecs[i].qscale);
+		}
+		else
+		{	fprintf(fp,"\t\t\t<PDataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%lld\" format=\"appended\"/>\n",
+				outvecs[i].name, (LLD)outvecs[i].ncomp);
+		}
 	}
 	fprintf(fp, "\t\t</PPointData>\n");
 
@@ -648,13 +867,14 @@ PetscErrorCode PVOutWritePVTR(PVOut *pvout, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
-	fclose(fp);
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName)
 {
 	FILE          *fp;
+	OutFile        of;
 	FDSTAG        *fs;
 	JacRes        *jr;
 	char          *fname;
@@ -682,8 +902,8 @@ PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName)
 
 	// open outfile_p_XXXXXX.vtr file in the output directory (write mode)
 	asprintf(&fname, "%s/%s_p%1.8lld.vtr", dirName, pvout->outfile, (LLD)rank);
-	fp = fopen(fname,"wb");
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
 	free(fname);
 
 	// link output buffer to file
@@ -726,10 +946,10 @@ PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName)
 	outvecs = pvout->outvecs;
 	fprintf(fp, "\t\t\t<PointData>\n");
 	for(i = 0; i < pvout->nvec; i++)
-	{	fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%lld\" format=\"appended\" offset=\"%lld\"/>\n",
-			outvecs[i].name, (LLD)outvecs[i].ncomp, (LLD)offset);
+	{	fprintf(fp, "\t\t\t\t<DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"%lld\" format=\"appended\" offset=\"%lld\"/>\n",
+			outvecs[i].quant ? "UInt16" : "Float32", outvecs[i].name, (LLD)outvecs[i].ncomp, (LLD)offset);
 		// update offset
-		offset += sizeof(uint64_t) + sizeof(float)*(size_t)(nx*ny*nz*outvecs[i].ncomp);
+		offset += sizeof(uint64_t) + (outvecs[i].quant ? sizeof(uint16_t) : sizeof(float))*(size_t)(nx*ny*nz*outvecs[i].ncomp);
 	}
 	fprintf(fp, "\t\t\t</PointData>\n");
 
@@ -750,8 +970,19 @@ PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName)
 	{
 		// compute each output vector using its own setup function
 		ierr = outvecs[i].OutVecWrite(&outvecs[i]); CHKERRQ(ierr);
-		// write vector to output file
-		OutBufDump(outbuf);
+
+		if(outvecs[i].quant)
+		{
+			// write quantized vector to output file (global range of all sub-domains)
+			ierr = OutBufGetQuant(outbuf, &outvecs[i].qoff, &outvecs[i].qscale); CHKERRQ(ierr);
+
+			OutBufDumpQuant(outbuf, outvecs[i].qoff, outvecs[i].qscale);
+		}
+		else
+		{
+			// write vector to output file
+			OutBufDump(outbuf);
+		}
 	}
 
 	// close appended data section and file
@@ -759,75 +990,1145 @@ PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
-	fclose(fp);
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-//........................... Service Functions .............................
-//---------------------------------------------------------------------------
-void WriteXMLHeader(FILE *fp, const char *file_type)
-{
-	// write standard header to ParaView XML file
-	fprintf(fp,"<?xml version=\"1.0\"?>\n");
-#ifdef PETSC_WORDS_BIGENDIAN
-	fprintf(fp,"<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"BigEndian\" header_type=\"UInt64\">\n", file_type);
-#else
-	fprintf(fp,"<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n", file_type);
-#endif
-}
-//---------------------------------------------------------------------------
-PetscErrorCode UpdatePVDFile(
-		const char *dirName, const char *outfile, const char *ext,
-		long int *offset, PetscScalar ttime, PetscInt outpvd)
+PetscErrorCode PVOutWriteVTRCollective(PVOut *pvout, const char *dirName)
 {
-	FILE        *fp;
-	char        *fname;
+	// write all output vectors of a time step to a single .vtr file
+	// header & coordinates are written by the first process,
+	// each process writes its own nodes of every vector with MPI-IO
+
+	FILE          *fp;
+	FDSTAG        *fs;
+	JacRes        *jr;
+	char          *fname;
+	OutBuf        *outbuf;
+	OutVec        *outvecs;
+	MPI_File       fh;
+	MPI_Offset     hsize, offset;
+	MPI_Datatype   mtype, ftype;
+	PetscScalar   *crd[3];
+	float         *fcrd;
+	uint64_t       nbytes;
+	PetscInt       i, j, n, ntot, rx, ry, rz, sx, sy, sz, nx, ny, nz;
+	PetscMPIInt    msize[3], fsize[3], subsz[3], start[3], zero[3];
+	size_t         off = 0;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	// check whether pvd is requested
-	if(!outpvd) PetscFunctionReturn(0);
+	// access output buffer object & staggered grid layout
+	outbuf  = &pvout->outbuf;
+	outvecs =  pvout->outvecs;
+	fs      =  outbuf->fs;
+	jr      =  pvout->jr;
 
-	// only first process generates this file (WARNING! Bottleneck!)
-	if(!ISRankZero(PETSC_COMM_WORLD)) PetscFunctionReturn(0);
+	// get sizes of output grid
+	GET_OUTPUT_RANGE(rx, nx, sx, fs->dsx)
+	GET_OUTPUT_RANGE(ry, ny, sy, fs->dsy)
+	GET_OUTPUT_RANGE(rz, nz, sz, fs->dsz)
 
-	// open outfile.pvd file (write or update mode)
-	asprintf(&fname, "%s.pvd", outfile);
-	if(!ttime) fp = fopen(fname,"wb");
-	else       fp = fopen(fname,"r+b");
-	free(fname);
+	// total number of output nodes
+	ntot = fs->dsx.tnods*fs->dsy.tnods*fs->dsz.tnods;
 
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	// gather global coordinates on first process
+	ierr = Discret1DGatherCoord(&fs->dsx, &crd[0]); CHKERRQ(ierr);
+	ierr = Discret1DGatherCoord(&fs->dsy, &crd[1]); CHKERRQ(ierr);
+	ierr = Discret1DGatherCoord(&fs->dsz, &crd[2]); CHKERRQ(ierr);
 
-	if(!ttime)
+	asprintf(&fname, "%s/%s.vtr", dirName, pvout->outfile);
+
+	hsize = 0;
+
+	if(ISRankZero(PETSC_COMM_WORLD))
 	{
+		// header must reach the disk before collective write (no asynchronous output)
+		fp = fopen(fname, "wb");
+		if(fp == NULL) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Cannot open file %s", fname);
+
 		// write header
-		WriteXMLHeader(fp, "Collection");
+		WriteXMLHeader(fp, "RectilinearGrid");
 
-		// open time step collection
-		fprintf(fp,"<Collection>\n");
+		// open rectilinear grid data block & single piece (write total grid size)
+		fprintf(fp, "\t<RectilinearGrid WholeExtent=\"%lld %lld %lld %lld %lld %lld\">\n",
+			1LL, (LLD)fs->dsx.tnods,
+			1LL, (LLD)fs->dsy.tnods,
+			1LL, (LLD)fs->dsz.tnods);
+
+		fprintf(fp, "\t\t<Piece Extent=\"%lld %lld %lld %lld %lld %lld\">\n",
+			1LL, (LLD)fs->dsx.tnods,
+			1LL, (LLD)fs->dsy.tnods,
+			1LL, (LLD)fs->dsz.tnods);
+
+		// write cell data block (empty)
+		fprintf(fp, "\t\t\t<CellData>\n");
+		fprintf(fp, "\t\t\t</CellData>\n");
+
+		// write coordinate block
+		fprintf(fp, "\t\t\t<Coordinates>\n");
+
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"x\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)off);
+		off += sizeof(uint64_t) + sizeof(float)*(size_t)fs->dsx.tnods;
+
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"y\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)off);
+		off += sizeof(uint64_t) + sizeof(float)*(size_t)fs->dsy.tnods;
+
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"z\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)off);
+		off += sizeof(uint64_t) + sizeof(float)*(size_t)fs->dsz.tnods;
+
+		fprintf(fp, "\t\t\t</Coordinates>\n");
+
+		// write description of output vectors (parameterized)
+		fprintf(fp, "\t\t\t<PointData>\n");
+		for(i = 0; i < pvout->nvec; i++)
+		{	fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%lld\" format=\"appended\" offset=\"%lld\"/>\n",
+				outvecs[i].name, (LLD)outvecs[i].ncomp, (LLD)off);
+			// update offset
+			off += sizeof(uint64_t) + sizeof(float)*(size_t)(ntot*outvecs[i].ncomp);
+		}
+		fprintf(fp, "\t\t\t</PointData>\n");
+
+		// close sub-domain and grid blocks
+		fprintf(fp, "\t\t</Piece>\n");
+		fprintf(fp, "\t</RectilinearGrid>\n");
+
+		// write appended data section
+		fprintf(fp, "\t<AppendedData encoding=\"raw\">\n");
+		fprintf(fp,"_");
+
+		// write scaled global coordinate vectors
+		ierr = PetscMalloc((size_t)PetscMax(fs->dsx.tnods, PetscMax(fs->dsy.tnods, fs->dsz.tnods))*sizeof(float), &fcrd); CHKERRQ(ierr);
+
+		for(j = 0; j < 3; j++)
+		{
+			if     (j == 0) n = fs->dsx.tnods;
+			else if(j == 1) n = fs->dsy.tnods;
+			else            n = fs->dsz.tnods;
+
+			for(i = 0; i < n; i++) fcrd[i] = (float) (jr->scal->length*crd[j][i]);
+
+			nbytes = (uint64_t)n*sizeof(float);
+			fwrite(&nbytes, sizeof(uint64_t), 1, fp);
+			fwrite(fcrd, sizeof(float), (size_t)n, fp);
+		}
+
+		ierr = PetscFree(fcrd); CHKERRQ(ierr);
+
+		// get size of the file header
+		hsize = (MPI_Offset)ftell(fp);
+
+		fclose(fp);
 	}
-	else
+
+	ierr = PetscFree(crd[0]); CHKERRQ(ierr);
+	ierr = PetscFree(crd[1]); CHKERRQ(ierr);
+	ierr = PetscFree(crd[2]); CHKERRQ(ierr);
+
+	// distribute header size (also guarantees that header is written)
+	ierr = MPI_Bcast(&hsize, 1, MPI_OFFSET, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	// open file for collective write
+	ierr = MPI_File_open(PETSC_COMM_WORLD, fname, MPI_MODE_WRONLY, MPI_INFO_NULL, &fh); CHKERRQ(ierr);
+
+	// each process writes only nodes it owns (no overlap between sub-domains)
+	// layout is [z][y][x*ncomp], x index runs fastest
+	offset = hsize;
+
+	for(i = 0; i < pvout->nvec; i++)
 	{
-		// put the file pointer on the next entry
-		ierr = fseek(fp, (*offset), SEEK_SET); CHKERRQ(ierr);
+		// compute each output vector using its own setup function
+		OutBufConnectToFile(outbuf, NULL);
+
+		ierr = outvecs[i].OutVecWrite(&outvecs[i]); CHKERRQ(ierr);
+
+		// write number of bytes
+		if(ISRankZero(PETSC_COMM_WORLD))
+		{
+			nbytes = (uint64_t)(ntot*outvecs[i].ncomp)*sizeof(float);
+
+			ierr = MPI_File_write_at(fh, offset, &nbytes, (PetscMPIInt)sizeof(uint64_t), MPI_BYTE, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+		}
+
+		offset += (MPI_Offset)sizeof(uint64_t);
+
+		// set local buffer and file subarray types
+		msize[0] = (PetscMPIInt)nz;            msize[1] = (PetscMPIInt)ny;            msize[2] = (PetscMPIInt)(nx*outvecs[i].ncomp);
+		fsize[0] = (PetscMPIInt)fs->dsz.tnods; fsize[1] = (PetscMPIInt)fs->dsy.tnods; fsize[2] = (PetscMPIInt)(fs->dsx.tnods*outvecs[i].ncomp);
+		subsz[0] = (PetscMPIInt)fs->dsz.nnods; subsz[1] = (PetscMPIInt)fs->dsy.nnods; subsz[2] = (PetscMPIInt)(fs->dsx.nnods*outvecs[i].ncomp);
+		start[0] = (PetscMPIInt)sz;            start[1] = (PetscMPIInt)sy;            start[2] = (PetscMPIInt)(sx*outvecs[i].ncomp);
+		zero [0] = 0;                          zero [1] = 0;                          zero [2] = 0;
+
+		ierr = MPI_Type_create_subarray(3, msize, subsz, zero,  MPI_ORDER_C, MPI_FLOAT, &mtype); CHKERRQ(ierr);
+		ierr = MPI_Type_create_subarray(3, fsize, subsz, start, MPI_ORDER_C, MPI_FLOAT, &ftype); CHKERRQ(ierr);
+		ierr = MPI_Type_commit(&mtype); CHKERRQ(ierr);
+		ierr = MPI_Type_commit(&ftype); CHKERRQ(ierr);
+
+		// write vector data
+		ierr = MPI_File_set_view(fh, offset, MPI_FLOAT, ftype, "native", MPI_INFO_NULL); CHKERRQ(ierr);
+		ierr = MPI_File_write_all(fh, outbuf->buff, 1, mtype, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+
+		ierr = MPI_Type_free(&mtype); CHKERRQ(ierr);
+		ierr = MPI_Type_free(&ftype); CHKERRQ(ierr);
+
+		// clear buffer
+		outbuf->cn = 0;
+
+		// update offset
+		offset += (MPI_Offset)sizeof(float)*(MPI_Offset)(ntot*outvecs[i].ncomp);
 	}
 
-	// add entry to .pvd file
-	fprintf(fp,"\t<DataSet timestep=\"%1.6e\" file=\"%s/%s.%s\"/>\n",
-		ttime, dirName, outfile, ext);
+	// reset view
+	ierr = MPI_File_set_view(fh, 0, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL); CHKERRQ(ierr);
 
-	// store current position in the file
-	(*offset) = ftell(fp);
+	// close appended data section and file
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		char tail[] = "\n\t</AppendedData>\n</VTKFile>\n";
 
-	// close time step collection
-	fprintf(fp,"</Collection>\n");
-	fprintf(fp,"</VTKFile>\n");
+		ierr = MPI_File_write_at(fh, offset, tail, (PetscMPIInt)strlen(tail), MPI_CHAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+	}
 
-	// close file
-	fclose(fp);
+	ierr = MPI_File_close(&fh); CHKERRQ(ierr);
+
+	free(fname);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+//............................ Output views .................................
+//---------------------------------------------------------------------------
+static PetscErrorCode OutViewGetNode(Discret1D *ds, PetscScalar x, PetscInt *ind)
+{
+	// get global index of the node closest to the coordinate (collective)
+
+	struct { double dist; int ind; } loc, glob;
+
+	PetscInt i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	loc.dist = PETSC_MAX_REAL;
+	loc.ind  = 0;
+
+	for(i = 0; i < ds->nnods; i++)
+	{
+		if(PetscAbsScalar(ds->ncoor[i] - x) < loc.dist)
+		{
+			loc.dist = (double)PetscAbsScalar(ds->ncoor[i] - x);
+			loc.ind  = (int)(ds->pstart + i);
+		}
+	}
+
+	ierr = MPI_Allreduce(&loc, &glob, 1, MPI_DOUBLE_INT, MPI_MINLOC, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	(*ind) = (PetscInt)glob.ind;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscInt OutViewGetRange(OutView *view, PetscInt dir, Discret1D *ds, PetscInt r, PetscInt *beg, PetscInt *num)
+{
+	// get range of view nodes on processor r in direction dir
+	// return zero if processor does not contribute to the view
+
+	PetscInt i, g, n, s, e, *gidx;
+
+	n    = view->ng[dir];
+	gidx = view->gidx[dir];
+
+	// output range of processor (including shared end node)
+	s = ds->starts[r];
+	e = ds->starts[r+1];
+
+	(*beg) = 0;
+	(*num) = 0;
+
+	for(i = 0; i < n; i++)
+	{
+		g = gidx[i];
+
+		if(g < s || g > e) continue;
+
+		if(!(*num)) (*beg) = i;
+
+		(*num)++;
+	}
+
+	// slice is written by the owner of the node only
+	if(n == 1)
+	{
+		g = gidx[0];
+
+		return (g >= s && (g < e || r == ds->nproc-1));
+	}
+
+	// single shared node is covered by the neighbor
+	return ((*num) > 1);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PVOutViewCreateData(PVOut *pvout)
+{
+	FDSTAG    *fs;
+	Discret1D *ds;
+	OutView   *view;
+	char       fields[_str_len_], *ptr;
+	PetscInt   i, j, k, r, g, ib, ie, n;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs = pvout->jr->fs;
+
+	for(i = 0; i < pvout->nview; i++)
+	{
+		view = &pvout->view[i];
+
+		// setup view nodes in all directions
+		for(j = 0; j < 3; j++)
+		{
+			if     (j == 0) ds = &fs->dsx;
+			else if(j == 1) ds = &fs->dsy;
+			else            ds = &fs->dsz;
+
+			ierr = OutViewGetNode(ds, view->box[2*j],   &ib); CHKERRQ(ierr);
+			ierr = OutViewGetNode(ds, view->box[2*j+1], &ie); CHKERRQ(ierr);
+
+			if(ib > ie) { g = ib; ib = ie; ie = g; }
+
+			ierr = makeIntArray(&view->gidx[j], NULL, ie-ib+1); CHKERRQ(ierr);
+
+			// every stride-th node, last node of the box and sub-domain boundary nodes
+			for(g = ib, n = 0, r = 1; g <= ie; g++)
+			{
+				while(r < ds->nproc && ds->starts[r] < g) r++;
+
+				if(!((g-ib) % view->stride[j]) || g == ie || (r < ds->nproc && ds->starts[r] == g))
+				{
+					view->gidx[j][n++] = g;
+				}
+			}
+
+			view->ng[j] = n;
+		}
+
+		// setup output vectors
+		ierr = makeIntArray(&view->ivec, NULL, pvout->nvec); CHKERRQ(ierr);
+
+		view->nvec = 0;
+
+		if(!strcmp(view->fields, "all"))
+		{
+			for(k = 0; k < pvout->nvec; k++) view->ivec[view->nvec++] = k;
+		}
+		else
+		{
+			strcpy(fields, view->fields);
+
+			for(ptr = strtok(fields, ","); ptr; ptr = strtok(NULL, ","))
+			{
+				k = PVOutFindVec(pvout, ptr);
+
+				if(k == -1)
+				{
+					SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Output view %s: field %s is not activated in the main output\n", view->name, ptr);
+				}
+
+				view->ivec[view->nvec++] = k;
+			}
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscInt PVOutViewIsOutput(PVOut *pvout, PetscInt step)
+{
+	PetscInt i;
+
+	for(i = 0; i < pvout->nview; i++)
+	{
+		if(!(step % pvout->view[i].nstep_out)) return 1;
+	}
+
+	return 0;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PVOutWriteViews(PVOut *pvout, const char *dirName, PetscScalar ttime, PetscInt step)
+{
+	OutView *view;
+	char    *fname;
+	PetscInt i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	for(i = 0; i < pvout->nview; i++)
+	{
+		view = &pvout->view[i];
+
+		if(step % view->nstep_out) continue;
+
+		// update .pvd file if necessary
+		asprintf(&fname, "%s_%s", pvout->outfile, view->name);
+		ierr = UpdatePVDFile(dirName, fname, "pvtr", &view->offset, ttime, pvout->outpvd); CHKERRQ(ierr);
+		free(fname);
+
+		// write parallel data .pvtr file
+		ierr = PVOutViewWritePVTR(pvout, view, dirName); CHKERRQ(ierr);
+
+		// write sub-domain data .vtr files
+		ierr = PVOutViewWriteVTR(pvout, view, dirName); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PVOutViewWritePVTR(PVOut *pvout, OutView *view, const char *dirName)
+{
+	FILE        *fp;
+	OutFile      of;
+	FDSTAG      *fs;
+	char        *fname;
+	OutVec      *outvecs;
+	PetscInt     i, rx, ry, rz, bx, by, bz, nx, ny, nz;
+	PetscMPIInt  nproc, iproc;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// only first process generates this file
+	if(!ISRankZero(PETSC_COMM_WORLD)) PetscFunctionReturn(0);
+
+	// access staggered grid layout
+	fs = pvout->outbuf.fs;
+
+	// open outfile_view.pvtr file in the output directory (write mode)
+	asprintf(&fname, "%s/%s_%s.pvtr", dirName, pvout->outfile, view->name);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
+	free(fname);
+
+	// write header
+	WriteXMLHeader(fp, "PRectilinearGrid");
+
+	// open rectilinear grid data block (write total view size)
+	fprintf(fp, "\t<PRectilinearGrid GhostLevel=\"0\" WholeExtent=\"%lld %lld %lld %lld %lld %lld\">\n",
+		1LL, (LLD)view->ng[0],
+		1LL, (LLD)view->ng[1],
+		1LL, (LLD)view->ng[2]);
+
+	// write cell data block (empty)
+	fprintf(fp, "\t\t<PCellData>\n");
+	fprintf(fp, "\t\t</PCellData>\n");
+
+	// write coordinate block
+	fprintf(fp, "\t\t<PCoordinates>\n");
+	fprintf(fp, "\t\t\t<PDataArray type=\"Float32\" Name=\"x\" NumberOfComponents=\"1\" format=\"appended\" header_type=\"UInt64\"/>\n");
+	fprintf(fp, "\t\t\t<PDataArray type=\"Float32\" Name=\"y\" NumberOfComponents=\"1\" format=\"appended\" header_type=\"UInt64\"/>\n");
+	fprintf(fp, "\t\t\t<PDataArray type=\"Float32\" Name=\"z\" NumberOfComponents=\"1\" format=\"appended\" header_type=\"UInt64\"/>\n");
+	fprintf(fp, "\t\t</PCoordinates>\n");
+
+	// write description of output vectors
+	outvecs = pvout->outvecs;
+	fprintf(fp, "\t\t<PPointData>\n");
+	for(i = 0; i < view->nvec; i++)
+	{	fprintf(fp,"\t\t\t<PDataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%lld\" format=\"appended\"/>\n",
+			outvecs[view->ivec[i]].name, (LLD)outvecs[view->ivec[i]].ncomp);
+	}
+	fprintf(fp, "\t\t</PPointData>\n");
+
+	// get total number of sub-domains
+	MPI_Comm_size(PETSC_COMM_WORLD, &nproc);
+
+	// write extents and data file names of sub-domains intersecting the view
+	for(iproc = 0; iproc < nproc; iproc++)
+	{
+		// get sub-domain ranks in all coordinate directions
+		getLocalRank(&rx, &ry, &rz, iproc, fs->dsx.nproc, fs->dsy.nproc);
+
+		if(!OutViewGetRange(view, 0, &fs->dsx, rx, &bx, &nx)
+		|| !OutViewGetRange(view, 1, &fs->dsy, ry, &by, &ny)
+		|| !OutViewGetRange(view, 2, &fs->dsz, rz, &bz, &nz)) continue;
+
+		fprintf(fp, "\t\t<Piece Extent=\"%lld %lld %lld %lld %lld %lld\" Source=\"%s_%s_p%1.8lld.vtr\"/>\n",
+			(LLD)(bx + 1), (LLD)(bx + nx),
+			(LLD)(by + 1), (LLD)(by + ny),
+			(LLD)(bz + 1), (LLD)(bz + nz), pvout->outfile, view->name, (LLD)iproc);
+	}
+
+	// close rectilinear grid data block
+	fprintf(fp, "\t</PRectilinearGrid>\n");
+	fprintf(fp, "</VTKFile>\n");
+
+	// close file
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PVOutViewWriteVTR(PVOut *pvout, OutView *view, const char *dirName)
+{
+	FILE          *fp;
+	OutFile        of;
+	FDSTAG        *fs;
+	JacRes        *jr;
+	char          *fname;
+	float         *buff;
+	OutBuf        *outbuf;
+	OutVec        *outvec;
+	Discret1D     *ds;
+	PetscInt       i, j, k, c, l, m, rx, ry, rz, sx, sy, sz, nx, ny, nc, cnt, act;
+	PetscInt       beg[3] = {0, 0, 0}, num[3] = {0, 0, 0}, *ix, *iy, *iz;
+	PetscMPIInt    rank;
+	size_t         offset = 0;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// get global sub-domain rank
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+	// access output buffer object & staggered grid layout
+	outbuf = &pvout->outbuf;
+	fs     =  outbuf->fs;
+	jr     =  pvout->jr;
+	buff   =  outbuf->buff;
+	fp     =  NULL;
+
+	// get sizes of output grid
+	GET_OUTPUT_RANGE(rx, nx, sx, fs->dsx)
+	GET_OUTPUT_RANGE(ry, ny, sy, fs->dsy)
+
+	// number of nodes in z-direction is not needed
+	rz = fs->dsz.rank;
+	sz = fs->dsz.starts[rz];
+
+	// check whether sub-domain intersects the view
+	act = OutViewGetRange(view, 0, &fs->dsx, rx, &beg[0], &num[0])
+	&&    OutViewGetRange(view, 1, &fs->dsy, ry, &beg[1], &num[1])
+	&&    OutViewGetRange(view, 2, &fs->dsz, rz, &beg[2], &num[2]);
+
+	if(act)
+	{
+		// open outfile_view_p_XXXXXX.vtr file in the output directory (write mode)
+		asprintf(&fname, "%s/%s_%s_p%1.8lld.vtr", dirName, pvout->outfile, view->name, (LLD)rank);
+		ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+		fp = of.fp;
+		free(fname);
+
+		// write header
+		WriteXMLHeader(fp, "RectilinearGrid");
+
+		// open rectilinear grid data block & sub-domain (piece) description block
+		fprintf(fp, "\t<RectilinearGrid WholeExtent=\"%lld %lld %lld %lld %lld %lld\">\n",
+			(LLD)(beg[0] + 1), (LLD)(beg[0] + num[0]),
+			(LLD)(beg[1] + 1), (LLD)(beg[1] + num[1]),
+			(LLD)(beg[2] + 1), (LLD)(beg[2] + num[2]));
+
+		fprintf(fp, "\t\t<Piece Extent=\"%lld %lld %lld %lld %lld %lld\">\n",
+			(LLD)(beg[0] + 1), (LLD)(beg[0] + num[0]),
+			(LLD)(beg[1] + 1), (LLD)(beg[1] + num[1]),
+			(LLD)(beg[2] + 1), (LLD)(beg[2] + num[2]));
+
+		// write cell data block (empty)
+		fprintf(fp, "\t\t\t<CellData>\n");
+		fprintf(fp, "\t\t\t</CellData>\n");
+
+		// write coordinate block
+		fprintf(fp, "\t\t\t<Coordinates>\n");
+
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"x\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)num[0];
+
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"y\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)num[1];
+
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"z\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)num[2];
+
+		fprintf(fp, "\t\t\t</Coordinates>\n");
+
+		// write description of output vectors
+		fprintf(fp, "\t\t\t<PointData>\n");
+		for(i = 0; i < view->nvec; i++)
+		{	outvec = &pvout->outvecs[view->ivec[i]];
+			fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"%s\" NumberOfComponents=\"%lld\" format=\"appended\" offset=\"%lld\"/>\n",
+				outvec->name, (LLD)outvec->ncomp, (LLD)offset);
+			// update offset
+			offset += sizeof(uint64_t) + sizeof(float)*(size_t)(num[0]*num[1]*num[2]*outvec->ncomp);
+		}
+		fprintf(fp, "\t\t\t</PointData>\n");
+
+		// close sub-domain and grid blocks
+		fprintf(fp, "\t\t</Piece>\n");
+		fprintf(fp, "\t</RectilinearGrid>\n");
+
+		// write appended data section
+		fprintf(fp, "\t<AppendedData encoding=\"raw\">\n");
+		fprintf(fp,"_");
+
+		// link output buffer to file
+		OutBufConnectToFile(outbuf, fp);
+
+		// coordinate vectors of view nodes
+		for(j = 0; j < 3; j++)
+		{
+			if     (j == 0) ds = &fs->dsx;
+			else if(j == 1) ds = &fs->dsy;
+			else            ds = &fs->dsz;
+
+			for(i = 0; i < num[j]; i++)
+			{
+				buff[i] = (float)(jr->scal->length*ds->ncoor[view->gidx[j][beg[j]+i] - ds->pstart]);
+			}
+
+			outbuf->cn = num[j];
+
+			OutBufDump(outbuf);
+		}
+	}
+
+	// local indices of view nodes
+	ix = view->gidx[0] + beg[0];
+	iy = view->gidx[1] + beg[1];
+	iz = view->gidx[2] + beg[2];
+
+	for(l = 0; l < view->nvec; l++)
+	{
+		outvec = &pvout->outvecs[view->ivec[l]];
+		nc     =  outvec->ncomp;
+
+		// compute output vector (collective, all processors participate)
+		ierr = outvec->OutVecWrite(outvec); CHKERRQ(ierr);
+
+		if(!act) { outbuf->cn = 0; continue; }
+
+		// compact view nodes in place (target never overtakes source)
+		cnt = 0;
+
+		for(k = 0; k < num[2]; k++)
+		for(j = 0; j < num[1]; j++)
+		for(i = 0; i < num[0]; i++)
+		{
+			m = nc*((ix[i]-sx) + (iy[j]-sy)*nx + (iz[k]-sz)*nx*ny);
+
+			for(c = 0; c < nc; c++) buff[cnt++] = buff[m+c];
+		}
+
+		outbuf->cn = cnt;
+
+		// write vector to output file
+		OutBufDump(outbuf);
+	}
+
+	if(act)
+	{
+		// close appended data section and file
+		fprintf(fp, "\n\t</AppendedData>\n");
+		fprintf(fp, "</VTKFile>\n");
+
+		// close file
+		ierr = OutFileClose(&of); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+//........................... Service Functions .............................
+//---------------------------------------------------------------------------
+void WriteXMLHeader(FILE *fp, const char *file_type)
+{
+	// write standard header to ParaView XML file
+	fprintf(fp,"<?xml version=\"1.0\"?>\n");
+#ifdef PETSC_WORDS_BIGENDIAN
+	fprintf(fp,"<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"BigEndian\" header_type=\"UInt64\">\n", file_type);
+#else
+	fprintf(fp,"<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n", file_type);
+#endif
+}
+//---------------------------------------------------------------------------
+PetscErrorCode UpdatePVDFile(
+		const char *dirName, const char *outfile, const char *ext,
+		long int *offset, PetscScalar ttime, PetscInt outpvd)
+{
+	FILE        *fp;
+	char        *fname;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// check whether pvd is requested
+	if(!outpvd) PetscFunctionReturn(0);
+
+	// only first process generates this file (WARNING! Bottleneck!)
+	if(!ISRankZero(PETSC_COMM_WORLD)) PetscFunctionReturn(0);
+
+	// open outfile.pvd file (write or update mode)
+	asprintf(&fname, "%s.pvd", outfile);
+	if(!ttime) fp = fopen(fname,"wb");
+	else       fp = fopen(fname,"r+b");
+	free(fname);
+
+	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+
+	if(!ttime)
+	{
+		// write header
+		WriteXMLHeader(fp, "Collection");
+
+		// open time step collection
+		fprintf(fp,"<Collection>\n");
+	}
+	else
+	{
+		// put the file pointer on the next entry
+		ierr = fseek(fp, (*offset), SEEK_SET); CHKERRQ(ierr);
+	}
+
+	// add entry to .pvd file
+	fprintf(fp,"\t<DataSet timestep=\"%1.6e\" file=\"%s/%s.%s\"/>\n",
+		ttime, dirName, outfile, ext);
+
+	// store current position in the file
+	(*offset) = ftell(fp);
+
+	// close time step collection
+	fprintf(fp,"</Collection>\n");
+	fprintf(fp,"</VTKFile>\n");
+
+	// close file
+	fclose(fp);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+//.......................... Asynchronous output ............................
+//---------------------------------------------------------------------------
+// output mode, compression and snapshot queues are shared by all output drivers
+static PetscInt             outZipType     = 0; // 0 - none, 1 - zlib, 2 - lz4
+static PetscInt             outZipLevel    = 0;
+static double               outZipTime     = 0.0;
+static size_t               outZipRaw      = 0;
+static size_t               outZipOut      = 0;
+static PetscInt             outAsyncActive = 0;
+static PetscInt             outAsyncFailed = 0;
+static std::thread         *outAsyncWorker = NULL; // never destroyed at exit (see OutAsyncFinalize)
+static PetscInt             outAsyncFinReg = 0;
+static std::vector<OutFile> outAsyncQueue;
+static std::vector<OutFile> outAsyncFlight;
+//---------------------------------------------------------------------------
+static size_t OutZipBlock(char *dst, size_t cap, const char *src, size_t len)
+{
+	// compress single block, return compressed size (zero on failure)
+
+#ifdef LAMEM_ZLIB
+	if(outZipType == 1)
+	{
+		uLongf dlen = (uLongf)cap;
+
+		if(compress2((Bytef*)dst, &dlen, (const Bytef*)src, (uLong)len, (int)outZipLevel) != Z_OK) return 0;
+
+		return (size_t)dlen;
+	}
+#endif
+
+#ifdef LAMEM_LZ4
+	if(outZipType == 2)
+	{
+		// map level 1 (fast) ... 9 (best) to LZ4 acceleration 9 ... 1
+		int dlen = LZ4_compress_fast(src, dst, (int)len, (int)cap, (int)(10 - outZipLevel));
+
+		return (size_t)(dlen > 0 ? dlen : 0);
+	}
+#endif
+
+	(void)dst; (void)cap; (void)src; (void)len;
+
+	return 0;
+}
+//---------------------------------------------------------------------------
+static size_t OutZipBound(size_t len)
+{
+#ifdef LAMEM_ZLIB
+	if(outZipType == 1) return (size_t)compressBound((uLong)len);
+#endif
+
+#ifdef LAMEM_LZ4
+	if(outZipType == 2) return (size_t)LZ4_compressBound((int)len);
+#endif
+
+	return len;
+}
+//---------------------------------------------------------------------------
+static int OutZipAppended(OutFile &of, std::vector<char> &out)
+{
+	// convert raw appended data of a VTK XML file to compressed format
+	// (header: number of blocks, block size, last block size, compressed block sizes)
+	// every offset attribute in the XML header is updated, all other content is kept
+	// returns zero if file has no appended data or cannot be converted
+
+	const size_t  bsize   = 1 << 20;
+	const char    tag[]   = "<AppendedData encoding=\"raw\">\n_";
+	const char    attr[]  = "offset=\"";
+	const char    vtk[]   = "<VTKFile";
+	const char   *comp    = (outZipType == 1) ? " compressor=\"vtkZLibDataCompressor\"" : " compressor=\"vtkLZ4DataCompressor\"";
+	char         *beg, *end, *hend, *data, *p, *q;
+	size_t        hlen, dlen, pos, nbytes, nb, last, ib, len, csz, bound, hdr;
+	uint64_t      val;
+	std::vector<size_t> oldoff, newoff;
+	std::vector<char>   blk;
+
+	beg = of.buf;
+	end = of.buf + of.size;
+
+	// locate appended data section
+	hend = std::search(beg, end, tag, tag + sizeof(tag) - 1);
+
+	if(hend == end) return 0;
+
+	hlen = (size_t)(hend - beg) + sizeof(tag) - 1;
+	data = beg + hlen;
+	dlen = of.size - hlen;
+
+	// collect offsets from XML header (appended arrays are stored in the same order)
+	p = beg;
+
+	while((p = std::search(p, hend, attr, attr + sizeof(attr) - 1)) != hend)
+	{
+		p += sizeof(attr) - 1;
+		oldoff.push_back((size_t)strtoull(p, &q, 10));
+		p = q;
+	}
+
+	// compress all arrays
+	pos = 0;
+
+	for(size_t k = 0; k < oldoff.size(); k++)
+	{
+		// check data layout
+		if(oldoff[k] != pos || pos + sizeof(uint64_t) > dlen) return 0;
+
+		memcpy(&val, data + pos, sizeof(uint64_t));
+
+		nbytes = (size_t)val;
+		pos   += sizeof(uint64_t);
+
+		if(pos + nbytes > dlen) return 0;
+
+		newoff.push_back(blk.size());
+
+		// compression header
+		nb   = (nbytes + bsize - 1)/bsize;
+		last = nbytes % bsize;
+		hdr  = blk.size();
+
+		blk.resize(hdr + sizeof(uint64_t)*(3 + nb));
+
+		val = (uint64_t)nb;    memcpy(&blk[hdr],                    &val, sizeof(uint64_t));
+		val = (uint64_t)bsize; memcpy(&blk[hdr +   sizeof(uint64_t)], &val, sizeof(uint64_t));
+		val = (uint64_t)last;  memcpy(&blk[hdr + 2*sizeof(uint64_t)], &val, sizeof(uint64_t));
+
+		// compressed blocks
+		for(ib = 0; ib < nb; ib++)
+		{
+			len   = (ib == nb-1 && last) ? last : bsize;
+			bound = OutZipBound(len);
+
+			blk.resize(blk.size() + bound);
+
+			csz = OutZipBlock(&blk[blk.size() - bound], bound, data + pos + ib*bsize, len);
+
+			if(!csz) return 0;
+
+			blk.resize(blk.size() - bound + csz);
+
+			val = (uint64_t)csz; memcpy(&blk[hdr + (3 + ib)*sizeof(uint64_t)], &val, sizeof(uint64_t));
+		}
+
+		pos += nbytes;
+	}
+
+	// assemble header with updated offsets
+	out.clear();
+	out.reserve(hlen + blk.size() + dlen - pos + 64);
+
+	p = beg;
+	q = std::search(beg, hend, vtk, vtk + sizeof(vtk) - 1);
+
+	if(q != hend)
+	{
+		q += sizeof(vtk) - 1;
+		out.insert(out.end(), p, q);
+		out.insert(out.end(), comp, comp + strlen(comp));
+		p = q;
+	}
+
+	for(size_t k = 0; k < newoff.size(); k++)
+	{
+		char num[32];
+
+		q = std::search(p, hend, attr, attr + sizeof(attr) - 1) + sizeof(attr) - 1;
+		out.insert(out.end(), p, q);
+		snprintf(num, sizeof(num), "%llu", (unsigned long long)newoff[k]);
+		out.insert(out.end(), num, num + strlen(num));
+		strtoull(q, &p, 10);
+	}
+
+	// copy rest of header, compressed data and closing tags
+	out.insert(out.end(), p, data);
+	out.insert(out.end(), blk.begin(), blk.end());
+	out.insert(out.end(), data + pos, end);
+
+	return 1;
+}
+//---------------------------------------------------------------------------
+static int OutFileWrite(OutFile &of)
+{
+	// write memory stream to disk (compress appended data if requested)
+	// no MPI/PETSc calls (executed by background thread in asynchronous mode)
+
+	FILE              *fp;
+	const char        *buf;
+	size_t             size;
+	int                fail = 0;
+	std::vector<char>  out;
+
+	buf  = of.buf;
+	size = of.size;
+
+	if(outZipType)
+	{
+		auto t = std::chrono::steady_clock::now();
+
+		if(OutZipAppended(of, out))
+		{
+			buf  = out.data();
+			size = out.size();
+		}
+
+		outZipTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+		outZipRaw  += of.size;
+		outZipOut  += size;
+	}
+
+	fp = fopen(of.name, "wb");
+
+	if(fp == NULL || fwrite(buf, 1, size, fp) != size) fail = 1;
+
+	if(fp) fclose(fp);
+
+	free(of.name);
+	free(of.buf);
+
+	return fail;
+}
+//---------------------------------------------------------------------------
+static void OutAsyncWriteSnapshot()
+{
+	// write all files of the snapshot to disk (background thread, no MPI/PETSc calls)
+
+	size_t i;
+
+	for(i = 0; i < outAsyncFlight.size(); i++)
+	{
+		if(OutFileWrite(outAsyncFlight[i])) outAsyncFailed = 1;
+	}
+
+	outAsyncFlight.clear();
+}
+//---------------------------------------------------------------------------
+PetscErrorCode OutFileOpen(OutFile *of, const char *fname)
+{
+	PetscFunctionBeginUser;
+
+	of->name = NULL;
+	of->buf  = NULL;
+	of->size = 0;
+
+#if !defined(_WIN32)
+	if(outAsyncActive || outZipType)
+	{
+		// assemble file in memory
+		of->fp   = open_memstream(&of->buf, &of->size);
+		of->name = strdup(fname);
+	}
+	else
+#endif
+	{
+		of->fp = fopen(fname, "wb");
+	}
+
+	if(of->fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode OutFileClose(OutFile *of)
+{
+	PetscFunctionBeginUser;
+
+	// close file (finalizes memory stream buffer)
+	fclose(of->fp);
+
+	if(of->name)
+	{
+		// add memory stream to current snapshot
+		if(outAsyncActive) outAsyncQueue.push_back(*of);
+
+		// write (compressed) memory stream immediately
+		else if(OutFileWrite(*of))
+		{
+			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Failed to write output file\n");
+		}
+	}
+
+	of->fp = NULL;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode OutAsyncBegin(PetscInt active)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// wait for previous snapshot
+	ierr = OutAsyncFlush(); CHKERRQ(ierr);
+
+#if defined(_WIN32)
+	// memory streams are not available
+	active = 0;
+#endif
+
+	outAsyncActive = active;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode OutAsyncCommit()
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(outAsyncQueue.empty()) PetscFunctionReturn(0);
+
+	// join writer on shutdown, also if an error exit happens while a snapshot is in flight
+	if(!outAsyncFinReg)
+	{
+		ierr = PetscRegisterFinalize(OutAsyncFinalize); CHKERRQ(ierr);
+
+		outAsyncFinReg = 1;
+	}
+
+	// hand over current snapshot to the background thread
+	outAsyncFlight.swap(outAsyncQueue);
+
+	outAsyncWorker = new std::thread(OutAsyncWriteSnapshot);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode OutAsyncFinalize()
+{
+	// wait for the background thread & release it
+	// (heap allocated, a joinable static std::thread would call std::terminate at exit)
+
+	if(outAsyncWorker)
+	{
+		if(outAsyncWorker->joinable()) outAsyncWorker->join();
+
+		delete outAsyncWorker;
+
+		outAsyncWorker = NULL;
+	}
+
+	return 0;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode OutCompressSet(PetscInt level, const char *type)
+{
+	PetscFunctionBeginUser;
+
+	outZipType  = 0;
+	outZipLevel = level;
+
+	if(!level) PetscFunctionReturn(0);
+
+	if(!strcmp(type, "zlib"))
+	{
+#ifdef LAMEM_ZLIB
+		outZipType = 1;
+#else
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "zlib output compression requires LaMEM compiled with zlib=1\n");
+#endif
+	}
+	else if(!strcmp(type, "lz4"))
+	{
+#ifdef LAMEM_LZ4
+		outZipType = 2;
+#else
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "lz4 output compression requires LaMEM compiled with lz4=1\n");
+#endif
+	}
+	else
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Unknown output compressor: %s (possible options: zlib, lz4)\n", type);
+	}
+
+#if defined(_WIN32)
+	// memory streams are not available
+	outZipType = 0;
+#endif
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode OutCompressReport()
+{
+	// print total compression statistics (call after all output is written)
+
+	double ltime, gtime, lsize[2], gsize[2];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!outZipType) PetscFunctionReturn(0);
+
+	ltime    = outZipTime;
+	lsize[0] = (double)outZipRaw;
+	lsize[1] = (double)outZipOut;
+
+	ierr = MPI_Reduce(&ltime, &gtime, 1, MPI_DOUBLE, MPI_MAX, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	ierr = MPI_Reduce(lsize,  gsize,  2, MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	PetscPrintf(PETSC_COMM_WORLD, "Output compression: %g MB -> %g MB (ratio %g), max. compression time %g sec\n",
+		gsize[0]/1048576.0, gsize[1]/1048576.0, gsize[1] ? gsize[0]/gsize[1] : 0.0, gtime);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode OutAsyncFlush()
+{
+	PetscInt gflag;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = OutAsyncFinalize(); CHKERRQ(ierr);
+
+	// check write errors on all processors (all of them stop collectively)
+	ierr = MPI_Allreduce(&outAsyncFailed, &gflag, 1, MPIU_INT, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	outAsyncFailed = 0;
+
+	if(gflag)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_WRITE, "Asynchronous output failed to write snapshot files\n");
+	}
 
 	PetscFunctionReturn(0);
 }
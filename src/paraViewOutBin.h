@@ -45,6 +45,49 @@ struct JacRes;
 struct Discret1D;
 struct OutVec;
 
+//---------------------------------------------------------------------------
+//.......................... Asynchronous output ............................
+//---------------------------------------------------------------------------
+// In asynchronous mode output files are assembled in memory (memory streams).
+// Files of one output step form a snapshot, which is written to disk by a
+// background thread, while the time loop continues. At most one snapshot
+// is outstanding, the next output step waits until it is written.
+// If compression is activated, appended data of every file is converted
+// to VTK compressed block format before it is written to disk.
+//---------------------------------------------------------------------------
+struct OutFile
+{
+	FILE   *fp;   // file handler (memory stream in asynchronous mode)
+	char   *name; // file name (asynchronous mode)
+	char   *buf;  // memory stream buffer
+	size_t  size; // memory stream size
+};
+//---------------------------------------------------------------------------
+
+// open output file (or memory stream in asynchronous mode)
+PetscErrorCode OutFileOpen(OutFile *of, const char *fname);
+
+// close output file (or add memory stream to current snapshot)
+PetscErrorCode OutFileClose(OutFile *of);
+
+// wait until previous snapshot is written, set output mode
+PetscErrorCode OutAsyncBegin(PetscInt active);
+
+// start writing current snapshot in the background
+PetscErrorCode OutAsyncCommit();
+
+// wait until all output is written (call before exit)
+PetscErrorCode OutAsyncFlush();
+
+// join background thread (registered with PetscRegisterFinalize)
+PetscErrorCode OutAsyncFinalize();
+
+// set compression of appended binary data (level 0 deactivates compression)
+PetscErrorCode OutCompressSet(PetscInt level, const char *type);
+
+// print compression statistics (collective)
+PetscErrorCode OutCompressReport();
+
 //---------------------------------------------------------------------------
 //............................. Output buffer ...............................
 //---------------------------------------------------------------------------
@@ -69,6 +112,12 @@ void OutBufConnectToFile(OutBuf  *outbuf, FILE *fp);
 // dump output buffer contents to disk
 void OutBufDump(OutBuf  *outbuf);
 
+// get global range of output buffer & set 16-bit quantization parameters (collective)
+PetscErrorCode OutBufGetQuant(OutBuf *outbuf, PetscScalar *qoff, PetscScalar *qscale);
+
+// dump output buffer contents to disk as 16-bit unsigned integers
+void OutBufDumpQuant(OutBuf *outbuf, PetscScalar qoff, PetscScalar qscale);
+
 // put FDSTAG coordinate vector to output buffer
 void OutBufPutCoordVec(
 	OutBuf      *outbuf,
@@ -147,6 +196,30 @@ void OutMaskSetDefault(OutMask *omask);
 
 PetscInt OutMaskCountActive(OutMask *omask);
 
+//---------------------------------------------------------------------------
+//............................ Output view ..................................
+//---------------------------------------------------------------------------
+// Output view is a sub-set of the grid output (slice, box or coarsened volume)
+// written with its own frequency. View nodes are every stride-th node inside
+// the box plus the sub-domain boundary nodes, which keeps the pieces of
+// neighboring processors connected. Processors that do not intersect the view
+// do not write any files.
+//---------------------------------------------------------------------------
+struct OutView
+{
+	char         name[_str_len_];   // view name (appended to output file name)
+	PetscInt     nstep_out;         // output frequency (time steps)
+	PetscScalar  box[6];            // bounding box (coincident bounds define a slice)
+	PetscInt     stride[3];         // decimation stride in each direction
+	char         fields[_str_len_]; // comma-separated output vector names (all if not set)
+	long int     offset;            // pvd file offset
+
+	// setup data (recreated after restart)
+	PetscInt     nvec;              // number of output vectors
+	PetscInt    *ivec;              // indices of output vectors
+	PetscInt     ng[3];             // number of view nodes in each direction
+	PetscInt    *gidx[3];           // global indices of view nodes
+};
 //---------------------------------------------------------------------------
 //...................... ParaView output driver object ......................
 //---------------------------------------------------------------------------
@@ -160,6 +233,13 @@ struct PVOut
 	OutBuf    outbuf;             // output buffer
 	long int  offset;             // pvd file offset
 	PetscInt  outpvd;             // pvd file output flag
+	PetscInt  outasync;           // asynchronous output flag
+	PetscInt  outsingle;          // single-file (collective) output flag
+	PetscInt  outzip;             // compression level of appended data (0 - no compression)
+	char      outzipper[_str_len_]; // compressor type (zlib, lz4)
+	char      outquant[_str_len_];  // comma-separated names of vectors with 16-bit quantized output
+	PetscInt  nview;              // number of output views
+	OutView   view[_max_num_out_views_]; // output views
 
 };
 //---------------------------------------------------------------------------
@@ -183,6 +263,24 @@ PetscErrorCode PVOutWritePVTR(PVOut *pvout, const char *dirName);
 // write sequential VTR files on every processor (called every time step)
 PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName);
 
+// write all sub-domains into a single .vtr file with MPI-IO
+PetscErrorCode PVOutWriteVTRCollective(PVOut *pvout, const char *dirName);
+
+// setup view nodes & output vectors of all output views
+PetscErrorCode PVOutViewCreateData(PVOut *pvout);
+
+// check whether any output view is due in current time step
+PetscInt PVOutViewIsOutput(PVOut *pvout, PetscInt step);
+
+// write all output views that are due in current time step
+PetscErrorCode PVOutWriteViews(PVOut *pvout, const char *dirName, PetscScalar ttime, PetscInt step);
+
+// write parallel PVTR file of output view (first processor)
+PetscErrorCode PVOutViewWritePVTR(PVOut *pvout, OutView *view, const char *dirName);
+
+// write VTR file of output view (processors intersecting the view)
+PetscErrorCode PVOutViewWriteVTR(PVOut *pvout, OutView *view, const char *dirName);
+
 //---------------------------------------------------------------------------
 //........................... Service Functions .............................
 //---------------------------------------------------------------------------
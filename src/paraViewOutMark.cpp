@@ -17,6 +17,7 @@
 #include "scaling.h"
 #include "advect.h"
 #include "JacRes.h"
+#include "fdstag.h"
 #include "tools.h"
 //---------------------------------------------------------------------------
 PetscErrorCode PVMarkCreate(PVMark *pvmark, FB *fb)
@@ -35,15 +36,43 @@ PetscErrorCode PVMarkCreate(PVMark *pvmark, FB *fb)
 	if(!pvmark->outmark) PetscFunctionReturn(0);
 
 	// initialize
-	pvmark->outpvd = 1;
+	pvmark->outpvd   = 1;
+	pvmark->stride   = 1;
+	pvmark->cellmax  = 0;
+	pvmark->vertex   = 1;
+	pvmark->phase    = 1;
 
 	// read
-	ierr = getStringParam(fb, _OPTIONAL_, "out_file_name", filename,    "output"); CHKERRQ(ierr);
-	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_pvd",  &pvmark->outpvd, 1, 1); CHKERRQ(ierr);
+	ierr = getStringParam(fb, _OPTIONAL_, "out_file_name",        filename,    "output"); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_pvd",         &pvmark->outpvd,   1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_stride",      &pvmark->stride,   1, 0); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_cell_max",    &pvmark->cellmax,  1, 0); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_vertex",      &pvmark->vertex,   1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_phase",       &pvmark->phase,    1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_temperature", &pvmark->temp,     1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_pressure",    &pvmark->pres,     1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_mark_plast_strain",&pvmark->aps,      1, 1); CHKERRQ(ierr);
+
+	if(pvmark->stride < 1)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Marker output stride must be positive (out_mark_stride)");
+	}
+
+	if(pvmark->cellmax < 0)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Maximum number of output markers per cell must be non-negative (out_mark_cell_max)");
+	}
 
 	// print summary
 	PetscPrintf(PETSC_COMM_WORLD, "Marker output parameters:\n");
-	PetscPrintf(PETSC_COMM_WORLD, "   Write .pvd file : %s \n", pvmark->outpvd ? "yes" : "no");
+	PetscPrintf(PETSC_COMM_WORLD, "   Write .pvd file                  : %s \n", pvmark->outpvd ? "yes" : "no");
+	PetscPrintf(PETSC_COMM_WORLD, "   Write poly-vertex cell           : %s \n", pvmark->vertex ? "yes" : "no");
+	if(pvmark->stride  > 1) PetscPrintf(PETSC_COMM_WORLD, "   Marker stride                    : %lld \n", (LLD)pvmark->stride);
+	if(pvmark->cellmax)     PetscPrintf(PETSC_COMM_WORLD, "   Maximum markers per cell         : %lld \n", (LLD)pvmark->cellmax);
+	if(pvmark->phase)       PetscPrintf(PETSC_COMM_WORLD, "   Phase                            @ \n");
+	if(pvmark->temp)        PetscPrintf(PETSC_COMM_WORLD, "   Temperature                      @ \n");
+	if(pvmark->pres)        PetscPrintf(PETSC_COMM_WORLD, "   Pressure                         @ \n");
+	if(pvmark->aps)         PetscPrintf(PETSC_COMM_WORLD, "   Accumulated plastic strain       @ \n");
 	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
 
 	// set file name
@@ -61,176 +90,264 @@ PetscErrorCode PVMarkWriteTimeStep(PVMark *pvmark, const char *dirName, PetscSca
 	if(!pvmark->outmark) PetscFunctionReturn(0);
 
 	// update .pvd file if necessary
-	ierr = UpdatePVDFile(dirName, pvmark->outfile, "pvtu", &pvmark->offset, ttime, pvmark->outpvd); CHKERRQ(ierr);
+	ierr = UpdatePVDFile(dirName, pvmark->outfile, "pvtp", &pvmark->offset, ttime, pvmark->outpvd); CHKERRQ(ierr);
 
-	// write parallel data .pvtu file
-	ierr = PVMarkWritePVTU(pvmark, dirName); CHKERRQ(ierr);
+	// write parallel data .pvtp file
+	ierr = PVMarkWritePVTP(pvmark, dirName); CHKERRQ(ierr);
 
-	// write sub-domain data .vtu files
-	ierr = PVMarkWriteVTU(pvmark, dirName); CHKERRQ(ierr);
+	// write sub-domain data .vtp files
+	ierr = PVMarkWriteVTP(pvmark, dirName); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode PVMarkWriteVTU(PVMark *pvmark, const char *dirName)
+PetscErrorCode PVMarkSelect(PVMark *pvmark, PetscInt *nsel, PetscInt **sel)
 {
-	// output markers in .vtu files
+	// select subset of local markers for output
+	// (every stride-th marker by coordinate hash, at most cellmax per cell)
+	// returns NULL index array if all markers are selected
+	AdvCtx   *actx;
+	uint64_t  stride;
+	PetscInt  i, j, n, cnt, ID, *ind;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	actx   = pvmark->actx;
+	stride = (uint64_t)pvmark->stride;
+
+	(*nsel) = actx->nummark;
+	(*sel)  = NULL;
+
+	if(stride == 1 && !pvmark->cellmax) PetscFunctionReturn(0);
+
+	ierr = makeIntArray(&ind, NULL, actx->nummark+1); CHKERRQ(ierr);
+
+	n = 0;
+
+	if(!pvmark->cellmax)
+	{
+		for(i = 0; i < actx->nummark; i++)
+		{
+			if(MarkerHash(actx->markers[i]) % stride == 0) ind[n++] = i;
+		}
+	}
+	else
+	{
+		// scan markers clustered by host cells
+		for(ID = 0; ID < actx->fs->nCells; ID++)
+		{
+			for(j = actx->markstart[ID], cnt = 0; j < actx->markstart[ID+1] && cnt < pvmark->cellmax; j++)
+			{
+				i = actx->markind[j];
+
+				if(MarkerHash(actx->markers[i]) % stride) continue;
+
+				ind[n++] = i;
+				cnt++;
+			}
+		}
+	}
+
+	(*nsel) = n;
+	(*sel)  = ind;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PVMarkWriteVTP(PVMark *pvmark, const char *dirName)
+{
+	// output markers in .vtp files (point cloud with optional single poly-vertex cell)
 	AdvCtx     *actx;
+	Scaling    *scal;
+	Marker     *P;
 	char       *fname;
 	FILE       *fp;
-	PetscInt    i, idx, connect, phase;
-	uint64_t	length;
-	PetscScalar scal_length;
-	float       xp[3];
+	OutFile     of;
+	PetscInt    i, n, nverts, *sel;
+	uint64_t    length;
+	float      *fbuf;
+	int        *ibuf;
+	void       *buf;
 	size_t      offset = 0;
 
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// get context
 	actx = pvmark->actx;
+	scal = actx->jr->scal;
 
-	// create file name
-	asprintf(&fname, "%s/%s_p%1.8lld.vtu", dirName, pvmark->outfile, (LLD)actx->iproc);
-
-	// open file
-	fp = fopen( fname, "wb" );
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
-	free(fname);
-
-	// write header
-	WriteXMLHeader(fp, "UnstructuredGrid");
-
-	// initialize connectivity
-	connect = actx->nummark;
+	// select output markers
+	ierr = PVMarkSelect(pvmark, &n, &sel); CHKERRQ(ierr);
 
-	// begin unstructured grid
-	fprintf( fp, "\t<UnstructuredGrid>\n" );
-	fprintf( fp, "\t\t<Piece NumberOfPoints=\"%lld\" NumberOfCells=\"%lld\">\n",(LLD)actx->nummark,(LLD)connect );
+	// all markers are connected by a single poly-vertex cell
+	nverts = (pvmark->vertex && n) ? 1 : 0;
 
-	// cells
-	fprintf( fp, "\t\t\t<Cells>\n");
+	// allocate output buffer (coordinates are the largest array)
+	ierr = PetscMalloc((size_t)(3*n+1)*sizeof(float), &buf); CHKERRQ(ierr);
 
-	// connectivity
-	fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%lld\"/>\n",(LLD)offset);
-	offset += sizeof(uint64_t) + sizeof(int)*(size_t)connect;
+	fbuf = (float*)buf;
+	ibuf = (int*)  buf;
 
-	// offsets
-	fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%lld\"/>\n",(LLD)offset);
-	offset += sizeof(uint64_t) + sizeof(int)*(size_t)connect;
-	// types
-	fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"types\" format=\"appended\" offset=\"%lld\"/>\n",(LLD)offset);
-	offset += sizeof(uint64_t) + sizeof(int)*(size_t)connect;
+	// create file name
+	asprintf(&fname, "%s/%s_p%1.8lld.vtp", dirName, pvmark->outfile, (LLD)actx->iproc);
 
-	fprintf( fp, "\t\t\t</Cells>\n");
+	// open file
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
+	free(fname);
 
-	// write cell data block (empty)
-	fprintf( fp, "\t\t\t<CellData>\n");
-	fprintf( fp, "\t\t\t</CellData>\n");
+	// write header
+	WriteXMLHeader(fp, "PolyData");
 
-	// points
-	fprintf( fp, "\t\t\t<Points>\n");
+	// begin poly data
+	fprintf(fp, "\t<PolyData>\n");
+	fprintf(fp, "\t\t<Piece NumberOfPoints=\"%lld\" NumberOfVerts=\"%lld\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n", (LLD)n, (LLD)nverts);
 
 	// point coordinates
-	fprintf( fp, "\t\t\t\t<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%lld\" />\n",(LLD)offset);
-	offset += sizeof(uint64_t) + sizeof(float)*(size_t)(actx->nummark*3);
+	fprintf(fp, "\t\t\t<Points>\n");
+	fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset);
+	offset += sizeof(uint64_t) + sizeof(float)*(size_t)(3*n);
+	fprintf(fp, "\t\t\t</Points>\n");
 
-	fprintf( fp, "\t\t\t</Points>\n");
+	// poly-vertex cell
+	if(nverts)
+	{
+		fprintf(fp, "\t\t\t<Verts>\n");
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(int)*(size_t)n;
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(int);
+		fprintf(fp, "\t\t\t</Verts>\n");
+	}
 
-	// point data - marker phase
-	fprintf( fp, "\t\t\t<PointData Scalars=\"\">\n");
+	// point data
+	fprintf(fp, "\t\t\t<PointData>\n");
 
-	fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"Phase\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset );
-	offset += sizeof(uint64_t) + sizeof(int)*(size_t)actx->nummark;
+	if(pvmark->phase)
+	{
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"Phase\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(int)*(size_t)n;
+	}
+	if(pvmark->temp)
+	{
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"temperature %s\" format=\"appended\" offset=\"%lld\"/>\n", scal->lbl_temperature, (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)n;
+	}
+	if(pvmark->pres)
+	{
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"pressure %s\" format=\"appended\" offset=\"%lld\"/>\n", scal->lbl_stress, (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)n;
+	}
+	if(pvmark->aps)
+	{
+		fprintf(fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"plast_strain %s\" format=\"appended\" offset=\"%lld\"/>\n", scal->lbl_unit, (LLD)offset);
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)n;
+	}
+
+	fprintf(fp, "\t\t\t</PointData>\n");
 
-	fprintf( fp, "\t\t\t</PointData>\n");
+	fprintf(fp, "\t\t</Piece>\n");
+	fprintf(fp, "\t</PolyData>\n");
 
-	fprintf( fp, "\t\t</Piece>\n");
-	fprintf( fp, "\t</UnstructuredGrid>\n");
+	fprintf(fp, "\t<AppendedData encoding=\"raw\">\n");
+	fprintf(fp, "_");
 
-	fprintf( fp,"\t<AppendedData encoding=\"raw\">\n");
-	fprintf( fp,"_");
+	// marker access
+	#define GET_MARKER P = &actx->markers[sel ? sel[i] : i];
 
 	// -------------------
-	// write connectivity
+	// write point coordinates
 	// -------------------
-	length = (uint64_t)sizeof(int)*connect;
-	fwrite( &length,sizeof(uint64_t),1, fp);
-
-	for( i = 0; i < connect; i++)
+	for(i = 0; i < n; i++)
 	{
-		idx = i;
-		fwrite( &idx, sizeof(int),1, fp );
+		GET_MARKER
+		fbuf[3*i  ] = (float)(P->X[0]*scal->length);
+		fbuf[3*i+1] = (float)(P->X[1]*scal->length);
+		fbuf[3*i+2] = (float)(P->X[2]*scal->length);
 	}
+	length = (uint64_t)sizeof(float)*(uint64_t)(3*n);
+	fwrite(&length, sizeof(uint64_t), 1, fp);
+	fwrite(fbuf, sizeof(float), (size_t)(3*n), fp);
+
 	// -------------------
-	// write offsets
+	// write poly-vertex cell
 	// -------------------
-	length = (uint64_t)sizeof(int)*connect;
-	fwrite( &length,sizeof(uint64_t),1, fp);
-
-	for( i = 0; i < connect; i++)
+	if(nverts)
 	{
-		idx = i+1;
-		fwrite( &idx, sizeof(int),1, fp );
+		for(i = 0; i < n; i++) ibuf[i] = (int)i;
+		length = (uint64_t)sizeof(int)*(uint64_t)n;
+		fwrite(&length, sizeof(uint64_t), 1, fp);
+		fwrite(ibuf, sizeof(int), (size_t)n, fp);
+
+		ibuf[0] = (int)n;
+		length  = (uint64_t)sizeof(int);
+		fwrite(&length, sizeof(uint64_t), 1, fp);
+		fwrite(ibuf, sizeof(int), 1, fp);
 	}
+
 	// -------------------
-	// write types
+	// write fields
 	// -------------------
-	length = (uint64_t)sizeof(int)*connect;
-	fwrite( &length,sizeof(uint64_t),1, fp);
-
-	for( i = 0; i < connect; i++)
+	if(pvmark->phase)
 	{
-		idx = 1;
-		fwrite( &idx, sizeof(int),1, fp );
+		for(i = 0; i < n; i++) { GET_MARKER ibuf[i] = (int)P->phase; }
+		length = (uint64_t)sizeof(int)*(uint64_t)n;
+		fwrite(&length, sizeof(uint64_t), 1, fp);
+		fwrite(ibuf, sizeof(int), (size_t)n, fp);
 	}
-	// -------------------
-	// write point coordinates
-	// -------------------
-	length = (uint64_t)sizeof(float)*(3*actx->nummark);
-	fwrite( &length,sizeof(uint64_t),1, fp);
-
-	// scaling length
-	scal_length = actx->jr->scal->length;
-
-	for( i = 0; i < actx->nummark; i++)
+	if(pvmark->temp)
 	{
-		xp[0] = (float)(actx->markers[i].X[0]*scal_length);
-		xp[1] = (float)(actx->markers[i].X[1]*scal_length);
-		xp[2] = (float)(actx->markers[i].X[2]*scal_length);
-		fwrite( xp, sizeof(float), (size_t)3, fp );
+		for(i = 0; i < n; i++) { GET_MARKER fbuf[i] = (float)(P->T*scal->temperature - scal->Tshift); }
+		length = (uint64_t)sizeof(float)*(uint64_t)n;
+		fwrite(&length, sizeof(uint64_t), 1, fp);
+		fwrite(fbuf, sizeof(float), (size_t)n, fp);
 	}
-	// -------------------
-	// write field: phases
-	// -------------------
-	length = (uint64_t)sizeof(int)*(actx->nummark);
-	fwrite( &length,sizeof(uint64_t),1, fp);
-
-	for( i = 0; i < actx->nummark; i++)
+	if(pvmark->pres)
 	{
-		phase = actx->markers[i].phase;
-		fwrite( &phase, sizeof(int),1, fp );
+		for(i = 0; i < n; i++) { GET_MARKER fbuf[i] = (float)(P->p*scal->stress); }
+		length = (uint64_t)sizeof(float)*(uint64_t)n;
+		fwrite(&length, sizeof(uint64_t), 1, fp);
+		fwrite(fbuf, sizeof(float), (size_t)n, fp);
 	}
-	// -------------------
+	if(pvmark->aps)
+	{
+		for(i = 0; i < n; i++) { GET_MARKER fbuf[i] = (float)P->APS; }
+		length = (uint64_t)sizeof(float)*(uint64_t)n;
+		fwrite(&length, sizeof(uint64_t), 1, fp);
+		fwrite(fbuf, sizeof(float), (size_t)n, fp);
+	}
+
+	#undef GET_MARKER
 
 	// end header
-	fprintf( fp,"\n\t</AppendedData>\n");
-	fprintf( fp, "</VTKFile>\n");
+	fprintf(fp, "\n\t</AppendedData>\n");
+	fprintf(fp, "</VTKFile>\n");
 
 	// close file
-	fclose(fp);
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
+
+	// clean up
+	ierr = PetscFree(buf); CHKERRQ(ierr);
+	ierr = PetscFree(sel); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode PVMarkWritePVTU(PVMark *pvmark, const char *dirName)
+PetscErrorCode PVMarkWritePVTP(PVMark *pvmark, const char *dirName)
 {
-	// create .pvtu file for marker output
-	// load the pvtu file in ParaView and apply a Glyph-spheres filter
+	// create .pvtp file for marker output
+	// load the pvtp file in ParaView and apply a Glyph-spheres filter
+	// (or use Point Gaussian representation if vertex cells are deactivated)
 	AdvCtx   *actx;
+	Scaling  *scal;
 	char     *fname;
 	FILE     *fp;
+	OutFile   of;
 	PetscInt i;
 
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// only processor 0
@@ -238,52 +355,46 @@ PetscErrorCode PVMarkWritePVTU(PVMark *pvmark, const char *dirName)
 
 	// get context
 	actx = pvmark->actx;
+	scal = actx->jr->scal;
 
 	// create file name
-	asprintf(&fname, "%s/%s.pvtu", dirName, pvmark->outfile);
+	asprintf(&fname, "%s/%s.pvtp", dirName, pvmark->outfile);
 
 	// open file
-	fp = fopen( fname, "wb" );
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
 	free(fname);
 
 	// write header
-	WriteXMLHeader(fp, "PUnstructuredGrid");
+	WriteXMLHeader(fp, "PPolyData");
 
 	// define ghost level
-	fprintf( fp, "\t<PUnstructuredGrid GhostLevel=\"0\">\n" );
-
-	// cell data (empty)
-	fprintf( fp, "\t\t<PCellData>\n");
-	fprintf( fp, "\t\t</PCellData>\n");
-
-	// cells
-	fprintf( fp, "\t\t\t<Cells>\n");
-	fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" />\n");
-	fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" />\n");
-	fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"types\" format=\"appended\" />\n");
-	fprintf( fp, "\t\t\t</Cells>\n");
+	fprintf(fp, "\t<PPolyData GhostLevel=\"0\">\n");
 
 	// points
-	fprintf( fp, "\t\t<PPoints>\n");
-	fprintf( fp, "\t\t\t<PDataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\" format=\"appended\"/>\n");
-	fprintf( fp, "\t\t</PPoints>\n");
+	fprintf(fp, "\t\t<PPoints>\n");
+	fprintf(fp, "\t\t\t<PDataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\"/>\n");
+	fprintf(fp, "\t\t</PPoints>\n");
 
 	// point data
-	fprintf( fp, "\t\t<PPointData>\n");
-	fprintf(fp,"\t\t\t<PDataArray type=\"Int32\" Name=\"Phase\" NumberOfComponents=\"1\" format=\"appended\"/>\n");
-	fprintf( fp, "\t\t</PPointData>\n");
-
-	for(i = 0; i < actx->nproc; i++){
-		fprintf( fp, "\t\t<Piece Source=\"%s_p%1.8lld.vtu\"/>\n",pvmark->outfile,(LLD)i);
+	fprintf(fp, "\t\t<PPointData>\n");
+	if(pvmark->phase) fprintf(fp, "\t\t\t<PDataArray type=\"Int32\" Name=\"Phase\" NumberOfComponents=\"1\" format=\"appended\"/>\n");
+	if(pvmark->temp)  fprintf(fp, "\t\t\t<PDataArray type=\"Float32\" Name=\"temperature %s\" NumberOfComponents=\"1\" format=\"appended\"/>\n", scal->lbl_temperature);
+	if(pvmark->pres)  fprintf(fp, "\t\t\t<PDataArray type=\"Float32\" Name=\"pressure %s\" NumberOfComponents=\"1\" format=\"appended\"/>\n", scal->lbl_stress);
+	if(pvmark->aps)   fprintf(fp, "\t\t\t<PDataArray type=\"Float32\" Name=\"plast_strain %s\" NumberOfComponents=\"1\" format=\"appended\"/>\n", scal->lbl_unit);
+	fprintf(fp, "\t\t</PPointData>\n");
+
+	for(i = 0; i < actx->nproc; i++)
+	{
+		fprintf(fp, "\t\t<Piece Source=\"%s_p%1.8lld.vtp\"/>\n", pvmark->outfile, (LLD)i);
 	}
 
 	// close the file
-	fprintf( fp, "\t</PUnstructuredGrid>\n");
-	fprintf( fp, "</VTKFile>\n");
+	fprintf(fp, "\t</PPolyData>\n");
+	fprintf(fp, "</VTKFile>\n");
 
 	// close file and free name
-	fclose(fp);
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -28,6 +28,13 @@ struct PVMark
 	long int  offset;             // pvd file offset
 	PetscInt  outmark;            // marker output flag
 	PetscInt  outpvd;             // pvd file output flag
+	PetscInt  stride;             // output every stride-th marker (selected by coordinate hash)
+	PetscInt  cellmax;            // maximum number of output markers per cell (0 - unlimited)
+	PetscInt  vertex;             // write poly-vertex cell flag (0 - point cloud only)
+	PetscInt  phase;              // phase output flag
+	PetscInt  temp;               // temperature output flag
+	PetscInt  pres;               // pressure output flag
+	PetscInt  aps;                // accumulated plastic strain output flag
 
 };
 
@@ -36,14 +43,17 @@ struct PVMark
 // create ParaView output driver
 PetscErrorCode PVMarkCreate(PVMark *pvmark, FB *fb);
 
-// write all time-step output files to disk (PVD, PVTU, VTU)
+// write all time-step output files to disk (PVD, PVTP, VTP)
 PetscErrorCode PVMarkWriteTimeStep(PVMark *pvmark, const char *dirName, PetscScalar ttime);
 
-// .vtu marker output
-PetscErrorCode PVMarkWriteVTU(PVMark *pvmark, const char *dirName);
+// select local markers for output (NULL index array - all markers)
+PetscErrorCode PVMarkSelect(PVMark *pvmark, PetscInt *nsel, PetscInt **sel);
 
-// .pvtu marker output
-PetscErrorCode PVMarkWritePVTU(PVMark *pvmark, const char *dirName);
+// .vtp marker output
+PetscErrorCode PVMarkWriteVTP(PVMark *pvmark, const char *dirName);
+
+// .pvtp marker output
+PetscErrorCode PVMarkWritePVTP(PVMark *pvmark, const char *dirName);
 
 //---------------------------------------------------------------------------
 
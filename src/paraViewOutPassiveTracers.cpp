@@ -53,10 +53,12 @@ PetscErrorCode PVPtrCreate(PVPtr *pvptr, FB *fb)
 	ierr = getIntParam   (fb, _OPTIONAL_, "out_ptr_MeltFraction",    &pvptr->MeltFraction, 1, 1); CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "out_ptr_Active",          &pvptr->Active   , 1, 1); CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "out_ptr_Grid_Mf",          &pvptr->Grid_mf   , 1, 1); CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "out_ptr_series",          &pvptr->outser   , 1, 1); CHKERRQ(ierr);
 
 	// print summary
 	PetscPrintf(PETSC_COMM_WORLD, "Passive Tracers output parameters:\n");
 	if(pvptr->outpvd) PetscPrintf(PETSC_COMM_WORLD, "   Write Passive tracers pvd file  \n");
+	if(pvptr->outser) PetscPrintf(PETSC_COMM_WORLD, "   Write Passive tracers time series file  \n");
 	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
 
 	// set file name
@@ -82,6 +84,9 @@ PetscErrorCode PVPtrWriteTimeStep(PVPtr *pvptr, const char *dirName, PetscScalar
 	// write sub-domain data .vtu files
 	ierr = PVPtrWriteVTU(pvptr, dirName); CHKERRQ(ierr);
 
+	// append tracer paths to time series file
+	ierr = PVPtrWriteSeries(pvptr, ttime); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -89,39 +94,42 @@ PetscErrorCode PVPtrWriteVTU(PVPtr *pvptr, const char *dirName)
 {
 	// output markers in .vtu files
 	P_Tr       *ptr;
+	PtrMark    *gtr;
 	char       *fname;
 	FILE       *fp;
-	PetscInt    i, idx, connect;
+	OutFile     of;
+	PetscInt    i, idx, connect, nummark;
 	uint64_t 	length;
 	PetscScalar scal_length;
 	float       var,Xp[3];
 	PetscInt    var_int;
-	PetscScalar *xp,*yp,*zp,*buf;
 	size_t      offset = 0;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	// get context
-	ptr = pvptr->actx->Ptr;
+	// get context (every processor writes its own tracers)
+	ptr     = pvptr->actx->Ptr;
+	gtr     = ptr->tracers;
+	nummark = ptr->numloc;
 
 	// create file name
 	asprintf(&fname, "%s/%s_p%1.8lld.vtu", dirName, pvptr->outfile, (LLD)pvptr->actx->iproc);
 
 	// open file
-	fp = fopen( fname, "wb" );
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
 	free(fname);
 
 	// write header
 	WriteXMLHeader(fp, "UnstructuredGrid");
 
 	// initialize connectivity
-	connect = ptr->nummark;
+	connect = nummark;
 
 	// begin unstructured grid
 	fprintf( fp, "\t<UnstructuredGrid>\n" );
-	fprintf( fp, "\t\t<Piece NumberOfPoints=\"%lld\" NumberOfCells=\"%lld\">\n",(LLD)ptr->nummark,(LLD)connect );
+	fprintf( fp, "\t\t<Piece NumberOfPoints=\"%lld\" NumberOfCells=\"%lld\">\n",(LLD)nummark,(LLD)connect );
 
 	// cells
 	fprintf( fp, "\t\t\t<Cells>\n");
@@ -148,7 +156,7 @@ PetscErrorCode PVPtrWriteVTU(PVPtr *pvptr, const char *dirName)
 
 	// point coordinates
 	fprintf( fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%lld\" />\n",(LLD)offset);
-	offset += sizeof(uint64_t) + sizeof(float)*(size_t)(ptr->nummark*3);
+	offset += sizeof(uint64_t) + sizeof(float)*(size_t)(nummark*3);
 
 	fprintf( fp, "\t\t\t</Points>\n");
 
@@ -157,41 +165,41 @@ PetscErrorCode PVPtrWriteVTU(PVPtr *pvptr, const char *dirName)
 	if(pvptr->Phase)
 	{
 		fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"Phase\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset );
-		offset += sizeof(uint64_t) + sizeof(int)*(size_t)ptr->nummark;
+		offset += sizeof(uint64_t) + sizeof(int)*(size_t)nummark;
 	}
 
 	if(pvptr->Temperature)
 	{
 		fprintf( fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"Temperature %s\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n",pvptr->actx->jr->scal->lbl_temperature, (LLD)offset);
-		offset += sizeof(uint64_t) + sizeof(float)*(size_t)ptr->nummark;
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)nummark;
 	}
 	if(pvptr->Pressure)
 	{
 		fprintf( fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"Pressure %s\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n",pvptr->actx->jr->scal->lbl_stress ,(LLD)offset);
-		offset += sizeof(uint64_t) + sizeof(float)*(size_t)ptr->nummark;
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)nummark;
 	}
 	if(pvptr->MeltFraction)
 	{
 		fprintf( fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"Mf %s\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n",pvptr->actx->jr->scal->lbl_unit  ,(LLD)offset);
 
-		offset += sizeof(uint64_t) + sizeof(float)*(size_t)ptr->nummark;
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)nummark;
 	}
 	if(pvptr->Grid_mf)
 	{
 		fprintf( fp, "\t\t\t\t<DataArray type=\"Float32\" Name=\"Mf_Grid %s\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n",pvptr->actx->jr->scal->lbl_unit  ,(LLD)offset);
-		offset += sizeof(uint64_t) + sizeof(float)*(size_t)ptr->nummark;
+		offset += sizeof(uint64_t) + sizeof(float)*(size_t)nummark;
 		}
 
 	if(pvptr->ID)
 	{
 		fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"ID\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset );
-		offset += sizeof(uint64_t) + sizeof(int)*(size_t)ptr->nummark;
+		offset += sizeof(uint64_t) + sizeof(int)*(size_t)nummark;
 	}
 
 	if(pvptr->Active)
 	{
 		fprintf( fp, "\t\t\t\t<DataArray type=\"Int32\" Name=\"Active\" NumberOfComponents=\"1\" format=\"appended\" offset=\"%lld\"/>\n", (LLD)offset );
-		offset += sizeof(uint64_t) + sizeof(int)*(size_t)ptr->nummark;
+		offset += sizeof(uint64_t) + sizeof(int)*(size_t)nummark;
 	}
 
 	fprintf( fp, "\t\t\t</PointData>\n");
@@ -239,166 +247,110 @@ PetscErrorCode PVPtrWriteVTU(PVPtr *pvptr, const char *dirName)
 	// write point coordinates
 	// -------------------
 	// scaling length
-		scal_length = pvptr->actx->jr->scal->length;
-
-		ierr = VecGetArray(ptr->x, &xp)           ; CHKERRQ(ierr);
-		ierr = VecGetArray(ptr->y, &yp)           ; CHKERRQ(ierr);
-		ierr = VecGetArray(ptr->z, &zp)           ; CHKERRQ(ierr);
-
-
+	scal_length = pvptr->actx->jr->scal->length;
 
-	length = (uint64_t)sizeof(float)*(3*ptr->nummark);
+	length = (uint64_t)sizeof(float)*(3*nummark);
 	fwrite( &length,sizeof(uint64_t),1, fp);
 
-	for( i = 0; i < ptr->nummark; i++)
+	for( i = 0; i < nummark; i++)
 	{
-		Xp[0] = (float)(xp[i]*scal_length);
-		Xp[1] = (float)(yp[i]*scal_length);
-		Xp[2] = (float)(zp[i]*scal_length);
+		Xp[0] = (float)(gtr[i].X[0]*scal_length);
+		Xp[1] = (float)(gtr[i].X[1]*scal_length);
+		Xp[2] = (float)(gtr[i].X[2]*scal_length);
 		fwrite( Xp, sizeof(float), (size_t)3, fp );
 	}
-	ierr = VecRestoreArray(ptr->x, &xp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(ptr->y, &yp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(ptr->z, &zp)           ; CHKERRQ(ierr);
-
-
-
 
 	// -------------------
 	// write field: phases
 	// -------------------
 	if(pvptr->Phase)
 	{
-		ierr = VecGetArray(ptr->phase, &buf)           ; CHKERRQ(ierr);
-
-		length = (uint64_t)sizeof(int)*(ptr->nummark);
+		length = (uint64_t)sizeof(int)*(nummark);
 		fwrite( &length,sizeof(uint64_t),1, fp);
 
-		for( i = 0; i < ptr->nummark; i++)
+		for( i = 0; i < nummark; i++)
 		{
-			var_int = PetscInt(buf[i]);
+			var_int = PetscInt(gtr[i].phase);
 			fwrite( &var_int, sizeof(int),1, fp );
 		}
-	// -------------------
-		ierr = VecRestoreArray(ptr->phase, &buf)           ; CHKERRQ(ierr);
-
-
 	}
 
 	if(pvptr->Temperature)
-		{
-			ierr = VecGetArray(ptr->T, &buf)           ; CHKERRQ(ierr);
-
-			length = (uint64_t)sizeof(float)*(ptr->nummark);
-			fwrite( &length,sizeof(uint64_t),1, fp);
-
-			for( i = 0; i < ptr->nummark; i++)
-			{
-				var = float(buf[i]*pvptr->actx->jr->scal->temperature-pvptr->actx->jr->scal->Tshift);
-				fwrite( &var, sizeof(float),1, fp );
-			}
-		// -------------------
-			ierr = VecRestoreArray(ptr->T, &buf)           ; CHKERRQ(ierr);
-
-			// end header
+	{
+		length = (uint64_t)sizeof(float)*(nummark);
+		fwrite( &length,sizeof(uint64_t),1, fp);
 
+		for( i = 0; i < nummark; i++)
+		{
+			var = float(gtr[i].T*pvptr->actx->jr->scal->temperature-pvptr->actx->jr->scal->Tshift);
+			fwrite( &var, sizeof(float),1, fp );
 		}
-
+	}
 
 	if(pvptr->Pressure)
-		{
-			ierr = VecGetArray(ptr->p, &buf)           ; CHKERRQ(ierr);
-
-			length = (uint64_t)sizeof(float)*(ptr->nummark);
-			fwrite( &length,sizeof(uint64_t),1, fp);
-
-			for( i = 0; i < ptr->nummark; i++)
-			{
-				var = float(buf[i]*pvptr->actx->jr->scal->stress);
-				fwrite( &var, sizeof(float),1, fp );
-			}
-		// -------------------
-			ierr = VecRestoreArray(ptr->p, &buf)           ; CHKERRQ(ierr);
-
+	{
+		length = (uint64_t)sizeof(float)*(nummark);
+		fwrite( &length,sizeof(uint64_t),1, fp);
 
+		for( i = 0; i < nummark; i++)
+		{
+			var = float(gtr[i].p*pvptr->actx->jr->scal->stress);
+			fwrite( &var, sizeof(float),1, fp );
 		}
+	}
 
 	if(pvptr->MeltFraction)
-		{
-			ierr = VecGetArray(ptr->Melt_fr, &buf)           ; CHKERRQ(ierr);
-
-			length = (uint64_t)sizeof(float)*(ptr->nummark);
-			fwrite( &length,sizeof(uint64_t),1, fp);
-
-			for( i = 0; i < ptr->nummark; i++)
-			{
-				var = float(buf[i]);
-				fwrite( &var, sizeof(float),1, fp );
-			}
-		// -------------------
-			ierr = VecRestoreArray(ptr->Melt_fr, &buf)           ; CHKERRQ(ierr);
-
+	{
+		length = (uint64_t)sizeof(float)*(nummark);
+		fwrite( &length,sizeof(uint64_t),1, fp);
 
+		for( i = 0; i < nummark; i++)
+		{
+			var = float(gtr[i].mf);
+			fwrite( &var, sizeof(float),1, fp );
 		}
+	}
 
 	if(pvptr->Grid_mf)
-		{
-			ierr = VecGetArray(ptr->Melt_Grid, &buf)           ; CHKERRQ(ierr);
-
-			length = (uint64_t)sizeof(float)*(ptr->nummark);
-			fwrite( &length,sizeof(uint64_t),1, fp);
-
-			for( i = 0; i < ptr->nummark; i++)
-			{
-				var = float(buf[i]);
-				fwrite( &var, sizeof(float),1, fp );
-			}
-		// -------------------
-			ierr = VecRestoreArray(ptr->Melt_Grid, &buf)           ; CHKERRQ(ierr);
-
+	{
+		length = (uint64_t)sizeof(float)*(nummark);
+		fwrite( &length,sizeof(uint64_t),1, fp);
 
+		for( i = 0; i < nummark; i++)
+		{
+			var = float(gtr[i].mfgrid);
+			fwrite( &var, sizeof(float),1, fp );
 		}
+	}
 
 	if(pvptr->ID)
-			{
-				ierr = VecGetArray(ptr->ID, &buf)           ; CHKERRQ(ierr);
-
-				length = (uint64_t)sizeof(int)*(ptr->nummark);
-				fwrite( &length,sizeof(uint64_t),1, fp);
-
-				for( i = 0; i < ptr->nummark; i++)
-				{
-					var_int = PetscInt(buf[i]);
-					fwrite( &var_int, sizeof(int),1, fp );
-				}
-			// -------------------
-				ierr = VecRestoreArray(ptr->ID, &buf)           ; CHKERRQ(ierr);
-
+	{
+		length = (uint64_t)sizeof(int)*(nummark);
+		fwrite( &length,sizeof(uint64_t),1, fp);
 
-			}
+		for( i = 0; i < nummark; i++)
+		{
+			var_int = PetscInt(gtr[i].ID);
+			fwrite( &var_int, sizeof(int),1, fp );
+		}
+	}
 
 	if(pvptr->Active)
-			{
-				ierr = VecGetArray(ptr->C_advection, &buf)           ; CHKERRQ(ierr);
-
-				length = (uint64_t)sizeof(int)*(ptr->nummark);
-				fwrite( &length,sizeof(uint64_t),1, fp);
-
-				for( i = 0; i < ptr->nummark; i++)
-				{
-					var_int = PetscInt(buf[i]);
-					fwrite( &var_int, sizeof(int),1, fp );
-				}
-
-				ierr = VecRestoreArray(ptr->C_advection, &buf)           ; CHKERRQ(ierr);
-
-			}
+	{
+		length = (uint64_t)sizeof(int)*(nummark);
+		fwrite( &length,sizeof(uint64_t),1, fp);
 
+		for( i = 0; i < nummark; i++)
+		{
+			var_int = PetscInt(gtr[i].active);
+			fwrite( &var_int, sizeof(int),1, fp );
+		}
+	}
 
 	fprintf( fp,"\n\t</AppendedData>\n");
 	fprintf( fp, "</VTKFile>\n");
 	// close file
-	fclose(fp);
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -407,23 +359,26 @@ PetscErrorCode PVPtrWritePVTU(PVPtr *pvptr, const char *dirName)
 {
 	// create .pvtu file for marker output
 	// load the pvtu file in ParaView and apply a Glyph-spheres filter
-	char     *fname;
-	FILE     *fp;
-	PetscInt i;
+	char        *fname;
+	FILE        *fp;
+	OutFile      of;
+	PetscMPIInt  nproc, i;
 
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// only processor 0
 	if (!ISRankZero(PETSC_COMM_WORLD)) { PetscFunctionReturn(0); }
 
 	// get context
+	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &nproc); CHKERRQ(ierr);
 
 	// create file name
 	asprintf(&fname, "%s/%s.pvtu", dirName, pvptr->outfile);
 
 	// open file
-	fp = fopen( fname, "wb" );
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
 	free(fname);
 
 	// write header
@@ -490,7 +445,7 @@ PetscErrorCode PVPtrWritePVTU(PVPtr *pvptr, const char *dirName)
 	fprintf( fp, "\t\t</PPointData>\n");
 
 
-	for(i = 0; i < 1; i++){
+	for(i = 0; i < nproc; i++){
 			fprintf( fp, "\t\t<Piece Source=\"%s_p%1.8lld.vtu\"/>\n",pvptr->outfile,(LLD)i);
 		}
 
@@ -499,11 +454,215 @@ PetscErrorCode PVPtrWritePVTU(PVPtr *pvptr, const char *dirName)
 	fprintf( fp, "</VTKFile>\n");
 
 	// close file and free name
-	fclose(fp);
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
+//---------------------------------------------------------------------------
+PetscErrorCode PVPtrWriteSeries(PVPtr *pvptr, PetscScalar ttime)
+{
+	// append current tracer state to binary time series file (collective MPI-IO)
+	// file starts with a header:
+	//    tag, version, number of fields        (3 doubles)
+	//    field names with units                (_ptr_ser_lbl_ characters each, space padded)
+	// followed by a sequence of blocks, one per output step:
+	//    time, ntot                            (2 doubles)
+	//    ID, time, x, y, z, p, T, mf           (8 doubles per tracer, ntot tracers)
+	// tracer order within a block is arbitrary, paths are identified by ID
+
+	P_Tr        *ptr;
+	Scaling     *scal;
+	PtrMark     *P;
+	MPI_File     fh;
+	MPI_Datatype rtype;
+	MPI_Offset   fsize, offset;
+	PetscScalar *buf, hdr[2];
+	PetscInt     i, numloc, ntot, nprev;
+	char        *fname;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// check activation
+	if(!pvptr->outser) PetscFunctionReturn(0);
+
+	ptr    = pvptr->actx->Ptr;
+	scal   = pvptr->actx->jr->scal;
+	numloc = ptr->numloc;
+	nprev  = 0;
+
+	// get offset of local tracers in the block
+	ierr = MPI_Exscan(&numloc, &nprev, 1, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	ierr = MPI_Allreduce(&numloc, &ntot, 1, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	if(ISRankZero(PETSC_COMM_WORLD)) nprev = 0;
+
+	// pack local tracers (dimensional units)
+	ierr = PetscMalloc((size_t)(8*numloc + 1)*sizeof(PetscScalar), &buf); CHKERRQ(ierr);
 
+	for(i = 0; i < numloc; i++)
+	{
+		P = &ptr->tracers[i];
+
+		buf[8*i + 0] = P->ID;
+		buf[8*i + 1] = ttime;
+		buf[8*i + 2] = P->X[0]*scal->length;
+		buf[8*i + 3] = P->X[1]*scal->length;
+		buf[8*i + 4] = P->X[2]*scal->length;
+		buf[8*i + 5] = P->p*scal->stress;
+		buf[8*i + 6] = P->T*scal->temperature - scal->Tshift;
+		buf[8*i + 7] = P->mf;
+	}
+
+	// open file (start new series or truncate after restart time at the first output step of the run)
+	asprintf(&fname, "%s.series.dat", pvptr->outfile);
+
+	ierr = MPI_File_open(PETSC_COMM_WORLD, fname, MPI_MODE_CREATE | MPI_MODE_RDWR, MPI_INFO_NULL, &fh); CHKERRQ(ierr);
+
+	free(fname);
+
+	if(!pvptr->serinit)
+	{
+		ierr = PVPtrInitSeries(pvptr, fh); CHKERRQ(ierr);
+
+		pvptr->serinit = 1;
+	}
 
+	ierr = MPI_File_get_size(fh, &fsize); CHKERRQ(ierr);
 
+	// block header
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		hdr[0] = ttime;
+		hdr[1] = (PetscScalar)ntot;
+
+		ierr = MPI_File_write_at(fh, fsize, hdr, 2, MPIU_SCALAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+	}
+
+	// tracer records (counts in records)
+	offset = fsize + (MPI_Offset)sizeof(PetscScalar)*(2 + 8*(MPI_Offset)nprev);
+
+	ierr = MPI_Type_contiguous(8, MPIU_SCALAR, &rtype); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&rtype);                     CHKERRQ(ierr);
+
+	ierr = MPI_File_write_at_all(fh, offset, buf, (PetscMPIInt)numloc, rtype, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+	ierr = MPI_File_close(&fh); CHKERRQ(ierr);
+
+	ierr = MPI_Type_free(&rtype); CHKERRQ(ierr);
+	ierr = PetscFree(buf);        CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PVPtrInitSeries(PVPtr *pvptr, MPI_File fh)
+{
+	// start new time series file (write header), or after restart keep all blocks
+	// up to the restart time and truncate the rest (incompatible file is replaced)
+
+	Scaling     *scal;
+	MPI_Offset   fsize, hsize, bsize, offset;
+	PetscScalar  hdr[3], blk[2];
+	char         lbl[_ptr_ser_nfld_*_ptr_ser_lbl_+1], *fld;
+	long long    keep;
+	PetscInt     i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	scal  = pvptr->actx->jr->scal;
+	hsize = (MPI_Offset)(3*sizeof(PetscScalar) + _ptr_ser_nfld_*_ptr_ser_lbl_);
+	keep  = 0;
+
+	if(ISRankZero(PETSC_COMM_WORLD) && pvptr->restart)
+	{
+		ierr = MPI_File_get_size(fh, &fsize); CHKERRQ(ierr);
 
+		if(fsize >= hsize)
+		{
+			ierr = MPI_File_read_at(fh, 0, hdr, 3, MPIU_SCALAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+		}
+
+		if(fsize >= hsize
+		&& hdr[0] == _ptr_ser_tag_
+		&& hdr[1] == (PetscScalar)_ptr_ser_version_
+		&& hdr[2] == (PetscScalar)_ptr_ser_nfld_)
+		{
+			// keep complete blocks up to restart time
+			offset = hsize;
+			keep   = (long long)hsize;
+
+			while(offset + (MPI_Offset)(2*sizeof(PetscScalar)) <= fsize)
+			{
+				ierr = MPI_File_read_at(fh, offset, blk, 2, MPIU_SCALAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+
+				bsize = (MPI_Offset)sizeof(PetscScalar)*(2 + _ptr_ser_nfld_*(MPI_Offset)blk[1]);
+
+				if(blk[0] > pvptr->trestart || offset + bsize > fsize) break;
+
+				offset += bsize;
+				keep    = (long long)offset;
+			}
+		}
+		else
+		{
+			PetscPrintf(PETSC_COMM_SELF, "Warning! Incompatible passive tracer time series file is replaced \n");
+		}
+	}
+
+	ierr = MPI_Bcast(&keep, 1, MPI_LONG_LONG, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	ierr = MPI_File_set_size(fh, (MPI_Offset)keep); CHKERRQ(ierr);
+
+	if(keep) PetscFunctionReturn(0);
+
+	// write header of new file
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		hdr[0] = _ptr_ser_tag_;
+		hdr[1] = (PetscScalar)_ptr_ser_version_;
+		hdr[2] = (PetscScalar)_ptr_ser_nfld_;
+
+		memset(lbl, ' ', sizeof(lbl));
+
+		for(i = 0; i < _ptr_ser_nfld_; i++)
+		{
+			fld = lbl + i*_ptr_ser_lbl_;
+
+			if(i == 0) snprintf(fld, _ptr_ser_lbl_, "ID");
+			if(i == 1) snprintf(fld, _ptr_ser_lbl_, "time %s", scal->lbl_time);
+			if(i == 2) snprintf(fld, _ptr_ser_lbl_, "x %s",    scal->lbl_length);
+			if(i == 3) snprintf(fld, _ptr_ser_lbl_, "y %s",    scal->lbl_length);
+			if(i == 4) snprintf(fld, _ptr_ser_lbl_, "z %s",    scal->lbl_length);
+			if(i == 5) snprintf(fld, _ptr_ser_lbl_, "p %s",    scal->lbl_stress);
+			if(i == 6) snprintf(fld, _ptr_ser_lbl_, "T %s",    scal->lbl_temperature);
+			if(i == 7) snprintf(fld, _ptr_ser_lbl_, "mf %s",   scal->lbl_unit);
+
+			// replace terminating zero by padding
+			fld[strlen(fld)] = ' ';
+		}
+
+		ierr = MPI_File_write_at(fh, 0, hdr, 3, MPIU_SCALAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+		ierr = MPI_File_write_at(fh, (MPI_Offset)(3*sizeof(PetscScalar)), lbl, _ptr_ser_nfld_*_ptr_ser_lbl_, MPI_CHAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+	}
+
+	// make header visible before blocks are appended
+	ierr = MPI_File_sync(fh);                 CHKERRQ(ierr);
+	ierr = MPI_Barrier(PETSC_COMM_WORLD);     CHKERRQ(ierr);
+	ierr = MPI_File_sync(fh);                 CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PVPtrSetRestart(PVPtr *pvptr, PetscScalar trestart)
+{
+	// continue time series file after restart
+
+	PetscFunctionBeginUser;
+
+	pvptr->serinit  = 0;
+	pvptr->restart  = 1;
+	pvptr->trestart = trestart;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
@@ -28,6 +28,7 @@ struct PVPtr
 	long int  offset;             // pvd file offset
 	PetscInt  outptr;             // marker output flag
 	PetscInt  outpvd;             // pvd file output flag
+	PetscInt  outser;             // tracer time series output flag
 	PetscInt  Temperature;
 	PetscInt  Pressure;
 	PetscInt  Phase;
@@ -35,6 +36,9 @@ struct PVPtr
 	PetscInt  ID;
 	PetscInt  Active;
 	PetscInt  Grid_mf;
+	PetscInt  serinit;            // time series file initialized in this run
+	PetscInt  restart;            // run is restarted (keep time series up to restart time)
+	PetscScalar trestart;         // restart time (output units)
 
 };
 
@@ -52,5 +56,14 @@ PetscErrorCode PVPtrWriteVTU(PVPtr *pvptr, const char *dirName);
 // .pvtu marker output
 PetscErrorCode PVPtrWritePVTU(PVPtr *pvptr, const char *dirName);
 
+// append tracer paths to binary time series file
+PetscErrorCode PVPtrWriteSeries(PVPtr *pvptr, PetscScalar ttime);
+
+// start new time series file, or truncate existing one after restart time (collective)
+PetscErrorCode PVPtrInitSeries(PVPtr *pvptr, MPI_File fh);
+
+// continue time series file after restart
+PetscErrorCode PVPtrSetRestart(PVPtr *pvptr, PetscScalar trestart);
+
 
 #endif
@@ -131,12 +131,14 @@ PetscErrorCode PVSurfWriteTimeStep(PVSurf *pvsurf, const char *dirName, PetscSca
 PetscErrorCode PVSurfWritePVTS(PVSurf *pvsurf, const char *dirName)
 {
 	FILE        *fp;
+	OutFile      of;
 	FDSTAG      *fs;
 	char        *fname;
 	Scaling     *scal;
 	PetscInt     nproc, rx, ry, rz;
 	PetscMPIInt  iproc;
 
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// only first process generates this file (WARNING! Bottleneck!)
@@ -148,8 +150,8 @@ PetscErrorCode PVSurfWritePVTS(PVSurf *pvsurf, const char *dirName)
 
 	// open outfile.pvts file in the output directory (write mode)
 	asprintf(&fname, "%s/%s.pvts", dirName, pvsurf->outfile);
-	fp = fopen(fname,"wb");
-	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+	ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+	fp = of.fp;
 	free(fname);
 
 	// write header
@@ -212,7 +214,7 @@ PetscErrorCode PVSurfWritePVTS(PVSurf *pvsurf, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
-	fclose(fp);
+	ierr = OutFileClose(&of); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -220,6 +222,7 @@ PetscErrorCode PVSurfWritePVTS(PVSurf *pvsurf, const char *dirName)
 PetscErrorCode PVSurfWriteVTS(PVSurf *pvsurf, const char *dirName)
 {
 	FILE      *fp;
+	OutFile    of;
 	FDSTAG    *fs;
 	Scaling   *scal;
 	char      *fname;
@@ -239,8 +242,8 @@ PetscErrorCode PVSurfWriteVTS(PVSurf *pvsurf, const char *dirName)
 	{
 		// open outfile_p_XXXXXX.vts file in the output directory (write mode)
 		asprintf(&fname, "%s/%s_p%1.8lld.vts", dirName, pvsurf->outfile, (LLD)fs->dsz.color);
-		fp = fopen(fname,"wb");
-		if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
+		ierr = OutFileOpen(&of, fname); CHKERRQ(ierr);
+		fp = of.fp;
 		free(fname);
 
 		// get sizes of output grid
@@ -327,7 +330,7 @@ PetscErrorCode PVSurfWriteVTS(PVSurf *pvsurf, const char *dirName)
 		fprintf(fp, "</VTKFile>\n");
 
 		// close file
-		fclose(fp);
+		ierr = OutFileClose(&of); CHKERRQ(ierr);
 	}
 
 	PetscFunctionReturn(0);
@@ -14,6 +14,22 @@
 #include "parsing.h"
 #include "tools.h"
 
+#include <unordered_map>
+
+//---------------------------------------------------------------------------
+// key index of input file buffer (built once after parsing)
+//---------------------------------------------------------------------------
+struct FBIndex
+{
+	unordered_map<string, vector<PetscInt> > fmap; // key -> flat lines (ascending)
+	unordered_map<string, vector<PetscInt> > bmap; // key -> block lines (ascending)
+	vector<string>   fkey;  // keys of flat lines
+	vector<string>   bkey;  // keys of block lines (empty for delimiters)
+	vector<PetscInt> bseg;  // opening delimiter line of block lines
+	vector<char>     fused; // access flags of flat lines
+	vector<char>     bused; // access flags of block lines
+};
+
 //---------------------------------------------------------------------------
 PetscErrorCode FBLoad(FB **pfb, PetscBool DisplayOutput, char *restartFileName)
 {
@@ -82,9 +98,12 @@ PetscErrorCode FBLoad(FB **pfb, PetscBool DisplayOutput, char *restartFileName)
 
 		// set number of characters
 		fb->nchar = (PetscInt)sz + 1;
+
+		// purge comments & empty lines, check syntax
+		ierr = FBCleanBuffer(fb); CHKERRQ(ierr);
 	}
 
-	// broadcast
+	// broadcast cleaned buffer
 	if(ISParallel(PETSC_COMM_WORLD))
 	{
 		ierr = MPI_Bcast(&fb->nchar, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
@@ -92,17 +111,25 @@ PetscErrorCode FBLoad(FB **pfb, PetscBool DisplayOutput, char *restartFileName)
 
 	if(!ISRankZero(PETSC_COMM_WORLD))
 	{
-		ierr = PetscMalloc((size_t)fb->nchar*sizeof(char), &fb->fbuf); CHKERRQ(ierr);
+		ierr = PetscMalloc((size_t)(fb->nchar + 1)*sizeof(char), &fb->fbuf); CHKERRQ(ierr);
+
+		fb->fbuf[fb->nchar] = '\0';
 	}
 
 	if(ISParallel(PETSC_COMM_WORLD))
 	{
 		ierr = MPI_Bcast(fb->fbuf, (PetscMPIInt)fb->nchar, MPI_CHAR, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
 	}
-	
-	// parse buffer
+
+	// setup lines & key index
 	ierr = FBParseBuffer(fb); CHKERRQ(ierr);
 
+	// report duplicate keys
+	if(DisplayOutput)
+	{
+		ierr = FBCheckDuplicates(fb); CHKERRQ(ierr);
+	}
+
 	// copy all command line and previously specified options to buffer
 	ierr = PetscOptionsGetAll(NULL, &all_options);  CHKERRQ(ierr);
 
@@ -154,6 +181,8 @@ PetscErrorCode FBDestroy(FB **pfb)
 	ierr = PetscFree(fb->pfLines); CHKERRQ(ierr);
 	ierr = PetscFree(fb->pbLines); CHKERRQ(ierr);
 	ierr = FBFreeBlocks(fb);       CHKERRQ(ierr);
+
+	delete fb->index;
 	ierr = PetscFree(fb);          CHKERRQ(ierr);
 
 	// clear pointer
@@ -162,11 +191,12 @@ PetscErrorCode FBDestroy(FB **pfb)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode FBParseBuffer(FB *fb)
+PetscErrorCode FBCleanBuffer(FB *fb)
 {
-	char      *line, *b, p;
-	size_t    len, maxlen;
-	PetscInt  i, nchar, nlines, comment, cnt, block, *fblock;
+	// purge comments, line delimiters & empty lines, check syntax (first processor)
+
+	char      *b, p;
+	PetscInt  i, nchar, comment, cnt;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -207,13 +237,12 @@ PetscErrorCode FBParseBuffer(FB *fb)
 		}
 	}
 
-	// purge empty lines, count actual number of lines
-	for(i = 0, cnt = 0, p = '\0', nlines = 0; i < nchar; i++)
+	// purge empty lines
+	for(i = 0, cnt = 0, p = '\0'; i < nchar; i++)
 	{
 		if(b[i] == '\0' && p == '\0') continue;
 		p        = b[i];
 		b[cnt++] = p;
-		if(p == '\0') nlines++;
 	}
 
 	// collect garbage
@@ -222,6 +251,29 @@ PetscErrorCode FBParseBuffer(FB *fb)
 	// store actual number of characters
 	fb->nchar = cnt;
 
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FBParseBuffer(FB *fb)
+{
+	// setup flat & block lines and key index of cleaned buffer
+
+	FBIndex   *idx;
+	char      *line, *b;
+	size_t    len, maxlen;
+	PetscInt  i, nlines, block, seg, *fblock;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	b = fb->fbuf;
+
+	// count actual number of lines
+	for(i = 0, nlines = 0; i < fb->nchar; i++)
+	{
+		if(b[i] == '\0') nlines++;
+	}
+
 	// count lines form flat and block access spaces, get line buffer size
 	fb->nbLines = 0;
 	fb->nfLines = 0;
@@ -265,6 +317,238 @@ PetscErrorCode FBParseBuffer(FB *fb)
 
 	ierr = PetscFree(fblock); CHKERRQ(ierr);
 
+	// build key index (first token of every line)
+	idx = new FBIndex;
+
+	idx->fkey.resize ((size_t)fb->nfLines);
+	idx->fused.resize((size_t)fb->nfLines, 0);
+	idx->bkey.resize ((size_t)fb->nbLines);
+	idx->bseg.resize ((size_t)fb->nbLines, -1);
+	idx->bused.resize((size_t)fb->nbLines, 0);
+
+	for(i = 0; i < fb->nfLines; i++)
+	{
+		FBGetLineKey(fb->pfLines[i], idx->fkey[(size_t)i]);
+
+		if(!idx->fkey[(size_t)i].empty()) idx->fmap[idx->fkey[(size_t)i]].push_back(i);
+	}
+
+	for(i = 0, block = 0, seg = -1; i < fb->nbLines; i++)
+	{
+		line = fb->pbLines[i];
+
+		// delimiters open & close blocks
+		if(strstr(line, "<") && strstr(line, ">"))
+		{
+			block = !block;
+			seg   =  block ? i : -1;
+
+			continue;
+		}
+
+		idx->bseg[(size_t)i] = seg;
+
+		FBGetLineKey(line, idx->bkey[(size_t)i]);
+
+		if(!idx->bkey[(size_t)i].empty()) idx->bmap[idx->bkey[(size_t)i]].push_back(i);
+	}
+
+	fb->index = idx;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void FBGetLineKey(const char *line, string &key)
+{
+	// get first token of a line
+
+	size_t beg, end;
+
+	beg = strspn(line, " ");
+	end = beg + strcspn(line + beg, " ");
+
+	key.assign(line + beg, end - beg);
+}
+//---------------------------------------------------------------------------
+PetscInt FBFindKeyLine(FB *fb, const char *key)
+{
+	// find first line with matching key in current access range (flat or current block)
+	// using key index, mark line as used, return line index (-1 if not found)
+
+	FBIndex                                            *idx;
+	unordered_map<string, vector<PetscInt> >           *map;
+	unordered_map<string, vector<PetscInt> >::iterator  it;
+	vector<PetscInt>::iterator                          pos;
+	vector<char>                                       *used;
+	PetscInt                                            lnbeg, lnend;
+
+	idx = fb->index;
+
+	FBGetLineRanges(fb, &lnbeg, &lnend, PETSC_FALSE);
+
+	if(fb->nblocks) { map = &idx->bmap; used = &idx->bused; }
+	else            { map = &idx->fmap; used = &idx->fused; }
+
+	it = map->find(key);
+
+	if(it == map->end()) return -1;
+
+	pos = lower_bound(it->second.begin(), it->second.end(), lnbeg);
+
+	if(pos == it->second.end() || (*pos) >= lnend) return -1;
+
+	(*used)[(size_t)(*pos)] = 1;
+
+	return (*pos);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FBGetKeyValues(FB *fb, const char *key, char **values)
+{
+	// find key in current access range (flat or current block) using key index
+	// return pointer to the first value token in line buffer (NULL if not found)
+	// remaining tokens are retrieved by strtok(NULL, " ")
+
+	char     *ptr, *line, **lines;
+	PetscInt  lnbeg, lnend, ln;
+
+	PetscFunctionBeginUser;
+
+	(*values) = NULL;
+
+	line  = fb->lbuf;
+	lines = FBGetLineRanges(fb, &lnbeg, &lnend, PETSC_FALSE);
+
+	// find first line with matching key within access range
+	ln = FBFindKeyLine(fb, key);
+
+	if(ln < 0) PetscFunctionReturn(0);
+
+	// copy line for parsing
+	strcpy(line, lines[ln]);
+
+	// skip key
+	strtok(line, " ");
+
+	// check equal sign
+	ptr = strtok(NULL, " ");
+
+	if(!ptr || strcmp(ptr, "="))
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No equal sign specified for parameter \"%s\"\n", key);
+	}
+
+	// retrieve values after equal sign
+	ptr = strtok(NULL, " ");
+
+	if(!ptr) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No value specified for parameter \"%s\"\n", key);
+
+	(*values) = ptr;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FBCheckDuplicates(FB *fb)
+{
+	// report keys specified more than once in flat mode or within a block
+	// PETSc options are excluded, -input_strict turns warnings into error
+
+	FBIndex          *idx;
+	vector<PetscInt> *v;
+	PetscInt          i, cnt;
+	PetscBool         strict;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	idx = fb->index;
+	cnt = 0;
+
+	for(i = 0; i < fb->nfLines; i++)
+	{
+		if(idx->fkey[(size_t)i].empty() || idx->fkey[(size_t)i][0] == '-') continue;
+
+		// all lines except first one are duplicates
+		if(idx->fmap[idx->fkey[(size_t)i]][0] == i) continue;
+
+		PetscPrintf(PETSC_COMM_WORLD, "WARNING! Duplicate parameter \"%s\" (first value is used)\n", idx->fkey[(size_t)i].c_str());
+
+		cnt++;
+	}
+
+	for(i = 0; i < fb->nbLines; i++)
+	{
+		if(idx->bkey[(size_t)i].empty() || idx->bkey[(size_t)i][0] == '-') continue;
+
+		// lines of the same key are sorted, check previous line
+		v = &idx->bmap[idx->bkey[(size_t)i]];
+
+		for(size_t j = 1; j < v->size(); j++)
+		{
+			if((*v)[j] != i) continue;
+
+			if(idx->bseg[(size_t)(*v)[j-1]] == idx->bseg[(size_t)i])
+			{
+				PetscPrintf(PETSC_COMM_WORLD, "WARNING! Duplicate parameter \"%s\" in block %s (first value is used)\n",
+					idx->bkey[(size_t)i].c_str(), fb->pbLines[idx->bseg[(size_t)i]]);
+
+				cnt++;
+			}
+			break;
+		}
+	}
+
+	ierr = PetscOptionsHasName(NULL, NULL, "-input_strict", &strict); CHKERRQ(ierr);
+
+	if(cnt && strict)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Input file contains %lld duplicate parameter(s)\n", (LLD)cnt);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FBCheckUnused(FB *fb)
+{
+	// report keys that were never retrieved (unknown or ignored parameters)
+	// call after all objects are created from the input file
+	// PETSc options are excluded, -input_strict turns warnings into error
+
+	FBIndex   *idx;
+	PetscInt   i, cnt;
+	PetscBool  strict;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	idx = fb->index;
+	cnt = 0;
+
+	for(i = 0; i < fb->nfLines; i++)
+	{
+		if(idx->fkey[(size_t)i].empty() || idx->fkey[(size_t)i][0] == '-' || idx->fused[(size_t)i]) continue;
+
+		PetscPrintf(PETSC_COMM_WORLD, "WARNING! Unknown or unused parameter \"%s\"\n", idx->fkey[(size_t)i].c_str());
+
+		cnt++;
+	}
+
+	for(i = 0; i < fb->nbLines; i++)
+	{
+		if(idx->bkey[(size_t)i].empty() || idx->bkey[(size_t)i][0] == '-' || idx->bused[(size_t)i]) continue;
+
+		PetscPrintf(PETSC_COMM_WORLD, "WARNING! Unknown or unused parameter \"%s\" in block %s\n",
+			idx->bkey[(size_t)i].c_str(), fb->pbLines[idx->bseg[(size_t)i]]);
+
+		cnt++;
+	}
+
+	ierr = PetscOptionsHasName(NULL, NULL, "-input_strict", &strict); CHKERRQ(ierr);
+
+	if(cnt && strict)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Input file contains %lld unknown or unused parameter(s)\n", (LLD)cnt);
+	}
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -340,9 +624,12 @@ PetscErrorCode FBFreeBlocks(FB *fb)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-char ** FBGetLineRanges(FB *fb, PetscInt *lnbeg, PetscInt *lnend)
+char ** FBGetLineRanges(FB *fb, PetscInt *lnbeg, PetscInt *lnend, PetscBool raw)
 {
 	// return input file line ranges and pointers for parsing depending on access mode
+	// lines are marked as used in raw access mode (parsed by the caller)
+
+	PetscInt i;
 
 	if(fb->nblocks)
 	{
@@ -350,6 +637,8 @@ char ** FBGetLineRanges(FB *fb, PetscInt *lnbeg, PetscInt *lnend)
 		(*lnbeg) = fb->blBeg[fb->blockID];
 		(*lnend) = fb->blEnd[fb->blockID];
 
+		if(raw) for(i = (*lnbeg); i < (*lnend); i++) fb->index->bused[(size_t)i] = 1;
+
 		return fb->pbLines;
 	}
 	else
@@ -358,6 +647,8 @@ char ** FBGetLineRanges(FB *fb, PetscInt *lnbeg, PetscInt *lnend)
 		(*lnbeg) = 0;
 		(*lnend) = fb->nfLines;
 
+		if(raw) for(i = (*lnbeg); i < (*lnend); i++) fb->index->fused[(size_t)i] = 1;
+
 		return fb->pfLines;
 	}
 }
@@ -370,56 +661,34 @@ PetscErrorCode FBGetIntArray(
 		PetscInt    num,
 		PetscBool  *found)
 {
-	PetscFunctionBeginUser;
+	char     *ptr;
+	PetscInt  count;
 
-	char     *ptr, *line, **lines;
-	PetscInt  i, lnbeg, lnend, count;
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
 	// initialize
 	(*nvalues) = 0;
 	(*found)   = PETSC_FALSE;
 
-	// get line buffer & pointers
-	line  = fb->lbuf;
-	lines = FBGetLineRanges(fb, &lnbeg, &lnend);
+	// find key & first value
+	ierr = FBGetKeyValues(fb, key, &ptr); CHKERRQ(ierr);
 
-	for(i = lnbeg; i < lnend; i++)
-	{
-		// copy line for parsing
-		strcpy(line, lines[i]);
+	if(!ptr) PetscFunctionReturn(0);
 
-		// check for key match
-		ptr = strtok(line, " ");
+	// retrieve values after equal sign
+	count = 0;
 
-		if(!ptr || strcmp(ptr, key)) continue;
+	while(ptr != NULL && count < num)
+	{
+		values[count++] = (PetscInt)strtol(ptr, NULL, 0);
 
-		// check equal sign
 		ptr = strtok(NULL, " ");
-
-		if(!ptr || strcmp(ptr, "="))
-		{
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No equal sign specified for parameter \"%s\"\n", key);
-		}
-
-		// retrieve values after equal sign
-		count = 0;
-		ptr   = strtok(NULL, " ");
-
-		while(ptr != NULL && count < num)
-		{
-			values[count++] = (PetscInt)strtol(ptr, NULL, 0);
-
-			ptr = strtok(NULL, " ");
-		}
-
-		if(!count) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No value specified for parameter \"%s\"\n", key);
-
-		(*nvalues) = count;
-		(*found)   = PETSC_TRUE;
-
-		PetscFunctionReturn(0);
 	}
 
+	(*nvalues) = count;
+	(*found)   = PETSC_TRUE;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -431,56 +700,34 @@ PetscErrorCode FBGetScalarArray(
 		PetscInt     num,
 		PetscBool   *found)
 {
-	PetscFunctionBeginUser;
+	char     *ptr;
+	PetscInt  count;
 
-	char     *ptr, *line, **lines;
-	PetscInt  i, lnbeg, lnend, count;
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
 	// initialize
 	(*nvalues) = 0;
 	(*found)   = PETSC_FALSE;
 
-	// get line buffer & pointers
-	line  = fb->lbuf;
-	lines = FBGetLineRanges(fb, &lnbeg, &lnend);
+	// find key & first value
+	ierr = FBGetKeyValues(fb, key, &ptr); CHKERRQ(ierr);
 
-	for(i = lnbeg; i < lnend; i++)
-	{
-		// copy line for parsing
-		strcpy(line, lines[i]);
+	if(!ptr) PetscFunctionReturn(0);
 
-		// check for key match
-		ptr = strtok(line, " ");
+	// retrieve values after equal sign
+	count = 0;
 
-		if(!ptr || strcmp(ptr, key)) continue;
+	while(ptr != NULL && count < num)
+	{
+		values[count++] = (PetscScalar)strtod(ptr, NULL);
 
-		// check equal sign
 		ptr = strtok(NULL, " ");
-
-		if(!ptr || strcmp(ptr, "="))
-		{
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No equal sign specified for parameter \"%s\"\n", key);
-		}
-
-		// retrieve values after equal sign
-		count = 0;
-		ptr   = strtok(NULL, " ");
-
-		while(ptr != NULL && count < num)
-		{
-			values[count++] = (PetscScalar)strtod(ptr, NULL);
-
-			ptr = strtok(NULL, " ");
-		}
-
-		if(!count) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No value specified for parameter \"%s\"\n", key);
-
-		(*nvalues) = count;
-		(*found)   = PETSC_TRUE;
-
-		PetscFunctionReturn(0);
 	}
 
+	(*nvalues) = count;
+	(*found)   = PETSC_TRUE;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -490,54 +737,29 @@ PetscErrorCode FBGetString(
 		char       *str,    // output string
 		PetscBool  *found)
 {
-	PetscFunctionBeginUser;
+	char *ptr;
 
-	char     *ptr, *line, **lines;
-	PetscInt  i, lnbeg, lnend;
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
 	// initialize
 	(*found) = PETSC_FALSE;
 
-	// get line buffer & pointers
-	line  = fb->lbuf;
-	lines = FBGetLineRanges(fb, &lnbeg, &lnend);
-
-	for(i = lnbeg; i < lnend; i++)
-	{
-		// copy line for parsing
-		strcpy(line, lines[i]);
-
-		// check for key match
-		ptr = strtok(line, " ");
-
-		if(!ptr || strcmp(ptr, key)) continue;
-
-		// check equal sign
-		ptr = strtok(NULL, " ");
-
-		if(!ptr || strcmp(ptr, "="))
-		{
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No equal sign specified for parameter \"%s\"\n", key);
-		}
-
-		// retrieve values after equal sign
-		ptr = strtok(NULL, " ");
+	// find key & value
+	ierr = FBGetKeyValues(fb, key, &ptr); CHKERRQ(ierr);
 
-		if(!ptr) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No value specified for parameter \"%s\"\n", key);
+	if(!ptr) PetscFunctionReturn(0);
 
-		// make sure string fits & is null terminated (two null characters are reserved in the end)
-		if(strlen(ptr) > (_str_len_ - 2) )
-		{
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "String %s is more than %lld symbols long, (_str_len_ in parsing.h) \n", key, (LLD)(_str_len_ - 2));
-		}
-
-		// copy & pad the rest of the string with zeros
-		strncpy(str, ptr, _str_len_);
+	// make sure string fits & is null terminated (two null characters are reserved in the end)
+	if(strlen(ptr) > (_str_len_ - 2) )
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "String %s is more than %lld symbols long, (_str_len_ in parsing.h) \n", key, (LLD)(_str_len_ - 2));
+	}
 
-		(*found) = PETSC_TRUE;
+	// copy & pad the rest of the string with zeros
+	strncpy(str, ptr, _str_len_);
 
-		PetscFunctionReturn(0);
-	}
+	(*found) = PETSC_TRUE;
 
 	PetscFunctionReturn(0);
 }
@@ -584,6 +806,11 @@ PetscErrorCode getIntParam(
 	{
 		ierr = FBGetIntArray(fb, key, &nval, val, num, &found); CHKERRQ(ierr);
 	}
+	else if(fb)
+	{
+		// overridden in command line, input file parameter is still known
+		FBFindKeyLine(fb, key);
+	}
 
 	// check whether parameter is set
 	if(found != PETSC_TRUE)
@@ -650,6 +877,11 @@ PetscErrorCode getScalarParam(
 	{
 		ierr = FBGetScalarArray(fb, key, &nval, val, num, &found); CHKERRQ(ierr);
 	}
+	else if(fb)
+	{
+		// overridden in command line, input file parameter is still known
+		FBFindKeyLine(fb, key);
+	}
 
 	// check data item exists
 	if(found != PETSC_TRUE)
@@ -705,6 +937,11 @@ PetscErrorCode getStringParam(
 	{
 		ierr = FBGetString(fb, key, str, &found);  CHKERRQ(ierr);
 	}
+	else if(fb)
+	{
+		// overridden in command line, input file parameter is still known
+		FBFindKeyLine(fb, key);
+	}
 
 	// check data item exists
 	if(!strlen(str))
@@ -741,7 +978,7 @@ PetscErrorCode PetscOptionsReadFromFile(FB *fb, PetscBool DisplayOutput)
 
 	for(jj = 0; jj < fb->nblocks; jj++)
 	{
-		lines = FBGetLineRanges(fb, &lnbeg, &lnend);
+		lines = FBGetLineRanges(fb, &lnbeg, &lnend, PETSC_TRUE);
 
 		for(i = lnbeg; i < lnend; i++)
 		{
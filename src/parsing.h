@@ -15,6 +15,8 @@
 
 //-----------------------------------------------------------------------------
 
+struct FBIndex;
+
 enum ParamType
 {
 	_REQUIRED_,
@@ -41,6 +43,11 @@ struct FB
 	//
 	// All strings reserve two null characters in the end to detect overrun
 	//
+	// Buffer is cleaned on the first processor and broadcast, every processor
+	// indexes the lines by key once, so that lookups don't scan the buffer.
+	// Duplicate and unused (unknown) keys are reported, command line option
+	// -input_strict turns these warnings into errors.
+	//
 	//=====================================================================
 
 
@@ -61,6 +68,8 @@ struct FB
 	PetscInt  *blEnd;   // ending lines of blocks
 
     PetscInt   ID;      // ID of the current phase or softening law 
+
+	FBIndex   *index;   // key index (hash map from key to flat & block lines)
 };
 
 //-----------------------------------------------------------------------------
@@ -69,13 +78,31 @@ PetscErrorCode FBLoad(FB **pfb, PetscBool DisplayOutput, char *restartFileName =
 
 PetscErrorCode FBDestroy(FB **pfb);
 
+PetscErrorCode FBCleanBuffer(FB *fb);
+
 PetscErrorCode FBParseBuffer(FB *fb);
 
+// get first token of a line
+void FBGetLineKey(const char *line, std::string &key);
+
+// find key in current access range, mark line as used, return line index (-1 if not found)
+PetscInt FBFindKeyLine(FB *fb, const char *key);
+
+// find key in current access range, return first value token
+PetscErrorCode FBGetKeyValues(FB *fb, const char *key, char **values);
+
+// report duplicate keys (flat mode or within a block)
+PetscErrorCode FBCheckDuplicates(FB *fb);
+
+// report keys that were never retrieved
+PetscErrorCode FBCheckUnused(FB *fb);
+
 PetscErrorCode FBFindBlocks(FB *fb, ParamType ptype, const char *keybeg, const char *keyend);
 
 PetscErrorCode FBFreeBlocks(FB *fb);
 
-char ** FBGetLineRanges(FB *fb, PetscInt *lnbeg, PetscInt *lnend);
+// raw access marks lines as used (parsed by the caller)
+char ** FBGetLineRanges(FB *fb, PetscInt *lnbeg, PetscInt *lnend, PetscBool raw);
 
 PetscErrorCode FBGetIntArray(
 		FB         *fb,
@@ -33,13 +33,12 @@
 #include "tssolve.h"
 
 // allocate storage for the passive tracers
-// create initial distribution of markers (every processors knows everything)
+// create initial distribution of markers (every processor keeps the tracers of its subdomain)
 // Assign the initial phase, find the closest marker
 // Advection & interpolation
 // 1. Interpolate the data from the grid (vx,vy,vz)
 	// a. Advect them accordingly to the local velocity field
-	// b. Select the marker that are effectively within the processor and put to zero all the quantity for the others and interpolate them
-	// c. Sum all the quantity in all the processors
+	// b. Migrate the tracers that left the subdomain to the neighbor processors
 // 2. Communicate to the master processors all the data, and print the output
 
 //---------------------------------------------------------------------------
@@ -47,8 +46,7 @@
 PetscErrorCode ADVPtrPassive_Tracer_create(AdvCtx *actx, FB *fb)
 {
 /*
- *  This function creates all the vector required for tracing pressure, temperature, phase and x,y,z position.
- *  RecvBuf is a vector used only for the synching operation and it has any meaning.
+ *  This function reads the passive tracer parameters and creates the local tracer storage.
  */
 
 	P_Tr            *passive_tr;
@@ -99,10 +97,6 @@ PetscErrorCode ADVPtrPassive_Tracer_create(AdvCtx *actx, FB *fb)
 
 	nummark = passive_tr->passive_tracer_resolution[0]*passive_tr->passive_tracer_resolution[1]*passive_tr->passive_tracer_resolution[2];
 	passive_tr->nummark = nummark;
-	if (passive_tr->nummark>_max_passive_tracer)
-	{
-		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "The total number of passive tracers must be lower than %d",_max_passive_tracer);
-	}
 
 
      PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
@@ -129,57 +123,79 @@ PetscErrorCode ADVPtrPassive_Tracer_create(AdvCtx *actx, FB *fb)
 	 PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
 
 
-	 // Allocate memory
-	 ierr = ADVPtrReCreateStorage(actx); CHKERRQ(ierr);
-
 	 // Initialize the initial coordinate distribution and phase
 	 ierr =  ADVPassiveTracerInit(actx); CHKERRQ(ierr);
 
 	 PetscFunctionReturn(0);
 	}
 // ---------------------------------------------------------------------------------------------------------------------------//
-PetscErrorCode ADVPtrReCreateStorage(AdvCtx *actx)
+PetscErrorCode ADVPtrReAllocStorage(AdvCtx *actx, PetscInt numloc)
 {
+	// make sure local tracer storage can hold requested number of tracers
+	// storage only grows, current tracers are preserved
+
+	P_Tr     *ptr;
+	PtrMark  *tracers;
 
 	PetscErrorCode  ierr;
 	PetscFunctionBeginUser;
 
-		if(!actx->jr->ctrl.Passive_Tracer)	PetscFunctionReturn(0);
+	ptr = actx->Ptr;
+
 	// check whether current storage is insufficient
+	if(numloc <= ptr->markcap) PetscFunctionReturn(0);
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark  ,&actx->Ptr->ID);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->ID); CHKERRQ(ierr);
+	// update capacity
+	ptr->markcap = (PetscInt)(_cap_overhead_*(PetscScalar)numloc);
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark  ,&actx->Ptr->x);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->x); CHKERRQ(ierr);
+	if(ptr->markcap < _mark_buff_sz_) ptr->markcap = _mark_buff_sz_;
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark, &actx->Ptr->y);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->y); CHKERRQ(ierr);
+	// reallocate memory for tracers
+	ierr = PetscMalloc((size_t)ptr->markcap*sizeof(PtrMark), &tracers); CHKERRQ(ierr);
+	ierr = PetscMemzero(tracers, (size_t)ptr->markcap*sizeof(PtrMark)); CHKERRQ(ierr);
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark, &actx->Ptr->z);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->z); CHKERRQ(ierr);
+	// copy current data
+	if(ptr->numloc)
+	{
+		ierr = PetscMemcpy(tracers, ptr->tracers, (size_t)ptr->numloc*sizeof(PtrMark)); CHKERRQ(ierr);
+	}
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark  ,&actx->Ptr->T);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->T); CHKERRQ(ierr);
+	// update tracer storage
+	ierr = PetscFree(ptr->tracers); CHKERRQ(ierr);
+	ptr->tracers = tracers;
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark ,&actx->Ptr->p);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->p); CHKERRQ(ierr);
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVPtrGetMPIBuff(AdvCtx *actx, PetscInt nsend, PetscInt nrecv)
+{
+	// make sure exchange buffers can hold requested number of tracers
+	// buffers only grow, contents are NOT preserved
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark ,&actx->Ptr->phase);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->phase); CHKERRQ(ierr);
+	P_Tr *ptr;
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark ,&actx->Ptr->Melt_fr);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->Melt_fr); CHKERRQ(ierr);
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark ,&actx->Ptr->C_advection);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->C_advection); CHKERRQ(ierr);
+	ptr = actx->Ptr;
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark ,&actx->Ptr->Recv);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->Recv); CHKERRQ(ierr);
+	if(nsend > ptr->sendcap)
+	{
+		ierr = PetscFree(ptr->sendbuf); CHKERRQ(ierr);
 
-		ierr = VecCreateSeq(PETSC_COMM_SELF,actx->Ptr->nummark ,&actx->Ptr->Melt_Grid);      CHKERRQ(ierr);
-		ierr = VecZeroEntries(actx->Ptr->Melt_Grid); CHKERRQ(ierr);
+		ptr->sendcap = (PetscInt)(_cap_overhead_*(PetscScalar)nsend);
 
+		ierr = PetscMalloc((size_t)ptr->sendcap*sizeof(PtrMark), &ptr->sendbuf); CHKERRQ(ierr);
+	}
+
+	if(nrecv > ptr->recvcap)
+	{
+		ierr = PetscFree(ptr->recvbuf); CHKERRQ(ierr);
+
+		ptr->recvcap = (PetscInt)(_cap_overhead_*(PetscScalar)nrecv);
+
+		ierr = PetscMalloc((size_t)ptr->recvcap*sizeof(PtrMark), &ptr->recvbuf); CHKERRQ(ierr);
+	}
 
 	PetscFunctionReturn(0);
 }
@@ -207,101 +223,101 @@ PetscErrorCode ADVPtrInitCoord(AdvCtx *actx)
 	//Initialize the passive tracer lagrangian grid. The initial passive tracer distribution is a rectangular grid, with a
 	// a variable resolution. After initializing the coordinates, phase, temperature and pressure are interpolated from
 	// the nearest marker (s.s.)
+	// Every processor only keeps the tracers located in its own subdomain.
 
 	PetscScalar  x, y, z, dx, dy, dz,nx,ny,nz;
+	PetscScalar  bx, by, bz, ex, ey, ez;
 	PetscInt     i, j, k;
 	PetscInt     imark;
-	PetscScalar  *Xp,*Yp,*Zp,*ID,*active;
+	P_Tr        *ptr;
+	PtrMark     *P;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	nx = (PetscScalar) actx->Ptr->passive_tracer_resolution[0];
-	ny = (PetscScalar) actx->Ptr->passive_tracer_resolution[1];
-	nz = (PetscScalar) actx->Ptr->passive_tracer_resolution[2];
-	dx = (actx->Ptr->box_passive_tracer[1]/(actx->dbm->scal->length)-actx->Ptr->box_passive_tracer[0]/(actx->dbm->scal->length))/nx;
-	dy = (actx->Ptr->box_passive_tracer[3]/(actx->dbm->scal->length)-actx->Ptr->box_passive_tracer[2]/(actx->dbm->scal->length))/ny;
-	dz = (actx->Ptr->box_passive_tracer[5]/(actx->dbm->scal->length)-actx->Ptr->box_passive_tracer[4]/(actx->dbm->scal->length))/nz;
-
+	ptr = actx->Ptr;
 
-	// marker counter
-	imark = 0;
-	ierr = VecGetArray(actx->Ptr->x, &Xp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->y, &Yp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->z, &Zp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->ID, &ID)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->C_advection, &active)           ; CHKERRQ(ierr);
+	nx = (PetscScalar) ptr->passive_tracer_resolution[0];
+	ny = (PetscScalar) ptr->passive_tracer_resolution[1];
+	nz = (PetscScalar) ptr->passive_tracer_resolution[2];
+	dx = (ptr->box_passive_tracer[1]/(actx->dbm->scal->length)-ptr->box_passive_tracer[0]/(actx->dbm->scal->length))/nx;
+	dy = (ptr->box_passive_tracer[3]/(actx->dbm->scal->length)-ptr->box_passive_tracer[2]/(actx->dbm->scal->length))/ny;
+	dz = (ptr->box_passive_tracer[5]/(actx->dbm->scal->length)-ptr->box_passive_tracer[4]/(actx->dbm->scal->length))/nz;
 
+	ierr = FDSTAGGetLocalBox(actx->fs, &bx, &by, &bz, &ex, &ey, &ez); CHKERRQ(ierr);
 
+	// marker counter
+	imark       = 0;
+	ptr->numloc = 0;
 
 	// create uniform distribution of markers/cell for variable grid
-	for(k = 0; k < actx->Ptr->passive_tracer_resolution[2]; k++)
+	for(k = 0; k < ptr->passive_tracer_resolution[2]; k++)
 	{
 		// spacing of particles
-		for(j = 0; j < actx->Ptr->passive_tracer_resolution[1]; j++)
+		for(j = 0; j < ptr->passive_tracer_resolution[1]; j++)
 		{
-			for(i = 0; i < actx->Ptr->passive_tracer_resolution[0]; i++)
+			for(i = 0; i < ptr->passive_tracer_resolution[0]; i++)
 			{
 				// spacing of particles
 				// loop over markers in cells
 				if(k==0)
 				{
-					z = actx->Ptr->box_passive_tracer[4]/(actx->dbm->scal->length) + dz/2;
+					z = ptr->box_passive_tracer[4]/(actx->dbm->scal->length) + dz/2;
 				}
 				else
 				{
-					z = actx->Ptr->box_passive_tracer[4]/(actx->dbm->scal->length) + dz/2 + ((PetscScalar) k)*dz;
+					z = ptr->box_passive_tracer[4]/(actx->dbm->scal->length) + dz/2 + ((PetscScalar) k)*dz;
 				}
 				if(j==0)
 				{
-					y = actx->Ptr->box_passive_tracer[2]/(actx->dbm->scal->length) + dy/2;
+					y = ptr->box_passive_tracer[2]/(actx->dbm->scal->length) + dy/2;
 				}
 				else
 				{
-					y = actx->Ptr->box_passive_tracer[2]/(actx->dbm->scal->length) + dy/2 + ((PetscScalar) j)*dy;
+					y = ptr->box_passive_tracer[2]/(actx->dbm->scal->length) + dy/2 + ((PetscScalar) j)*dy;
 				}
 				if(i==0)
 				{
-					x = actx->Ptr->box_passive_tracer[0]/(actx->dbm->scal->length) + dx/2;
+					x = ptr->box_passive_tracer[0]/(actx->dbm->scal->length) + dx/2;
 				}
 				else
 				{
-					x = actx->Ptr->box_passive_tracer[0]/(actx->dbm->scal->length) + dx/2+ ((PetscScalar) i)*dx;
+					x = ptr->box_passive_tracer[0]/(actx->dbm->scal->length) + dx/2+ ((PetscScalar) i)*dx;
 				}
 
+				// keep only tracers of the local subdomain
+				if(x >= bx && x < ex && y >= by && y < ey && z >= bz && z < ez)
+				{
+					// make sure space is enough
+					ierr = ADVPtrReAllocStorage(actx, ptr->numloc + 1); CHKERRQ(ierr);
 
-				// set marker coordinates
-				Xp[imark] = x;
-				Yp[imark] = y;
-				Zp[imark] = z;
-				ID[imark] = ((PetscScalar) i) + ny*((PetscScalar) j) +ny*nx*((PetscScalar) k);
+					P = &ptr->tracers[ptr->numloc++];
 
-				if(actx->Ptr->Condition_pr == _Always_)
-				{
-					active[imark] = 1.0;
-				}
-				else
-				{
-					active[imark] = 0.0;
-				}
+					// set marker coordinates
+					P->X[0]  = x;
+					P->X[1]  = y;
+					P->X[2]  = z;
+					P->ID    = ((PetscScalar) i) + nx*((PetscScalar) j) + nx*ny*((PetscScalar) k);
+					P->ind   = imark;
+					P->phase = 0.0;
 
+					if(ptr->Condition_pr == _Always_)
+					{
+						P->active = 1.0;
+					}
+					else
+					{
+						P->active = 0.0;
+					}
+				}
 
-				// increment local counter
+				// increment global counter
 				imark++;
 			}
 		}
 
 	}
 
-
-	ierr = VecRestoreArray(actx->Ptr->x, &Xp)                  ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->y, &Yp)                  ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->z, &Zp)                  ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->ID, &ID)                 ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->C_advection, &active)    ; CHKERRQ(ierr);
-
-
-
 	PetscFunctionReturn(0);
 }
 
@@ -315,19 +331,14 @@ PetscErrorCode ADV_Assign_Phase(AdvCtx *actx)
 	vector <spair>    dist;
 	spair d;
 	Marker   *IP;
-	PetscScalar  X[3],Xm[3],*Xp,*Yp,*Zp,*Pr,*T,*phase;
-	PetscInt     I, J, K,ii,numpassive,imark,ID,nx,ny,n,*markind,id_m;
-	PetscScalar ex,bx,ey,by,ez,bz;
+	PtrMark  *P;
+	PetscScalar  Xm[3];
+	PetscInt     I, J, K,ii,imark,ID,nx,ny,n,*markind,id_m;
 
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-
-	fs = actx->fs;
-
-	numpassive = actx->Ptr->nummark;
-
 	ierr = ADVMapMarkToCells(actx); CHKERRQ(ierr);
 
 	// get context
@@ -337,99 +348,52 @@ PetscErrorCode ADV_Assign_Phase(AdvCtx *actx)
 	nx = fs->dsx.ncels;
 	ny = fs->dsy.ncels;
 
-	ierr = FDSTAGGetLocalBox(fs, &bx, &by, &bz, &ex, &ey, &ez); CHKERRQ(ierr);
-
-
 	dist.reserve(_mark_buff_sz_);
-	ierr = VecGetArray(actx->Ptr->x, &Xp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->y, &Yp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->z, &Zp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->p, &Pr)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->T, &T)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->phase, &phase)           ; CHKERRQ(ierr);
-
-	for(imark=0;imark<numpassive;imark++)
-	{
-		// get marker coordinates
-			X[0] = Xp[imark];
-			X[1] = Yp[imark];
-			X[2] = Zp[imark];
 
+	// all local tracers are located in the local subdomain
+	for(imark=0;imark<actx->Ptr->numloc;imark++)
+	{
+		P = &actx->Ptr->tracers[imark];
 
+		// get host cell IDs in all directions
+		ierr = Discret1DFindPoint(&fs->dsx, P->X[0], I); CHKERRQ(ierr);
+		ierr = Discret1DFindPoint(&fs->dsy, P->X[1], J); CHKERRQ(ierr);
+		ierr = Discret1DFindPoint(&fs->dsz, P->X[2], K); CHKERRQ(ierr);
 
-			if(X[0] >= bx && X[0]< ex && X[1] >= by && X[1]< ey && X[2] >= bz && X[2]< ez)
-			{
-			// get host cell IDs in all directions
-			ierr = Discret1DFindPoint(&fs->dsx, X[0], I); CHKERRQ(ierr);
-			ierr = Discret1DFindPoint(&fs->dsy, X[1], J); CHKERRQ(ierr);
-			ierr = Discret1DFindPoint(&fs->dsz, X[2], K); CHKERRQ(ierr);
-
-			// compute and store consecutive index
-			GET_CELL_ID(ID, I, J, K, nx, ny);
-
-			dist.clear();
-
-
-			n = actx->markstart[ID+1] - actx->markstart[ID];
-			markind = actx->markind + actx->markstart[ID];
-
-			for (ii = 0; ii < n; ii++)
-			{
-				id_m=markind[ii];
-				Xm[0] = actx->markers[id_m].X[0];
-				Xm[1] = actx->markers[id_m].X[1];
-				Xm[2] = actx->markers[id_m].X[2];
-
-
-				d.first  = EDIST(X, Xm);
-				d.second = id_m;
-				dist.push_back(d);
-			}
-
-			// sort markers by distance
-			sort(dist.begin(), dist.end());
-			IP = &actx->markers[dist.begin()->second];
-
-			// clone closest marker
-			phase[imark]= ((PetscScalar) IP->phase);
-			T[imark]= IP->T;
-			Pr[imark]= IP->p;
-			}
-			else
-			{
-
-				phase[imark]= -DBL_MAX;
-				T[imark]= -DBL_MAX;
-				Pr[imark]= -DBL_MAX;
-			}
-
-	}
+		// compute and store consecutive index
+		GET_CELL_ID(ID, I, J, K, nx, ny);
 
-	ierr = VecRestoreArray(actx->Ptr->x, &Xp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->y, &Yp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->z, &Zp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->p, &Pr)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->T, &T)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->phase, &phase)           ; CHKERRQ(ierr);
+		dist.clear();
 
-	if(ISParallel(PETSC_COMM_WORLD))
-	{
-		ierr = Sync_Vector(actx->Ptr->p,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+		n = actx->markstart[ID+1] - actx->markstart[ID];
+		markind = actx->markind + actx->markstart[ID];
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->p); CHKERRQ(ierr);
+		for (ii = 0; ii < n; ii++)
+		{
+			id_m=markind[ii];
+			Xm[0] = actx->markers[id_m].X[0];
+			Xm[1] = actx->markers[id_m].X[1];
+			Xm[2] = actx->markers[id_m].X[2];
 
-		ierr = Sync_Vector(actx->Ptr->T,actx,actx->Ptr->nummark); CHKERRQ(ierr);
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->T); CHKERRQ(ierr);
+			d.first  = EDIST(P->X, Xm);
+			d.second = id_m;
+			dist.push_back(d);
+		}
 
-		ierr = Sync_Vector(actx->Ptr->phase,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+		// sort markers by distance
+		sort(dist.begin(), dist.end());
+		IP = &actx->markers[dist.begin()->second];
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->phase); CHKERRQ(ierr);
+		// clone closest marker
+		P->phase = ((PetscScalar) IP->phase);
+		P->T     = IP->T;
+		P->p     = IP->p;
 	}
 
-
 	PetscFunctionReturn(0);
 }
+
 //------------------------------------------------------------------------------
 PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
 {
@@ -439,10 +403,8 @@ PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
  * in this routine (this may cause the failing of t19_passive tracers)
  * 2nd : In order to mantain a certain degree of consistency between the routine it is necessary
  * to create a general function for the advection. On the other hand, a potential solution
- * Function: 1st part: Each timestep the function advect the passive tracers whose coordinate are
- * belonging to the current processor. The passive tracers that does not belong to the processor
- * are set to be equal to -DBL_MAX. After that, the x,y,z, Temperature, Pressure are syncronized in
- * all processor with an All_reduce operation.
+ * Function: 1st part: Each timestep the function advect the passive tracers owned by the
+ * current processor. Tracers that leave the subdomain are migrated to the neighbor processors.
  * 2nd part: The routine check if the passive tracer is below the free surface, changing eventually its phase
  * and following the same approach for the coordinate and P,T.
  */
@@ -452,18 +414,16 @@ PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
 	SolVarCell      *svCell;
 	Material_t      *mat;
 	PData           *Pd;
-	PetscInt        sx, sy, sz, nx, ny,nz;
-	PetscInt        jj, I, J, K, II, JJ, KK, AirPhase, num_part,ID, n, ii, numActTracers,*markind,id_m ;
-	PetscScalar     ex,bx,ey,by,ez,bz;
+	PtrMark         *P;
+	PetscInt        sx, sy, sz, nx, ny;
+	PetscInt        jj, I, J, K, II, JJ, KK, AirPhase, ID, n, ii, numActTracers,*markind,id_m ;
 	PetscScalar     *ncx, *ncy, *ncz;
 	PetscScalar     *ccx, *ccy, *ccz;
 	PetscScalar     ***lvx, ***lvy, ***lvz, ***lp, ***lT;
 	PetscScalar     vx, vy, vz, xc, yc, zc, xp, yp, zp, dt, Ttop, endx,endy,endz,begx,begy,begz,npx,npy,npz;
-	PetscScalar     *Xp, *Yp,*Zp,*T,*Pr,*phase,*mf_ptr,*Active,*melt_grid;
 	PetscScalar     pShift;
 	PetscScalar     Xm[3],X[3];
 	PetscLogDouble t;
-	PetscMPIInt 	rank;
 	vector <spair>    dist;
 	spair d;
 	PetscErrorCode ierr;
@@ -472,9 +432,6 @@ PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
 	AirPhase = -1;
 	Ttop     =  0.0;
 
-
-	MPI_Comm_rank( MPI_COMM_WORLD, &rank );
-
 	// access context
 	fs = actx->fs;
 	jr = actx->jr;
@@ -526,210 +483,168 @@ PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
 	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lp,  &lp) ; CHKERRQ(ierr);
 	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lT,  &lT) ; CHKERRQ(ierr);
 
-	ierr = FDSTAGGetLocalBox(fs, &bx, &by, &bz, &ex, &ey, &ez); CHKERRQ(ierr);
-
-
-	ierr = VecGetArray(actx->Ptr->x, &Xp)              ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->y, &Yp)              ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->z, &Zp)              ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->p, &Pr)              ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->T, &T)               ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->phase, &phase)       ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->Melt_fr, &mf_ptr)    ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->Melt_Grid, &melt_grid); CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->C_advection, &Active); CHKERRQ(ierr);
-
-	// scan all markers
+	// scan all local markers
     numActTracers   = 0;
-	num_part        = actx->Ptr->nummark;
 
-	for(jj = 0; jj < num_part; jj++)
+	for(jj = 0; jj < actx->Ptr->numloc; jj++)
 	{
-
-		// get consecutive index of the host cell
-		xp = Xp[jj];
-		yp = Yp[jj];
-		zp = Zp[jj];
+		P = &actx->Ptr->tracers[jj];
 
 		// get marker coordinates
-		if(xp >= bx && xp< ex && yp >= by && yp< ey && zp >= bz && zp< ez)
-		{
-			ierr = Discret1DFindPoint(&fs->dsx, xp, I); CHKERRQ(ierr);
-			ierr = Discret1DFindPoint(&fs->dsy, yp, J); CHKERRQ(ierr);
-			ierr = Discret1DFindPoint(&fs->dsz, zp, K); CHKERRQ(ierr);
+		xp = P->X[0];
+		yp = P->X[1];
+		zp = P->X[2];
 
-			// get coordinates of cell center
-			xc = ccx[I];
-			yc = ccy[J];
-			zc = ccz[K];
+		// get consecutive index of the host cell
+		ierr = Discret1DFindPoint(&fs->dsx, xp, I); CHKERRQ(ierr);
+		ierr = Discret1DFindPoint(&fs->dsy, yp, J); CHKERRQ(ierr);
+		ierr = Discret1DFindPoint(&fs->dsz, zp, K); CHKERRQ(ierr);
 
-			// map marker on the cells of X, Y, Z & center grids
-			if(xp > xc) { II = I; } else { II = I-1; }
-			if(yp > yc) { JJ = J; } else { JJ = J-1; }
-			if(zp > zc) { KK = K; } else { KK = K-1; }
+		// get coordinates of cell center
+		xc = ccx[I];
+		yc = ccy[J];
+		zc = ccz[K];
 
-			// interpolate velocity, pressure & temperature
-			vx = InterpLin3D(lvx, I,  JJ, KK, sx, sy, sz, xp, yp, zp, ncx, ccy, ccz);
-			vy = InterpLin3D(lvy, II, J,  KK, sx, sy, sz, xp, yp, zp, ccx, ncy, ccz);
-			vz = InterpLin3D(lvz, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz);
+		// map marker on the cells of X, Y, Z & center grids
+		if(xp > xc) { II = I; } else { II = I-1; }
+		if(yp > yc) { JJ = J; } else { JJ = J-1; }
+		if(zp > zc) { KK = K; } else { KK = K-1; }
 
-			// update pressure & temperature variables
-			Pr[jj] = InterpLin3D(lp, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz) + pShift;
-			T[jj]  = InterpLin3D(lT, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz);
+		// interpolate velocity, pressure & temperature
+		vx = InterpLin3D(lvx, I,  JJ, KK, sx, sy, sz, xp, yp, zp, ncx, ccy, ccz);
+		vy = InterpLin3D(lvy, II, J,  KK, sx, sy, sz, xp, yp, zp, ccx, ncy, ccz);
+		vz = InterpLin3D(lvz, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz);
 
-			GET_CELL_ID(ID, I, J, K, nx, ny)
+		// update pressure & temperature variables
+		P->p = InterpLin3D(lp, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz) + pShift;
+		P->T = InterpLin3D(lT, II, JJ, K,  sx, sy, sz, xp, yp, zp, ccx, ccy, ncz);
 
-			svCell = &jr->svCell[ID];
+		GET_CELL_ID(ID, I, J, K, nx, ny)
 
+		svCell = &jr->svCell[ID];
 
-			melt_grid[jj] = svCell->svBulk.mf;
 
-			if(svCell->svBulk.mf>0.0)
-			{
-			  //check if the original phase saved is one that has a phase/melt law associated
+		P->mfgrid = svCell->svBulk.mf;
 
+		if(svCell->svBulk.mf>0.0)
+		{
+		  //check if the original phase saved is one that has a phase/melt law associated
 
-				if(mat[PetscInt(phase[jj])].pdn)
-				{
-					ierr = setDataPhaseDiagram(Pd, Pr[jj], T[jj], mat[PetscInt(phase[jj])].pdn); CHKERRQ(ierr);
-					mf_ptr[jj]= Pd->mf;
-				}
-				else
-				{
-					// Passive tracers are initialize during the initial stage of the simulation.
-					// They can have a different phase as soon as the melting start.
 
-					// sort markers by distance
-					dist.clear();
-					n = actx->markstart[ID+1] - actx->markstart[ID];
-					markind = actx->markind + actx->markstart[ID];
+			if(mat[PetscInt(P->phase)].pdn)
+			{
+				ierr = setDataPhaseDiagram(Pd, P->p, P->T, mat[PetscInt(P->phase)].pdn); CHKERRQ(ierr);
+				P->mf = Pd->mf;
+			}
+			else
+			{
+				// Passive tracers are initialize during the initial stage of the simulation.
+				// They can have a different phase as soon as the melting start.
 
+				// sort markers by distance
+				dist.clear();
+				n = actx->markstart[ID+1] - actx->markstart[ID];
+				markind = actx->markind + actx->markstart[ID];
 
-					for (ii = 0; ii < n; ii++)
+
+				for (ii = 0; ii < n; ii++)
+				{
+					id_m=markind[ii];
+					Xm[0] = actx->markers[id_m].X[0];
+					Xm[1] = actx->markers[id_m].X[1];
+					Xm[2] = actx->markers[id_m].X[2];
+					X[0]  = xp;
+					X[1]  = yp;
+					X[2]  = zp;
+
+					if (mat[actx->markers[ii].phase].pdn)
 					{
-						id_m=markind[ii];
-						Xm[0] = actx->markers[id_m].X[0];
-						Xm[1] = actx->markers[id_m].X[1];
-						Xm[2] = actx->markers[id_m].X[2];
-						X[0]  = xp;
-						X[1]  = yp;
-						X[2]  = zp;
-
-						if (mat[actx->markers[ii].phase].pdn)
-						{
-							d.first  = EDIST(Xm, X);
-							d.second = id_m;
-							dist.push_back(d);
-						}
+						d.first  = EDIST(Xm, X);
+						d.second = id_m;
+						dist.push_back(d);
 					}
-					sort(dist.begin(), dist.end());
-					phase[jj] = (PetscScalar) actx->markers[dist.begin()->second].phase;
+				}
+				sort(dist.begin(), dist.end());
+				P->phase = (PetscScalar) actx->markers[dist.begin()->second].phase;
 
-					ierr = setDataPhaseDiagram(Pd, Pr[jj], T[jj], mat[PetscInt(phase[jj])].pdn); CHKERRQ(ierr);
+				ierr = setDataPhaseDiagram(Pd, P->p, P->T, mat[PetscInt(P->phase)].pdn); CHKERRQ(ierr);
 
-					mf_ptr[jj]=Pd->mf;
+				P->mf = Pd->mf;
 
-				}
-			}
-			else
-			{
-				mf_ptr[jj]=0.0;
 			}
+		}
+		else
+		{
+			P->mf = 0.0;
+		}
 
 
-			if((Active[jj] == 0.0) && actx->Ptr->Condition_pr != _Always_)
-			{
-				ierr = Check_advection_condition(actx, jj, ID,xp,yp,zp,Pr[jj],T[jj],melt_grid[jj]); CHKERRQ(ierr);
-			}
+		if((P->active == 0.0) && actx->Ptr->Condition_pr != _Always_)
+		{
+			ierr = Check_advection_condition(actx, P, ID, P->mfgrid); CHKERRQ(ierr);
+		}
+
+		// override temperature of air phase
+		if(AirPhase != -1 && P->phase == ((PetscScalar) AirPhase)) P->T = Ttop;
 
-			// override temperature of air phase
-			if(AirPhase != -1 && phase[jj] == ((PetscScalar) AirPhase)) T[jj] = Ttop;
+		// advect marker
 
-			// advect marker
+		if(P->active == 1.0)
+		{
+            numActTracers += 1; // keep track of the # of active tracers on this processor
+			npx = xp + vx*dt;
+			npy = yp + vy*dt;
+			npz = zp + vz*dt;
+		}
+		else
+		{
+			npx = xp;
+			npy = yp;
+			npz = zp;
+		}
 
-			if( Active[jj]==1.0)
+		if(npz > endz)
 			{
-                numActTracers += 1; // keep track of the # of active tracers on this processor
-				npx = xp + vx*dt;
-				npy = yp + vy*dt;
-				npz = zp + vz*dt;
+				npz = zp;
+				P->active = 0.0;
 			}
-			else
+		else if(npz < begz)
 			{
-				npx = xp;
-				npy = yp;
 				npz = zp;
+				P->active = 0.0;
 			}
 
-			if(npz > endz)
-				{
-					npz = zp;
-					Active[jj]=0.0;
-				}
-			else if(npz < begz)
-				{
-					npz = zp;
-					Active[jj]=0.0;
-				}
-
-			if(npy > endy)
-				{
-					npy = yp;
-					Active[jj]=0.0;
-				}
-			else if(npy < begy)
-				{
-				  	npy = yp;
-					Active[jj]=0.0;
-				}
-
-
-			if(npx > endx)
-				{
-					npx = xp;
-					Active[jj]=0.0;
+		if(npy > endy)
+			{
+				npy = yp;
+				P->active = 0.0;
+			}
+		else if(npy < begy)
+			{
+			  	npy = yp;
+				P->active = 0.0;
+			}
 
-				}
-			else if(npx < begx)
-				{
-					npx = xp;
-					Active[jj]=0.0;
-				}
 
+		if(npx > endx)
+			{
+				npx = xp;
+				P->active = 0.0;
 
+			}
+		else if(npx < begx)
+			{
+				npx = xp;
+				P->active = 0.0;
+			}
 
-			Xp[jj]=npx;
-			Yp[jj]=npy;
-			Zp[jj]=npz;
-		}
-		else
-		{
-			Xp[jj]      =   -DBL_MAX;
-			Yp[jj]      =   -DBL_MAX;
-			Zp[jj]      =   -DBL_MAX;
-			Pr[jj]      =   -DBL_MAX;
-			T[jj]       =   -DBL_MAX;
-			phase[jj]   =   -DBL_MAX;
-			mf_ptr[jj]  =   -DBL_MAX;
-			Active[jj]  =   -DBL_MAX;
-			melt_grid[jj] = -DBL_MAX;
 
-		}
 
+		P->X[0] = npx;
+		P->X[1] = npy;
+		P->X[2] = npz;
 	}
 
-
-	ierr = VecRestoreArray(actx->Ptr->x, &Xp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->y, &Yp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->z, &Zp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->p, &Pr)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->T, &T)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->phase, &phase)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->Melt_fr, &mf_ptr)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->Melt_Grid, &melt_grid)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->C_advection, &Active)           ; CHKERRQ(ierr);
-
-
 	// restore access
 	ierr = DMDAVecRestoreArray(fs->DA_X,   jr->lvx, &lvx); CHKERRQ(ierr);
 	ierr = DMDAVecRestoreArray(fs->DA_Y,   jr->lvy, &lvy); CHKERRQ(ierr);
@@ -737,90 +652,149 @@ PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
 	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lp,  &lp);  CHKERRQ(ierr);
 	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lT,  &lT);  CHKERRQ(ierr);
 
-	// get local grid sizes
-	ierr = DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
-
-
 	if(ISParallel(PETSC_COMM_WORLD))
 	{
+		// migrate tracers to the processors that own them
+		ierr = ADVPtrExchange(actx); CHKERRQ(ierr);
 
-		// sync pressure
-		ierr = Sync_Vector(actx->Ptr->p,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+		// number of active tracer in the whole domain
+        PetscInt numActTracers_0;
+        ierr = MPI_Reduce(&numActTracers, &numActTracers_0, 1, MPIU_INT, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+        numActTracers   = numActTracers_0;       // sum of # of active tracers on root
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->p); CHKERRQ(ierr);
+	}
 
-		// sync temperature
-		ierr = Sync_Vector(actx->Ptr->T,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+    // print output
+    PetscPrintf(PETSC_COMM_WORLD,"\n Currently active tracers    :  %lld \n", (LLD) numActTracers);
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->T); CHKERRQ(ierr);
 
-		// sync coordinate
-		//x
-		ierr = Sync_Vector(actx->Ptr->x,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+	// Check whatever the marker are belonging to rocks phase or not
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->x); CHKERRQ(ierr);
+	ierr = ADVMarkCrossFreeSurfPassive_Tracers(actx); CHKERRQ(ierr);
 
-		//y
-		ierr = Sync_Vector(actx->Ptr->y,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+	PrintDone(t);
+	
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->y); CHKERRQ(ierr);
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVPtrExchange(AdvCtx *actx)
+{
+	// migrate passive tracers to the neighbor processes that own them
+	// (same communication pattern as for the markers, see ADVExchange)
 
-		//z
-		ierr = Sync_Vector(actx->Ptr->z,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+	FDSTAG      *fs;
+	P_Tr        *ptr;
+	PtrMark     *P;
+	PetscInt     i, k, lrank, cnt, nsend, nrecv;
+	PetscInt     nsendm[_num_neighb_], nrecvm[_num_neighb_];
+	PetscInt     ptsend[_num_neighb_], ptrecv[_num_neighb_];
+	PetscMPIInt  grank, scnt, rcnt;
+	MPI_Datatype ptype;
+	MPI_Request  srequest[_num_neighb_];
+	MPI_Request  rrequest[_num_neighb_];
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->z); CHKERRQ(ierr);
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
-		// sync melt fraction
-		// melt fraction of the particle
-		ierr = Sync_Vector(actx->Ptr->Melt_fr,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+	fs  = actx->fs;
+	ptr = actx->Ptr;
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->Melt_fr); CHKERRQ(ierr);
+	// count number of tracers to be sent to each neighbor domain
+	ierr = PetscMemzero(nsendm, _num_neighb_*sizeof(PetscInt)); CHKERRQ(ierr);
+	ierr = PetscMemzero(nrecvm, _num_neighb_*sizeof(PetscInt)); CHKERRQ(ierr);
 
-		// melt fraction of the grid
-		ierr = Sync_Vector(actx->Ptr->Melt_Grid,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+	for(i = 0; i < ptr->numloc; i++)
+	{
+		ierr = FDSTAGGetPointRanks(fs, ptr->tracers[i].X, &lrank, &grank); CHKERRQ(ierr);
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->Melt_Grid); CHKERRQ(ierr);
+		if(grank != actx->iproc && grank != -1) nsendm[lrank]++;
+	}
 
-		//sync advection condition
-		ierr = Sync_Vector(actx->Ptr->C_advection,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+	// communicate number of tracers with neighbor processes
+	scnt = 0;
+	rcnt = 0;
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->C_advection); CHKERRQ(ierr);
+	for(k = 0; k < _num_neighb_; k++)
+	{
+		if(fs->neighb[k] != actx->iproc && fs->neighb[k] != -1)
+		{
+			ierr = MPI_Isend(&nsendm[k], 1, MPIU_INT, fs->neighb[k], 300, actx->icomm, &srequest[scnt++]); CHKERRQ(ierr);
+			ierr = MPI_Irecv(&nrecvm[k], 1, MPIU_INT, fs->neighb[k], 300, actx->icomm, &rrequest[rcnt++]); CHKERRQ(ierr);
+		}
+	}
 
-		//sync phase
-		ierr = Sync_Vector(actx->Ptr->phase,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+	// pack departing tracers into send buffer, compact local storage
+	nsend = getPtrCnt(_num_neighb_, nsendm, ptsend);
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->phase); CHKERRQ(ierr);
+	ierr = ADVPtrGetMPIBuff(actx, nsend, 0); CHKERRQ(ierr);
 
-		// number of active tracer in the whole domain
-        PetscInt numActTracers_0;
-        ierr = MPI_Reduce(&numActTracers, &numActTracers_0, 1, MPIU_INT, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
-        numActTracers   = numActTracers_0;       // sum of # of active tracers on root
+	for(i = 0, cnt = 0; i < ptr->numloc; i++)
+	{
+		P = &ptr->tracers[i];
 
+		ierr = FDSTAGGetPointRanks(fs, P->X, &lrank, &grank); CHKERRQ(ierr);
+
+		if(grank == actx->iproc)
+		{
+			ptr->tracers[cnt++] = *P;
+		}
+		else if(grank != -1)
+		{
+			ptr->sendbuf[ptsend[lrank]++] = *P;
+		}
 	}
 
-    // print output
-    PetscPrintf(PETSC_COMM_WORLD,"\n Currently active tracers    :  %lld \n", (LLD) numActTracers);
+	ptr->numloc = cnt;
 
+	rewindPtr(_num_neighb_, ptsend);
 
-	// Check whatever the marker are belonging to rocks phase or not
+	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+	if(rcnt) { ierr = MPI_Waitall(rcnt, rrequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
 
-	ierr = ADVMarkCrossFreeSurfPassive_Tracers(actx); CHKERRQ(ierr);
+	// make sure space is enough
+	nrecv = getPtrCnt(_num_neighb_, nrecvm, ptrecv);
 
+	ierr = ADVPtrGetMPIBuff(actx, 0, nrecv); CHKERRQ(ierr);
 
+	// communicate tracers with neighbor processes (counts in tracers, not bytes)
+	ierr = MPI_Type_contiguous((PetscMPIInt)sizeof(PtrMark), MPI_BYTE, &ptype); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&ptype);                                            CHKERRQ(ierr);
 
-	if(ISParallel(PETSC_COMM_WORLD))
+	scnt = 0;
+	rcnt = 0;
+
+	for(k = 0; k < _num_neighb_; k++)
 	{
-		ierr = Sync_Vector(actx->Ptr->phase,actx,actx->Ptr->nummark); CHKERRQ(ierr);
+		if(nsendm[k])
+		{
+			ierr = MPI_Isend(&ptr->sendbuf[ptsend[k]], (PetscMPIInt)nsendm[k], ptype,
+				fs->neighb[k], 301, actx->icomm, &srequest[scnt++]); CHKERRQ(ierr);
+		}
+		if(nrecvm[k])
+		{
+			ierr = MPI_Irecv(&ptr->recvbuf[ptrecv[k]], (PetscMPIInt)nrecvm[k], ptype,
+				fs->neighb[k], 301, actx->icomm, &rrequest[rcnt++]); CHKERRQ(ierr);
+		}
+	}
 
-		ierr = VecCopy(actx->Ptr->Recv,actx->Ptr->phase); CHKERRQ(ierr);
+	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+	if(rcnt) { ierr = MPI_Waitall(rcnt, rrequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+
+	ierr = MPI_Type_free(&ptype); CHKERRQ(ierr);
+
+	// store received tracers
+	ierr = ADVPtrReAllocStorage(actx, ptr->numloc + nrecv); CHKERRQ(ierr);
+
+	if(nrecv)
+	{
+		ierr = PetscMemcpy(ptr->tracers + ptr->numloc, ptr->recvbuf, (size_t)nrecv*sizeof(PtrMark)); CHKERRQ(ierr);
 	}
 
-	PrintDone(t);
-	
+	ptr->numloc += nrecv;
 
 	PetscFunctionReturn(0);
 }
-
 //----------------------------------------------------------------------------//
 
 PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx)
@@ -833,8 +807,8 @@ PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx)
 	Vec             vphase;
 	PetscInt        sx, sy, sz;
 	PetscInt        ii, jj, ID, I, J, K, L, AirPhase, phaseID, nmark, *markind, markid;
-	PetscScalar     ***ltopo, ***phase, *ncx, *ncy, topo, xp, yp, zp, *IX,bz,ez,by,ey,bx,ex,Xm[3];
-	PetscScalar *Xp, *Yp,*Zp,*phaseptr;
+	PetscScalar     ***ltopo, ***phase, *ncx, *ncy, topo, xp, yp, zp, *IX,Xm[3];
+	PtrMark         *P;
 	spair           d;
 	vector <spair>  dist;
 
@@ -860,9 +834,6 @@ PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx)
 	ncx = fs->dsx.ncoor;
 	ncy = fs->dsy.ncoor;
 
-	ierr = FDSTAGGetLocalBox(fs, &bx, &by, &bz, &ex, &ey, &ez); CHKERRQ(ierr);
-
-
 	// reserve marker distance buffer
 	dist.reserve(_mark_buff_sz_);
 
@@ -876,122 +847,104 @@ PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx)
 	ierr = DMDAVecGetArray(surf->DA_SURF, surf->ltopo, &ltopo);  CHKERRQ(ierr);
 	ierr = DMDAVecGetArray(fs->DA_CEN,    vphase,      &phase);  CHKERRQ(ierr);
 
-	ierr = VecGetArray(actx->Ptr->x, &Xp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->y, &Yp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->z, &Zp)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->phase, &phaseptr)           ; CHKERRQ(ierr);
-
-	// scan all markers
-	for(jj = 0; jj < actx->Ptr->nummark; jj++)
+	// scan all local markers
+	for(jj = 0; jj < actx->Ptr->numloc; jj++)
 	{
 		// access next marker
-		xp = Xp[jj];
-		yp = Yp[jj];
-		zp = Zp[jj];;
+		P  = &actx->Ptr->tracers[jj];
+		xp = P->X[0];
+		yp = P->X[1];
+		zp = P->X[2];
 		// get consecutive index of the host cell
+		ierr = Discret1DFindPoint(&fs->dsx, xp, I); CHKERRQ(ierr);
+		ierr = Discret1DFindPoint(&fs->dsy, yp, J); CHKERRQ(ierr);
+		ierr = Discret1DFindPoint(&fs->dsz, zp, K); CHKERRQ(ierr);
 
-		if(xp >= bx && xp<ex && yp >= by && yp< ey && zp >= bz && zp< ez)
-		{
-
-			ierr = Discret1DFindPoint(&fs->dsx, xp, I); CHKERRQ(ierr);
-			ierr = Discret1DFindPoint(&fs->dsy, yp, J); CHKERRQ(ierr);
-			ierr = Discret1DFindPoint(&fs->dsz, zp, K); CHKERRQ(ierr);
+		GET_CELL_ID(ID, I, J, K, fs->dsx.ncels, fs->dsy.ncels)
 
-			GET_CELL_ID(ID, I, J, K, fs->dsx.ncels, fs->dsy.ncels)
 
+		// compute surface topography at marker position
+		topo = InterpLin2D(ltopo, I, J, L, sx, sy, xp, yp, ncx, ncy);
 
-			// compute surface topography at marker position
-			topo = InterpLin2D(ltopo, I, J, L, sx, sy, xp, yp, ncx, ncy);
+		// check whether rock marker is above the free surface
+		if(P->phase != ((PetscScalar) AirPhase) && zp > topo)
+		{
+			// erosion (physical or numerical) -> rock turns into air
+			P->phase= ((PetscScalar) AirPhase);
+		}
 
-			// check whether rock marker is above the free surface
-            if(phaseptr[jj] != ((PetscScalar) AirPhase) && zp > topo)
+		// check whether air marker is below the free surface
+		if(P->phase == ((PetscScalar) AirPhase) && zp < topo)
+		{
+			if(surf->SedimentModel > 0)
 			{
-				// erosion (physical or numerical) -> rock turns into air
-				phaseptr[jj]= ((PetscScalar) AirPhase);
+			// sedimentation (physical) -> air turns into a prescribed rock
+				P->phase= (PetscScalar) surf->phase;
 			}
-
-			// check whether air marker is below the free surface
-			if(phaseptr[jj] == ((PetscScalar) AirPhase) && zp < topo)
+			else
 			{
-				if(surf->SedimentModel > 0)
-				{
-				// sedimentation (physical) -> air turns into a prescribed rock
-					phaseptr[jj]= (PetscScalar) surf->phase;
-				}
-				else
-				{
-				// sedimentation (numerical) -> air turns into closest (reference) rock
-					Xm[0]=xp;
-					Xm[1]=yp;
-					Xm[2]=zp;
+			// sedimentation (numerical) -> air turns into closest (reference) rock
+				Xm[0]=xp;
+				Xm[1]=yp;
+				Xm[2]=zp;
 
-				// get marker list in containing cell
-					nmark   = actx->markstart[ID+1] - actx->markstart[ID];
-					markind = actx->markind + actx->markstart[ID];
+			// get marker list in containing cell
+				nmark   = actx->markstart[ID+1] - actx->markstart[ID];
+				markind = actx->markind + actx->markstart[ID];
 
-				// clear distance storage
-					dist.clear();
+			// clear distance storage
+				dist.clear();
 
-					for(ii = 0; ii < nmark; ii++)
-					{
-					// get current marker
-						markid = markind[ii];
-						IP     = &actx->markers[markid];
+				for(ii = 0; ii < nmark; ii++)
+				{
+				// get current marker
+					markid = markind[ii];
+					IP     = &actx->markers[markid];
 
-						// sort out air markers
-						if(IP->phase == AirPhase) continue;
+					// sort out air markers
+					if(IP->phase == AirPhase) continue;
 
-						// get marker coordinates
-						IX = IP->X;
+					// get marker coordinates
+					IX = IP->X;
 
-						// store marker index and distance
-						d.first  = EDIST(Xm, IX);
-						d.second = markid;
+					// store marker index and distance
+					d.first  = EDIST(Xm, IX);
+					d.second = markid;
 
-						dist.push_back(d);
-					}
+					dist.push_back(d);
+				}
 
-					// find closest rock marker (if any)
-					if(dist.size())
-					{
-					// sort rock markers by distance
-						sort(dist.begin(), dist.end());
+				// find closest rock marker (if any)
+				if(dist.size())
+				{
+				// sort rock markers by distance
+					sort(dist.begin(), dist.end());
 
-					// copy phase from closest marker
-						IP = &actx->markers[dist.begin()->second];
+				// copy phase from closest marker
+					IP = &actx->markers[dist.begin()->second];
 
-						phaseptr[jj] = (PetscScalar) IP->phase;
-					}
-					else
-					{
-					// no local rock marker found, set phase to reference
-						phaseID = (PetscInt)phase[sz+K][sy+J][sx+I];
-
-						if(phaseID < 0)
-						{
-						SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Incorrect sedimentation phase");
-						}
+					P->phase = (PetscScalar) IP->phase;
+				}
+				else
+				{
+				// no local rock marker found, set phase to reference
+					phaseID = (PetscInt)phase[sz+K][sy+J][sx+I];
 
-						phaseptr[jj] = (PetscScalar) phaseID;
+					if(phaseID < 0)
+					{
+					SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Incorrect sedimentation phase");
 					}
-				}
-				//=======================================================================
-				// WARNING! At best clone history from nearest rock marker
-				//=======================================================================
 
+					P->phase = (PetscScalar) phaseID;
+				}
 			}
-		}
-		else
-		{
-			phaseptr[jj] = -DBL_MAX;
+			//=======================================================================
+			// WARNING! At best clone history from nearest rock marker
+			//=======================================================================
+
 		}
 	}
 
-
-	ierr = VecRestoreArray(actx->Ptr->x, &Xp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->y, &Yp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->z, &Zp)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->phase, &phaseptr) ; CHKERRQ(ierr);
 	// restore access
 	ierr = DMDAVecRestoreArray(surf->DA_SURF, surf->ltopo, &ltopo);  CHKERRQ(ierr);
 	ierr = DMDAVecRestoreArray(fs->DA_CEN,    vphase,      &phase);  CHKERRQ(ierr);
@@ -1003,62 +956,51 @@ PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx)
 }
 
 //----------------------------------------------------------------------------//
-PetscErrorCode Check_advection_condition(AdvCtx *actx, PetscInt jj, PetscInt ID, PetscScalar xp, PetscScalar yp, PetscScalar zp, PetscScalar P,PetscScalar T,PetscScalar mf)
+PetscErrorCode Check_advection_condition(AdvCtx *actx, PtrMark *P, PetscInt ID, PetscScalar mf)
 {
 
-	PetscScalar 		*phase,*Active;
-	PetscScalar 		Xm[3],X[3];
+	PetscScalar 		Xm[3];
 	vector <spair>    	dist;
 	spair 				d;
-	PetscErrorCode 		ierr;
 
 	PetscFunctionBeginUser;
 
-	ierr = VecGetArray(actx->Ptr->C_advection, &Active); CHKERRQ(ierr);
-
 	if(actx->Ptr->Condition_pr == _Time_ptr_)
 	{
-		if((actx->jr->ts->time>=actx->Ptr->value_condition )&& Active[jj] == 0.0)
+		if((actx->jr->ts->time>=actx->Ptr->value_condition )&& P->active == 0.0)
 		{
-			Active[jj] = 1.0;
+			P->active = 1.0;
 		}
 	}
 	else if(actx->Ptr->Condition_pr ==_Melt_Fr_)
 	{
-		if((mf>=actx->Ptr->value_condition) && Active[jj] == 0.0)
+		if((mf>=actx->Ptr->value_condition) && P->active == 0.0)
 		{
-			Active[jj] = 1.0;
+			P->active = 1.0;
 		}
 	}
 	else if(actx->Ptr->Condition_pr ==_Temp_ptr_)
 	{
-		if((T>=actx->Ptr->value_condition) && Active[jj] == 0.0)
+		if((P->T>=actx->Ptr->value_condition) && P->active == 0.0)
 		{
-			Active[jj] = 1.0;
+			P->active = 1.0;
 		}
 	}
 	else if(actx->Ptr->Condition_pr ==_Pres_ptr_)
 	{
-		if((P>=actx->Ptr->value_condition) && Active[jj] == 0.0)
+		if((P->p>=actx->Ptr->value_condition) && P->active == 0.0)
 		{
-			Active[jj] = 1.0;
+			P->active = 1.0;
 		}
 	}
 
 	// overwrite the phase in case of delayed activation or if some condition are met
 
-	if(((actx->Ptr->Condition_pr ==_Pres_ptr_)||(actx->Ptr->Condition_pr ==_Temp_ptr_)||(actx->Ptr->Condition_pr ==_Time_ptr_)) && Active[jj] == 1.0)
+	if(((actx->Ptr->Condition_pr ==_Pres_ptr_)||(actx->Ptr->Condition_pr ==_Temp_ptr_)||(actx->Ptr->Condition_pr ==_Time_ptr_)) && P->active == 1.0)
 	{
 
 		PetscInt n, ii,id_m,*markind;
 
-		ierr = VecGetArray(actx->Ptr->phase, &phase); CHKERRQ(ierr);
-
-
-		X[0]  = xp;
-		X[1]  = yp;
-		X[2]  = zp;
-
 		dist.clear();
 		n = actx->markstart[ID+1] - actx->markstart[ID];
 		markind = actx->markind + actx->markstart[ID];
@@ -1072,84 +1014,47 @@ PetscErrorCode Check_advection_condition(AdvCtx *actx, PetscInt jj, PetscInt ID,
 			Xm[2] =actx->markers[id_m].X[2];
 
 
-			d.first  = EDIST(Xm, X);
+			d.first  = EDIST(Xm, P->X);
 			d.second = id_m;
 			dist.push_back(d);
 
 		}
 		sort(dist.begin(), dist.end());
-		phase[jj]= (PetscScalar) actx->markers[dist.begin()->second].phase;
-		ierr = VecRestoreArray(actx->Ptr->phase, &phase); CHKERRQ(ierr);
-
-
+		P->phase = (PetscScalar) actx->markers[dist.begin()->second].phase;
 
 	}
 
-	ierr = VecRestoreArray(actx->Ptr->C_advection, &Active); CHKERRQ(ierr);
-
 	PetscFunctionReturn(0);
 }
 
 
 
+
 //----------------------------------------------------------------------------//
 PetscErrorCode ADVPtrDestroy(AdvCtx *actx)
 {
-
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-
-	// check whether current storage is insufficient
-
-	VecDestroy(&actx->Ptr->ID);
-
-	VecDestroy(&actx->Ptr->x);
-
-	VecDestroy(&actx->Ptr->y);
-
-	VecDestroy(&actx->Ptr->z);
-
-	VecDestroy(&actx->Ptr->T);
-
-	VecDestroy(&actx->Ptr->p);
-
-	VecDestroy(&actx->Ptr->phase);
-
-	VecDestroy(&actx->Ptr->Melt_fr);
-
-	VecDestroy(&actx->Ptr->Melt_Grid);
-
-	VecDestroy(&actx->Ptr->C_advection);
-
-	VecDestroy(&actx->Ptr->Recv);
-
-
+	ierr = PetscFree(actx->Ptr->tracers); CHKERRQ(ierr);
+	ierr = PetscFree(actx->Ptr->sendbuf); CHKERRQ(ierr);
+	ierr = PetscFree(actx->Ptr->recvbuf); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
+
 // --------------------------------------------------------------------------------------- //
 
 //-------------------------------------------------------------------------//
 
 PetscErrorCode Passive_Tracer_WriteRestart(AdvCtx *actx, FILE *fp)
 {
-	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	// store local tracers to disk
 	if(actx->jr->ctrl.Passive_Tracer)
 	{
-
-	// write solution vectors
-	ierr = VecWriteRestart(actx->Ptr->x, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->y, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->z, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->p, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->T, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->phase, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->Melt_fr, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->Melt_Grid, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->C_advection, fp); CHKERRQ(ierr);
-	ierr = VecWriteRestart(actx->Ptr->ID, fp); CHKERRQ(ierr);
+		fwrite(actx->Ptr->tracers, (size_t)actx->Ptr->numloc*sizeof(PtrMark), 1, fp);
 	}
 
 	PetscFunctionReturn(0);
@@ -1159,51 +1064,38 @@ PetscErrorCode Passive_Tracer_WriteRestart(AdvCtx *actx, FILE *fp)
 
 PetscErrorCode ReadPassive_Tracers(AdvCtx *actx, FILE *fp)
 {
+	P_Tr     *ptr;
+	PetscInt  numloc;
+
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	// read solution vectors
+	// read local tracers
 	if(actx->jr->ctrl.Passive_Tracer)
 	{
-		ierr = ADVPtrReCreateStorage(actx); CHKERRQ(ierr);
-
-		ierr = VecReadRestart(actx->Ptr->x, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->y, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->z, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->p, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->T, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->phase, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->Melt_fr, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->Melt_Grid, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->C_advection, fp); CHKERRQ(ierr);
-		ierr = VecReadRestart(actx->Ptr->ID, fp); CHKERRQ(ierr);
-	}
-
-
-
-	PetscFunctionReturn(0);
-}
-//---------------------------------------------------------
-PetscErrorCode Sync_Vector(Vec x,AdvCtx *actx ,PetscInt nummark)
-{
-	PetscScalar *recv,*send;
+		ptr = actx->Ptr;
 
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
-
-	ierr = VecZeroEntries(actx->Ptr->Recv); CHKERRQ(ierr);
+		// reset storage (pointers read from restart database are invalid)
+		numloc       = ptr->numloc;
+		ptr->tracers = NULL;
+		ptr->sendbuf = NULL;
+		ptr->recvbuf = NULL;
+		ptr->numloc  = 0;
+		ptr->markcap = 0;
+		ptr->sendcap = 0;
+		ptr->recvcap = 0;
 
-	ierr = VecGetArray(x, &send)           ; CHKERRQ(ierr);
-	ierr = VecGetArray(actx->Ptr->Recv, &recv)           ; CHKERRQ(ierr);
+		ierr = ADVPtrReAllocStorage(actx, numloc); CHKERRQ(ierr);
 
-	ierr = MPI_Allreduce(send, recv, (PetscMPIInt)nummark, MPIU_SCALAR, MPI_MAX,PETSC_COMM_WORLD); CHKERRQ(ierr);
+		fread(ptr->tracers, (size_t)numloc*sizeof(PtrMark), 1, fp);
 
-	ierr = VecRestoreArray(x, &send)           ; CHKERRQ(ierr);
-	ierr = VecRestoreArray(actx->Ptr->Recv, &recv)           ; CHKERRQ(ierr);
+		ptr->numloc = numloc;
+	}
 
 	PetscFunctionReturn(0);
 }
 
+//---------------------------------------------------------
 
 //=========================================================
 /*
@@ -44,10 +44,12 @@ struct DBMat;
 
 /*
  * The passive tracer are placed at the cell center. They are globally identified by the ID of the cell
- * The global ID number is given by the following formulation ID = i + Npx*(ip+j*nx+jp*ny)+Npx*Npy*npx*npy*(k+kp*nz)
- * where ip,jp,kp are the current index of the processor; Npx,Npy,Npz are the total number of processor along x,y,z direction
- * nx,ny,nz are the number of nodes along x,y,z direction contained in each processor.
+ * The global ID number is given by the following formulation ID = i + nx*j + nx*ny*k
+ * where i,j,k are the indices of the tracer in the initial tracer grid, and nx,ny,nz are
+ * the number of tracers along x,y,z direction (PassiveTracer_Resolution).
  * Each time the marker are advected, and interpolated revelant information: e.g. pressure and temperature
+ * Every processor only stores the tracers located in its subdomain. Tracers are migrated to the
+ * neighbor processors after advection, and written in parallel (one output piece per processor).
  */
 
 //---------------------------------------------------------------------------
@@ -63,30 +65,43 @@ enum Condition
 
 //---------------------------------------------------------------------------
 
+struct PtrMark
+{
+	PetscScalar X[3];   // global coordinates
+	PetscScalar p;      // pressure
+	PetscScalar T;      // temperature
+	PetscScalar phase;  // phase identifier
+	PetscScalar mf;     // melt fraction acquired
+	PetscScalar mfgrid; // melt quantity effectively seen by the grid
+	PetscScalar active; // condition to advect marker
+	PetscScalar ID;     // global identification number
+	PetscInt    ind;    // position in the initial tracer grid
+};
+
+//---------------------------------------------------------------------------
+
 struct P_Tr
 {
 
 	PetscScalar box_passive_tracer[6];
 	PetscInt    passive_tracer_resolution[3];
-	PetscInt    nummark ;
+	PetscInt    nummark ; // total number of tracers
 	Condition   Condition_pr;
 	PetscScalar value_condition;
-	Vec         ID;    // global identification number
-	Vec    phase; // phase identifier
-	Vec    x;      // global coordinates
-	Vec    y;      //
-	Vec    z;      //
-	Vec    p;     // pressure
-	Vec    T;     // temperature
-	Vec    Melt_fr; // Melt fraction acquired
-	Vec    Melt_Grid; // melt quantity effectively seen by the grid
-	Vec    C_advection; // condition to advect marker /*NB: in the future it could be useful to customize better this vector */
-	Vec    Recv;  // Vector that must be used during synching operation
+	PtrMark    *tracers;  // tracers owned by the current processor
+	PetscInt    numloc;   // number of local tracers
+	PetscInt    markcap;  // capacity of local storage
+	PtrMark    *sendbuf;  // exchange buffers
+	PtrMark    *recvbuf;  //
+	PetscInt    sendcap;  // capacity of exchange buffers
+	PetscInt    recvcap;  //
 };
 
 PetscErrorCode ADVPtrPassive_Tracer_create(AdvCtx *actx, FB *fb);
 
-PetscErrorCode ADVPtrReCreateStorage(AdvCtx *actx);
+PetscErrorCode ADVPtrReAllocStorage(AdvCtx *actx, PetscInt numloc);
+
+PetscErrorCode ADVPtrGetMPIBuff(AdvCtx *actx, PetscInt nsend, PetscInt nrecv);
 
 PetscErrorCode ADVPassiveTracerInit(AdvCtx *actx);
 
@@ -96,6 +111,8 @@ PetscErrorCode ADV_Assign_Phase(AdvCtx *actx);
 
 PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx);
 
+PetscErrorCode ADVPtrExchange(AdvCtx *actx);
+
 PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx);
 
 PetscErrorCode ADVPtrDestroy(AdvCtx *actx);
@@ -104,9 +121,7 @@ PetscErrorCode ReadPassive_Tracers(AdvCtx *actx, FILE *fp);
 
 PetscErrorCode Passive_Tracer_WriteRestart(AdvCtx *actx, FILE *fp);
 
-PetscErrorCode Sync_Vector(Vec x,AdvCtx *actx ,PetscInt nummark);
-
-PetscErrorCode Check_advection_condition(AdvCtx *actx, PetscInt jj, PetscInt ID, PetscScalar xp, PetscScalar yp, PetscScalar zp, PetscScalar P,PetscScalar T,PetscScalar mf);
+PetscErrorCode Check_advection_condition(AdvCtx *actx, PtrMark *P, PetscInt ID, PetscScalar mf);
 
 //PetscErrorCode Passive_tracers_save(AdvCtx *actx);
 
@@ -717,8 +717,9 @@ PetscErrorCode Phase_Transition(AdvCtx *actx)
 	Ph_trans_t      *PhaseTrans;
 	Marker          *P;
 	JacRes          *jr;
-	PetscInt        i, ph,nPtr, numPhTrn,below,above,num_phas;
+	PetscInt        i, ph,nPtr, numPhTrn,below,above,num_phas,numPhases;
 	PetscInt        PH1,PH2, ID, InsideAbove,nphc; // nphc nophasechange condition
+	PetscInt        *phact, *lawnphc, *lawall, *skip;
 	PetscScalar     T, time, factor, dxBox, dyBox, dzBox;
 	PetscLogDouble  t;
 	SolVarCell      *svCell;
@@ -742,8 +743,12 @@ PetscErrorCode Phase_Transition(AdvCtx *actx)
 	//For dynamic diking
 	ierr = Locate_Dike_Zones(actx); CHKERRQ(ierr);
 	
-	// loop over all phase transition laws		PetscPrintf(PETSC_COMM_WORLD,"PHASE = %d  i = %d, counter = %d\n",P->phase,i,counter);
-	nPtr        =   0;
+	// prefilter: markers of phases not involved in a constant/clapeyron transition are never modified by it
+	numPhases = dbm->numPhases;
+
+	ierr = makeIntArray(&phact,   NULL, numPhases*numPhTrn); CHKERRQ(ierr);
+	ierr = makeIntArray(&lawnphc, NULL, numPhTrn);           CHKERRQ(ierr);
+	ierr = makeIntArray(&lawall,  NULL, numPhTrn);           CHKERRQ(ierr);
 
 	for(nPtr=0; nPtr<numPhTrn; nPtr++)
 	  {
@@ -752,11 +757,11 @@ PetscErrorCode Phase_Transition(AdvCtx *actx)
 	    // Is the phase transition changing the phase, or other properites?
 	    if((PhaseTrans->PhaseInside[0]>0 && PhaseTrans->PhaseOutside[0]>0) || (PhaseTrans->PhaseAbove[0]>0 && PhaseTrans->PhaseBelow[0]>0))
 	    {
-              nphc = 1;
+              lawnphc[nPtr] = 1;
 	    }
 	    else
 	    {
-              nphc = 0;
+              lawnphc[nPtr] = 0;
 	    }
 	    // calling the moving dike function
 
@@ -769,14 +774,50 @@ PetscErrorCode Phase_Transition(AdvCtx *actx)
               ierr = LinkNotInAirBoxes(PhaseTrans, jr); CHKERRQ(ierr);
 
 	    }
-	    
-		for(i = 0; i < actx->nummark; i++)      // loop over all (local) particles
+
+	    // box transitions can also modify markers of other phases
+	    if ( PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_ )
+	    {
+              lawall[nPtr] = 1;
+	    }
+
+	    // mark involved phases
+	    for(i = 0; i < PhaseTrans->number_phases; i++)
+	    {
+              if ( PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_ )
+              {
+                if (PhaseTrans->PhaseInside [i] >= 0 && PhaseTrans->PhaseInside [i] < numPhases) phact[PhaseTrans->PhaseInside [i]*numPhTrn + nPtr] = 1;
+                if (PhaseTrans->PhaseOutside[i] >= 0 && PhaseTrans->PhaseOutside[i] < numPhases) phact[PhaseTrans->PhaseOutside[i]*numPhTrn + nPtr] = 1;
+              }
+              else
+              {
+                if (PhaseTrans->PhaseBelow[i] >= 0 && PhaseTrans->PhaseBelow[i] < numPhases) phact[PhaseTrans->PhaseBelow[i]*numPhTrn + nPtr] = 1;
+                if (PhaseTrans->PhaseAbove[i] >= 0 && PhaseTrans->PhaseAbove[i] < numPhases) phact[PhaseTrans->PhaseAbove[i]*numPhTrn + nPtr] = 1;
+              }
+	    }
+	  }
+
+	// cell prefilter: constant/clapeyron transitions that cannot modify any marker of a cell
+	ierr = makeIntArray(&skip, NULL, jr->fs->nCells*numPhTrn); CHKERRQ(ierr);
+
+	ierr = Phase_Transition_CellCull(actx, lawnphc, lawall, skip); CHKERRQ(ierr);
+
+	// apply all transition laws to every marker in turn (same order as law by law)
+	for(i = 0; i < actx->nummark; i++)      // loop over all (local) particles
+	{
+		// get consecutive index of the host cell of marker
+		ID = 	actx->cellnum[i];
+
+		for(nPtr=0; nPtr<numPhTrn; nPtr++)
 		{
+			PhaseTrans = jr->dbm->matPhtr+nPtr;
+			nphc       = lawnphc[nPtr];
+
 			// access marker
 			P   =   &actx->markers[i];      
 
-			// get consecutive index of the host cell of marker
-			ID = 	actx->cellnum[i];
+			// skip constant/clapeyron transitions that do not involve the current marker phase or its cell
+			if(!lawall[nPtr] && (P->phase < 0 || P->phase >= numPhases || !phact[P->phase*numPhTrn + nPtr] || skip[ID*numPhTrn + nPtr])) continue;
 
 			// access host cell solution variables
 			svCell = &jr->svCell[ID];
@@ -911,12 +952,213 @@ PetscErrorCode Phase_Transition(AdvCtx *actx)
 		}
 
 	}
+
+	ierr = PetscFree(phact);   CHKERRQ(ierr);
+	ierr = PetscFree(lawnphc); CHKERRQ(ierr);
+	ierr = PetscFree(lawall);  CHKERRQ(ierr);
+	ierr = PetscFree(skip);    CHKERRQ(ierr);
+
 	ierr = ADVInterpMarkToCell(actx);   CHKERRQ(ierr);
 
     	PrintDone(t);
 	PetscFunctionReturn(0);
 }
 
+//----------------------------------------------------------------------------------------
+PetscErrorCode Phase_Transition_CellCull(AdvCtx *actx, PetscInt *lawnphc, PetscInt *lawall, PetscInt *skip)
+{
+	// mark constant/clapeyron transitions that leave all markers of a cell unchanged (skip[cell*numPhTrn + law])
+	// transition conditions are bounded by the range of marker variables (T, p, APS, X) in every cell,
+	// melt fraction is uniform in a cell. Laws are applied in sequence, therefore phases produced by a
+	// law that is not skipped (and APS reset) are added to the cell state. Box laws can change phase & T
+	// of any marker, no law following a box law is skipped.
+	// -phase_trans_nocull disables the cell prefilter (reference for regression tests)
+
+	JacRes       *jr;
+	Ph_trans_t   *PhaseTrans;
+	Marker       *P;
+	PetscScalar  *bnd, *b, pShift, time;
+	unsigned int *mask;
+	PetscInt      i, ID, nPtr, numPhTrn, numPhases, nCells, cond, noop, boxseen;
+	PetscBool     nocull;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscOptionsHasName(NULL, NULL, "-phase_trans_nocull", &nocull); CHKERRQ(ierr);
+
+	if(nocull) PetscFunctionReturn(0);
+
+	jr        = actx->jr;
+	numPhTrn  = jr->dbm->numPhtr;
+	numPhases = jr->dbm->numPhases;
+	nCells    = jr->fs->nCells;
+	pShift    = jr->ctrl.pShift ? jr->ctrl.pShift : 0.0;
+	time      = jr->bc->ts->time;
+
+	// range of marker variables [Tmin, Tmax, pmin, pmax, APSmin, APSmax, xmin, xmax, ymin, ymax, zmin, zmax]
+	// & set of phases (bit mask, at most 32 phases) in every cell
+	ierr = makeScalArray(&bnd, NULL, 12*nCells); CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)nCells*sizeof(unsigned int), &mask); CHKERRQ(ierr);
+	ierr = PetscMemzero(mask, (size_t)nCells*sizeof(unsigned int)); CHKERRQ(ierr);
+
+	for(ID = 0; ID < nCells; ID++)
+	{
+		b = bnd + 12*ID;
+
+		b[0] = b[2] = b[4] = b[6] = b[8] = b[10] =  DBL_MAX;
+		b[1] = b[3] = b[5] = b[7] = b[9] = b[11] = -DBL_MAX;
+	}
+
+	for(i = 0; i < actx->nummark; i++)
+	{
+		P  = &actx->markers[i];
+		ID = actx->cellnum[i];
+		b  = bnd + 12*ID;
+
+		b[0]  = PetscMin(b[0],  P->T);    b[1]  = PetscMax(b[1],  P->T);
+		b[2]  = PetscMin(b[2],  P->p);    b[3]  = PetscMax(b[3],  P->p);
+		b[4]  = PetscMin(b[4],  P->APS);  b[5]  = PetscMax(b[5],  P->APS);
+		b[6]  = PetscMin(b[6],  P->X[0]); b[7]  = PetscMax(b[7],  P->X[0]);
+		b[8]  = PetscMin(b[8],  P->X[1]); b[9]  = PetscMax(b[9],  P->X[1]);
+		b[10] = PetscMin(b[10], P->X[2]); b[11] = PetscMax(b[11], P->X[2]);
+
+		// phases out of range are never modified by constant/clapeyron laws
+		if(P->phase >= 0 && P->phase < numPhases) mask[ID] |= 1u << P->phase;
+	}
+
+	for(ID = 0; ID < nCells; ID++)
+	{
+		b       = bnd + 12*ID;
+		boxseen = 0;
+
+		for(nPtr = 0; nPtr < numPhTrn; nPtr++)
+		{
+			PhaseTrans = jr->dbm->matPhtr+nPtr;
+
+			if(lawall[nPtr]) { boxseen = 1; continue; }
+
+			if(boxseen) continue;
+
+			// get uniform condition of the law in the cell
+			cond = Check_Phase_Transition_Range(PhaseTrans, b, jr->svCell[ID].svBulk.mf, pShift, time);
+
+			// check every phase present in the cell
+			noop = (cond >= 0);
+
+			for(i = 0; i < numPhases && noop; i++)
+			{
+				if(mask[ID] & (1u << i)) noop = Check_Phase_Transition_Stable(PhaseTrans, i, lawnphc[nPtr], cond);
+			}
+
+			if(noop) { skip[ID*numPhTrn + nPtr] = 1; continue; }
+
+			// update cell state with possible outcome of the law
+			for(i = 0; i < PhaseTrans->number_phases; i++)
+			{
+				if(PhaseTrans->PhaseBelow[i] >= 0 && PhaseTrans->PhaseBelow[i] < numPhases) mask[ID] |= 1u << PhaseTrans->PhaseBelow[i];
+				if(PhaseTrans->PhaseAbove[i] >= 0 && PhaseTrans->PhaseAbove[i] < numPhases) mask[ID] |= 1u << PhaseTrans->PhaseAbove[i];
+			}
+
+			if(PhaseTrans->Reset == 1) b[4] = PetscMin(b[4], 0.0);
+		}
+	}
+
+	ierr = PetscFree(bnd);  CHKERRQ(ierr);
+	ierr = PetscFree(mask); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//----------------------------------------------------------------------------------------
+PetscInt Check_Phase_Transition_Range(Ph_trans_t *PhaseTrans, PetscScalar *bnd, PetscScalar mf, PetscScalar pShift, PetscScalar time)
+{
+	// get condition of a constant/clapeyron law for a range of marker variables (see Phase_Transition_CellCull)
+	// returns 1 (above for all markers), 0 (below for all markers) or -1 (undecided)
+	// comparisons are the same as in Check_Constant/Clapeyron_Phase_Transition (monotonic in every variable)
+
+	PetscInt    ip, above, below;
+	PetscScalar vmin, vmax, T0, s, P0, Pmin, Pmax;
+
+	if(PhaseTrans->Type == _Constant_)
+	{
+		if     (PhaseTrans->Parameter_transition == _T_)             { vmin = bnd[0];        vmax = bnd[1];        }
+		else if(PhaseTrans->Parameter_transition == _Pressure_)      { vmin = bnd[2]+pShift; vmax = bnd[3]+pShift; }
+		else if(PhaseTrans->Parameter_transition == _PlasticStrain_) { vmin = bnd[4];        vmax = bnd[5];        }
+		else if(PhaseTrans->Parameter_transition == _X_)             { vmin = bnd[6];        vmax = bnd[7];        }
+		else if(PhaseTrans->Parameter_transition == _Y_)             { vmin = bnd[8];        vmax = bnd[9];        }
+		else if(PhaseTrans->Parameter_transition == _Depth_)         { vmin = bnd[10];       vmax = bnd[11];       }
+		else if(PhaseTrans->Parameter_transition == _MeltFraction_)  { vmin = mf;            vmax = mf;            }
+		else if(PhaseTrans->Parameter_transition == _Time_)          { vmin = time;          vmax = time;          }
+		else return -1;
+
+		if(vmin >= PhaseTrans->ConstantValue) return 1;
+		if(vmax <  PhaseTrans->ConstantValue) return 0;
+
+		return -1;
+	}
+
+	if(PhaseTrans->Type == _Clapeyron_)
+	{
+		// above requires all equations, below requires any equation
+		above = 1;
+		below = 0;
+
+		for(ip = 0; ip < PhaseTrans->neq; ip++)
+		{
+			T0 = PhaseTrans->T0_clapeyron[ip];
+			s  = PhaseTrans->clapeyron_slope[ip];
+			P0 = PhaseTrans->P0_clapeyron[ip];
+
+			Pmin = ((s >= 0.0 ? bnd[0] : bnd[1]) - T0)*s + P0;
+			Pmax = ((s >= 0.0 ? bnd[1] : bnd[0]) - T0)*s + P0;
+
+			if(!(bnd[2]+pShift >= Pmax)) above = 0;
+			if(  bnd[3]+pShift <  Pmin)  below = 1;
+		}
+
+		if(above) return 1;
+		if(below) return 0;
+	}
+
+	return -1;
+}
+//----------------------------------------------------------------------------------------
+PetscInt Check_Phase_Transition_Stable(Ph_trans_t *PhaseTrans, PetscInt phase, PetscInt nphc, PetscInt InAbove)
+{
+	// check whether a constant/clapeyron law with given condition leaves a marker of given phase unchanged
+	// (same phase selection & APS reset as in Phase_Transition)
+
+	PetscInt it, below, above, PH1, PH2, ph, setph;
+
+	below = -1;
+	above = -1;
+
+	for(it = 0; it < PhaseTrans->number_phases; it++) { if(PhaseTrans->PhaseBelow[it] == phase) { below = it; break; } }
+	for(it = 0; it < PhaseTrans->number_phases; it++) { if(PhaseTrans->PhaseAbove[it] == phase) { above = it; break; } }
+
+	if(below < 0 && above < 0) return 1;
+
+	PH1 = phase;
+	PH2 = phase;
+
+	if     (below >= 0 && nphc == 1) { PH1 = PhaseTrans->PhaseBelow[below]; PH2 = PhaseTrans->PhaseAbove[below]; }
+	else if(above >= 0 && nphc == 1) { PH1 = PhaseTrans->PhaseBelow[above]; PH2 = PhaseTrans->PhaseAbove[above]; }
+
+	ph    = InAbove ? PH2 : PH1;
+	setph = (PhaseTrans->PhaseDirection == 0)
+	||      (PhaseTrans->PhaseDirection == 1 && below >= 0)
+	||      (PhaseTrans->PhaseDirection == 2 && above >= 0);
+
+	if(setph && ph != phase) return 0;
+
+	if(PhaseTrans->Reset == 1)
+	{
+		if(PhaseTrans->PhaseDirection <  2 && InAbove == 1) return 0;
+		if(PhaseTrans->PhaseDirection >= 2 && InAbove == 0) return 0;
+	}
+
+	return 1;
+}
 //----------------------------------------------------------------------------------------
 
 PetscErrorCode MovingBox(Ph_trans_t *PhaseTrans, TSSol *ts, JacRes *jr)
@@ -36,6 +36,9 @@ PetscErrorCode Set_NotInAirBox_Phase_Transition(Ph_trans_t *ph, DBMat *dbm, FB *
 PetscErrorCode SetClapeyron_Eq(Ph_trans_t *ph);
 PetscErrorCode Overwrite_density(DBMat *dbm);
 PetscErrorCode Phase_Transition(AdvCtx *actx);
+PetscErrorCode Phase_Transition_CellCull(AdvCtx *actx, PetscInt *lawnphc, PetscInt *lawall, PetscInt *skip);
+PetscInt Check_Phase_Transition_Range(Ph_trans_t *PhaseTrans, PetscScalar *bnd, PetscScalar mf, PetscScalar pShift, PetscScalar time);
+PetscInt Check_Phase_Transition_Stable(Ph_trans_t *PhaseTrans, PetscInt phase, PetscInt nphc, PetscInt InAbove);
 PetscInt Transition(Ph_trans_t *PhaseTrans, Marker *P, PetscInt PH1,PetscInt PH2, 
 			  Controls ctrl,Scaling *scal, SolVarCell *svCell, PetscInt *ph, PetscScalar *T, PetscInt *InsideAbove, PetscScalar, JacRes *jr, PetscInt cellID);
 PetscInt Check_Phase_above_below(PetscInt *phase_array, Marker *P,PetscInt num_phas);
@@ -0,0 +1,332 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//.........................   STARTUP PROFILER   ............................
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "startup.h"
+#include "parsing.h"
+#include "tools.h"
+//---------------------------------------------------------------------------
+// number of reduced values (max section)
+#define _startup_num_max_ (3*_STARTUP_NUM_ + 4)
+// number of reduced values (sum section)
+#define _startup_num_sum_ (_STARTUP_NUM_ + 2)
+//---------------------------------------------------------------------------
+
+struct StartupProf
+{
+	PetscLogStage  id   [_STARTUP_NUM_];       // PETSc log stages
+	PetscLogDouble time [_STARTUP_NUM_];       // exclusive wall time
+	PetscLogDouble mem  [_STARTUP_NUM_];       // resident memory at stage exit
+	PetscInt       calls[_STARTUP_NUM_];       // number of calls
+	PetscInt       stack[_startup_max_depth_]; // active stages
+	PetscInt       depth;                      // number of active stages
+	PetscLogDouble tbeg;                       // profiling start time
+	PetscLogDouble tmark;                      // time of last stage transition
+	PetscLogDouble peak;                       // peak resident memory (sampled)
+	PetscBool      registered;                 // log stages registration flag
+	PetscBool      active;                     // profiling activation flag
+};
+
+//---------------------------------------------------------------------------
+
+static StartupProf prof;
+
+static const char *startupName[_STARTUP_NUM_] =
+{
+	"Input parsing",
+	"Parameters & databases",
+	"Grid setup",
+	"Solution objects",
+	"Marker initialization",
+	"Phase diagram loading",
+	"Marker mapping & projection",
+	"Output objects",
+	"Restart loading",
+	"Solver creation",
+	"Initial BC & state",
+	"Initial guess",
+	"Preconditioner setup",
+	"Initial output"
+};
+
+static const char *startupLogName[_STARTUP_NUM_] =
+{
+	"Startup: Input",
+	"Startup: Params",
+	"Startup: Grid",
+	"Startup: Objects",
+	"Startup: MarkInit",
+	"Startup: PhaseDiag",
+	"Startup: MarkProj",
+	"Startup: Output",
+	"Startup: Restart",
+	"Startup: Solver",
+	"Startup: InitState",
+	"Startup: InitGuess",
+	"Startup: PCSetup",
+	"Startup: InitOut"
+};
+
+//---------------------------------------------------------------------------
+static PetscErrorCode StartupProfCharge()
+{
+	// charge elapsed time to the innermost active stage
+
+	PetscLogDouble t;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscTime(&t); CHKERRQ(ierr);
+
+	if(prof.depth) prof.time[prof.stack[prof.depth-1]] += t - prof.tmark;
+
+	prof.tmark = t;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode StartupProfSample(PetscInt stage)
+{
+	// sample resident memory at stage exit
+
+	PetscLogDouble mem;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscMemoryGetCurrentUsage(&mem); CHKERRQ(ierr);
+
+	mem /= 1024.0*1024.0;
+
+	if(mem > prof.mem[stage]) prof.mem[stage] = mem;
+	if(mem > prof.peak)       prof.peak       = mem;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode StartupProfInit()
+{
+	PetscInt i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// register log stages only once (library can be called repeatedly)
+	if(!prof.registered)
+	{
+		for(i = 0; i < _STARTUP_NUM_; i++)
+		{
+			ierr = PetscLogStageRegister(startupLogName[i], &prof.id[i]); CHKERRQ(ierr);
+		}
+
+		prof.registered = PETSC_TRUE;
+	}
+
+	// reset counters
+	for(i = 0; i < _STARTUP_NUM_; i++)
+	{
+		prof.time [i] = 0.0;
+		prof.mem  [i] = 0.0;
+		prof.calls[i] = 0;
+	}
+
+	prof.depth  = 0;
+	prof.peak   = 0.0;
+	prof.active = PETSC_TRUE;
+
+	ierr = PetscTime(&prof.tbeg); CHKERRQ(ierr);
+
+	prof.tmark = prof.tbeg;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode StartupProfBegin(StartupStage stage)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!prof.active) PetscFunctionReturn(0);
+
+	if(prof.depth == _startup_max_depth_)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Startup stages are nested too deep (_startup_max_depth_ in startup.h)\n");
+	}
+
+	ierr = StartupProfCharge(); CHKERRQ(ierr);
+
+	prof.stack[prof.depth++] = stage;
+
+	prof.calls[stage]++;
+
+	ierr = PetscLogStagePush(prof.id[stage]); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode StartupProfEnd(StartupStage stage)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!prof.active) PetscFunctionReturn(0);
+
+	if(!prof.depth || prof.stack[prof.depth-1] != stage)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Unbalanced startup stage: %s\n", startupName[stage]);
+	}
+
+	ierr = StartupProfCharge();        CHKERRQ(ierr);
+	ierr = StartupProfSample(stage);   CHKERRQ(ierr);
+
+	prof.depth--;
+
+	ierr = PetscLogStagePop(); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode StartupProfReport()
+{
+	// combine all local contributions in two reductions (maxima and sums)
+	// minima are computed as maxima of negative values
+
+	FILE           *fp;
+	PetscMPIInt    nproc;
+	PetscBool      print, json, sep;
+	PetscInt       i;
+	PetscLogDouble t, other, lmax[_startup_num_max_], gmax[_startup_num_max_], lsum[_startup_num_sum_], gsum[_startup_num_sum_];
+	PetscLogDouble tmin, tmax, tavg, ratio;
+	char           fname[_str_len_];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!prof.active) PetscFunctionReturn(0);
+
+	// close stages left open
+	while(prof.depth)
+	{
+		ierr = StartupProfEnd((StartupStage)prof.stack[prof.depth-1]); CHKERRQ(ierr);
+	}
+
+	// stop profiling
+	prof.active = PETSC_FALSE;
+
+	ierr = PetscTime(&t); CHKERRQ(ierr);
+
+	t -= prof.tbeg;
+
+	// time outside of all stages
+	for(i = 0, other = t; i < _STARTUP_NUM_; i++) other -= prof.time[i];
+
+	ierr = PetscOptionsHasName(NULL, NULL, "-startup_report", &print); CHKERRQ(ierr);
+
+	ierr = PetscOptionsGetCheckString("-startup_report_json", fname, &json); CHKERRQ(ierr);
+
+	if(!print && !json) PetscFunctionReturn(0);
+
+	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &nproc); CHKERRQ(ierr);
+
+	// pack local values
+	for(i = 0; i < _STARTUP_NUM_; i++)
+	{
+		lmax[3*i  ] =  prof.time[i];
+		lmax[3*i+1] = -prof.time[i];
+		lmax[3*i+2] =  prof.mem [i];
+		lsum[i]     =  prof.time[i];
+	}
+
+	lmax[3*_STARTUP_NUM_  ] =  t;
+	lmax[3*_STARTUP_NUM_+1] = -t;
+	lmax[3*_STARTUP_NUM_+2] =  prof.peak;
+	lmax[3*_STARTUP_NUM_+3] = -prof.peak;
+
+	lsum[_STARTUP_NUM_  ] = other;
+	lsum[_STARTUP_NUM_+1] = prof.peak;
+
+	if(ISParallel(PETSC_COMM_WORLD))
+	{
+		ierr = MPI_Reduce(lmax, gmax, _startup_num_max_, MPI_DOUBLE, MPI_MAX, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+		ierr = MPI_Reduce(lsum, gsum, _startup_num_sum_, MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr = PetscMemcpy(gmax, lmax, _startup_num_max_*sizeof(PetscLogDouble)); CHKERRQ(ierr);
+		ierr = PetscMemcpy(gsum, lsum, _startup_num_sum_*sizeof(PetscLogDouble)); CHKERRQ(ierr);
+	}
+
+	if(!ISRankZero(PETSC_COMM_WORLD)) PetscFunctionReturn(0);
+
+	if(print)
+	{
+		PetscPrintf(PETSC_COMM_SELF,"--------------------------------------------------------------------------\n");
+		PetscPrintf(PETSC_COMM_SELF,"Startup profile (wall time [s] over ranks, resident memory [MB] at exit):\n");
+		PetscPrintf(PETSC_COMM_SELF,"   Stage                         calls     min        max        avg     max/min  memory\n");
+
+		for(i = 0; i < _STARTUP_NUM_; i++)
+		{
+			if(!prof.calls[i]) continue;
+
+			tmax  =  gmax[3*i];
+			tmin  = -gmax[3*i+1];
+			tavg  =  gsum[i]/(PetscLogDouble)nproc;
+			ratio =  tmin > 0.0 ? tmax/tmin : 1.0;
+
+			PetscPrintf(PETSC_COMM_SELF,"   %-28s: %4lld  %1.3e  %1.3e  %1.3e  %6.2f  %8.1f\n",
+				startupName[i], (LLD)prof.calls[i], tmin, tmax, tavg, ratio, gmax[3*i+2]);
+		}
+
+		PetscPrintf(PETSC_COMM_SELF,"   Outside of stages [s] (avg)            : %g\n", gsum[_STARTUP_NUM_]/(PetscLogDouble)nproc);
+		PetscPrintf(PETSC_COMM_SELF,"   Total startup time [s] (min/max)      : %g / %g\n", -gmax[3*_STARTUP_NUM_+1], gmax[3*_STARTUP_NUM_]);
+		PetscPrintf(PETSC_COMM_SELF,"   Peak resident memory [MB] (min/max/total): %g / %g / %g\n", -gmax[3*_STARTUP_NUM_+3], gmax[3*_STARTUP_NUM_+2], gsum[_STARTUP_NUM_+1]);
+		PetscPrintf(PETSC_COMM_SELF,"--------------------------------------------------------------------------\n");
+	}
+
+	if(json)
+	{
+		fp = fopen(fname, "w");
+
+		if(fp == NULL) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Cannot open file %s\n", fname);
+
+		fprintf(fp, "{\n");
+		fprintf(fp, "  \"nproc\": %lld,\n", (LLD)nproc);
+		fprintf(fp, "  \"total_time\": {\"min\": %g, \"max\": %g},\n", -gmax[3*_STARTUP_NUM_+1], gmax[3*_STARTUP_NUM_]);
+		fprintf(fp, "  \"other_time_avg\": %g,\n", gsum[_STARTUP_NUM_]/(PetscLogDouble)nproc);
+		fprintf(fp, "  \"peak_memory_mb\": {\"min\": %g, \"max\": %g, \"total\": %g},\n",
+			-gmax[3*_STARTUP_NUM_+3], gmax[3*_STARTUP_NUM_+2], gsum[_STARTUP_NUM_+1]);
+		fprintf(fp, "  \"stages\": [");
+
+		for(i = 0, sep = PETSC_FALSE; i < _STARTUP_NUM_; i++)
+		{
+			if(!prof.calls[i]) continue;
+
+			tmax  =  gmax[3*i];
+			tmin  = -gmax[3*i+1];
+			tavg  =  gsum[i]/(PetscLogDouble)nproc;
+			ratio =  tmin > 0.0 ? tmax/tmin : 1.0;
+
+			fprintf(fp, "%s\n    {\"name\": \"%s\", \"calls\": %lld, \"time_min\": %g, \"time_max\": %g, \"time_avg\": %g, \"imbalance\": %g, \"memory_max_mb\": %g}",
+				sep ? "," : "", startupName[i], (LLD)prof.calls[i], tmin, tmax, tavg, ratio, gmax[3*i+2]);
+
+			sep = PETSC_TRUE;
+		}
+
+		fprintf(fp, "\n  ]\n}\n");
+
+		fclose(fp);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
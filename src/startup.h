@@ -0,0 +1,68 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//.........................   STARTUP PROFILER   ............................
+//---------------------------------------------------------------------------
+#ifndef __startup_h__
+#define __startup_h__
+//---------------------------------------------------------------------------
+// Every initialization phase (from loading the input file up to the initial
+// guess) is registered as a PETSc log stage, so that it appears separately
+// in -log_view. In addition, exclusive wall time, number of calls and
+// resident memory (sampled at the end of every phase) are accumulated on
+// every processor. Stages can be nested, time of the inner stage is not
+// counted in the outer one. Profiling stops after the first report.
+//
+// Command line options:
+//
+//    -startup_report              - print summary (min/max over processors)
+//    -startup_report_json <file>  - write summary to JSON file
+//---------------------------------------------------------------------------
+
+// maximum nesting depth of startup stages
+#define _startup_max_depth_ 8
+
+//---------------------------------------------------------------------------
+
+enum StartupStage
+{
+	_STARTUP_INPUT_,      // input file parsing
+	_STARTUP_PARAM_,      // scaling, time stepping, material & dike databases
+	_STARTUP_GRID_,       // staggered grid & domain decomposition
+	_STARTUP_OBJECTS_,    // free surface, boundary conditions, residual evaluation
+	_STARTUP_MARK_INIT_,  // marker initialization (geometric primitives, files, temperature)
+	_STARTUP_PHASE_DIAG_, // phase diagram loading
+	_STARTUP_MARK_PROJ_,  // marker mapping, checks & initial history projection
+	_STARTUP_OUTPUT_,     // output objects, passive tracers & diagnostics
+	_STARTUP_RESTART_,    // restart database loading
+	_STARTUP_SOLVER_,     // preconditioner matrix, preconditioner & nonlinear solver creation
+	_STARTUP_INIT_STATE_, // first boundary conditions, temperature & pressure initialization
+	_STARTUP_INIT_SOLVE_, // initial guess solve or initial residual
+	_STARTUP_PC_SETUP_,   // preconditioner (multigrid) setup during initial guess
+	_STARTUP_INIT_OUT_,   // output of the initial state
+	_STARTUP_NUM_         // number of stages
+};
+
+//---------------------------------------------------------------------------
+
+// register PETSc log stages (once), reset counters & start profiling
+PetscErrorCode StartupProfInit();
+
+// enter initialization stage (no-op after report)
+PetscErrorCode StartupProfBegin(StartupStage stage);
+
+// leave initialization stage (no-op after report)
+PetscErrorCode StartupProfEnd(StartupStage stage);
+
+// stop profiling, print & save report if requested (collective)
+PetscErrorCode StartupProfReport();
+
+//---------------------------------------------------------------------------
+#endif
@@ -156,7 +156,7 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 			if(isubcell != i)
 			{
 				// clone markers
-				ierr = ADVMarkClone(actx, icell, i, s, h, dist, iclone); CHKERRQ(ierr);
+				ierr = ADVMarkClone(actx, icell, i, s, h, iclone); CHKERRQ(ierr);
 
 				// update counter
 				nclone++;
@@ -169,7 +169,7 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 				// merge markers if required
 				if(ie - ib > actx->npmax)
 				{
-					ierr = ADVMarkCheckMerge(actx, ib, ie, nmerge, mark, cell, iclone, imerge); CHKERRQ(ierr);
+					ierr = ADVMarkCheckMerge(actx, ib, ie, nmerge, mark, dist, cell, iclone, imerge); CHKERRQ(ierr);
 				}
 
 				// switch to next populated subcell
@@ -199,7 +199,6 @@ PetscErrorCode ADVMarkClone(
 	PetscInt         isubcell,
 	PetscScalar      s[3],
 	PetscScalar      h[3],
-	vector <spair>  &dist,
 	vector <Marker> &iclone)
 {
 	// clone closest marker & put it in the center of an empty subcell
@@ -207,7 +206,7 @@ PetscErrorCode ADVMarkClone(
 	//  - all newly created markers are stored for insertion in iclone
 
 	BCCtx            *bc;
-	spair             d;
+	spair             d, dmin;
 	Marker            P;
 	PetscScalar       xc[3], *x;
 	PetscInt          I, J, K, j, npx, npy, imark, nmark, *markind;
@@ -230,27 +229,25 @@ PetscErrorCode ADVMarkClone(
 	COORD_SUBCELL(xc[1], (PetscScalar) J, s[1], h[1]);
 	COORD_SUBCELL(xc[2], (PetscScalar) K, s[2], h[2]);
 
-	// clear distance storage
-	dist.clear();
-
 	// find closest marker (cell-wise approximation)
+	dmin.first  = DBL_MAX;
+	dmin.second = -1;
+
 	for(j = 0; j < nmark; j++)
 	{
 		// get marker index & coordinates
 		imark = markind[j];
 		x     = actx->markers[imark].X;
 
-		// store marker and distance
+		// update closest marker and distance
 		d.first  = EDIST(x, xc);
 		d.second = imark;
-		dist.push_back(d);
-	}
 
-	// sort markers by distance
-	sort(dist.begin(), dist.end());
+		if(d < dmin) dmin = d;
+	}
 
 	// clone closest marker
-	P = actx->markers[dist.begin()->second];
+	P = actx->markers[dmin.second];
 
 	// place clone in cell center
 	P.X[0] = xc[0];
@@ -272,6 +269,7 @@ PetscErrorCode ADVMarkCheckMerge(
 	PetscInt           ie,
 	PetscInt          &nmerge,
 	vector <Marker>   &mark,
+	vector <spair>    &dist,
 	vector <ipair>    &cell,
 	vector <Marker>   &iclone,
 	vector <PetscInt> &imerge)
@@ -323,7 +321,7 @@ PetscErrorCode ADVMarkCheckMerge(
 			}
 
 			// merge markers
-			ierr = ADVMarkMerge(mark, nmark, actx->npmax, sz); CHKERRQ(ierr);
+			ierr = ADVMarkMerge(mark, dist, nmark, actx->npmax, sz); CHKERRQ(ierr);
 
 			// update counter
 			nmerge += nmark - actx->npmax;
@@ -357,16 +355,20 @@ PetscErrorCode ADVMarkCheckMerge(
 //---------------------------------------------------------------------------
 PetscErrorCode ADVMarkMerge(
 	vector <Marker> &mark,
+	vector <spair>  &dist,
 	PetscInt         nmark,
 	PetscInt         npmax,
 	PetscInt        &sz)
 {
 	// recursively find and merge closest markers until required number is reached
 	// put new markers in the end of the storage, mark merged markers with phase -1
+	// closest pairs are taken from a heap of pair distances (invalid pairs are skipped lazily),
+	// pair key j*nmax + k reproduces lexicographic tie-breaking of an exhaustive search
 
 	Marker       P;
-	PetscInt     j, k, jmin, kmin;
-	PetscScalar  d, dmin;
+	PetscInt     j, k, jmin, kmin, nmax;
+	PetscScalar  d;
+	spair        t;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -374,31 +376,44 @@ PetscErrorCode ADVMarkMerge(
 	// initialize storage size
 	sz = nmark;
 
-	while(nmark > npmax)
-	{
-		// find closest markers
-		dmin  = DBL_MAX;
-		jmin  = 0;
-		kmin  = 0;
+	if(nmark <= npmax) PetscFunctionReturn(0);
 
-		for(j = 0; j < sz; j++)
+	// maximum storage size
+	nmax = 2*nmark - npmax;
+
+	// compute distances between all pairs of markers
+	dist.clear();
+
+	for(j = 0; j < sz; j++)
+	{
+		for(k = j+1; k < sz; k++)
 		{
-			if(mark[j].phase == -1) continue;
+			d        = EDIST(mark[j].X, mark[k].X);
+			t.first  = d;
+			t.second = j*nmax + k;
+			dist.push_back(t);
+		}
+	}
 
-			for(k = j+1; k < sz; k++)
+	make_heap(dist.begin(), dist.end(), greater<spair>());
+
+	while(nmark > npmax)
+	{
+		// find closest markers that are not merged yet
+		do
+		{
+			if(dist.empty())
 			{
-				if(mark[k].phase == -1) continue;
+				SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Marker merge heap is empty");
+			}
 
-				d = EDIST(mark[j].X, mark[k].X);
+			jmin = dist.front().second / nmax;
+			kmin = dist.front().second % nmax;
 
-				if(d < dmin)
-				{
-					dmin = d;
-					jmin = j;
-					kmin = k;
-				}
-			}
-		}
+			pop_heap(dist.begin(), dist.end(), greater<spair>());
+			dist.pop_back();
+
+		} while(mark[jmin].phase == -1 || mark[kmin].phase == -1);
 
 		// merge closest markers
 		ierr = MarkerMerge(mark[jmin], mark[kmin], P); CHKERRQ(ierr);
@@ -410,6 +425,18 @@ PetscErrorCode ADVMarkMerge(
 		mark[jmin].phase = -1;
 		mark[kmin].phase = -1;
 
+		// add distances to new marker
+		for(j = 0; j < sz; j++)
+		{
+			if(mark[j].phase == -1) continue;
+
+			d        = EDIST(mark[j].X, mark[sz].X);
+			t.first  = d;
+			t.second = j*nmax + sz;
+			dist.push_back(t);
+			push_heap(dist.begin(), dist.end(), greater<spair>());
+		}
+
 		// update counters
 		nmark--;
 		sz++;
@@ -423,7 +450,7 @@ PetscErrorCode ADVCollectGarbageVec(AdvCtx *actx, vector <Marker> &recvbuf, vect
 	// rearrange storage after marker resampling
 
 	Marker   *markers;
-	PetscInt  nummark, nrecv, ndel;
+	PetscInt *cellnum, nummark, nrecv, ndel;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -431,13 +458,16 @@ PetscErrorCode ADVCollectGarbageVec(AdvCtx *actx, vector <Marker> &recvbuf, vect
 	// access storage
 	nummark = actx->nummark;
 	markers = actx->markers;
+	cellnum = actx->cellnum;
 	nrecv   = (PetscInt)recvbuf.size();
 	ndel    = (PetscInt)idel.size();
 
 	// close holes in marker storage
+	// (host cells of new markers are unknown)
 	while(nrecv && ndel)
 	{
 		markers[idel[ndel-1]] = recvbuf[nrecv-1];
+		cellnum[idel[ndel-1]] = -1;
 		nrecv--;
 		ndel--;
 	}
@@ -449,10 +479,12 @@ PetscErrorCode ADVCollectGarbageVec(AdvCtx *actx, vector <Marker> &recvbuf, vect
 
 		// make sure we have a correct storage pointer
 		markers = actx->markers;
+		cellnum = actx->cellnum;
 
 		// put the rest in the end of marker storage
 		while(nrecv)
 		{
+			cellnum[nummark]   = -1;
 			markers[nummark++] = recvbuf[nrecv-1];
 			nrecv--;
 		}
@@ -466,6 +498,7 @@ PetscErrorCode ADVCollectGarbageVec(AdvCtx *actx, vector <Marker> &recvbuf, vect
 			if(idel[ndel-1] != nummark-1)
 			{
 				markers[idel[ndel-1]] = markers[nummark-1];
+				cellnum[idel[ndel-1]] = cellnum[nummark-1];
 			}
 			nummark--;
 			ndel--;
@@ -751,6 +784,7 @@ PetscErrorCode ADVGetSedPhase(AdvCtx *actx, Vec vphase)
 	Marker   P;
 	PetscInt nmark = 5, npmax = 2, sz;
 	vector   <Marker> mark;
+	vector   <spair>  dist;
 	mark.reserve(_mark_buff_sz_);
 	mark.clear();
 	PetscMemzero(&P, sizeof(Marker));
@@ -759,7 +793,7 @@ PetscErrorCode ADVGetSedPhase(AdvCtx *actx, Vec vphase)
 	P.phase = 1; P.X[0] = 3; P.X[1] = 4; P.X[2] = 0; mark.push_back(P);
 	P.phase = 1; P.X[0] = 4; P.X[1] = 3; P.X[2] = 0; mark.push_back(P);
 	P.phase = 1; P.X[0] = 5; P.X[1] = 5; P.X[2] = 0; mark.push_back(P);
-	ierr = ADVMarkMerge(mark, nmark, npmax, sz); CHKERRQ(ierr);
+	ierr = ADVMarkMerge(mark, dist, nmark, npmax, sz); CHKERRQ(ierr);
 
 	AdvCtx actx;
 	Marker  P;
@@ -777,6 +811,7 @@ PetscErrorCode ADVGetSedPhase(AdvCtx *actx, Vec vphase)
 	vector <PetscInt> imerge;
 	vector <ipair>    cell;
 	vector <Marker>   mark;
+	vector <spair>    dist;
 	cell.reserve(_mark_buff_sz_);
 	mark.reserve(_mark_buff_sz_);
 	iclone.reserve(actx.nummark*_mark_buff_ratio_/100);
@@ -792,5 +827,5 @@ PetscErrorCode ADVGetSedPhase(AdvCtx *actx, Vec vphase)
 	t.first = 0; t.second = 2; cell.push_back(t);
 	t.first = 0; t.second = 3; cell.push_back(t);
 	t.first = 0; t.second = 4; cell.push_back(t);
-	ierr = ADVMarkCheckMerge(&actx, ib, ie, nmerge, mark, cell, iclone, imerge); CHKERRQ(ierr);
+	ierr = ADVMarkCheckMerge(&actx, ib, ie, nmerge, mark, dist, cell, iclone, imerge); CHKERRQ(ierr);
 */
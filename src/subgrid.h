@@ -29,7 +29,6 @@ PetscErrorCode ADVMarkClone(
 	PetscInt         isubcell,
 	PetscScalar     *s,
 	PetscScalar     *h,
-	vector <spair>  &dist,
 	vector <Marker> &iclone);
 
 // merge markers in a densely populated subcell
@@ -39,6 +38,7 @@ PetscErrorCode ADVMarkCheckMerge(
 	PetscInt           ie,
 	PetscInt          &nmerge,
 	vector <Marker>   &mark,
+	vector <spair>    &dist,
 	vector <ipair>    &cell,
 	vector <Marker>   &iclone,
 	vector <PetscInt> &imerge);
@@ -46,6 +46,7 @@ PetscErrorCode ADVMarkCheckMerge(
 // recursively find and merge closest markers until required number is reached
 PetscErrorCode ADVMarkMerge(
 	vector <Marker> &mark,
+	vector <spair>  &dist,
 	PetscInt         nmark,
 	PetscInt         npmax,
 	PetscInt        &sz);
@@ -220,6 +220,76 @@ PetscErrorCode FreeSurfWriteRestart(FreeSurf *surf, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode FreeSurfWriteRestartPortable(FreeSurf *surf, PetscViewer viewer)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// free surface cases only
+	if(!surf->UseFreeSurf) PetscFunctionReturn(0);
+
+	// store topography vector in natural ordering (one layer per z-process)
+	ierr = VecView(surf->gtopo, viewer); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FreeSurfReadRestartPortable(FreeSurf *surf, PetscViewer viewer)
+{
+	// topography is stored redundantly for every z-process of the saving run,
+	// read the entire vector on all ranks and copy the first layer to the local part
+
+	FDSTAG      *fs;
+	PetscInt     tr[2], Nx, Ny, L, i, j, sx, sy, sz, nx, ny;
+	PetscScalar  ***topo, *buff;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// free surface cases only
+	if(!surf->UseFreeSurf) PetscFunctionReturn(0);
+
+	fs = surf->jr->fs;
+	L  = (PetscInt)fs->dsz.rank;
+	Nx = fs->dsx.tnods;
+	Ny = fs->dsy.tnods;
+
+	// read vector header (class id & global size)
+	ierr = PetscViewerBinaryRead(viewer, tr, 2, NULL, PETSC_INT); CHKERRQ(ierr);
+
+	if(tr[1] < Nx*Ny || tr[1] % (Nx*Ny))
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Restart topography size does not match input file\n");
+	}
+
+	ierr = makeScalArray(&buff, NULL, tr[1]); CHKERRQ(ierr);
+
+	ierr = PetscViewerBinaryRead(viewer, buff, tr[1], NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+	// set local part of topography
+	ierr = DMDAVecGetArray(surf->DA_SURF, surf->gtopo, &topo); CHKERRQ(ierr);
+
+	ierr = DMDAGetCorners(fs->DA_COR, &sx, &sy, &sz, &nx, &ny, NULL); CHKERRQ(ierr);
+
+	START_PLANE_LOOP
+	{
+		topo[L][j][i] = buff[j*Nx + i];
+	}
+	END_PLANE_LOOP
+
+	ierr = DMDAVecRestoreArray(surf->DA_SURF, surf->gtopo, &topo); CHKERRQ(ierr);
+
+	ierr = PetscFree(buff); CHKERRQ(ierr);
+
+	// get ghosted topography vector
+	GLOBAL_TO_LOCAL(surf->DA_SURF, surf->gtopo, surf->ltopo);
+
+	// update average topography
+	ierr = FreeSurfGetAvgTopo(surf); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode FreeSurfDestroy(FreeSurf *surf)
 {
 	PetscErrorCode ierr;
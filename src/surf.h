@@ -76,6 +76,11 @@ PetscErrorCode FreeSurfReadRestart(FreeSurf *surf, FILE *fp);
 
 PetscErrorCode FreeSurfWriteRestart(FreeSurf *surf, FILE *fp);
 
+// partition-independent restart (topography in natural ordering)
+PetscErrorCode FreeSurfWriteRestartPortable(FreeSurf *surf, PetscViewer viewer);
+
+PetscErrorCode FreeSurfReadRestartPortable(FreeSurf *surf, PetscViewer viewer);
+
 PetscErrorCode FreeSurfDestroy(FreeSurf *surf);
 
 // advect topography on the free surface mesh
@@ -10,10 +10,15 @@
 //---------------------------------------------------------------------------
 // ........................... UTILITY FUNCTIONS ............................
 //---------------------------------------------------------------------------
+#include <thread>   // before LaMEM headers (min/max macros)
 #include "LaMEM.h"
 #include "tools.h"
 #include <unistd.h>
 
+//---------------------------------------------------------------------------
+// number of worker threads per processor
+static PetscInt numThreads = 1;
+
 //---------------------------------------------------------------------------
 // Printing functions
 //---------------------------------------------------------------------------
@@ -369,6 +374,126 @@ PetscErrorCode DirCheck(const char *name, PetscInt *exists)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode FileCheck(const char *name, PetscInt *exists)
+{
+	struct stat s;
+	int         status;
+	PetscInt    check;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// check file on rank zero
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		status = stat(name, &s);
+
+		// check whether file exists and is a regular file
+		check = (!status && S_ISREG(s.st_mode));
+	}
+
+	// synchronize
+	if(ISParallel(PETSC_COMM_WORLD))
+	{
+		ierr = MPI_Bcast(&check, 1, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	}
+
+	(*exists) = check;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+// Worker threads for local loops
+//---------------------------------------------------------------------------
+PetscErrorCode ThreadSetNum()
+{
+	PetscInt  nt;
+	PetscBool found;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	nt = 1;
+
+	ierr = PetscOptionsGetInt(NULL, NULL, "-nthreads", &nt, &found); CHKERRQ(ierr);
+
+	if(nt < 1)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Number of threads must be positive (nthreads)");
+	}
+
+	numThreads = nt;
+
+	if(numThreads > 1)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "Worker threads per processor    : %lld \n", (LLD)numThreads);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscInt ThreadGetNum()
+{
+	return numThreads;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ThreadFor(PetscInt n, PetscInt grain, const std::function<void(PetscInt, PetscInt, PetscInt)> &body)
+{
+	// split index range in contiguous chunks, calling thread processes the first one
+
+	PetscInt                 nt, t, beg, end, chunk;
+	std::vector<std::thread> workers;
+
+	PetscFunctionBeginUser;
+
+	if(n <= 0) PetscFunctionReturn(0);
+
+	if(grain < 1) grain = 1;
+
+	// number of threads with enough work
+	nt = numThreads;
+
+	if(nt > n/grain) nt = n/grain;
+
+	if(nt <= 1)
+	{
+		body(0, n, 0);
+
+		PetscFunctionReturn(0);
+	}
+
+	chunk = (n + nt - 1)/nt;
+
+	try
+	{
+		workers.reserve((size_t)(nt-1));
+
+		for(t = 1; t < nt; t++)
+		{
+			beg = t*chunk;
+			end = beg + chunk; if(end > n) end = n;
+
+			if(beg >= end) break;
+
+			workers.emplace_back(body, beg, end, t);
+		}
+	}
+	catch(const std::exception &e)
+	{
+		for(auto &w : workers) w.join();
+
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_MEM, "Cannot start worker thread: %s", e.what());
+	}
+
+	end = chunk; if(end > n) end = n;
+
+	body(0, end, 0);
+
+	for(auto &w : workers) w.join();
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 // Fast detection points inside a polygonal region.
 //
 // Originally written as a MATLAB mexFunction by:
@@ -432,6 +557,95 @@ void polygon_box(
 	(*pnv)  = nv;        // number of vertices
 }
 //---------------------------------------------------------------------------
+PetscInt polygon_edge_test(
+	PetscInt     iv,         // edge index (from vertex iv to vertex iv+1)
+	PetscInt     nv,         // number of polygon vertices
+	PetscScalar *vcoord,     // coordinates of polygon vertices
+	PetscScalar  xp,         // test point coordinates
+	PetscScalar  yp,
+	PetscScalar  atol,       // absolute tolerance
+	PetscScalar *nIntersect) // number of intersections (updated)
+{
+	// test intersection of a polygon edge with the vertical ray from a point
+	// return 1 if point is on the edge
+
+	PetscInt    ind;
+	PetscScalar ax, bx, ay, by;
+	PetscScalar intersecty, tmp, xvind;
+
+	// does the line PQ intersect the line AB?
+	if(iv == nv-1)
+	{
+		ax = vcoord[2*(nv-1)  ];
+		ay = vcoord[2*(nv-1)+1];
+		bx = vcoord[0         ];
+		by = vcoord[1         ];
+	}
+	else
+	{
+		ax = vcoord[2*iv      ];
+		ay = vcoord[2*iv+1    ];
+		bx = vcoord[2*(iv+1)  ];
+		by = vcoord[2*(iv+1)+1];
+	}
+
+	if(ax == bx)
+	{
+		// vertical points
+		if(xp == ax)
+		{
+			// ensure order correct
+			if(ay > by)
+			{
+				tmp = ay; ay = by; by = tmp;
+			}
+			if(yp >= ay && yp <= by)
+			{
+				return 1;
+			}
+		}
+	}
+	else
+	{
+		// non-vertical points
+		if(xp < PetscMin(ax, bx) || PetscMax(ax, bx) < xp) return 0;
+
+		intersecty = ay + (xp - ax)/(bx - ax)*(by - ay);
+
+		if(fabs(intersecty - yp) < atol)
+		{
+			return 1;
+		}
+		else if(intersecty < yp && (ax == xp || bx == xp))
+		{
+			if(ax == xp)
+			{
+				if(iv == 0)
+				{
+					ind = nv-1;
+				}
+				else
+				{
+					ind = iv-1;
+				}
+
+				xvind = vcoord[2*ind];
+
+				if(PetscMin(bx, xvind) < xp && xp < PetscMax(bx, xvind))
+				{
+					(*nIntersect) += 1.0;
+				}
+			}
+		}
+		else if (intersecty < yp)
+		{
+			(*nIntersect) += 1.0;
+		}
+	}
+
+	return 0;
+}
+//---------------------------------------------------------------------------
 void in_polygon(
 	PetscInt     np,     // number of test points
 	PetscScalar *pcoord, // coordinates of test points
@@ -441,11 +655,10 @@ void in_polygon(
 	PetscScalar  atol,   // absolute tolerance
 	PetscInt    *in)     // point location flags (1-inside, 0-outside)
 {
-	PetscInt    ip, iv, ind;
+	PetscInt    ip, iv;
 	PetscInt    point_on, point_in;
-	PetscScalar ax, bx, ay, by;
-	PetscScalar nIntersect, intersecty, tmp;
-	PetscScalar xmin, xmax, ymin, ymax, xp, yp, xvind;
+	PetscScalar nIntersect;
+	PetscScalar xmin, xmax, ymin, ymax, xp, yp;
 
 	// get bounding box
 	xmin = box[0];
@@ -475,78 +688,141 @@ void in_polygon(
 
 		for(iv = 0; iv < nv; iv++)
 		{
-			// does the line PQ intersect the line AB?
-			if(iv == nv-1)
+			if(polygon_edge_test(iv, nv, vcoord, xp, yp, atol, &nIntersect))
 			{
-				ax = vcoord[2*(nv-1)  ];
-				ay = vcoord[2*(nv-1)+1];
-				bx = vcoord[0         ];
-				by = vcoord[1         ];
+				point_on   = 1;
+				nIntersect = 0.0;
+				break;
 			}
-			else
+		}
+
+		// check if the contour polygon is closed
+		point_in = (PetscInt)(nIntersect - 2.0*floor(nIntersect/2.0));
+		in[ip]   = PetscMax(point_on, point_in);
+	}
+}
+//---------------------------------------------------------------------------
+PetscErrorCode polygon_buckets(
+	PetscInt     nv,     // number of polygon vertices
+	PetscScalar *vcoord, // coordinates of polygon vertices
+	PetscScalar *box,    // bounding box of a polygon
+	PetscInt     nb,     // number of buckets
+	PetscInt    *bstart, // start of edge list in every bucket (size nb+1)
+	PetscInt   **bedge,  // edge lists (grow-only storage)
+	PetscInt    *bcap)   // capacity of edge lists
+{
+	// sort polygon edges into uniform buckets along the x-axis
+	// every edge is listed in all buckets overlapped by its x-range (in ascending order)
+
+	PetscInt    iv, ib, ie, jb, sz, pass, *cnt;
+	PetscScalar ax, bx;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	cnt = NULL;
+
+	for(pass = 0; pass < 2; pass++)
+	{
+		if(!pass)
+		{
+			ierr = PetscMemzero(bstart, (size_t)(nb+1)*sizeof(PetscInt)); CHKERRQ(ierr);
+		}
+
+		for(iv = 0; iv < nv; iv++)
+		{
+			ax = vcoord[2*iv];
+			bx = vcoord[2*((iv+1) % nv)];
+
+			ib = polygon_bucket(PetscMin(ax, bx), box, nb);
+			ie = polygon_bucket(PetscMax(ax, bx), box, nb);
+
+			for(jb = ib; jb <= ie; jb++)
 			{
-				ax = vcoord[2*iv      ];
-				ay = vcoord[2*iv+1    ];
-				bx = vcoord[2*(iv+1)  ];
-				by = vcoord[2*(iv+1)+1];
+				if(!pass) bstart[jb+1]++;
+				else      (*bedge)[cnt[jb]++] = iv;
 			}
+		}
+
+		if(!pass)
+		{
+			for(jb = 0; jb < nb; jb++) bstart[jb+1] += bstart[jb];
 
-			if(ax == bx)
+			// make sure space is enough
+			sz = bstart[nb];
+
+			if(sz > (*bcap))
 			{
-				// vertical points
-				if(xp == ax)
-				{
-					// ensure order correct
-					if(ay > by)
-					{
-						tmp = ay; ay = by; by = tmp;
-					}
-					if(yp >= ay && yp <= by)
-					{
-						point_on   = 1;
-						nIntersect = 0.0;
-						break;
-					}
-				}
+				ierr = PetscFree(*bedge); CHKERRQ(ierr);
+
+				(*bcap) = (PetscInt)(_cap_overhead_*(PetscScalar)sz);
+
+				ierr = PetscMalloc((size_t)(*bcap)*sizeof(PetscInt), bedge); CHKERRQ(ierr);
 			}
-			else
-			{
-				// non-vertical points
-				if(xp < PetscMin(ax, bx) || PetscMax(ax, bx) < xp) continue;
 
-				intersecty = ay + (xp - ax)/(bx - ax)*(by - ay);
+			ierr = makeIntArray(&cnt, bstart, nb); CHKERRQ(ierr);
+		}
+	}
 
-				if(fabs(intersecty - yp) < atol)
-				{
-					point_on   = 1;
-					nIntersect = 0.0;
-					break;
-				}
-				else if(intersecty < yp && (ax == xp || bx == xp))
-				{
-					if(ax == xp)
-					{
-						if(iv == 0)
-						{
-							ind = nv-1;
-						}
-						else
-						{
-							ind = iv-1;
-						}
-
-						xvind = vcoord[2*ind];
-
-						if(PetscMin(bx, xvind) < xp && xp < PetscMax(bx, xvind))
-						{
-							nIntersect += 1.0;
-						}
-					}
-				}
-				else if (intersecty < yp)
-				{
-					nIntersect += 1.0;
-				}
+	ierr = PetscFree(cnt); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void in_polygon_buckets(
+	PetscInt     np,     // number of test points
+	PetscScalar *pcoord, // coordinates of test points
+	PetscInt     nv,     // number of polygon vertices
+	PetscScalar *vcoord, // coordinates of polygon vertices
+	PetscScalar *box,    // bounding box of a polygon (optimization)
+	PetscScalar  atol,   // absolute tolerance
+	PetscInt     nb,     // number of buckets
+	PetscInt    *bstart, // start of edge list in every bucket
+	PetscInt    *bedge,  // edge lists
+	PetscInt    *in)     // point location flags (1-inside, 0-outside)
+{
+	// same as in_polygon, but only edges overlapping the bucket of a point are tested
+
+	PetscInt    ip, jb, jj;
+	PetscInt    point_on, point_in;
+	PetscScalar nIntersect;
+	PetscScalar xmin, xmax, ymin, ymax, xp, yp;
+
+	// get bounding box
+	xmin = box[0];
+	xmax = box[1];
+	ymin = box[2];
+	ymax = box[3];
+
+	// test whether each point is in polygon
+	for(ip = 0; ip < np; ip++)
+	{
+		// assume point is outside
+		in[ip] = 0;
+
+		// get point coordinates
+		xp = pcoord[2*ip    ];
+		yp = pcoord[2*ip + 1];
+
+		// check bounding box
+		if(xp < xmin) continue;
+		if(xp > xmax) continue;
+		if(yp < ymin) continue;
+		if(yp > ymax) continue;
+
+		// count the number of intersections
+		nIntersect = 0.0;
+		point_on   = 0;
+
+		jb = polygon_bucket(xp, box, nb);
+
+		for(jj = bstart[jb]; jj < bstart[jb+1]; jj++)
+		{
+			if(polygon_edge_test(bedge[jj], nv, vcoord, xp, yp, atol, &nIntersect))
+			{
+				point_on   = 1;
+				nIntersect = 0.0;
+				break;
 			}
 		}
 
@@ -83,6 +83,30 @@ PetscErrorCode DirRename(const char *old_name, const char *new_name);
 
 PetscErrorCode DirCheck(const char *name, PetscInt *exists);
 
+PetscErrorCode FileCheck(const char *name, PetscInt *exists);
+
+//---------------------------------------------------------------------------
+// Worker threads for local loops
+//---------------------------------------------------------------------------
+
+// Number of threads per processor is set with -nthreads (default 1, loops
+// run on the calling thread). Loop bodies must not call PETSc or MPI
+// functions: PETSc stack & error handling are not thread-safe. Bodies
+// handle contiguous chunks [beg, end) of the index range, tid is the
+// thread index (0 ... number of threads - 1) to select private storage.
+
+// minimum number of markers per worker thread
+#define _thread_grain_ 1024
+
+// read number of worker threads (-nthreads)
+PetscErrorCode ThreadSetNum();
+
+// get number of worker threads
+PetscInt ThreadGetNum();
+
+// run body(beg, end, tid) on [0, n), at least grain indices per thread
+PetscErrorCode ThreadFor(PetscInt n, PetscInt grain, const std::function<void(PetscInt, PetscInt, PetscInt)> &body);
+
 //---------------------------------------------------------------------------
 // Numerical functions
 //---------------------------------------------------------------------------
@@ -125,6 +149,51 @@ void in_polygon(
 	PetscScalar  atol,   // absolute tolerance
 	PetscInt    *in);    // point location flags (1-inside, 0-outside)
 
+PetscInt polygon_edge_test(
+	PetscInt     iv,          // edge index (from vertex iv to vertex iv+1)
+	PetscInt     nv,          // number of polygon vertices
+	PetscScalar *vcoord,      // coordinates of polygon vertices
+	PetscScalar  xp,          // test point coordinates
+	PetscScalar  yp,
+	PetscScalar  atol,        // absolute tolerance
+	PetscScalar *nIntersect); // number of intersections (updated)
+
+PetscErrorCode polygon_buckets(
+	PetscInt     nv,     // number of polygon vertices
+	PetscScalar *vcoord, // coordinates of polygon vertices
+	PetscScalar *box,    // bounding box of a polygon
+	PetscInt     nb,     // number of buckets
+	PetscInt    *bstart, // start of edge list in every bucket (size nb+1)
+	PetscInt   **bedge,  // edge lists (grow-only storage)
+	PetscInt    *bcap);  // capacity of edge lists
+
+void in_polygon_buckets(
+	PetscInt     np,     // number of test points
+	PetscScalar *pcoord, // coordinates of test points
+	PetscInt     nv,     // number of polygon vertices
+	PetscScalar *vcoord, // coordinates of polygon vertices
+	PetscScalar *box,    // bounding box of a polygon (optimization)
+	PetscScalar  atol,   // absolute tolerance
+	PetscInt     nb,     // number of buckets
+	PetscInt    *bstart, // start of edge list in every bucket
+	PetscInt    *bedge,  // edge lists
+	PetscInt    *in);    // point location flags (1-inside, 0-outside)
+
+// bucket index of x-coordinate (monotonic, clamped to valid range)
+static inline PetscInt polygon_bucket(PetscScalar x, PetscScalar *box, PetscInt nb)
+{
+	PetscInt ib;
+
+	if(box[1] <= box[0]) return 0;
+
+	ib = (PetscInt)((x - box[0])/(box[1] - box[0])*(PetscScalar)nb);
+
+	if(ib < 0)      ib = 0;
+	if(ib > nb - 1) ib = nb - 1;
+
+	return ib;
+}
+
 //---------------------------------------------------------------------------
 // Polygon stretching functions
 //---------------------------------------------------------------------------
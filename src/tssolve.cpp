@@ -52,14 +52,16 @@ PetscErrorCode TSSolCreate(TSSol *ts, FB *fb)
 	ierr = getIntParam   (fb, _OPTIONAL_, "nstep_out",       &ts->nstep_out,  1,               -1  );          CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "nstep_ini",       &ts->nstep_ini,  1,               -1  );          CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "nstep_rdb",       &ts->nstep_rdb,  1,               -1  );          CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "rdb_portable",    &ts->rdb_portable, 1,             1   );          CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "rdb_async",       &ts->rdb_async,  1,               1   );          CHKERRQ(ierr);
 	ierr = getScalarParam(fb, _OPTIONAL_, "time_tol",        &ts->tol,        1,               1.0 );          CHKERRQ(ierr);
 
-	if(ts->CFL < 0.0 && ts->CFL > 1.0)
+	if(ts->CFL < 0.0 || ts->CFL > 1.0)
 	{
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "CFL parameter must be between 0 and 1");
 	}
 
-	if(ts->CFLMAX < 0.0 && ts->CFLMAX > 1.0)
+	if(ts->CFLMAX < 0.0 || ts->CFLMAX > 1.0)
 	{
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "CFLMAX parameter must be between 0 and 1");
 	}
@@ -69,6 +71,16 @@ PetscErrorCode TSSolCreate(TSSol *ts, FB *fb)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "CFL parameter should be smaller than CFLMAX");
 	}
 
+	if(ts->rdb_portable && ts->rdb_async)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Asynchronous checkpointing (rdb_async) is not available for partition-independent restart (rdb_portable)");
+	}
+
+#if defined(_WIN32)
+	// memory streams are not available
+	ts->rdb_async = 0;
+#endif
+
 	if(!ts->time_end && !ts->nstep_max)
 	{
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Define at least one of the parameters: time_end, nstep_max");
@@ -110,6 +122,8 @@ PetscErrorCode TSSolCreate(TSSol *ts, FB *fb)
 	if(ts->nstep_out) PetscPrintf(PETSC_COMM_WORLD, "   Output every [n] steps       : %lld \n", (LLD)ts->nstep_out);
 	if(ts->nstep_ini) PetscPrintf(PETSC_COMM_WORLD, "   Output [n] initial steps     : %lld \n", (LLD)ts->nstep_ini);
 	if(ts->nstep_rdb) PetscPrintf(PETSC_COMM_WORLD, "   Save restart every [n] steps : %lld \n", (LLD)ts->nstep_rdb);
+	if(ts->nstep_rdb && ts->rdb_portable) PetscPrintf(PETSC_COMM_WORLD, "   Partition-independent restart @ \n");
+	if(ts->nstep_rdb && ts->rdb_async)    PetscPrintf(PETSC_COMM_WORLD, "   Asynchronous checkpointing    @ \n");
 
 	PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
 
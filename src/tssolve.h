@@ -43,6 +43,8 @@ struct TSSol
 	PetscInt    nstep_out;                 // save output every n steps
 	PetscInt    nstep_ini;                 // save output for n initial steps
 	PetscInt    nstep_rdb;                 // save restart database every n steps
+	PetscInt    rdb_portable;              // save partition-independent restart database
+	PetscInt    rdb_async;                 // write restart database in the background
 	PetscInt    fix_dt;                    // flag to keep time steps fixed for advection (elasticity, kinematic block BC)
 	PetscInt    istep;                     // time step counter
 };
@@ -6,6 +6,7 @@ using Test
 using GeophysicalModelGenerator
 using LaMEM.IO_functions
 using CairoMakie
+using JSON
 using LaMEM.LaMEM_jll.PETSc_jll
 
 if "use_dynamic_lib" in ARGS
@@ -22,7 +23,10 @@ else
     test_superlu=true
 end
 
-@show use_dynamic_lib test_superlu test_mumps
+# output compression tests require LaMEM compiled with zlib=1
+test_zlib = "zlib" in ARGS
+
+@show use_dynamic_lib test_superlu test_mumps test_zlib
 
 test_dir = pwd()
 
@@ -676,6 +680,24 @@ end
     # Test dike feature using optimized LaMEM
     @test perform_lamem_test(dir,"PhaseTransNotInAirBox_move.dat","PhaseTransNotInAirBox_move.expected",
                             keywords=keywords, accuracy=acc, cores=2, opt=true, mpiexec=mpiexec)
+
+    # Phases must be bit-identical whether transitions are skipped in cells that
+    # cannot cross them (default) or evaluated on every marker:
+    bin_dir = joinpath(test_dir,"../bin");
+    cd(dir)
+    @test run_lamem_local_test(ParamFile, 1, "-nstep_max 10 -out_file_name Cull",
+                            outfile="cull.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    @test run_lamem_local_test(ParamFile, 1, "-nstep_max 10 -out_file_name NoCull -phase_trans_nocull",
+                            outfile="nocull.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+    cd(test_dir)
+
+    data_cull,   _ = Read_LaMEM_timestep("Cull",   10, dir);
+    data_nocull, _ = Read_LaMEM_timestep("NoCull", 10, dir);
+
+    @test data_cull.fields.phase == data_nocull.fields.phase
+
+    clean_test_directory(dir)
 end
 
 
@@ -788,6 +810,46 @@ end
     # t21_Passive_Tracer_Condition
     @test perform_lamem_test(dir,"Passive_tracer_ex2D_Condition.dat","Passive_tracer-2D_Condition_p1.expected",
                             keywords=keywords, accuracy=acc, cores=1, opt=true, mpiexec=mpiexec)
+
+    # test_c
+    # tracer IDs (keys of the time series file) must be unique for a 3D tracer grid with nx != ny
+    bin_dir = joinpath(test_dir,"../bin");
+    cd(dir)
+    @test run_lamem_local_test("Passive_tracer_ex2D.dat", 1, "-out_file_name PtrKeys -nstep_max 1 -nstep_out 1 -PassiveTracer_Resolution 20,3,10",
+                            outfile="ptr_keys.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    blocks = read_lamem_ptr_series("PtrKeys_passive_tracers.series.dat")
+    cd(test_dir)
+
+    @test length(blocks) >= 1
+    for (_, ID, _) in blocks
+        @test length(ID) == 20*3*10
+        @test sort(ID) == collect(0:20*3*10-1)
+    end
+
+    # test_d
+    # tracers distributed over 4 ranks (owned by the rank of their cell) must follow the same paths as on 1 rank
+    cd(dir)
+    @test run_lamem_local_test("Passive_tracer_ex2D.dat", 1, "-out_file_name PtrSerial -nstep_max 3 -nstep_out 1",
+                            outfile="ptr_serial.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    @test run_lamem_local_test("Passive_tracer_ex2D.dat", 4, "-out_file_name PtrParallel -nstep_max 3 -nstep_out 1",
+                            outfile="ptr_parallel.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    serial   = read_lamem_ptr_series("PtrSerial_passive_tracers.series.dat")
+    parallel = read_lamem_ptr_series("PtrParallel_passive_tracers.series.dat")
+    cd(test_dir)
+
+    @test length(serial) == length(parallel)
+    for ((t1, ID1, d1), (t2, ID2, d2)) in zip(serial, parallel)
+        i1 = sortperm(ID1)
+        i2 = sortperm(ID2)
+        @test t1 ≈ t2
+        @test ID1[i1] == ID2[i2]
+        @test isapprox(d1[3:5, i1], d2[3:5, i2], rtol=1e-6, atol=1e-6)
+    end
+
+    clean_test_directory(dir)
 end
 
 @testset "t22_RidgeGeom" begin
@@ -974,6 +1036,41 @@ end
         @test perform_lamem_test(dir,"geomIO_Hollow.dat","t31_geomIO_Hollow.expected",
                                 keywords=keywords, accuracy=acc, cores=4, opt=true, mpiexec=mpiexec)
     end
+
+    if test_superlu
+        bin_dir = joinpath(test_dir,"../bin");
+        args    = "-time_end 1e-12 -save_mark 2"
+
+        # distributed polygon input (local slices, MPI-IO) must give the same markers as the single-file input
+        cd(dir)
+        @test run_lamem_local_test("geomIO_Bulky.dat", 4, args*" -poly_distr 0 -mark_save_file ./markers/Single",
+                                outfile="single.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+        @test run_lamem_local_test("geomIO_Bulky.dat", 4, args*" -poly_distr 1 -mark_save_file ./markers/Distr",
+                                outfile="distr.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+        # shared marker file written on 4 ranks must be read back unchanged on 2 ranks
+        @test run_lamem_local_test("geomIO_Bulky.dat", 2, args*" -msetup shared -mark_load_file ./markers/Single -mark_save_file ./markers/Reread",
+                                outfile="reread.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+        cd(test_dir)
+
+        single = read_lamem_markers_shared(joinpath(dir, "markers", "Single.shared.dat"))
+        distr  = read_lamem_markers_shared(joinpath(dir, "markers", "Distr.shared.dat"))
+        reread = read_lamem_markers_shared(joinpath(dir, "markers", "Reread.shared.dat"))
+
+        # same partitioning, markers are stored in the same order
+        @test length(single[1]) == 32^3*27
+        @test all(single .== distr)
+
+        # different partitioning, compare marker sets (sorted by coordinates)
+        isingle = sortperm(collect(zip(single[1], single[2], single[3])))
+        ireread = sortperm(collect(zip(reread[1], reread[2], reread[3])))
+
+        @test length(reread[1]) == length(single[1])
+        @test all(f[isingle] == g[ireread] for (f, g) in zip(single, reread))
+    end
+
+    clean_test_directory(dir)
 end
 
 @testset "t32_BC_velocity" begin
@@ -992,6 +1089,267 @@ end
                             keywords=keywords, accuracy=acc, cores=1, opt=true, mpiexec=mpiexec)
 end
 
+@testset "t33_NoisyLayers" begin
+    cd(test_dir)
+    dir = "t33_NoisyLayers";
+    bin_dir = joinpath(test_dir,"../bin");
+
+    # Phases of layers with random noise must be bit-identical whether markers are
+    # tested only against overlapping primitives (default) or against all of them:
+    cd(dir)
+    @test run_lamem_local_test("NoisyLayers.dat", 1, "-out_file_name Cull",
+                            outfile="cull.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    @test run_lamem_local_test("NoisyLayers.dat", 1, "-out_file_name NoCull -mark_geom_nocull",
+                            outfile="nocull.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+    cd(test_dir)
+
+    data_cull,   _ = Read_LaMEM_timestep("Cull",   0, dir);
+    data_nocull, _ = Read_LaMEM_timestep("NoCull", 0, dir);
+
+    @test data_cull.fields.phase == data_nocull.fields.phase
+
+    # Marker phases must reproduce the original algorithm, which tests every marker against
+    # all primitives in the order of appearance and draws one C library random number per
+    # layer and marker (default seed). Reference is computed here from the stored initial markers:
+    if !Sys.iswindows()
+        cd(dir)
+        @test run_lamem_local_test("NoisyLayers.dat", 1, "-out_file_name Ref -save_mark 1 -mark_save_file ./markers/mdb -time_end 1e-12",
+                                outfile="ref.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+        cd(test_dir)
+
+        X, Y, Z, phase, _ = read_lamem_markers(joinpath(dir, "markers", "mdb.00000000.dat"))
+
+        # primitives in the order of appearance (layers: phase, top, bottom, cosine amplitude, wavelength, noise amplitude)
+        prims = ((1,  -5.0, -10.0, 2.0, 50.0, 0.0),
+                 (2, -20.0, -25.0, 0.0,  1.0, 3.0),
+                 (3, -35.0, -40.0, 0.0,  1.0, 0.0),
+                 :box,
+                 (4, -44.0, -47.0, 0.0,  1.0, 2.0))
+
+        RAND_MAX = 2147483647
+        ccall(:srand, Cvoid, (Cuint,), 1)
+
+        ref  = zeros(Int64, length(X))
+        near = falses(length(X))
+
+        for i in eachindex(X)
+            for p in prims
+                if p == :box
+                    if -10.0 <= X[i] <= 10.0 && -10.0 <= Y[i] <= 10.0 && -32.0 <= Z[i] <= -28.0
+                        ref[i] = 1
+                    end
+                    continue
+                end
+                ph, top, bot, ampl, wl, rampl = p
+                pert  = ampl != 0.0 ? -ampl*cos(2π/wl*X[i]) : 0.0
+                prand = (ccall(:rand, Cint, ())/RAND_MAX - 0.5)*rampl
+                bot   = bot + pert + prand
+                top   = top + pert + prand
+                near[i] |= min(abs(Z[i] - bot), abs(Z[i] - top)) < 1e-6
+                if bot <= Z[i] <= top
+                    ref[i] = ph
+                end
+            end
+        end
+
+        # markers on layer interfaces (up to round-off of stored coordinates) are skipped
+        @test phase[.!near] == ref[.!near]
+        @test count(near) < length(X) ÷ 1000
+    end
+
+    clean_test_directory(dir)
+end
+
+@testset "t34_OutputFormats" begin
+    cd(test_dir)
+    dir = "t34_OutputFormats";
+    bin_dir = joinpath(test_dir,"../bin");
+
+    ParamFile = "FallingBlock_Output.dat";
+    fields    = ("phase", "velocity", "pressure", "j2_dev_stress")
+
+    # reference output (one .vtr file per rank, Float32)
+    cd(dir)
+    @test run_lamem_local_test(ParamFile, 1, "-out_file_name Ref", outfile="ref.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    tdir   = only(glob("Timestep_00000001_*"))
+    ref, _ = read_vtk_appended(joinpath(tdir, "Ref_p00000000.vtr"))
+
+    # single-file output (collective MPI-IO) must contain the global grid and the same fields
+    @test run_lamem_local_test(ParamFile, 2, "-out_file_name Single -out_single_file 1", outfile="single.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    single, _ = read_vtk_appended(joinpath(tdir, "Single.vtr"))
+
+    @test single["x"] ≈ ref["x"]
+    for f in fields
+        @test isapprox(single[vtk_field(single, f)], ref[vtk_field(ref, f)], rtol=1e-4, atol=1e-6)
+    end
+
+    # output view (slice z = 0.5, stride 2 in x and y) must contain the reference values at the selected nodes
+    view, _ = read_vtk_appended(joinpath(tdir, "Ref_slice_p00000000.vtr"))
+    ix = [findfirst(isapprox(x), ref["x"]) for x in view["x"]]
+    iy = [findfirst(isapprox(y), ref["y"]) for y in view["y"]]
+    iz = [findfirst(isapprox(z), ref["z"]) for z in view["z"]]
+    n  = (length(ref["x"]), length(ref["y"]), length(ref["z"]))
+
+    @test ix == collect(1:2:n[1])
+    @test iy == collect(1:2:n[2])
+    @test view["z"] ≈ [0.5]
+    @test view[vtk_field(view, "phase")] == vec(reshape(ref[vtk_field(ref, "phase")], n)[ix, iy, iz])
+    @test view[vtk_field(view, "velocity")] == vec(reshape(ref[vtk_field(ref, "velocity")], (3, n...))[:, ix, iy, iz])
+    @test !haskey(view, vtk_field(ref, "pressure"))
+
+    # 16-bit quantized fields must reproduce Float32 output within half a quantization step (Offset, Scale in .pvtr)
+    @test run_lamem_local_test(ParamFile, 1, "-out_file_name Quant -out_quantize phase,velocity,pressure", outfile="quant.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    quant, _ = read_vtk_appended(joinpath(tdir, "Quant_p00000000.vtr"))
+    _, qattr = read_vtk_appended(joinpath(tdir, "Quant.pvtr"))
+
+    for f in ("phase", "velocity", "pressure")
+        key = vtk_field(qattr, f)
+        off = parse(Float64, qattr[key]["Offset"])
+        scl = parse(Float64, qattr[key]["Scale"])
+        val = off .+ scl.*Float64.(quant[key])
+        rv  = Float64.(ref[vtk_field(ref, f)])
+
+        @test qattr[key]["type"] == "UInt16"
+        @test eltype(quant[key]) == UInt16
+        @test all(abs.(val .- rv) .<= 0.5*scl*(1 + 1e-6) .+ 1e-6*abs.(rv))
+    end
+    @test eltype(quant[vtk_field(quant, "j2_dev_stress")]) == Float32
+
+    # subsampled marker output must be a subset of the full marker output with the same values
+    @test run_lamem_local_test(ParamFile, 1, "-out_file_name Stride -out_mark_stride 4", outfile="stride.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+    @test run_lamem_local_test(ParamFile, 1, "-out_file_name CellMax -out_mark_cell_max 1", outfile="cellmax.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    mark, _ = read_vtk_appended(joinpath(tdir, "Ref_mark_p00000000.vtp"))
+    nmark   = length(mark["Phase"])
+    lookup  = Dict(Tuple(mark["Points"][3i-2:3i]) => mark["Phase"][i] for i in 1:nmark)
+
+    @test nmark == 16^3*8
+
+    for (name, nmin, nmax) in (("Stride", nmark ÷ 5, nmark ÷ 3), ("CellMax", 1, 16^3))
+        sub, _ = read_vtk_appended(joinpath(tdir, name*"_mark_p00000000.vtp"))
+        nsub   = length(sub["Phase"])
+
+        @test nmin <= nsub <= nmax
+        @test all(get(lookup, Tuple(sub["Points"][3i-2:3i]), -1) == sub["Phase"][i] for i in 1:nsub)
+    end
+
+    # AVD phases must not depend on the cached state: step 2 is computed from the cache of step 1 (Ref) or without it (AVD)
+    @test run_lamem_local_test(ParamFile, 1, "-out_file_name AVD -nstep_out 2", outfile="avd.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    tdir2     = only(glob("Timestep_00000002_*"))
+    avd_ref,_ = read_vtk_appended(joinpath(tdir2, "Ref_phase_p000000.vtr"))
+    avd_new,_ = read_vtk_appended(joinpath(tdir2, "AVD_phase_p000000.vtr"))
+    ph        = avd_ref["phase"]
+
+    @test length(avd_ref["x"]) == 16*3 + 1
+    @test length(ph) == (16*3)^3
+    @test all(p -> p in (0, 1), ph)
+    @test isapprox(count(==(1), ph)/length(ph), 0.5^3, atol=0.01)
+    @test avd_new["phase"] == ph
+
+    # zlib compressed output must be smaller and readable by standard VTK readers
+    if test_zlib
+        @test run_lamem_local_test(ParamFile, 1, "-out_file_name Zip -out_compress 6 -out_compressor zlib", outfile="zip.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+        @test filesize(joinpath(tdir, "Zip_p00000000.vtr")) < filesize(joinpath(tdir, "Ref_p00000000.vtr"))
+    end
+    cd(test_dir)
+
+    if test_zlib
+        data_ref, _ = Read_LaMEM_timestep("Ref", 1, dir)
+        data_zip, _ = Read_LaMEM_timestep("Zip", 1, dir)
+
+        @test data_zip.fields.phase == data_ref.fields.phase
+        @test data_zip.fields.pressure == data_ref.fields.pressure
+    end
+
+    clean_test_directory(dir)
+end
+
+@testset "t35_Restart" begin
+    cd(test_dir)
+    dir = "t35_Restart";
+    bin_dir = joinpath(test_dir,"../bin");
+
+    ParamFile = "FallingBlock_Restart.dat";
+
+    # partition-independent restart database is written at step 3 on 2 ranks and loaded on 1 rank,
+    # step 4 must reproduce the output of the uninterrupted run
+    cd(dir)
+    @test run_lamem_local_test(ParamFile, 2, "-out_file_name Portable -rdb_portable 1", outfile="portable.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+    cd(test_dir)
+
+    full, _ = Read_LaMEM_timestep("Portable", 4, dir)
+
+    cd(dir)
+    @test run_lamem_local_test(ParamFile, 1, "-mode restart -out_file_name Portable -rdb_portable 1", outfile="portable_restart.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+    cd(test_dir)
+
+    rest, _ = Read_LaMEM_timestep("Portable", 4, dir)
+
+    @test isapprox(rest.fields.phase, full.fields.phase, rtol=1e-6)
+    @test isapprox(rest.fields.pressure, full.fields.pressure, rtol=1e-4)
+    @test all(isapprox(r, f, rtol=1e-4, atol=1e-8) for (r, f) in zip(rest.fields.velocity, full.fields.velocity))
+
+    clean_test_directory(dir)
+
+    # asynchronous checkpoint at step 3, restart on the same number of ranks
+    cd(dir)
+    @test run_lamem_local_test(ParamFile, 2, "-out_file_name Async -rdb_async 1", outfile="async.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    tdir = only(glob("Timestep_00000004_*"))
+    full = [read_vtk_appended(joinpath(tdir, "Async_p0000000$(i).vtr"))[1] for i in 0:1]
+
+    @test isdir("restart")
+    @test run_lamem_local_test(ParamFile, 2, "-mode restart", outfile="async_restart.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    rest = [read_vtk_appended(joinpath(tdir, "Async_p0000000$(i).vtr"))[1] for i in 0:1]
+    cd(test_dir)
+
+    for (r, f) in zip(rest, full)
+        @test r[vtk_field(r, "phase")] == f[vtk_field(f, "phase")]
+        @test r[vtk_field(r, "velocity")] ≈ f[vtk_field(f, "velocity")]
+        @test r[vtk_field(r, "pressure")] ≈ f[vtk_field(f, "pressure")]
+    end
+
+    clean_test_directory(dir)
+end
+
+@testset "t36_InputCheck" begin
+    cd(test_dir)
+    dir = "t36_InputCheck";
+    bin_dir = joinpath(test_dir,"../bin");
+
+    ParamFile = "FallingBlock_InputCheck.dat";
+
+    # duplicate and unknown parameters are reported as warnings
+    cd(dir)
+    @test run_lamem_local_test(ParamFile, 1, "", outfile="input.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    log = read("input.out", String)
+    @test occursin("WARNING! Duplicate parameter \"nel_x\"", log)
+    @test occursin("WARNING! Unknown or unused parameter \"out_unknown_field\"", log)
+
+    # and abort the run in strict mode
+    @test !run_lamem_local_test(ParamFile, 1, "-input_strict", outfile="strict.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    # startup report must be valid JSON with one entry per executed startup phase
+    @test run_lamem_local_test(ParamFile, 2, "-startup_report_json startup.json", outfile="startup.out", bin_dir=bin_dir, opt=true, mpiexec=mpiexec)
+
+    report = JSON.parsefile("startup.json")
+    @test report["nproc"] == 2
+    @test !isempty(report["stages"])
+    @test all(st["calls"] > 0 && st["time_max"] >= st["time_min"] >= 0 for st in report["stages"])
+    rm("startup.json")
+    cd(test_dir)
+
+    clean_test_directory(dir)
+end
+
 
 end
 
@@ -367,12 +367,122 @@ function clean_test_directory(dir)
     for f in glob("ScalingLaw*.dat")
         rm(f)
     end
+    for f in glob("*.series.dat")
+        rm(f)
+    end
+    for f in glob("restart*")
+        rm(f, force=true, recursive=true)
+    end
     
     cd(cur_dir)  # return to directory       
 
 end
 
 
+"""
+    X, Y, Z, phase, T = read_lamem_markers(fname)
+
+Reads a marker database file written by LaMEM with `save_mark = 1` (PETSc binary format, big-endian),
+markers are returned in the storage order of the processor.
+"""
+function read_lamem_markers(fname::String)
+    data = Vector{Float64}(undef, filesize(fname) ÷ 8)
+    read!(fname, data)
+    data .= ntoh.(data)
+    n    = Int64(data[2])
+    buf  = reshape(data[3:2+5n], 5, n)
+
+    return buf[1,:], buf[2,:], buf[3,:], round.(Int64, buf[4,:]), buf[5,:]
+end
+
+
+"""
+    X, Y, Z, phase, T = read_lamem_markers_shared(fname)
+
+Reads a single shared marker file written by LaMEM with `save_mark = 2` (`<mark_save_file>.shared.dat`, native byte order).
+Markers are returned sorted by buckets, the order within a bucket depends on the partitioning.
+"""
+function read_lamem_markers_shared(fname::String)
+    data = Vector{Float64}(undef, filesize(fname) ÷ 8)
+    read!(fname, data)
+    n    = Int64(data[2])
+    nbt  = Int64(data[3]*data[4]*data[5])
+    pos  = 11 + nbt + 1
+    buf  = reshape(data[pos+1:pos+5n], 5, n)
+
+    return buf[1,:], buf[2,:], buf[3,:], round.(Int64, buf[4,:]), buf[5,:]
+end
+
+
+"""
+    arrays, attrs = read_vtk_appended(fname)
+
+Reads all data arrays of a VTK XML file written by LaMEM with raw appended data (UInt64 headers, native byte order,
+no compression). Returns dictionaries of array values and XML attributes keyed by array name (`"Points"` for unnamed arrays).
+Parallel files (.pvtr, .pvtp) contain no data, only attributes of `PDataArray` entries are returned.
+"""
+function read_vtk_appended(fname::String)
+    bytes  = read(fname)
+    str    = String(copy(bytes))
+    r      = findfirst("<AppendedData", str)
+    header = isnothing(r) ? str : str[1:first(r)-1]
+    base   = isnothing(r) ? 0 : findnext(isequal(UInt8('_')), bytes, last(r))
+    types  = Dict("Float32"=>Float32, "Float64"=>Float64, "Int32"=>Int32, "Int64"=>Int64, "UInt8"=>UInt8, "UInt16"=>UInt16)
+    arrays = Dict{String, Vector}()
+    attrs  = Dict{String, Dict{String, String}}()
+
+    for m in eachmatch(r"<P?DataArray([^>]*)>", header)
+        a    = Dict(x.captures[1] => x.captures[2] for x in eachmatch(r"(\w+)\s*=\s*\"([^\"]*)\"", m.captures[1]))
+        name = get(a, "Name", "Points")
+
+        attrs[name] = a
+
+        haskey(a, "offset") || continue
+
+        pos = base + parse(Int64, a["offset"])
+        nb  = Int64(reinterpret(UInt64, bytes[pos+1:pos+8])[1])
+
+        arrays[name] = collect(reinterpret(types[a["type"]], bytes[pos+9:pos+8+nb]))
+    end
+
+    return arrays, attrs
+end
+
+
+"""
+    key = vtk_field(dict, name)
+
+Returns the key of output field `name` (array names of LaMEM output contain units, e.g. `"velocity [ ]"`).
+"""
+vtk_field(dict, name::String) = only(filter(k -> k == name || startswith(k, name*" "), collect(keys(dict))))
+
+
+"""
+    blocks = read_lamem_ptr_series(fname::String)
+
+Reads a passive tracer time series file (`<out_file_name>_passive_tracers.series.dat`, native byte order).
+Returns a vector of `(time, ID, data)` tuples, one per output step, where `data` is an `8 x ntot` matrix
+with rows ID, time, x, y, z, p, T, mf (tracer order within a step is arbitrary).
+"""
+function read_lamem_ptr_series(fname::String)
+    data   = Vector{Float64}(undef, filesize(fname) ÷ 8)
+    read!(fname, data)
+    nfld   = Int64(data[3])
+    pos    = 3 + nfld*32 ÷ 8
+    blocks = Tuple{Float64, Vector{Int64}, Matrix{Float64}}[]
+
+    while pos + 2 <= length(data)
+        time = data[pos+1]
+        n    = Int64(data[pos+2])
+        buf  = reshape(data[pos+3:pos+2+nfld*n], nfld, n)
+        push!(blocks, (time, round.(Int64, buf[1,:]), buf))
+        pos += 2 + nfld*n
+    end
+
+    return blocks
+end
+
+
 """
     get_dylibs()
 This retrieves dynamic libraries, required to run LaMEM. It assumes that the global variable `use_dynamic_lib` is present